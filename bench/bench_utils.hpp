@@ -0,0 +1,235 @@
+#pragma once
+// Minimal benchmark harness shared by the bench/ executables.
+//
+// Each benchmark is a callable taking a State&. The body loops on
+// state.keep_running(); work that should not be timed goes between
+// state.pause() and state.resume(). Results are printed as a table, JSON or
+// CSV (--format=table|json|csv) so runs can be diffed across commits.
+//
+//   ./ecs_bench --format=json --filter=view --min-time=0.5 > bench.json
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace csics::bench {
+
+using Params = std::vector<std::pair<std::string, std::string>>;
+
+class State {
+   public:
+    explicit State(double min_time) : min_time_ns_(min_time * 1e9) {}
+
+    // Returns true while another timed iteration is needed.
+    bool keep_running() {
+        const auto now = clock::now();
+        if (running_) {
+            elapsed_ns_ += elapsed(start_, now);
+            ++iterations_;
+        }
+        if (iterations_ > 0 && elapsed_ns_ >= min_time_ns_) {
+            running_ = false;
+            return false;
+        }
+        running_ = true;
+        start_ = clock::now();
+        return true;
+    }
+
+    void pause() {
+        elapsed_ns_ += elapsed(start_, clock::now());
+        running_ = false;
+    }
+
+    void resume() {
+        running_ = true;
+        start_ = clock::now();
+    }
+
+    // Items processed per iteration, used for the throughput column.
+    void set_items_per_iteration(std::uint64_t items) { items_ = items; }
+    // Memory footprint of the structure under test, in bytes.
+    void set_bytes(std::uint64_t bytes) { bytes_ = bytes; }
+    // Bytes read or written per iteration, used for the MB/s column.
+    void set_bytes_per_iteration(std::uint64_t bytes) { processed_ = bytes; }
+
+    std::uint64_t iterations() const { return iterations_; }
+    double elapsed_ns() const { return elapsed_ns_; }
+    std::uint64_t items() const { return items_; }
+    std::uint64_t bytes() const { return bytes_; }
+    std::uint64_t bytes_per_iteration() const { return processed_; }
+
+   private:
+    using clock = std::chrono::steady_clock;
+    static double elapsed(clock::time_point a, clock::time_point b) {
+        return std::chrono::duration<double, std::nano>(b - a).count();
+    }
+
+    double min_time_ns_;
+    double elapsed_ns_ = 0;
+    std::uint64_t iterations_ = 0;
+    std::uint64_t items_ = 1;
+    std::uint64_t bytes_ = 0;
+    std::uint64_t processed_ = 0;
+    bool running_ = false;
+    clock::time_point start_;
+};
+
+// Keeps the compiler from optimising away a computed value.
+template <typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    Params params;
+    std::uint64_t iterations;
+    double ns_per_iteration;
+    double items_per_second;
+    double mb_per_second;
+    std::uint64_t bytes;
+};
+
+class Registry {
+   public:
+    void add(std::string name, Params params, std::function<void(State&)> fn) {
+        benchmarks_.push_back({std::move(name), std::move(params), std::move(fn)});
+    }
+
+    int run(int argc, char** argv) {
+        std::string_view format = "table";
+        std::string_view filter;
+        double min_time = 0.2;
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg.starts_with("--format=")) {
+                format = arg.substr(9);
+            } else if (arg.starts_with("--filter=")) {
+                filter = arg.substr(9);
+            } else if (arg.starts_with("--min-time=")) {
+                min_time = std::stod(std::string(arg.substr(11)));
+            } else {
+                std::fprintf(stderr,
+                             "usage: %s [--format=table|json|csv] "
+                             "[--filter=substr] [--min-time=seconds]\n",
+                             argv[0]);
+                return 1;
+            }
+        }
+
+        std::vector<Result> results;
+        for (auto& b : benchmarks_) {
+            const std::string full = full_name(b.name, b.params);
+            if (!filter.empty() && full.find(filter) == std::string::npos) {
+                continue;
+            }
+            State state(min_time);
+            b.fn(state);
+            const double ns = state.elapsed_ns() /
+                              std::max<std::uint64_t>(state.iterations(), 1);
+            results.push_back(Result{
+                b.name, b.params, state.iterations(), ns,
+                ns > 0 ? state.items() * 1e9 / ns : 0,
+                ns > 0 ? state.bytes_per_iteration() * 1e3 / ns : 0,
+                state.bytes()});
+            if (format == "table") {
+                print_row(results.back());
+            }
+        }
+
+        if (format == "json") {
+            print_json(results);
+        } else if (format == "csv") {
+            print_csv(results);
+        }
+        return 0;
+    }
+
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+   private:
+    struct Entry {
+        std::string name;
+        Params params;
+        std::function<void(State&)> fn;
+    };
+    std::vector<Entry> benchmarks_;
+
+    static std::string full_name(const std::string& name, const Params& p) {
+        std::string out = name;
+        for (const auto& [k, v] : p) {
+            out += "/" + k + "=" + v;
+        }
+        return out;
+    }
+
+    static long peak_rss_kb() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    static void print_row(const Result& r) {
+        std::printf(
+            "%-64s %12llu it %14.1f ns/it %14.0f items/s %10.1f MB/s "
+            "%12llu B\n",
+            full_name(r.name, r.params).c_str(),
+            static_cast<unsigned long long>(r.iterations), r.ns_per_iteration,
+            r.items_per_second, r.mb_per_second,
+            static_cast<unsigned long long>(r.bytes));
+    }
+
+    static void print_json(const std::vector<Result>& results) {
+        std::printf("{\n  \"context\": {\"peak_rss_kb\": %ld},\n", peak_rss_kb());
+        std::printf("  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            std::printf("    {\"name\": \"%s\", \"params\": {", r.name.c_str());
+            for (std::size_t j = 0; j < r.params.size(); ++j) {
+                std::printf("%s\"%s\": \"%s\"", j ? ", " : "",
+                            r.params[j].first.c_str(),
+                            r.params[j].second.c_str());
+            }
+            std::printf(
+                "}, \"iterations\": %llu, \"ns_per_iteration\": %.3f, "
+                "\"items_per_second\": %.3f, \"mb_per_second\": %.3f, "
+                "\"bytes\": %llu}%s\n",
+                static_cast<unsigned long long>(r.iterations),
+                r.ns_per_iteration, r.items_per_second, r.mb_per_second,
+                static_cast<unsigned long long>(r.bytes),
+                i + 1 < results.size() ? "," : "");
+        }
+        std::printf("  ]\n}\n");
+    }
+
+    static void print_csv(const std::vector<Result>& results) {
+        std::printf("name,params,iterations,ns_per_iteration,items_per_second,"
+                    "mb_per_second,bytes\n");
+        for (const auto& r : results) {
+            std::string params;
+            for (const auto& [k, v] : r.params) {
+                params += (params.empty() ? "" : ";") + k + "=" + v;
+            }
+            std::printf("%s,%s,%llu,%.3f,%.3f,%.3f,%llu\n", r.name.c_str(),
+                        params.c_str(),
+                        static_cast<unsigned long long>(r.iterations),
+                        r.ns_per_iteration, r.items_per_second, r.mb_per_second,
+                        static_cast<unsigned long long>(r.bytes));
+        }
+    }
+};
+
+};  // namespace csics::bench
@@ -0,0 +1,106 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench_utils.hpp"
+#include "csics/io/net/UDPEndpoint.hpp"
+
+using namespace csics::io::net;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+// Datagrams per iteration; small enough that a burst fits in the default
+// loopback receive buffer.
+constexpr std::size_t kDatagrams = 32;
+constexpr Port kRxPort = 47400;
+
+struct Loopback {
+    UDPEndpoint rx;
+    UDPEndpoint tx;
+    std::vector<char> payload;
+    std::vector<csics::BufferView> datagrams;
+
+    explicit Loopback(std::size_t size) : payload(size, 'x') {
+        rx.bind(kRxPort);
+        tx.bind(0);
+        datagrams.assign(kDatagrams,
+                         csics::BufferView(payload.data(), payload.size()));
+    }
+
+    void burst() { tx.send_batch(datagrams, SockAddr::localhost(kRxPort)); }
+};
+
+void bench_send(State& state, std::size_t size, bool batched) {
+    Loopback l(size);
+    state.set_items_per_iteration(kDatagrams);
+    state.set_bytes_per_iteration(kDatagrams * size);
+    std::array<char, 2048> buffer;
+    while (state.keep_running()) {
+        if (batched) {
+            l.burst();
+        } else {
+            for (const auto& d : l.datagrams) {
+                l.tx.send(d, SockAddr::localhost(kRxPort));
+            }
+        }
+        // drain so the next burst is not dropped
+        state.pause();
+        SockAddr src;
+        while (l.rx.poll(0) == PollStatus::Ready) {
+            l.rx.recv(csics::MutableBufferView(buffer.data(), buffer.size()),
+                      src);
+        }
+        state.resume();
+    }
+}
+
+void bench_recv(State& state, std::size_t size, bool batched) {
+    Loopback l(size);
+    state.set_items_per_iteration(kDatagrams);
+    state.set_bytes_per_iteration(kDatagrams * size);
+    std::vector<std::array<char, 2048>> storage(kDatagrams);
+    std::vector<csics::MutableBufferView> buffers;
+    for (auto& s : storage) {
+        buffers.emplace_back(s.data(), s.size());
+    }
+    std::vector<SockAddr> sources(kDatagrams);
+    std::vector<std::size_t> sizes(kDatagrams);
+    std::size_t received = 0;
+    while (state.keep_running()) {
+        state.pause();
+        l.burst();
+        l.rx.poll(1000);
+        state.resume();
+        if (batched) {
+            received += l.rx.recv_batch(buffers, sources, sizes,
+                                        RecvMode::NonBlocking)
+                            .messages;
+        } else {
+            for (std::size_t i = 0; i < kDatagrams; ++i) {
+                received += l.rx.recv(buffers[i], sources[i]).bytes_transferred;
+            }
+        }
+    }
+    csics::bench::do_not_optimize(received);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    for (std::size_t size : {144, 1024}) {
+        const std::string s = std::to_string(size);
+        r.add("udp/send", {{"size", s}, {"api", "sendto"}},
+              [=](State& st) { bench_send(st, size, false); });
+        r.add("udp/send", {{"size", s}, {"api", "send_batch"}},
+              [=](State& st) { bench_send(st, size, true); });
+        r.add("udp/recv", {{"size", s}, {"api", "recvfrom"}},
+              [=](State& st) { bench_recv(st, size, false); });
+        r.add("udp/recv", {{"size", s}, {"api", "recv_batch"}},
+              [=](State& st) { bench_recv(st, size, true); });
+    }
+    return r.run(argc, argv);
+}
@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "csics/lvc/dis/dis.hpp"
+
+using namespace csics::lvc::dis;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+constexpr std::size_t kPDUs = 100000;
+
+std::string log_path() {
+    return (std::filesystem::temp_directory_path() / "csics_capture_bench.dis")
+        .string();
+}
+
+EntityStateImage make_image() {
+    EntityStatePDU pdu{};
+    pdu.entity_id = EntityID(1, 1, 1);
+    pdu.dr_parameters.algorithm = 2;
+    return EntityStateImage(pdu);
+}
+
+void bench_record(State& state, bool compress) {
+    auto image = make_image();
+    csics::Buffer<char> pdu(EntityStateImage::size);
+    CaptureConfig config;
+    config.compress = compress;
+    state.set_items_per_iteration(kPDUs);
+    while (state.keep_running()) {
+        DISRecorder recorder(config);
+        recorder.open(log_path());
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            image.location(WorldCoordinates(double(i), 2.0, 3.0));
+            image.write(pdu);
+            recorder.record(pdu, std::chrono::microseconds(i * 100));
+        }
+        recorder.close();
+    }
+}
+
+// Replays the log written by the matching record run as fast as possible
+// into a sink that only touches each PDU.
+void bench_replay(State& state) {
+    DISLog log;
+    log.open(log_path());
+    ReplayConfig config;
+    config.speed = 0;
+    std::size_t bytes = 0;
+    state.set_items_per_iteration(log.records());
+    while (state.keep_running()) {
+        DISReplayer replayer(log, config);
+        replayer.play([&](csics::BufferView pdu) { bytes += pdu.size(); });
+    }
+    csics::bench::do_not_optimize(bytes);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    const std::string n = std::to_string(kPDUs);
+
+    r.add("dis_capture/record", {{"pdus", n}, {"compress", "off"}},
+          [](State& s) { bench_record(s, false); });
+    r.add("dis_capture/replay", {{"pdus", n}, {"compress", "off"}},
+          bench_replay);
+#ifdef CSICS_USE_ZSTD
+    r.add("dis_capture/record", {{"pdus", n}, {"compress", "zstd"}},
+          [](State& s) { bench_record(s, true); });
+    r.add("dis_capture/replay", {{"pdus", n}, {"compress", "zstd"}},
+          bench_replay);
+#endif
+
+    int ret = r.run(argc, argv);
+    std::filesystem::remove(log_path());
+    return ret;
+}
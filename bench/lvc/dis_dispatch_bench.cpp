@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench_utils.hpp"
+#include "csics/lvc/dis/dis.hpp"
+
+using namespace csics::lvc::dis;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+// A mixed stream of encoded PDUs, mostly entity state as on a typical
+// exercise network, spread over four exercises.
+struct Stream {
+    std::vector<csics::Buffer<char>> storage;
+    std::vector<csics::BufferView> pdus;
+
+    explicit Stream(std::size_t n) {
+        csics::serialization::DirectSerializer s;
+        storage.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            csics::Buffer<char> buffer(512);
+            const auto exercise = static_cast<std::uint8_t>(i % 4);
+            const auto id = EntityID(1, 1, static_cast<std::uint16_t>(i));
+            std::size_t size;
+            if (i % 10 == 9) {
+                TransmitterPDU pdu{};
+                pdu.header.exercise_id = exercise;
+                pdu.radio_reference_id = id;
+                pdu.modulation_parameters.push_back(1);
+                size = csics::serialization::serialize(s, buffer, pdu)
+                           .written_view.size();
+            } else {
+                EntityStatePDU pdu{};
+                pdu.header.exercise_id = exercise;
+                pdu.entity_id = id;
+                pdu.entity_appearance = static_cast<std::uint32_t>(i);
+                size = csics::serialization::serialize(s, buffer, pdu)
+                           .written_view.size();
+            }
+            storage.push_back(std::move(buffer));
+            pdus.emplace_back(storage.back().data(), size);
+        }
+    }
+};
+
+template <typename Dispatcher>
+void run(State& state, Dispatcher& dispatcher, const Stream& stream) {
+    state.set_items_per_iteration(stream.pdus.size());
+    while (state.keep_running()) {
+        for (auto bv : stream.pdus) {
+            auto status = dispatcher.dispatch(bv);
+            csics::bench::do_not_optimize(status);
+        }
+    }
+}
+
+constexpr std::size_t kPDUs = 10000;
+
+void bench_runtime_typed(State& state) {
+    Stream stream(kPDUs);
+    std::uint64_t sum = 0;
+    DISDispatcher dispatcher;
+    dispatcher.on<EntityStatePDU>(
+        [&](const EntityStatePDU& pdu) { sum += pdu.entity_appearance; });
+    dispatcher.on<TransmitterPDU>(
+        [&](const TransmitterPDU& pdu) { sum += pdu.radio_number; });
+    run(state, dispatcher, stream);
+    csics::bench::do_not_optimize(sum);
+}
+
+void bench_runtime_view(State& state) {
+    Stream stream(kPDUs);
+    std::uint64_t sum = 0;
+    DISDispatcher dispatcher;
+    dispatcher.on<EntityStatePDU>(
+        [&](const EntityStatePDUView& v) { sum += v.appearance(); });
+    dispatcher.on<TransmitterPDU>(
+        [&](const TransmitterPDUView& v) { sum += v.radio_number(); });
+    run(state, dispatcher, stream);
+    csics::bench::do_not_optimize(sum);
+}
+
+void bench_static_typed(State& state) {
+    Stream stream(kPDUs);
+    std::uint64_t sum = 0;
+    auto dispatcher = make_dis_dispatcher(
+        on<EntityStatePDU>(
+            [&](const EntityStatePDU& pdu) { sum += pdu.entity_appearance; }),
+        on<TransmitterPDU>(
+            [&](const TransmitterPDU& pdu) { sum += pdu.radio_number; }));
+    run(state, dispatcher, stream);
+    csics::bench::do_not_optimize(sum);
+}
+
+void bench_static_view(State& state, bool filtered) {
+    Stream stream(kPDUs);
+    std::uint64_t sum = 0;
+    auto dispatcher = make_dis_dispatcher(
+        on<EntityStatePDU>(
+            [&](const EntityStatePDUView& v) { sum += v.appearance(); }),
+        on<TransmitterPDU>(
+            [&](const TransmitterPDUView& v) { sum += v.radio_number(); }));
+    if (filtered) {
+        dispatcher.filter().exercise(0);
+    }
+    run(state, dispatcher, stream);
+    csics::bench::do_not_optimize(sum);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    const std::string n = std::to_string(kPDUs);
+
+    r.add("dis_dispatch/runtime", {{"pdus", n}, {"handler", "typed"}},
+          bench_runtime_typed);
+    r.add("dis_dispatch/runtime", {{"pdus", n}, {"handler", "view"}},
+          bench_runtime_view);
+    r.add("dis_dispatch/static", {{"pdus", n}, {"handler", "typed"}},
+          bench_static_typed);
+    r.add("dis_dispatch/static", {{"pdus", n}, {"handler", "view"}},
+          [](State& s) { bench_static_view(s, false); });
+    // three quarters of the stream is dropped by the exercise filter
+    r.add("dis_dispatch/static",
+          {{"pdus", n}, {"handler", "view"}, {"filter", "exercise"}},
+          [](State& s) { bench_static_view(s, true); });
+
+    return r.run(argc, argv);
+}
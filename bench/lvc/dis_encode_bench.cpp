@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "csics/lvc/dis/dis.hpp"
+
+using namespace csics::lvc::dis;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+constexpr std::size_t kPDUs = 10000;
+
+EntityStatePDU make_pdu() {
+    EntityStatePDU pdu{};
+    pdu.entity_id = EntityID(1, 1, 1);
+    pdu.entity_location = WorldCoordinates(1.0, 2.0, 3.0);
+    pdu.entity_linear_velocity = Vector(1.0f, 0.0f, 0.0f);
+    pdu.dr_parameters.algorithm = 2;
+    pdu.dr_parameters.params_type = 1;
+    return pdu;
+}
+
+// Encodes kPDUs heartbeats, moving the entity each time.
+template <typename Serializer>
+void bench_serializer(State& state) {
+    auto pdu = make_pdu();
+    csics::Buffer<char> out(256);
+    Serializer s;
+    state.set_items_per_iteration(kPDUs);
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            pdu.entity_location = WorldCoordinates(double(i), 2.0, 3.0);
+            auto res = csics::serialization::serialize(s, out, pdu);
+            csics::bench::do_not_optimize(res);
+        }
+    }
+}
+
+void bench_image(State& state) {
+    EntityStateImage image(make_pdu());
+    csics::Buffer<char> out(256);
+    state.set_items_per_iteration(kPDUs);
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            image.location(WorldCoordinates(double(i), 2.0, 3.0));
+            auto res = image.write(out);
+            csics::bench::do_not_optimize(res);
+        }
+    }
+}
+
+// Heartbeats through the bundler into a sink that only counts the calls
+// that would be sendmmsg system calls.
+void bench_bundle(State& state, bool bundle) {
+    auto pdu = make_pdu();
+    BundlerConfig config;
+    config.bundle = bundle;
+    PDUBundler<> bundler(config);
+    std::size_t calls = 0;
+    auto sink = [&](std::span<const csics::BufferView> d) {
+        ++calls;
+        return d.size();
+    };
+    state.set_items_per_iteration(kPDUs);
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            pdu.entity_location = WorldCoordinates(double(i), 2.0, 3.0);
+            bundler.add(pdu, sink);
+        }
+        bundler.flush(sink);
+    }
+    csics::bench::do_not_optimize(calls);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    const std::string n = std::to_string(kPDUs);
+
+    r.add("dis_encode/entity_state", {{"pdus", n}, {"path", "direct"}},
+          bench_serializer<csics::serialization::DirectSerializer>);
+    r.add("dis_encode/entity_state", {{"pdus", n}, {"path", "fixed"}},
+          bench_serializer<FixedLayoutSerializer>);
+    r.add("dis_encode/entity_state", {{"pdus", n}, {"path", "image"}},
+          bench_image);
+    r.add("dis_encode/bundle", {{"pdus", n}, {"bundle", "on"}},
+          [](State& s) { bench_bundle(s, true); });
+    r.add("dis_encode/bundle", {{"pdus", n}, {"bundle", "off"}},
+          [](State& s) { bench_bundle(s, false); });
+
+    return r.run(argc, argv);
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_utils.hpp"
+#include "csics/lvc/dis/dis.hpp"
+
+using namespace csics::lvc::dis;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+// Keys of `n` entities spread over a few sites and applications, in a
+// shuffled order.
+std::vector<std::uint64_t> make_keys(std::size_t n) {
+    std::vector<std::uint64_t> keys;
+    for (std::size_t i = 0; i < n; ++i) {
+        keys.push_back(EntityID(1 + i % 4, 1 + (i / 4) % 16,
+                                static_cast<std::uint16_t>(i / 64))
+                           .packed());
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(1));
+    return keys;
+}
+
+template <typename Map>
+void bench_find(State& state, std::size_t n) {
+    auto keys = make_keys(n);
+    Map map;
+    for (std::size_t i = 0; i < n; ++i) {
+        map[keys[i]] = static_cast<std::uint32_t>(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(2));
+    std::uint64_t sum = 0;
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        for (auto k : keys) {
+            if constexpr (std::is_same_v<Map, EntityIDMap<std::uint32_t>>) {
+                sum += *map.find(k);
+            } else {
+                sum += map.find(k)->second;
+            }
+        }
+    }
+    csics::bench::do_not_optimize(sum);
+}
+
+// One heartbeat from every entity per iteration, in shuffled order.
+void bench_update(State& state, std::size_t n) {
+    auto keys = make_keys(n);
+    std::vector<std::vector<char>> pdus;
+    for (auto k : keys) {
+        EntityStatePDU pdu{};
+        pdu.entity_id = EntityID(static_cast<std::uint16_t>(k >> 32),
+                                 static_cast<std::uint16_t>(k >> 16),
+                                 static_cast<std::uint16_t>(k));
+        std::vector<char> out(layout::entity_state::size);
+        encode_fixed(out, pdu);
+        pdus.push_back(std::move(out));
+    }
+    RemoteEntityTable<> table;
+    table.reserve(n);
+    auto now = std::chrono::steady_clock::now();
+    std::uint32_t ts = 0;
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        ts += 2;
+        now += std::chrono::seconds(1);
+        for (auto& pdu : pdus) {
+            csics::store_big<std::uint32_t>(pdu.data() + layout::header::timestamp,
+                                            ts);
+            table.update(csics::BufferView(pdu.data(), pdu.size()), now);
+        }
+        table.expire(now);
+        table.clear_events();
+    }
+    csics::bench::do_not_optimize(table.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    for (std::size_t n : {std::size_t{1000}, std::size_t{100000},
+                          std::size_t{1000000}}) {
+        const std::string ns = std::to_string(n);
+        r.add("entity_table/find", {{"entities", ns}, {"map", "EntityIDMap"}},
+              [n](State& s) { bench_find<EntityIDMap<std::uint32_t>>(s, n); });
+        r.add("entity_table/find", {{"entities", ns}, {"map", "unordered_map"}},
+              [n](State& s) {
+                  bench_find<std::unordered_map<std::uint64_t, std::uint32_t>>(
+                      s, n);
+              });
+        r.add("entity_table/update", {{"entities", ns}},
+              [n](State& s) { bench_update(s, n); });
+    }
+    return r.run(argc, argv);
+}
@@ -0,0 +1,255 @@
+#include <cstdint>
+#include <string>
+
+#include "bench_utils.hpp"
+#include "csics/lvc/dis/dis.hpp"
+
+#ifdef CSICS_BENCH_OPENDIS
+#include <dis7/DetonationPdu.h>
+#include <dis7/ElectromagneticEmissionsPdu.h>
+#include <dis7/EntityStatePdu.h>
+#include <dis7/FirePdu.h>
+#include <dis7/SignalPdu.h>
+#include <dis7/TransmitterPdu.h>
+#include <dis7/utils/DataStream.h>
+#endif
+
+using namespace csics::lvc::dis;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+// PDUs encoded or decoded per timed iteration.
+constexpr std::size_t kPDUs = 1000;
+constexpr std::size_t kBufferSize = 1 << 16;
+
+EntityStatePDU make_entity_state() {
+    EntityStatePDU pdu{};
+    pdu.entity_id = EntityID(1, 2, 3);
+    pdu.entity_type = EntityType(1, 2, 225, 1, 3, 4, 5);
+    pdu.entity_location = WorldCoordinates(-2450000.0, -4650000.0, 3550000.0);
+    pdu.entity_linear_velocity = Vector(120.0f, 5.0f, -1.0f);
+    pdu.entity_orientation = EulerAngles(0.1f, 0.2f, 0.3f);
+    pdu.entity_appearance = 0x12345678;
+    pdu.dr_parameters.algorithm = 4;
+    pdu.dr_parameters.params_type = 1;
+    for (std::uint8_t i = 0; i < 4; ++i) {
+        VariableParameters p{};
+        p.type = i;
+        pdu.variable_parameters.push_back(p);
+    }
+    return pdu;
+}
+
+FirePDU make_fire() {
+    FirePDU pdu{};
+    pdu.firing_entity_id = EntityID(1, 2, 3);
+    pdu.target_entity_id = EntityID(1, 2, 4);
+    pdu.munition_id = EntityID(1, 2, 5);
+    pdu.event_id = EventID(1, 2, 6);
+    pdu.location = WorldCoordinates(-2450000.0, -4650000.0, 3550000.0);
+    pdu.velocity = Vector(300.0f, 0.0f, 0.0f);
+    pdu.range = 12000.0f;
+    return pdu;
+}
+
+DetonationPDU make_detonation() {
+    DetonationPDU pdu{};
+    pdu.firing_entity_id = EntityID(1, 2, 3);
+    pdu.target_entity_id = EntityID(1, 2, 4);
+    pdu.munition_id = EntityID(1, 2, 5);
+    pdu.event_id = EventID(1, 2, 6);
+    pdu.location = WorldCoordinates(-2450000.0, -4650000.0, 3550000.0);
+    pdu.detonation_result = 1;
+    for (std::uint8_t i = 0; i < 2; ++i) {
+        VariableParameters p{};
+        p.type = i;
+        pdu.variable_parameters.push_back(p);
+    }
+    return pdu;
+}
+
+// Four systems of four beams, each jamming four tracks.
+ElectromagneticEmissionPDU make_emission() {
+    ElectromagneticEmissionPDU pdu{};
+    pdu.emitter_id = EntityID(1, 2, 3);
+    pdu.event_id = EventID(1, 2, 6);
+    for (std::uint8_t s = 0; s < 4; ++s) {
+        EmitterSystem system{};
+        system.emitter_name = 0x1234;
+        system.emitter_number = s;
+        system.emitter_location = EntityCoordinates(1.0f, 2.0f, 3.0f);
+        for (std::uint8_t b = 0; b < 4; ++b) {
+            Beam beam{};
+            beam.beam_number = b;
+            beam.number_of_targets = 4;
+            beam.fundamental_parameters.center_frequency = 9.4e9f;
+            beam.fundamental_parameters.pulse_repetition_frequency = 1000.0f;
+            csics::Buffer<TrackJam> jams;
+            for (std::uint16_t t = 0; t < 4; ++t) {
+                jams.push_back(TrackJam{EntityID(1, 2, t), s, b});
+            }
+            beam.track_jams = std::move(jams);
+            system.beams.push_back(std::move(beam));
+        }
+        pdu.emitter_systems.push_back(std::move(system));
+    }
+    return pdu;
+}
+
+TransmitterPDU make_transmitter() {
+    TransmitterPDU pdu{};
+    pdu.radio_reference_id = ID(1, 2, 3);
+    pdu.radio_type.dis7 = RadioType7{1, 2, 225, 3, 4, 5, 6};
+    pdu.center_frequency = 243000000;
+    for (std::uint8_t i = 0; i < 16; ++i) {
+        pdu.modulation_parameters.push_back(i);
+    }
+    VariableTransmitterParameters params;
+    params.type = 1;
+    for (std::size_t i = 0; i < 1024; ++i) {
+        params.data.push_back(static_cast<std::uint8_t>(i));
+    }
+    pdu.variable_parameters.push_back(std::move(params));
+    return pdu;
+}
+
+// 1 KB of audio; the data is a view, so it must outlive the PDU.
+SignalPDU make_signal() {
+    static const std::string audio(1024, '\x5A');
+    SignalPDU pdu{};
+    pdu.radio_reference_id = ID(1, 2, 3);
+    pdu.sample_rate = 8000;
+    pdu.samples = 512;
+    pdu.data = csics::BufferView(audio.data(), audio.size());
+    return pdu;
+}
+
+template <typename PDU>
+csics::Buffer<char> encode(const PDU& pdu) {
+    csics::serialization::DirectSerializer s;
+    csics::Buffer<char> out(kBufferSize);
+    auto res = csics::serialization::serialize(s, out, pdu);
+    out.resize(res.written_view.size());
+    return out;
+}
+
+template <typename PDU>
+void bench_encode(State& state, const PDU& pdu) {
+    csics::serialization::DirectSerializer s;
+    csics::Buffer<char> out(kBufferSize);
+    state.set_items_per_iteration(kPDUs);
+    state.set_bytes_per_iteration(kPDUs * encode(pdu).size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            auto res = csics::serialization::serialize(s, out, pdu);
+            csics::bench::do_not_optimize(res);
+        }
+    }
+}
+
+template <typename PDU>
+void bench_decode(State& state, const PDU& pdu) {
+    const auto encoded = encode(pdu);
+    const csics::BufferView in(encoded.data(), encoded.size());
+    state.set_items_per_iteration(kPDUs);
+    state.set_bytes_per_iteration(kPDUs * in.size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            csics::serialization::DirectDeserializer d(in);
+            PDU out;
+            auto res = csics::serialization::deserialize(d, out);
+            csics::bench::do_not_optimize(res);
+        }
+    }
+}
+
+#ifdef CSICS_BENCH_OPENDIS
+// open-dis objects are built by unmarshalling our encoding of the same PDU,
+// so both sides work on identical content.
+template <typename OpenPDU, typename PDU>
+void bench_opendis_encode(State& state, const PDU& pdu) {
+    const auto encoded = encode(pdu);
+    DIS::DataStream in(encoded.data(), encoded.size(), DIS::BIG);
+    OpenPDU open;
+    open.unmarshal(in);
+    DIS::DataStream out(DIS::BIG);
+    open.marshal(out);
+    state.set_items_per_iteration(kPDUs);
+    state.set_bytes_per_iteration(kPDUs * out.size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            out.clear();
+            open.marshal(out);
+            csics::bench::do_not_optimize(out.size());
+        }
+    }
+}
+
+template <typename OpenPDU, typename PDU>
+void bench_opendis_decode(State& state, const PDU& pdu) {
+    const auto encoded = encode(pdu);
+    state.set_items_per_iteration(kPDUs);
+    state.set_bytes_per_iteration(kPDUs * encoded.size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kPDUs; ++i) {
+            DIS::DataStream in(encoded.data(), encoded.size(), DIS::BIG);
+            OpenPDU out;
+            out.unmarshal(in);
+            csics::bench::do_not_optimize(out);
+        }
+    }
+}
+#endif
+
+template <typename PDU>
+void add_pdu(Registry& r, const std::string& name, const std::string& shape,
+             const PDU& pdu) {
+    const std::string n = std::to_string(kPDUs);
+    r.add("dis_serde/encode",
+          {{"pdus", n}, {"pdu", name}, {"shape", shape}, {"lib", "csics"}},
+          [pdu](State& s) { bench_encode(s, pdu); });
+    r.add("dis_serde/decode",
+          {{"pdus", n}, {"pdu", name}, {"shape", shape}, {"lib", "csics"}},
+          [pdu](State& s) { bench_decode(s, pdu); });
+}
+
+#ifdef CSICS_BENCH_OPENDIS
+template <typename OpenPDU, typename PDU>
+void add_opendis(Registry& r, const std::string& name,
+                 const std::string& shape, const PDU& pdu) {
+    const std::string n = std::to_string(kPDUs);
+    r.add("dis_serde/encode",
+          {{"pdus", n}, {"pdu", name}, {"shape", shape}, {"lib", "open-dis"}},
+          [pdu](State& s) { bench_opendis_encode<OpenPDU>(s, pdu); });
+    r.add("dis_serde/decode",
+          {{"pdus", n}, {"pdu", name}, {"shape", shape}, {"lib", "open-dis"}},
+          [pdu](State& s) { bench_opendis_decode<OpenPDU>(s, pdu); });
+}
+#endif
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    add_pdu(r, "entity_state", "small_fields", make_entity_state());
+    add_pdu(r, "fire", "small_fields", make_fire());
+    add_pdu(r, "detonation", "small_fields", make_detonation());
+    add_pdu(r, "emission", "nested", make_emission());
+    add_pdu(r, "transmitter", "large_array", make_transmitter());
+    add_pdu(r, "signal", "large_array", make_signal());
+#ifdef CSICS_BENCH_OPENDIS
+    add_opendis<DIS::EntityStatePdu>(r, "entity_state", "small_fields",
+                                     make_entity_state());
+    add_opendis<DIS::FirePdu>(r, "fire", "small_fields", make_fire());
+    add_opendis<DIS::DetonationPdu>(r, "detonation", "small_fields",
+                                    make_detonation());
+    add_opendis<DIS::ElectromagneticEmissionsPdu>(r, "emission", "nested",
+                                                  make_emission());
+    add_opendis<DIS::TransmitterPdu>(r, "transmitter", "large_array",
+                                     make_transmitter());
+    add_opendis<DIS::SignalPdu>(r, "signal", "large_array", make_signal());
+#endif
+    return r.run(argc, argv);
+}
@@ -0,0 +1,290 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_utils.hpp"
+#include "csics/serialization/serialization.hpp"
+
+using namespace csics::serialization;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+// Messages encoded or decoded per timed iteration.
+constexpr std::size_t kMessages = 1000;
+
+// Many small fields, like a track report.
+struct Contact {
+    int id = 4021;
+    double time = 1700000000.125;
+    double lat = 35.123456789;
+    double lon = -117.5;
+    double alt = 9144.0;
+    double heading = 271.5;
+    double speed = 240.25;
+    int quality = 7;
+    int iff = 4512;
+    bool hostile = true;
+    bool valid = true;
+    std::string callsign = "VIPER 1";
+
+    static consteval auto fields() {
+        return make_fields(
+            make_field("id", &Contact::id), make_field("time", &Contact::time),
+            make_field("lat", &Contact::lat), make_field("lon", &Contact::lon),
+            make_field("alt", &Contact::alt),
+            make_field("heading", &Contact::heading),
+            make_field("speed", &Contact::speed),
+            make_field("quality", &Contact::quality),
+            make_field("iff", &Contact::iff),
+            make_field("hostile", &Contact::hostile),
+            make_field("valid", &Contact::valid),
+            make_field("callsign", &Contact::callsign));
+    }
+};
+
+// Fixed size fields only, so DirectSerializer can write it as one copy.
+struct Track {
+    int id = 4021;
+    double time = 1700000000.125;
+    double lat = 35.123456789;
+    double lon = -117.5;
+    double alt = 9144.0;
+    double heading = 271.5;
+    double speed = 240.25;
+    float range = 1852.0f;
+    float bearing = 45.0f;
+    int quality = 7;
+    int iff = 4512;
+    std::uint16_t site = 1;
+    std::uint16_t application = 2;
+    bool hostile = true;
+    bool valid = true;
+
+    static consteval auto fields() {
+        return make_fields(
+            make_field("id", &Track::id), make_field("time", &Track::time),
+            make_field("lat", &Track::lat), make_field("lon", &Track::lon),
+            make_field("alt", &Track::alt),
+            make_field("heading", &Track::heading),
+            make_field("speed", &Track::speed),
+            make_field("range", &Track::range),
+            make_field("bearing", &Track::bearing),
+            make_field("quality", &Track::quality),
+            make_field("iff", &Track::iff), make_field("site", &Track::site),
+            make_field("application", &Track::application),
+            make_field("hostile", &Track::hostile),
+            make_field("valid", &Track::valid));
+    }
+};
+
+// One large array of numbers.
+struct Waveform {
+    int id = 9;
+    double rate = 8000.0;
+    std::vector<double> samples;
+
+    static consteval auto fields() {
+        return make_fields(make_field("id", &Waveform::id),
+                           make_field("rate", &Waveform::rate),
+                           make_field("samples", &Waveform::samples));
+    }
+};
+
+// Emitters, beams and track-jams nested as in an emission PDU.
+struct Jam {
+    int site = 1;
+    int application = 2;
+    int entity = 3;
+    int emitter = 1;
+    int beam = 1;
+
+    static consteval auto fields() {
+        return make_fields(make_field("site", &Jam::site),
+                           make_field("application", &Jam::application),
+                           make_field("entity", &Jam::entity),
+                           make_field("emitter", &Jam::emitter),
+                           make_field("beam", &Jam::beam));
+    }
+};
+
+struct EmitterBeam {
+    int number = 1;
+    double frequency = 9.4e9;
+    double prf = 1000.0;
+    double pulse_width = 1e-6;
+    double erp = 80.0;
+    std::vector<Jam> jams;
+
+    static consteval auto fields() {
+        return make_fields(make_field("number", &EmitterBeam::number),
+                           make_field("frequency", &EmitterBeam::frequency),
+                           make_field("prf", &EmitterBeam::prf),
+                           make_field("pulse_width", &EmitterBeam::pulse_width),
+                           make_field("erp", &EmitterBeam::erp),
+                           make_field("jams", &EmitterBeam::jams));
+    }
+};
+
+struct Emitter {
+    int name = 0x1234;
+    double x = 1.0;
+    double y = 2.0;
+    double z = 3.0;
+    std::vector<EmitterBeam> beams;
+
+    static consteval auto fields() {
+        return make_fields(make_field("name", &Emitter::name),
+                           make_field("x", &Emitter::x),
+                           make_field("y", &Emitter::y),
+                           make_field("z", &Emitter::z),
+                           make_field("beams", &Emitter::beams));
+    }
+};
+
+struct Emission {
+    int site = 1;
+    int application = 2;
+    int entity = 3;
+    std::vector<Emitter> systems;
+
+    static consteval auto fields() {
+        return make_fields(make_field("site", &Emission::site),
+                           make_field("application", &Emission::application),
+                           make_field("entity", &Emission::entity),
+                           make_field("systems", &Emission::systems));
+    }
+};
+
+// Payloads are filled in here rather than by default member initializers,
+// so the objects decoded into start out empty.
+Waveform make_waveform() {
+    Waveform w;
+    w.samples.resize(4096);
+    for (std::size_t i = 0; i < w.samples.size(); ++i) {
+        w.samples[i] = static_cast<double>(i) * 0.25 - 512.0;
+    }
+    return w;
+}
+
+Emission make_emission() {
+    EmitterBeam beam;
+    beam.jams.resize(4);
+    Emitter emitter;
+    emitter.beams.assign(4, beam);
+    Emission e;
+    e.systems.assign(4, emitter);
+    return e;
+}
+
+// Room for the largest shape in the most verbose format.
+constexpr std::size_t kBufferSize = 1 << 20;
+
+template <typename S, typename T>
+csics::Buffer<char> encode(const T& value) {
+    S s;
+    csics::Buffer<char> out(kBufferSize);
+    auto res = serialize(s, out, value);
+    out.resize(res.written_view.size());
+    return out;
+}
+
+template <typename S, typename T>
+void bench_encode(State& state, const T& value) {
+    S s;
+    csics::Buffer<char> out(kBufferSize);
+    state.set_items_per_iteration(kMessages);
+    state.set_bytes_per_iteration(kMessages * encode<S>(value).size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kMessages; ++i) {
+            auto res = serialize(s, out, value);
+            csics::bench::do_not_optimize(res);
+        }
+    }
+}
+
+template <typename S, typename D, typename T>
+void bench_decode(State& state, const T& value) {
+    const auto encoded = encode<S>(value);
+    const csics::BufferView in(encoded.data(), encoded.size());
+    state.set_items_per_iteration(kMessages);
+    state.set_bytes_per_iteration(kMessages * in.size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kMessages; ++i) {
+            D d(in);
+            T out;
+            auto res = deserialize(d, out);
+            csics::bench::do_not_optimize(res);
+        }
+    }
+}
+
+// Tagged against DirectSerializer's single copy of the whole struct, timed
+// in alternating batches so both see the same machine state. The tagged
+// time is reported; the ratio goes to stderr, out of the way of
+// --format=json output.
+template <typename T>
+void bench_tagged_overhead(State& state, const T& value) {
+    using clock = std::chrono::steady_clock;
+    TaggedSerializer tagged;
+    DirectSerializer direct;
+    csics::Buffer<char> out(kBufferSize);
+    double direct_ns = 0;
+    state.set_items_per_iteration(kMessages);
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i < kMessages; ++i) {
+            auto res = serialize(tagged, out, value);
+            csics::bench::do_not_optimize(res);
+        }
+        state.pause();
+        const auto start = clock::now();
+        for (std::size_t i = 0; i < kMessages; ++i) {
+            csics::MutableBufferView bv(out);
+            auto status = direct.write(bv, value);
+            csics::bench::do_not_optimize(status);
+            csics::bench::do_not_optimize(bv);
+        }
+        direct_ns += std::chrono::duration<double, std::nano>(clock::now() -
+                                                              start)
+                         .count();
+        state.resume();
+    }
+    std::fprintf(stderr, "tagged/direct encode time: %.2fx (%zu vs %zu B)\n",
+                 state.elapsed_ns() / direct_ns,
+                 encode<TaggedSerializer>(value).size(), sizeof(T));
+}
+
+template <typename S, typename D, typename T>
+void add_format(Registry& r, const std::string& format,
+                const std::string& shape, const T& value) {
+    const std::string n = std::to_string(kMessages);
+    r.add("serialization/encode",
+          {{"messages", n}, {"shape", shape}, {"format", format}},
+          [value](State& s) { bench_encode<S>(s, value); });
+    r.add("serialization/decode",
+          {{"messages", n}, {"shape", shape}, {"format", format}},
+          [value](State& s) { bench_decode<S, D>(s, value); });
+}
+
+template <typename T>
+void add_shape(Registry& r, const std::string& shape, const T& value) {
+    add_format<JSONSerializer, JSONDeserializer>(r, "json", shape, value);
+    add_format<CBORSerializer, CBORDeserializer>(r, "cbor", shape, value);
+    add_format<TaggedSerializer, TaggedDeserializer>(r, "tagged", shape,
+                                                     value);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    add_shape(r, "small_fields", Contact{});
+    r.add("serialization/tagged_overhead", {{"shape", "fixed_fields"}},
+          [](State& s) { bench_tagged_overhead(s, Track{}); });
+    add_shape(r, "large_array", make_waveform());
+    add_shape(r, "nested", make_emission());
+    return r.run(argc, argv);
+}
@@ -0,0 +1,500 @@
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_utils.hpp"
+#include "csics/sim/ecs/ecs.hpp"
+
+using namespace csics::sim::ecs;
+using csics::bench::Params;
+using csics::bench::Registry;
+using csics::bench::State;
+
+namespace {
+
+template <std::size_t Bytes, int Tag = 0>
+struct Payload {
+    std::array<std::uint8_t, Bytes> data{};
+};
+
+using P0 = Payload<16, 0>;
+using P1 = Payload<16, 1>;
+using P2 = Payload<16, 2>;
+using P3 = Payload<16, 3>;
+struct Unused {
+    int v;
+};
+
+template <typename Set>
+std::uint64_t storage_bytes(const Set& set) {
+    std::uint64_t bytes = 0;
+    set.visit_storage([&](const auto& buf) {
+        using T = typename std::remove_cvref_t<decltype(buf)>::value_type;
+        bytes += buf.capacity() * sizeof(T);
+    });
+    return bytes;
+}
+
+Entity make_entity(std::uint32_t id) {
+    Entity e;
+    e.id = id;
+    e.generation = 0;
+    return e;
+}
+
+template <std::size_t Bytes>
+void bench_sparse_insert(State& state, std::uint32_t n) {
+    state.set_items_per_iteration(n);
+    // the set outlives each iteration so its destructor runs while paused
+    std::optional<SparseSet<Payload<Bytes>>> set;
+    while (state.keep_running()) {
+        state.pause();
+        set.emplace();
+        state.resume();
+        for (std::uint32_t i = 0; i < n; ++i) {
+            set->insert(make_entity(i), Payload<Bytes>{});
+        }
+        state.pause();
+        state.set_bytes(storage_bytes(*set));
+        state.resume();
+    }
+}
+
+template <std::size_t Bytes>
+void bench_sparse_remove(State& state, std::uint32_t n) {
+    std::vector<std::uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    state.set_items_per_iteration(n);
+    std::optional<SparseSet<Payload<Bytes>>> set;
+    while (state.keep_running()) {
+        state.pause();
+        set.emplace();
+        for (std::uint32_t i = 0; i < n; ++i) {
+            set->insert(make_entity(i), Payload<Bytes>{});
+        }
+        state.resume();
+        for (auto id : order) {
+            set->remove(make_entity(id));
+        }
+    }
+}
+
+// Fills sets so that P0 is on every entity and the others on a `density`
+// fraction of entities.
+struct ViewFixture {
+    SparseSet<P0> s0;
+    SparseSet<P1> s1;
+    SparseSet<P2> s2;
+    SparseSet<P3> s3;
+
+    ViewFixture(std::uint32_t n, double density) {
+        std::mt19937 rng(7);
+        std::bernoulli_distribution has(density);
+        for (std::uint32_t i = 0; i < n; ++i) {
+            auto e = make_entity(i);
+            s0.insert(e, P0{});
+            if (has(rng)) s1.insert(e, P1{});
+            if (has(rng)) s2.insert(e, P2{});
+            if (has(rng)) s3.insert(e, P3{});
+        }
+    }
+};
+
+template <typename V>
+void iterate(State& state, V view) {
+    std::uint64_t rows = 0;
+    for (auto it = view.begin(); it != view.end(); ++it) {
+        ++rows;
+    }
+    state.set_items_per_iteration(rows);
+    while (state.keep_running()) {
+        std::uint64_t sum = 0;
+        for (auto&& row : view) {
+            sum += std::get<1>(row).data[0] + std::get<0>(row).id;
+        }
+        csics::bench::do_not_optimize(sum);
+    }
+}
+
+void bench_view(State& state, std::uint32_t n, int components,
+                double density) {
+    ViewFixture f(n, density);
+    switch (components) {
+        case 1:
+            iterate(state, View<P0>(f.s0));
+            break;
+        case 2:
+            iterate(state, View<P0, const P1>(f.s0, f.s1));
+            break;
+        case 3:
+            iterate(state, View<P0, const P1, const P2>(f.s0, f.s1, f.s2));
+            break;
+        default:
+            iterate(state, View<P0, const P1, const P2, const P3>(
+                               f.s0, f.s1, f.s2, f.s3));
+            break;
+    }
+    state.set_bytes(storage_bytes(f.s0) + storage_bytes(f.s1) +
+                    storage_bytes(f.s2) + storage_bytes(f.s3));
+}
+
+// A system whose view is always empty, so run() measures dispatch only.
+template <int I>
+struct EmptySystem {
+    using view_type = View<const Unused>;
+    void operator()(view_type v) const {
+        for (auto&& row : v) {
+            csics::bench::do_not_optimize(row);
+        }
+    }
+};
+
+template <int... Is>
+auto make_dispatch_world(std::integer_sequence<int, Is...>) {
+    return StaticWorldBuilder()
+        .add_layer(EmptySystem<Is>{}...)
+        .template add_component<Unused>()
+        .build();
+}
+
+template <int Systems>
+void bench_dispatch(State& state) {
+    auto world = make_dispatch_world(std::make_integer_sequence<int, Systems>{});
+    state.set_items_per_iteration(Systems);
+    while (state.keep_running()) {
+        world.run(0.01);
+    }
+}
+
+struct Spawner {
+    using view_type = View<const P0>;
+    template <typename Ctx>
+    void operator()(view_type v, double, Ctx& ctx) const {
+        for (auto&& [e, p] : v) {
+            (void)p;
+            ctx.template add_component<P1>(e);
+        }
+    }
+};
+
+struct Despawner {
+    using view_type = View<const P1>;
+    template <typename Ctx>
+    void operator()(view_type v, double, Ctx& ctx) const {
+        for (auto&& [e, p] : v) {
+            (void)p;
+            ctx.template remove_component<P1>(e);
+        }
+    }
+};
+
+// Each run() queues and applies n component adds, then n removes.
+void bench_deferred(State& state, std::uint32_t n) {
+    auto world = StaticWorldBuilder()
+                     .add_layer(Spawner{})
+                     .add_layer(Despawner{})
+                     .add_components<P0, P1>()
+                     .build();
+    for (std::uint32_t i = 0; i < n; ++i) {
+        auto e = world.add_entity();
+        world.add_component<P0>(e, P0{});
+    }
+    state.set_items_per_iteration(2ull * n);
+    while (state.keep_running()) {
+        world.run(0.01);
+    }
+}
+
+template <int... Is>
+DynamicWorld make_dynamic_dispatch_world(std::integer_sequence<int, Is...>) {
+    DynamicWorld world;
+    const auto layer = world.add_layer();
+    (world.add_system(layer, EmptySystem<Is>{}), ...);
+    return world;
+}
+
+template <int Systems>
+void bench_dynamic_dispatch(State& state) {
+    auto world =
+        make_dynamic_dispatch_world(std::make_integer_sequence<int, Systems>{});
+    state.set_items_per_iteration(Systems);
+    while (state.keep_running()) {
+        world.run(0.01);
+    }
+}
+
+void bench_dynamic_deferred(State& state, std::uint32_t n) {
+    DynamicWorld world;
+    world.register_component<P1>();
+    world.add_system(world.add_layer(), Spawner{});
+    world.add_system(world.add_layer(), Despawner{});
+    for (std::uint32_t i = 0; i < n; ++i) {
+        auto e = world.add_entity();
+        world.add_component<P0>(e, P0{});
+    }
+    state.set_items_per_iteration(2ull * n);
+    while (state.keep_running()) {
+        world.run(0.01);
+    }
+}
+
+// A full tick of one system touching two components, so the per-tick cost of
+// each world type (view construction, dispatch, context handling) shows up
+// against the same iteration work.
+struct Integrate {
+    using view_type = View<P0, const P1>;
+    void operator()(view_type v, double) const {
+        for (auto&& [e, p0, p1] : v) {
+            (void)e;
+            p0.data[0] += p1.data[0];
+        }
+    }
+};
+
+template <typename World>
+void fill_integrate(World& world, std::uint32_t n) {
+    for (std::uint32_t i = 0; i < n; ++i) {
+        auto e = world.add_entity();
+        world.template add_component<P0>(e, P0{});
+        world.template add_component<P1>(e, P1{});
+    }
+}
+
+void bench_static_tick(State& state, std::uint32_t n) {
+    auto world = StaticWorldBuilder()
+                     .add_layer(Integrate{})
+                     .add_components<P0, P1>()
+                     .build();
+    fill_integrate(world, n);
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        world.run(0.01);
+    }
+}
+
+void bench_dynamic_tick(State& state, std::uint32_t n) {
+    DynamicWorld world;
+    world.add_system(world.add_layer(), Integrate{});
+    fill_integrate(world, n);
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        world.run(0.01);
+    }
+}
+
+// Same work as Integrate, but on components registered only by name and
+// accessed through DynamicWorld::each.
+void bench_dynamic_raw_tick(State& state, std::uint32_t n) {
+    DynamicWorld world;
+    const ComponentId ids[] = {world.register_component("p0", sizeof(P0), 1),
+                               world.register_component("p1", sizeof(P1), 1)};
+    world.add_system(world.add_layer(),
+                     [&ids](DynamicWorld& w, double, DynamicWorld::Context&) {
+                         w.each(ids, [](const Entity&,
+                                        std::span<void* const> c) {
+                             static_cast<P0*>(c[0])->data[0] +=
+                                 static_cast<const P1*>(c[1])->data[0];
+                         });
+                     });
+    const P0 p0{};
+    const P1 p1{};
+    for (std::uint32_t i = 0; i < n; ++i) {
+        auto e = world.add_entity();
+        world.add_component(e, ids[0], &p0);
+        world.add_component(e, ids[1], &p1);
+    }
+    state.set_items_per_iteration(n);
+    while (state.keep_running()) {
+        world.run(0.01);
+    }
+}
+
+#ifdef CSICS_BUILD_LVC
+// One update per entity, encoded on the wire as received from the network,
+// in entity order or shuffled.
+struct EntityStateStream {
+    csics::Buffer<char> storage;
+    std::vector<csics::BufferView> pdus;
+
+    EntityStateStream(std::uint32_t n, bool shuffled) {
+        using namespace csics::lvc::dis;
+        csics::serialization::DirectSerializer s;
+        storage = csics::Buffer<char>(std::size_t{n} * 256);
+        std::size_t offset = 0;
+        for (std::uint32_t i = 0; i < n; ++i) {
+            EntityStatePDU pdu{};
+            pdu.entity_id = EntityID(1, static_cast<std::uint16_t>(i >> 16),
+                                     static_cast<std::uint16_t>(i));
+            pdu.entity_location = WorldCoordinates(i, 0.0, 0.0);
+            pdu.entity_linear_velocity = Vector(1.0f, 0.0f, 0.0f);
+            csics::MutableBufferView out(storage.data() + offset, 256);
+            auto size =
+                csics::serialization::serialize(s, out, pdu).written_view.size();
+            pdus.emplace_back(storage.data() + offset, size);
+            offset += size;
+        }
+        if (shuffled) {
+            std::mt19937 rng(42);
+            std::shuffle(pdus.begin(), pdus.end(), rng);
+        }
+    }
+};
+
+auto make_dis_world() {
+    using namespace csics::lvc::dis;
+    return StaticWorldBuilder()
+        .add_layer(Integrate{})
+        .add_components<WorldCoordinates, EulerAngles, Vector>()
+        .build();
+}
+
+// Baseline: decode each PDU in full, then one add_component per field.
+// Both ingest benches create the entities in an untimed first pass, so
+// the timed passes are updates to known entities.
+void bench_dis_ingest_single(State& state, std::uint32_t n, bool shuffled) {
+    using namespace csics::lvc::dis;
+    EntityStateStream stream(n, shuffled);
+    auto world = make_dis_world();
+    std::unordered_map<std::uint64_t, Entity> entities;
+    state.set_items_per_iteration(n);
+    auto pass = [&] {
+        for (auto bv : stream.pdus) {
+            csics::serialization::DirectDeserializer d(bv);
+            auto pdu = deserialize_direct(
+                d, csics::serialization::detail::type_tag<EntityStatePDU>{});
+            if (!pdu) {
+                continue;
+            }
+            auto [it, inserted] = entities.try_emplace(pdu->entity_id.packed());
+            if (inserted) {
+                it->second = world.add_entity();
+            }
+            world.add_component(it->second, pdu->entity_location);
+            world.add_component(it->second, pdu->entity_orientation);
+            world.add_component(it->second, pdu->entity_linear_velocity);
+        }
+    };
+    pass();
+    while (state.keep_running()) {
+        pass();
+    }
+}
+
+void bench_dis_ingest_batch(State& state, std::uint32_t n, bool shuffled,
+                            std::size_t batch) {
+    EntityStateStream stream(n, shuffled);
+    auto world = make_dis_world();
+    EntityStateIngest<> ingest;
+    const std::span<const csics::BufferView> pdus(stream.pdus);
+    state.set_items_per_iteration(n);
+    auto pass = [&] {
+        for (std::size_t i = 0; i < pdus.size(); i += batch) {
+            auto stats = ingest.ingest(
+                world, pdus.subspan(i, std::min(batch, pdus.size() - i)));
+            csics::bench::do_not_optimize(stats);
+        }
+    };
+    pass();
+    while (state.keep_running()) {
+        pass();
+    }
+}
+#endif
+
+std::string str(double v) {
+    auto s = std::to_string(v);
+    s.erase(s.find_last_not_of('0') + 1);
+    if (s.back() == '.') s.pop_back();
+    return s;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto& r = Registry::instance();
+    const std::uint32_t counts[] = {1000, 10000, 100000, 1000000};
+
+    for (auto n : counts) {
+        const std::string ns = std::to_string(n);
+        r.add("sparse_set/insert", {{"entities", ns}, {"component_bytes", "8"}},
+              [n](State& s) { bench_sparse_insert<8>(s, n); });
+        r.add("sparse_set/insert", {{"entities", ns}, {"component_bytes", "64"}},
+              [n](State& s) { bench_sparse_insert<64>(s, n); });
+        r.add("sparse_set/insert", {{"entities", ns}, {"component_bytes", "256"}},
+              [n](State& s) { bench_sparse_insert<256>(s, n); });
+        r.add("sparse_set/remove", {{"entities", ns}, {"component_bytes", "64"}},
+              [n](State& s) { bench_sparse_remove<64>(s, n); });
+    }
+
+    for (auto n : counts) {
+        for (int c = 1; c <= 4; ++c) {
+            for (double density : {1.0, 0.5, 0.1}) {
+                r.add("view/iterate",
+                      {{"entities", std::to_string(n)},
+                       {"components", std::to_string(c)},
+                       {"density", str(density)}},
+                      [=](State& s) { bench_view(s, n, c, density); });
+            }
+        }
+    }
+
+    r.add("world/run_dispatch", {{"systems", "1"}}, bench_dispatch<1>);
+    r.add("world/run_dispatch", {{"systems", "4"}}, bench_dispatch<4>);
+    r.add("world/run_dispatch", {{"systems", "16"}}, bench_dispatch<16>);
+
+    // deferred application looks entities up linearly, keep the sizes sane
+    for (std::uint32_t n : {100u, 1000u, 10000u}) {
+        r.add("world/deferred_commands", {{"entities", std::to_string(n)}},
+              [n](State& s) { bench_deferred(s, n); });
+    }
+
+    r.add("dynamic_world/run_dispatch", {{"systems", "1"}},
+          bench_dynamic_dispatch<1>);
+    r.add("dynamic_world/run_dispatch", {{"systems", "4"}},
+          bench_dynamic_dispatch<4>);
+    r.add("dynamic_world/run_dispatch", {{"systems", "16"}},
+          bench_dynamic_dispatch<16>);
+
+    for (std::uint32_t n : {100u, 1000u, 10000u}) {
+        r.add("dynamic_world/deferred_commands",
+              {{"entities", std::to_string(n)}},
+              [n](State& s) { bench_dynamic_deferred(s, n); });
+    }
+
+    for (std::uint32_t n : {1000u, 100000u}) {
+        const std::string ns = std::to_string(n);
+        r.add("world/tick", {{"entities", ns}},
+              [n](State& s) { bench_static_tick(s, n); });
+        r.add("dynamic_world/tick", {{"entities", ns}, {"components", "typed"}},
+              [n](State& s) { bench_dynamic_tick(s, n); });
+        r.add("dynamic_world/tick", {{"entities", ns}, {"components", "raw"}},
+              [n](State& s) { bench_dynamic_raw_tick(s, n); });
+    }
+
+#ifdef CSICS_BUILD_LVC
+    for (std::uint32_t n : {1000u, 100000u, 1000000u}) {
+        const std::string ns = std::to_string(n);
+        for (bool shuffled : {false, true}) {
+            const std::string order = shuffled ? "shuffled" : "sequential";
+            r.add("dis_ingest/single", {{"entities", ns}, {"order", order}},
+                  [n, shuffled](State& s) {
+                      bench_dis_ingest_single(s, n, shuffled);
+                  });
+            r.add("dis_ingest/batch",
+                  {{"entities", ns}, {"order", order}, {"batch", "256"}},
+                  [n, shuffled](State& s) {
+                      bench_dis_ingest_batch(s, n, shuffled, 256);
+                  });
+        }
+    }
+#endif
+
+    return r.run(argc, argv);
+}
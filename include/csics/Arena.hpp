@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace csics {
+
+// Monotonic bump allocator. Allocation moves a pointer, deallocation does
+// nothing, and reset() frees everything at once in O(1). Chunks are kept
+// across resets, so once a workload has been seen, repeating it makes no
+// calls into the global heap.
+//
+// Typical use is one arena per receive batch: PDUs and containers decoded
+// from the batch allocate from it, and it is reset once they are dropped.
+// Nothing allocated from the arena may be used after reset().
+//
+//   Arena arena;
+//   for (auto datagram : batch) {
+//       serialization::DirectDeserializer d(datagram, &arena);
+//       ...
+//   }
+//   arena.reset();
+//
+// Not thread safe.
+class Arena final : public std::pmr::memory_resource {
+   public:
+    explicit Arena(std::size_t chunk_size = 64 * 1024)
+        : chunk_size_(chunk_size < kMinChunk ? kMinChunk : chunk_size) {}
+
+    ~Arena() override {
+        Chunk* c = head_;
+        while (c != nullptr) {
+            Chunk* next = c->next;
+            ::operator delete(c, sizeof(Chunk) + c->size,
+                              std::align_val_t{alignof(Chunk)});
+            c = next;
+        }
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Makes all memory available again, keeping the chunks.
+    void reset() noexcept {
+        current_ = head_;
+        if (current_ != nullptr) {
+            p_ = current_->data();
+            end_ = p_ + current_->size;
+        }
+        used_ = 0;
+    }
+
+    // Bytes handed out since the last reset, including alignment padding.
+    std::size_t used() const noexcept { return used_; }
+    // Bytes held in chunks.
+    std::size_t capacity() const noexcept { return capacity_; }
+
+   protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        char* p = align(p_, alignment);
+        if (p == nullptr || bytes > static_cast<std::size_t>(end_ - p)) {
+            next_chunk(bytes + alignment);
+            p = align(p_, alignment);
+        }
+        used_ += static_cast<std::size_t>(p + bytes - p_);
+        p_ = p + bytes;
+        return p;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+   private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        std::size_t size;
+
+        char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    static constexpr std::size_t kMinChunk = 256;
+
+    std::size_t chunk_size_;
+    Chunk* head_ = nullptr;
+    Chunk* current_ = nullptr;
+    char* p_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t used_ = 0;
+    std::size_t capacity_ = 0;
+
+    static char* align(char* p, std::size_t alignment) noexcept {
+        if (p == nullptr) {
+            return nullptr;
+        }
+        const auto v = reinterpret_cast<std::uintptr_t>(p);
+        return p + ((alignment - v % alignment) % alignment);
+    }
+
+    // Moves to the next chunk with room for `bytes`, reusing chunks kept
+    // from before the last reset and allocating one only when none fits.
+    void next_chunk(std::size_t bytes) {
+        Chunk* prev = current_;
+        Chunk* c = current_ != nullptr ? current_->next : head_;
+        while (c != nullptr && c->size < bytes) {
+            prev = c;
+            c = c->next;
+        }
+        if (c == nullptr) {
+            // grow geometrically so a large batch settles on a few chunks
+            std::size_t size = capacity_ > chunk_size_ ? capacity_ : chunk_size_;
+            if (size < bytes) {
+                size = bytes;
+            }
+            c = static_cast<Chunk*>(::operator new(
+                sizeof(Chunk) + size, std::align_val_t{alignof(Chunk)}));
+            c->next = nullptr;
+            c->size = size;
+            capacity_ += size;
+            if (prev == nullptr) {
+                head_ = c;
+            } else {
+                prev->next = c;
+            }
+        }
+        // space left in the chunks passed over is lost until reset()
+        used_ += static_cast<std::size_t>(end_ - p_);
+        current_ = c;
+        p_ = c->data();
+        end_ = p_ + c->size;
+    }
+};
+
+};  // namespace csics
@@ -3,6 +3,7 @@
 
 #include <bit>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 namespace csics {
 namespace detail {
@@ -165,6 +166,46 @@ using le = endian<T, std::endian::little>;
 template <typename T>
 using ne = endian<T, std::endian::big>;  // network endian is big endian
 
+// Reads a big-endian T from possibly unaligned memory.
+template <EndianType T>
+inline T load_big(const void* p) noexcept {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) > 1) {
+        v = byteswap(v);
+    }
+    return v;
+}
+
+// Writes `v` big-endian to possibly unaligned memory.
+template <EndianType T>
+inline void store_big(void* p, T v) noexcept {
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) > 1) {
+        v = byteswap(v);
+    }
+    std::memcpy(p, &v, sizeof(T));
+}
+
+// Reads a little-endian T from possibly unaligned memory.
+template <EndianType T>
+inline T load_little(const void* p) noexcept {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+        v = byteswap(v);
+    }
+    return v;
+}
+
+// Writes `v` little-endian to possibly unaligned memory.
+template <EndianType T>
+inline void store_little(void* p, T v) noexcept {
+    if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+        v = byteswap(v);
+    }
+    std::memcpy(p, &v, sizeof(T));
+}
+
 template <typename T>
 struct is_endian_wrapper : std::false_type {};
 
@@ -9,6 +9,7 @@
 #include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <memory_resource>
 #include <mutex>
 #include <span>
 #include <stdexcept>
@@ -244,6 +245,10 @@ class BasicBufferView {
     constexpr BasicBufferView(U* data, std::size_t size) noexcept
         : buf_(reinterpret_cast<T*>(data)), size_(size) {}
 
+    constexpr BasicBufferView(T* data, std::size_t size) noexcept
+        requires(!IsByteType<T>)
+        : buf_(data), size_(size) {}
+
     // constexpr BasicBufferView(std::vector<T>& vec) noexcept
     //     : buf_(reinterpret_cast<T*>(vec.data())), size_(vec.size()) {}
 
@@ -337,16 +342,20 @@ class Buffer {
 
     constexpr Buffer() : capacity_(0), size_(0), buf_(nullptr) {}
 
+    // An empty buffer whose storage comes from `resource`, e.g. an Arena,
+    // which must outlive it. Moves carry the resource along; copies
+    // allocate from the global heap.
+    explicit Buffer(std::pmr::memory_resource& resource)
+        : resource_(&resource), capacity_(0), size_(0), buf_(nullptr) {}
+
     Buffer(std::size_t size)
         : capacity_(adjust_capacity(size)),
           size_(size),
-          buf_(static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                              std::align_val_t{Alignment}))) {}
+          buf_(allocate(capacity_)) {}
     constexpr Buffer(std::size_t size, const T& value)
         : capacity_(adjust_capacity(size)),
           size_(size),
-          buf_(static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                              std::align_val_t{Alignment}))) {
+          buf_(allocate(capacity_)) {
         if constexpr (!std::is_trivially_copyable_v<T>) {
             std::uninitialized_fill_n(buf_, size_, value);
         } else {
@@ -358,8 +367,7 @@ class Buffer {
     Buffer(const T* data, std::size_t size)
         : capacity_(adjust_capacity(size)),
           size_(size),
-          buf_(static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                              std::align_val_t{Alignment}))) {
+          buf_(allocate(capacity_)) {
         if constexpr (!std::is_trivially_copyable_v<T>) {
             std::uninitialized_copy(data, data + size_, buf_);
         } else {
@@ -370,8 +378,7 @@ class Buffer {
     Buffer(std::initializer_list<T> init)
         : capacity_(adjust_capacity(init.size())),
           size_(init.size()),
-          buf_(static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                              std::align_val_t{Alignment}))) {
+          buf_(allocate(capacity_)) {
         if constexpr (!std::is_trivially_copyable_v<T>) {
             std::uninitialized_copy(init.begin(), init.end(), buf_);
         } else {
@@ -383,15 +390,14 @@ class Buffer {
         if constexpr (!std::is_trivially_destructible_v<T>) {
             std::destroy_n(buf_, size_);
         }
-        operator delete(buf_, std::align_val_t{Alignment});
+        deallocate(buf_, capacity_);
     }
 
     template <size_t A = Alignment, CapacityPolicy P = Policy>
     Buffer(const Buffer<T, A, P>& other)
         : size_(other.size_),
           capacity_(adjust_capacity(other.size_)),
-          buf_(static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                              std::align_val_t{Alignment}))) {
+          buf_(allocate(capacity_)) {
         if constexpr (!std::is_trivially_copyable_v<T>) {
             std::uninitialized_copy(other.buf_, other.buf_ + size_, buf_);
         } else {
@@ -408,8 +414,7 @@ class Buffer {
         }
         size_ = other.size_;
         capacity_ = adjust_capacity(size_);
-        buf_ = static_cast<T*>(
-            ::operator new(capacity_ * sizeof(T), std::align_val_t{Alignment}));
+        buf_ = allocate(capacity_);
         if constexpr (!std::is_trivially_copyable_v<T>) {
             std::uninitialized_copy(other.buf_, other.buf_ + size_, buf_);
         } else {
@@ -423,22 +428,19 @@ class Buffer {
         if constexpr (A != Alignment || P.kind != Policy.kind) {
             capacity_ = adjust_capacity(other.size_);
 
-            buf_ = static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                                  std::align_val_t{Alignment}));
+            buf_ = allocate(capacity_);
             if constexpr (!std::is_trivially_copyable_v<T>) {
                 std::uninitialized_move(other.buf_, other.buf_ + size_, buf_);
             } else {
                 std::memcpy(buf_, other.buf_, size_ * sizeof(T));
             }
         } else {
-            if constexpr (!std::is_trivially_copyable_v<T>) {
-                buf_ = static_cast<T*>(::operator new(
-                    capacity_ * sizeof(T), std::align_val_t{Alignment}));
-                std::uninitialized_move(other.buf_, other.buf_ + size_, buf_);
-            } else {
-                buf_ = other.buf_;
-                other.buf_ = nullptr;
-            }
+            // same layout: take over the storage and the resource it came from
+            resource_ = other.resource_;
+            buf_ = other.buf_;
+            other.buf_ = nullptr;
+            other.size_ = 0;
+            other.capacity_ = 0;
         }
     }
 
@@ -506,30 +508,27 @@ class Buffer {
         return buf_[size_ - 1];
     }
 
-    Buffer(Buffer&& other) noexcept {
-        size_ = other.size_;
-        capacity_ = other.capacity_;
-        if constexpr (!std::is_trivially_copyable_v<T>) {
-            buf_ = static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                                  std::align_val_t{Alignment}));
-            std::uninitialized_move(other.buf_, other.buf_ + size_, buf_);
-        } else {
-            buf_ = other.buf_;
-            other.buf_ = nullptr;
-        }
+    // Takes over other's storage and memory resource, leaving it empty.
+    Buffer(Buffer&& other) noexcept
+        : resource_(other.resource_),
+          capacity_(other.capacity_),
+          size_(other.size_),
+          buf_(other.buf_) {
+        other.buf_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
     }
 
     template <size_t A = Alignment, CapacityPolicy P = Policy>
     Buffer& operator=(const Buffer<T, A, P>& other) {
-        if (this != &other) {
+        if (static_cast<const void*>(this) != &other) {
             if constexpr (!std::is_trivially_destructible_v<T>) {
                 std::destroy_n(buf_, size_);
             }
-            operator delete(buf_, std::align_val_t{Alignment});
+            deallocate(buf_, capacity_);
             size_ = other.size_;
             capacity_ = adjust_capacity(size_);
-            buf_ = static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                                  std::align_val_t{Alignment}));
+            buf_ = allocate(capacity_);
             if constexpr (!std::is_trivially_copyable_v<T>) {
                 std::uninitialized_copy(other.buf_, other.buf_ + size_, buf_);
             } else {
@@ -544,11 +543,10 @@ class Buffer {
             if constexpr (!std::is_trivially_destructible_v<T>) {
                 std::destroy_n(buf_, size_);
             }
-            operator delete(buf_, std::align_val_t{Alignment});
+            deallocate(buf_, capacity_);
             size_ = other.size_;
             capacity_ = adjust_capacity(size_);
-            buf_ = static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                                  std::align_val_t{Alignment}));
+            buf_ = allocate(capacity_);
             if constexpr (!std::is_trivially_copyable_v<T>) {
                 std::uninitialized_copy(other.buf_, other.buf_ + size_, buf_);
             } else {
@@ -560,34 +558,31 @@ class Buffer {
 
     template <size_t A = Alignment, CapacityPolicy P = Policy>
     Buffer& operator=(Buffer<T, A, P>&& other) noexcept {
-        if (this == &other) {
+        if (static_cast<const void*>(this) == &other) {
             return *this;
         }
 
         if constexpr (!std::is_trivially_destructible_v<T>) {
             std::destroy_n(buf_, size_);
         }
-        operator delete(buf_, std::align_val_t{Alignment});
+        deallocate(buf_, capacity_);
         size_ = other.size_;
 
         if constexpr (A != Alignment || P.kind != Policy.kind) {
             capacity_ = adjust_capacity(other.size_);
-            buf_ = static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                                  std::align_val_t{Alignment}));
+            buf_ = allocate(capacity_);
             if constexpr (!std::is_trivially_copyable_v<T>) {
                 std::uninitialized_move(other.buf_, other.buf_ + size_, buf_);
             } else {
                 std::memcpy(buf_, other.buf_, size_ * sizeof(T));
             }
         } else {
-            if constexpr (!std::is_trivially_copyable_v<T>) {
-                buf_ = static_cast<T*>(::operator new(
-                    capacity_ * sizeof(T), std::align_val_t{Alignment}));
-                std::uninitialized_move(other.buf_, other.buf_ + size_, buf_);
-            } else {
-                buf_ = other.buf_;
-                other.buf_ = nullptr;
-            }
+            resource_ = other.resource_;
+            capacity_ = other.capacity_;
+            buf_ = other.buf_;
+            other.buf_ = nullptr;
+            other.size_ = 0;
+            other.capacity_ = 0;
         }
         return *this;
     }
@@ -600,17 +595,14 @@ class Buffer {
         if constexpr (!std::is_trivially_destructible_v<T>) {
             std::destroy_n(buf_, size_);
         }
-        operator delete(buf_, std::align_val_t{Alignment});
+        deallocate(buf_, capacity_);
+        resource_ = other.resource_;
         size_ = other.size_;
         capacity_ = other.capacity_;
-        if constexpr (!std::is_trivially_copyable_v<T>) {
-            buf_ = static_cast<T*>(::operator new(capacity_ * sizeof(T),
-                                                  std::align_val_t{Alignment}));
-            std::uninitialized_move(other.buf_, other.buf_ + size_, buf_);
-        } else {
-            buf_ = other.buf_;
-            other.buf_ = nullptr;
-        }
+        buf_ = other.buf_;
+        other.buf_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
         return *this;
     }
 
@@ -622,6 +614,15 @@ class Buffer {
 
     constexpr std::size_t alignment() const noexcept { return Alignment; }
 
+    // The memory resource storage comes from, nullptr for the global heap.
+    std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+    void reserve(std::size_t capacity) {
+        if (capacity > capacity_) {
+            reallocate(capacity);
+        }
+    }
+
     constexpr bool empty() const noexcept { return size_ == 0; }
 
     constexpr T& push_back(const T& value) & {
@@ -766,6 +767,11 @@ class Buffer {
     const T* cend() const noexcept { return buf_ + size_; }
 
    private:
+    template <typename, size_t, CapacityPolicy>
+    friend class Buffer;
+
+    // nullptr for the global heap
+    std::pmr::memory_resource* resource_ = nullptr;
     std::size_t capacity_;
     std::size_t size_;
     T* buf_;
@@ -795,16 +801,34 @@ class Buffer {
         CSICS_RUNTIME_ASSERT(
             new_capacity >= size_,
             "New capacity must be greater than or equal to current size");
-        void* new_buf = ::operator new(new_capacity * sizeof(T),
-                                       std::align_val_t{Alignment});
+        T* new_buf = allocate(new_capacity);
 
-        destroy_and_copy_to(static_cast<T*>(new_buf));
+        destroy_and_copy_to(new_buf);
 
-        operator delete(buf_, std::align_val_t{Alignment});
-        buf_ = static_cast<T*>(new_buf);
+        deallocate(buf_, capacity_);
+        buf_ = new_buf;
         capacity_ = new_capacity;
     }
 
+    T* allocate(std::size_t capacity) {
+        const std::size_t bytes = capacity * sizeof(T);
+        if (resource_ != nullptr) {
+            return static_cast<T*>(resource_->allocate(bytes, Alignment));
+        }
+        return static_cast<T*>(
+            ::operator new(bytes, std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* buf, std::size_t capacity) noexcept {
+        if (resource_ != nullptr) {
+            if (buf != nullptr) {
+                resource_->deallocate(buf, capacity * sizeof(T), Alignment);
+            }
+            return;
+        }
+        ::operator delete(buf, std::align_val_t{Alignment});
+    }
+
     static constexpr std::size_t adjust_capacity(std::size_t requested_size) {
         if constexpr (Policy.kind == CapacityPolicy::Kind::Exact) {
             return requested_size;
@@ -7,6 +7,7 @@
 #include "csics/geo/Coordinates.hpp"
 #include "csics/geo/Ellipsoids.hpp"
 #include "csics/geo/Ops.hpp"
+#include "csics/geo/SpatialGrid.hpp"
 namespace csics::em {
 
 constexpr auto to_watts(auto dbm) -> double {
@@ -231,6 +232,13 @@ struct LinkBudgetBatch {
           interference_powers(size),
           sinrs(size) {}
 
+    void set(std::size_t i, const LinkBudget& budget) {
+        received_powers[i] = budget.received_power;
+        noise_floors[i] = budget.noise_floor;
+        interference_powers[i] = budget.interference_power;
+        sinrs[i] = budget.sinr;
+    }
+
     void push_back(const LinkBudget& budget) {
         received_powers.push_back(budget.received_power);
         noise_floors.push_back(budget.noise_floor);
@@ -294,33 +302,71 @@ class Link {
                                      Buffer<Rx>& rxs,
                                      executor::Executor auto&) {
         LinkBudgetBatch batch(rxs.size());
-        // This is always true for now as the batch is in development
         // TODO: implement a heuristic to determine when to batch and when to do
-        // sequentially
-        if (rxs.size() * (priority_txs.size() + interferer_txs.size()) < 0) {
-            Buffer<PropagationResult> desireds(priority_txs.size());
-            Buffer<PropagationResult> interferers(interferer_txs.size());
-
-            for (std::size_t i = 0; i < rxs.size(); ++i) {
-                auto& rx = rxs[i];
+        // sequentially; executor batch processing tbd
+        Buffer<PropagationResult> desireds(priority_txs.size());
+        Buffer<PropagationResult> interferers(interferer_txs.size());
 
-                for (std::size_t j = 0; j < priority_txs.size(); ++j) {
-                    desireds[j] = apply(channel, priority_txs[j], rx);
-                }
+        for (std::size_t i = 0; i < rxs.size(); ++i) {
+            auto& rx = rxs[i];
 
-                for (std::size_t k = 0; k < interferer_txs.size(); ++k) {
-                    interferers[k] = apply(channel, interferer_txs[k], rx);
-                }
+            for (std::size_t j = 0; j < priority_txs.size(); ++j) {
+                desireds[j] = apply(channel, priority_txs[j], rx);
+            }
 
-                LinkBudget budget =
-                    budget(channel, desireds, interferers);
-                batch.push_back(budget);
+            for (std::size_t k = 0; k < interferer_txs.size(); ++k) {
+                interferers[k] = apply(channel, interferer_txs[k], rx);
             }
-            return batch;
+
+            batch.set(i, budget(channel, desireds, interferers));
+        }
+        return batch;
+    }
+
+    // Indexes transmitters by their position in `txs` so they can be culled
+    // with the overload below.
+    template <Transmitter Tx>
+    static void index_transmitters(const Buffer<Tx>& txs,
+                                   geo::SpatialGrid& index) {
+        index.clear();
+        for (std::size_t i = 0; i < txs.size(); ++i) {
+            auto p = geo::to_geocentric(txs[i].location());
+            index.insert(static_cast<geo::SpatialGrid::id_type>(i), p.x(),
+                         p.y(), p.z());
         }
+    }
+
+    // Same as above, but interferers further than `max_range` metres from a
+    // receiver are skipped using `interferer_index` (built with
+    // index_transmitters). Desired transmitters are always evaluated.
+    template <Transmitter Tx, Receiver Rx>
+    static LinkBudgetBatch apply_and_budget(
+        ChannelModel auto channel, Buffer<Tx>& priority_txs,
+        Buffer<Tx>& interferer_txs, Buffer<Rx>& rxs,
+        const geo::SpatialGrid& interferer_index, double max_range,
+        executor::Executor auto&) {
+        LinkBudgetBatch batch(rxs.size());
+        Buffer<PropagationResult> desireds(priority_txs.size());
+        Buffer<PropagationResult> interferers;
+
+        for (std::size_t i = 0; i < rxs.size(); ++i) {
+            auto& rx = rxs[i];
 
-        // executor batch processing tbd
+            for (std::size_t j = 0; j < priority_txs.size(); ++j) {
+                desireds[j] = apply(channel, priority_txs[j], rx);
+            }
+
+            interferers.clear();
+            interferer_index.for_each_in_radius(
+                geo::to_geocentric(rx.location()), max_range,
+                [&](geo::SpatialGrid::id_type k, double) {
+                    interferers.push_back(
+                        apply(channel, interferer_txs[k], rx));
+                });
+
+            batch.set(i, budget(channel, desireds, interferers));
+        }
         return batch;
     }
 };
-};  // namespace csics::sim::em
+};  // namespace csics::em
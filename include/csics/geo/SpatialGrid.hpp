@@ -0,0 +1,373 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#include "csics/Buffer.hpp"
+#include "csics/geo/Coordinates.hpp"
+
+namespace csics::geo {
+
+// Uniform hashed grid over ECEF coordinates. Items are identified by a small
+// integer id (an entity id, an index into a transmitter buffer, ...) which is
+// used to index a sparse lookup table, so inserts, moves and removals are
+// O(1). Only occupied cells are stored.
+//
+// Pick a cell size close to the most common query radius: a radius query
+// visits ceil(2r / cell)^3 cells.
+class SpatialGrid {
+   public:
+    using id_type = std::uint32_t;
+    static constexpr id_type npos = std::numeric_limits<id_type>::max();
+
+    struct Neighbour {
+        id_type id;
+        double distance_sq;
+    };
+
+    explicit SpatialGrid(double cell_size)
+        : cell_size_(cell_size), inv_cell_size_(1.0 / cell_size) {
+        CSICS_RUNTIME_ASSERT(cell_size > 0.0, "Cell size must be positive");
+    }
+
+    template <typename E>
+    void insert(id_type id, const Geocentric<double, E>& p) {
+        insert(id, p.x(), p.y(), p.z());
+    }
+
+    // Inserts `id` or moves it if it is already present.
+    void insert(id_type id, double x, double y, double z) {
+        CSICS_RUNTIME_ASSERT(id != npos, "Invalid spatial grid id");
+        if (id >= lookup_.size()) {
+            const std::size_t old_size = lookup_.size();
+            lookup_.resize(std::max<std::size_t>(id + 1, old_size * 2));
+            std::fill(lookup_.begin() + old_size, lookup_.end(), npos);
+        }
+
+        const CellCoord cell = cell_of(x, y, z);
+        if (lookup_[id] != npos) {
+            Item& item = items_[lookup_[id]];
+            item.x = x;
+            item.y = y;
+            item.z = z;
+            if (!(item.cell == cell)) {
+                unlink(lookup_[id]);
+                link(lookup_[id], cell);
+            }
+            return;
+        }
+
+        lookup_[id] = static_cast<id_type>(items_.size());
+        items_.push_back(Item{x, y, z, id, 0, cell});
+        link(lookup_[id], cell);
+    }
+
+    void remove(id_type id) {
+        if (!contains(id)) {
+            return;
+        }
+        const id_type index = lookup_[id];
+        unlink(index);
+        const id_type last = static_cast<id_type>(items_.size() - 1);
+        if (index != last) {
+            // move the last item into the hole and patch its back references
+            items_[index] = items_[last];
+            lookup_[items_[index].id] = index;
+            cells_.find(items_[index].cell)
+                ->second.items[items_[index].cell_slot] = index;
+        }
+        items_.pop_back();
+        lookup_[id] = npos;
+    }
+
+    bool contains(id_type id) const noexcept {
+        return id < lookup_.size() && lookup_[id] != npos;
+    }
+
+    void clear() {
+        items_.clear();
+        cells_.clear();
+        std::fill(lookup_.begin(), lookup_.end(), npos);
+        bounds_valid_ = false;
+    }
+
+    // Calls f(id, x, y, z) for every item.
+    template <typename F>
+    void for_each(F&& f) const {
+        for (const auto& item : items_) {
+            f(item.id, item.x, item.y, item.z);
+        }
+    }
+
+    std::size_t size() const noexcept { return items_.size(); }
+    bool empty() const noexcept { return items_.empty(); }
+    std::size_t cell_count() const noexcept { return cells_.size(); }
+    double cell_size() const noexcept { return cell_size_; }
+
+    // Calls f(id, distance_sq) for every item within `radius` of `center`.
+    template <typename E, typename F>
+    void for_each_in_radius(const Geocentric<double, E>& center, double radius,
+                            F&& f) const {
+        const double r2 = radius * radius;
+        const double cx = center.x(), cy = center.y(), cz = center.z();
+        visit_cells(cell_of(cx - radius, cy - radius, cz - radius),
+                    cell_of(cx + radius, cy + radius, cz + radius),
+                    [&](const Cell& cell) {
+                        for (id_type index : cell.items) {
+                            const Item& item = items_[index];
+                            const double dx = item.x - cx;
+                            const double dy = item.y - cy;
+                            const double dz = item.z - cz;
+                            const double d2 = dx * dx + dy * dy + dz * dz;
+                            if (d2 <= r2) {
+                                f(item.id, d2);
+                            }
+                        }
+                    });
+    }
+
+    template <typename E>
+    void query_radius(const Geocentric<double, E>& center, double radius,
+                      Buffer<id_type>& out) const {
+        for_each_in_radius(center, radius,
+                           [&](id_type id, double) { out.push_back(id); });
+    }
+
+    // Appends every item inside the axis aligned ECEF box [lo, hi].
+    template <typename E>
+    void query_box(const Geocentric<double, E>& lo,
+                   const Geocentric<double, E>& hi,
+                   Buffer<id_type>& out) const {
+        visit_cells(cell_of(lo.x(), lo.y(), lo.z()),
+                    cell_of(hi.x(), hi.y(), hi.z()), [&](const Cell& cell) {
+                        for (id_type index : cell.items) {
+                            const Item& item = items_[index];
+                            if (item.x >= lo.x() && item.x <= hi.x() &&
+                                item.y >= lo.y() && item.y <= hi.y() &&
+                                item.z >= lo.z() && item.z <= hi.z()) {
+                                out.push_back(item.id);
+                            }
+                        }
+                    });
+    }
+
+    // Appends the k nearest items to `out`, closest first. Searches shells of
+    // cells outwards from the center and stops once no unvisited cell can
+    // hold anything closer than the current k-th neighbour. In sparse grids,
+    // once a shell would probe more cells than are occupied, the remaining
+    // occupied cells are walked directly instead.
+    template <typename E>
+    void query_knn(const Geocentric<double, E>& center, std::size_t k,
+                   Buffer<Neighbour>& out) const {
+        if (k == 0 || items_.empty()) {
+            return;
+        }
+        const std::size_t start = out.size();
+        const double cx = center.x(), cy = center.y(), cz = center.z();
+        const CellCoord c = cell_of(cx, cy, cz);
+        auto worse = [](const Neighbour& a, const Neighbour& b) {
+            return a.distance_sq < b.distance_sq;
+        };
+        auto consider = [&](const Cell& cell) {
+            for (id_type index : cell.items) {
+                const Item& item = items_[index];
+                const double dx = item.x - cx;
+                const double dy = item.y - cy;
+                const double dz = item.z - cz;
+                Neighbour n{item.id, dx * dx + dy * dy + dz * dz};
+                if (out.size() - start < k) {
+                    out.push_back(n);
+                    std::push_heap(out.begin() + start, out.end(), worse);
+                } else if (n.distance_sq < out[start].distance_sq) {
+                    std::pop_heap(out.begin() + start, out.end(), worse);
+                    out.back() = n;
+                    std::push_heap(out.begin() + start, out.end(), worse);
+                }
+            }
+        };
+
+        const std::int64_t max_ring = max_ring_from(c);
+        for (std::int64_t ring = 0; ring <= max_ring; ++ring) {
+            if (shell_size(ring) > static_cast<double>(cells_.size())) {
+                for (const auto& [coord, cell] : cells_) {
+                    if (chebyshev(c, coord) >= ring) {
+                        consider(cell);
+                    }
+                }
+                break;
+            }
+            visit_shell(c, ring, consider);
+            if (out.size() - start == k) {
+                // everything in rings > ring is at least ring * cell away
+                const double reach = static_cast<double>(ring) * cell_size_;
+                if (out[start].distance_sq <= reach * reach) {
+                    break;
+                }
+            }
+        }
+        std::sort_heap(out.begin() + start, out.end(), worse);
+    }
+
+   private:
+    struct CellCoord {
+        std::int32_t x, y, z;
+        bool operator==(const CellCoord& o) const noexcept {
+            return x == o.x && y == o.y && z == o.z;
+        }
+    };
+
+    struct CellHash {
+        std::size_t operator()(const CellCoord& c) const noexcept {
+            // large primes spread neighbouring cells across buckets
+            return static_cast<std::size_t>(
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(c.x)) *
+                 73856093ull) ^
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(c.y)) *
+                 19349663ull) ^
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(c.z)) *
+                 83492791ull));
+        }
+    };
+
+    struct Cell {
+        Buffer<id_type> items;
+    };
+
+    struct Item {
+        double x, y, z;
+        id_type id;
+        id_type cell_slot;  // position of this item in its cell's list
+        CellCoord cell;
+    };
+
+    double cell_size_;
+    double inv_cell_size_;
+    Buffer<Item> items_;
+    Buffer<id_type> lookup_;
+    // conservative bounds of every cell ever occupied since the last clear()
+    CellCoord lo_{}, hi_{};
+    bool bounds_valid_ = false;
+    std::unordered_map<CellCoord, Cell, CellHash> cells_;
+
+    CellCoord cell_of(double x, double y, double z) const noexcept {
+        return CellCoord{to_cell(x), to_cell(y), to_cell(z)};
+    }
+
+    std::int32_t to_cell(double v) const noexcept {
+        // clamp so oversized query boxes cannot overflow the cell index
+        constexpr double lo = std::numeric_limits<std::int32_t>::min() / 2;
+        constexpr double hi = std::numeric_limits<std::int32_t>::max() / 2;
+        return static_cast<std::int32_t>(
+            std::clamp(std::floor(v * inv_cell_size_), lo, hi));
+    }
+
+    void link(id_type index, CellCoord cell) {
+        auto& list = cells_[cell].items;
+        items_[index].cell = cell;
+        items_[index].cell_slot = static_cast<id_type>(list.size());
+        list.push_back(index);
+        if (!bounds_valid_) {
+            lo_ = hi_ = cell;
+            bounds_valid_ = true;
+        } else {
+            lo_ = {std::min(lo_.x, cell.x), std::min(lo_.y, cell.y),
+                   std::min(lo_.z, cell.z)};
+            hi_ = {std::max(hi_.x, cell.x), std::max(hi_.y, cell.y),
+                   std::max(hi_.z, cell.z)};
+        }
+    }
+
+    void unlink(id_type index) {
+        const Item& item = items_[index];
+        auto it = cells_.find(item.cell);
+        auto& list = it->second.items;
+        const id_type moved = list.back();
+        list[item.cell_slot] = moved;
+        items_[moved].cell_slot = item.cell_slot;
+        list.pop_back();
+        if (list.empty()) {
+            cells_.erase(it);
+        }
+    }
+
+    // Visits all occupied cells in [lo, hi]. Falls back to walking the
+    // occupied cells when the box covers more cells than exist.
+    template <typename F>
+    void visit_cells(CellCoord lo, CellCoord hi, F&& f) const {
+        auto extent = [](std::int32_t a, std::int32_t b) {
+            return static_cast<double>(std::int64_t{b} - a + 1);
+        };
+        const double span =
+            extent(lo.x, hi.x) * extent(lo.y, hi.y) * extent(lo.z, hi.z);
+        if (span > static_cast<double>(cells_.size())) {
+            for (const auto& [coord, cell] : cells_) {
+                if (coord.x >= lo.x && coord.x <= hi.x && coord.y >= lo.y &&
+                    coord.y <= hi.y && coord.z >= lo.z && coord.z <= hi.z) {
+                    f(cell);
+                }
+            }
+            return;
+        }
+        for (std::int32_t x = lo.x; x <= hi.x; ++x) {
+            for (std::int32_t y = lo.y; y <= hi.y; ++y) {
+                for (std::int32_t z = lo.z; z <= hi.z; ++z) {
+                    auto it = cells_.find(CellCoord{x, y, z});
+                    if (it != cells_.end()) {
+                        f(it->second);
+                    }
+                }
+            }
+        }
+    }
+
+    // Visits the occupied cells at Chebyshev distance exactly `ring` from c.
+    template <typename F>
+    void visit_shell(CellCoord c, std::int64_t ring, F&& f) const {
+        const auto r = static_cast<std::int32_t>(ring);
+        for (std::int32_t x = c.x - r; x <= c.x + r; ++x) {
+            for (std::int32_t y = c.y - r; y <= c.y + r; ++y) {
+                const bool x_or_y_edge = x == c.x - r || x == c.x + r ||
+                                         y == c.y - r || y == c.y + r;
+                // inner columns only touch the shell at their two ends
+                const std::int32_t step = x_or_y_edge || r == 0 ? 1 : 2 * r;
+                for (std::int32_t z = c.z - r; z <= c.z + r; z += step) {
+                    auto it = cells_.find(CellCoord{x, y, z});
+                    if (it != cells_.end()) {
+                        f(it->second);
+                    }
+                }
+            }
+        }
+    }
+
+    // Number of cells at Chebyshev distance exactly `ring`.
+    static double shell_size(std::int64_t ring) noexcept {
+        if (ring == 0) {
+            return 1.0;
+        }
+        const double outer = static_cast<double>(2 * ring + 1);
+        const double inner = static_cast<double>(2 * ring - 1);
+        return outer * outer * outer - inner * inner * inner;
+    }
+
+    static std::int64_t chebyshev(CellCoord a, CellCoord b) noexcept {
+        auto d = [](std::int32_t u, std::int32_t v) {
+            return std::abs(std::int64_t{u} - v);
+        };
+        return std::max({d(a.x, b.x), d(a.y, b.y), d(a.z, b.z)});
+    }
+
+    // Largest ring that can still contain an occupied cell.
+    std::int64_t max_ring_from(CellCoord c) const noexcept {
+        auto reach = [](std::int32_t lo, std::int32_t hi, std::int32_t v) {
+            return std::max(std::int64_t{hi} - v, std::int64_t{v} - lo);
+        };
+        return std::max({std::int64_t{0}, reach(lo_.x, hi_.x, c.x),
+                         reach(lo_.y, hi_.y, c.y), reach(lo_.z, hi_.z, c.z)});
+    }
+};
+
+};  // namespace csics::geo
@@ -4,3 +4,4 @@
 #include "csics/geo/Ellipsoids.hpp"
 #include "csics/geo/Coordinates.hpp"
 #include "csics/geo/Ops.hpp"
+#include "csics/geo/SpatialGrid.hpp"
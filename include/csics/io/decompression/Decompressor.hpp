@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+
+#include "csics/Buffer.hpp"
+#include "csics/io/compression/Compressor.hpp"
+
+namespace csics::io::decompression {
+using compression::CompressionStatus;
+using compression::CompressorType;
+
+struct DecompressionResult {
+    std::size_t
+        decompressed;  // How many bytes were put into the output buffer
+    std::size_t
+        input_consumed;  // How many bytes were consumed from the input buffer
+    CompressionStatus status;
+};
+
+class IDecompressor {
+   public:
+    virtual ~IDecompressor() = default;
+    virtual DecompressionResult decompress_partial(BufferView in,
+                                                   MutableBufferView out) = 0;
+    // Decompresses one whole frame. Returns InputBufferFinished once the
+    // frame ends, OutputBufferFull if `out` is too small for it and
+    // NeedsInput if `in` stops short of the end of the frame.
+    virtual DecompressionResult decompress_buffer(BufferView in,
+                                                  MutableBufferView out) = 0;
+    // Drops any partially decoded frame.
+    virtual void reset() = 0;
+
+    static std::unique_ptr<IDecompressor> create(CompressorType type);
+};
+
+};  // namespace csics::io::decompression
@@ -0,0 +1,2 @@
+#pragma once
+#include "csics/io/decompression/Decompressor.hpp"
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "csics/Buffer.hpp"
+
+namespace csics::io::file {
+
+enum class FileStatus : std::uint8_t {
+    Ok,
+    NotFound,
+    Error,
+};
+
+// A whole file mapped read-only into memory. The view stays valid until the
+// file is closed, moved from or destroyed.
+class MappedFile {
+   public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    FileStatus open(const std::string& path);
+    void close();
+
+    bool is_open() const noexcept;
+    BufferView view() const noexcept;
+    std::size_t size() const noexcept { return view().size(); }
+
+    // Hints that the mapping will be read front to back.
+    void advise_sequential() const noexcept;
+
+   private:
+    struct Internal;
+    Internal* internal_;
+};
+
+};  // namespace csics::io::file
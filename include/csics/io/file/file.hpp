@@ -0,0 +1,2 @@
+#pragma once
+#include "csics/io/file/MappedFile.hpp"
@@ -20,6 +20,28 @@ struct NetResult {
     std::size_t bytes_transferred;
 };
 
+// Result of a multi-datagram operation: how many datagrams went through and
+// their total size. On error, the datagrams after `messages` were not sent.
+struct NetBatchResult {
+    NetStatus status;
+    std::size_t messages;
+    std::size_t bytes_transferred;
+};
+
+// How a batched receive waits for datagrams.
+enum class RecvMode {
+    // Takes only what is already queued.
+    NonBlocking,
+    // Blocks for the first datagram, then takes what else is queued
+    // (MSG_WAITFORONE).
+    WaitForOne,
+    // Blocks until every buffer is filled.
+    WaitForAll,
+};
+
+// Most chunks a single send_gather call takes.
+constexpr std::size_t max_gather_chunks = 64;
+
 using Port = uint16_t;
 
 class IPAddress {
@@ -96,6 +118,9 @@ class SockAddr {
         return SockAddr(IPAddress::localhost(), port);
     }
 
+    constexpr const IPAddress& address() const noexcept { return address_; }
+    constexpr Port port() const noexcept { return port_; }
+
     void to_native(void* native_addr, std::size_t& addr_len) const;
     static std::optional<SockAddr> from_native(const void* native_addr,
                                               std::size_t addr_len);
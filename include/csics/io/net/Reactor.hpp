@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "csics/Buffer.hpp"
+#include "csics/io/net/NetTypes.hpp"
+#include "csics/queue/SPSCMessageQueue.hpp"
+
+namespace csics::io::net {
+class TCPEndpoint;
+class UDPEndpoint;
+
+enum class ReactorBackend { IoUring, Epoll };
+
+struct ReactorConfig {
+    // Receive buffers in the pool, rounded up to a power of two; at most
+    // 32768.
+    std::size_t buffer_count = 1024;
+    // Size of each receive buffer. A UDP buffer also holds the sender
+    // address, so the largest datagram is slightly smaller than this.
+    std::size_t buffer_size = 2048;
+    // Completions the queue holds before run_once starts dropping them,
+    // rounded up to a power of two.
+    std::size_t completion_capacity = 4096;
+    // Submission queue entries for io_uring.
+    std::size_t ring_entries = 256;
+    // Use epoll even where io_uring is available.
+    bool force_epoll = false;
+};
+
+// A datagram, or a chunk of a stream, received by a Reactor.
+struct Completion {
+    static constexpr std::uint16_t no_buffer = 0xFFFF;
+
+    std::uint32_t endpoint;  // id from Reactor::add
+    // Success when data arrived, Disconnected when a stream peer closed,
+    // Error when the endpoint failed and was removed.
+    NetStatus status;
+    // Pool buffer holding the data, or no_buffer. Hand it back with
+    // Reactor::release once the data is no longer needed.
+    std::uint16_t buffer;
+    std::uint32_t offset;  // where the data starts in the buffer
+    std::uint32_t size;
+    SockAddr source;  // sender of a datagram
+};
+
+// Serves the receive side of many endpoints from one thread. Received data
+// lands directly in a pool of reactor-owned buffers and is reported through
+// a single-producer single-consumer queue of Completions, so one thread can
+// run the reactor while another consumes.
+//
+// On Linux the reactor uses io_uring with a provided buffer ring and
+// multishot receives, so a busy socket costs no system call per datagram;
+// where io_uring is unavailable it falls back to epoll and recvmmsg.
+//
+//   Reactor reactor;
+//   auto id = reactor.add(udp);
+//   // reactor thread
+//   while (running) reactor.run_once(100);
+//   // consumer thread
+//   Completion c;
+//   while (reactor.completions().try_pop(c) == queue::SPSCError::None) {
+//       handle(reactor.data(c));
+//       reactor.release(c);
+//   }
+//
+// add, remove and run_once belong to the reactor thread; completions() and
+// release to the consumer thread, which may be the same one. Endpoints must
+// stay open until they are removed or the reactor is destroyed.
+class Reactor {
+   public:
+    explicit Reactor(ReactorConfig config = {});
+    ~Reactor();
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+    Reactor(Reactor&& other) noexcept;
+    Reactor& operator=(Reactor&& other) noexcept;
+
+    ReactorBackend backend() const noexcept;
+
+    // Starts receiving on a bound or connected endpoint, returning the id
+    // its completions carry, or nullopt on failure.
+    std::optional<std::uint32_t> add(UDPEndpoint& endpoint);
+    std::optional<std::uint32_t> add(TCPEndpoint& endpoint);
+    // Stops receiving on an endpoint. Completions already queued for it
+    // are still delivered.
+    NetStatus remove(std::uint32_t endpoint);
+
+    // Waits up to timeout_ms for data, queueing a Completion for each
+    // datagram or stream chunk received. Returns how many were queued.
+    std::size_t run_once(int timeout_ms);
+
+    queue::SPSCMessageQueue<Completion>& completions() noexcept;
+    BufferView data(const Completion& completion) const noexcept;
+    // Returns a completion's buffer to the pool.
+    void release(const Completion& completion);
+
+    // Completions dropped because the queue was full.
+    std::size_t dropped() const noexcept;
+
+   private:
+    struct Internal;
+    Internal* internal_;
+
+    std::optional<std::uint32_t> add_(int fd, bool datagram);
+};
+};  // namespace csics::io::net
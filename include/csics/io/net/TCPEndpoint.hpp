@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include "csics/Buffer.hpp"
 #include "csics/io/net/NetTypes.hpp"
 
@@ -16,6 +18,10 @@ class TCPEndpoint {
     TCPEndpoint& operator=(TCPEndpoint&& other) noexcept;
 
     NetResult send(BufferView data);
+    // Writes the chunks, in order, with one system call (sendmsg). As with
+    // send, fewer bytes than the chunks hold may be written. At most
+    // max_gather_chunks chunks.
+    NetResult send_gather(std::span<const BufferView> chunks);
     NetResult recv(BufferView buffer);
     template <typename T>
         requires std::is_convertible_v<T, SockAddr>
@@ -25,6 +31,9 @@ class TCPEndpoint {
 
     PollStatus poll(int timeoutMs);
 
+    // The underlying socket, or -1 before bind or connect.
+    int native_handle() const noexcept;
+
    private:
     struct Internal;
     Internal* internal_;
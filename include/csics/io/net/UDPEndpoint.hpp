@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <span>
+
 #include "csics/Buffer.hpp"
 #include "csics/io/net/NetTypes.hpp"
 namespace csics::io::net {
@@ -15,8 +18,43 @@ class UDPEndpoint {
     UDPEndpoint& operator=(UDPEndpoint&& other) noexcept;
 
     NetResult send(BufferView data, const SockAddr& dest);
+    // Sends each view as its own datagram, with as few system calls as the
+    // platform allows (sendmmsg on Linux).
+    NetBatchResult send_batch(std::span<const BufferView> datagrams,
+                              const SockAddr& dest);
+    // As above, sending datagrams[i] to dests[i]. The spans must be the
+    // same length.
+    NetBatchResult send_batch(std::span<const BufferView> datagrams,
+                              std::span<const SockAddr> dests);
+    // Sends the chunks, in order, as one datagram (sendmsg), so a message
+    // gathered from several buffers needs no staging copy. At most
+    // max_gather_chunks chunks.
+    NetResult send_gather(std::span<const BufferView> chunks,
+                          const SockAddr& dest);
     NetStatus bind(const Port port);
     NetResult recv(MutableBufferView buffer, SockAddr& src);
+    // Receives up to buffers.size() datagrams with as few system calls as
+    // the platform allows (recvmmsg on Linux). Datagram i lands in
+    // buffers[i], its length in sizes[i] and, when sources is not empty,
+    // its sender in sources[i]; sizes and a non-empty sources must be at
+    // least as long as buffers. A datagram longer than its buffer is
+    // truncated. Returns NetStatus::Empty when mode does not block and
+    // nothing was queued.
+    NetBatchResult recv_batch(std::span<MutableBufferView> buffers,
+                              std::span<SockAddr> sources,
+                              std::span<std::size_t> sizes,
+                              RecvMode mode = RecvMode::WaitForOne);
+    // As above, also filling timestamps[i] with the time the kernel
+    // received datagram i, as nanoseconds since the Unix epoch, or zero
+    // when enable_timestamps has not been called.
+    NetBatchResult recv_batch(std::span<MutableBufferView> buffers,
+                              std::span<SockAddr> sources,
+                              std::span<std::size_t> sizes,
+                              std::span<std::chrono::nanoseconds> timestamps,
+                              RecvMode mode = RecvMode::WaitForOne);
+    // Asks the kernel to timestamp received datagrams (SO_TIMESTAMPNS).
+    // Call after bind or connect.
+    NetStatus enable_timestamps();
     template <typename T>
         requires std::is_convertible_v<T, SockAddr>
     NetStatus connect(T&& addr) {
@@ -25,6 +63,9 @@ class UDPEndpoint {
 
     PollStatus poll(int timeout_ms);
 
+    // The underlying socket, or -1 before bind or connect.
+    int native_handle() const noexcept;
+
    private:
     struct Internal;
     Internal* internal_;
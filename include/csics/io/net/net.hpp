@@ -1,5 +1,6 @@
 #pragma once
 #include "csics/io/net/NetTypes.hpp"
+#include "csics/io/net/Reactor.hpp"
 #include "csics/io/net/TCPEndpoint.hpp"
 #include "csics/io/net/UDPEndpoint.hpp"
 #include "csics/io/net/MQTTEndpoint.hpp"
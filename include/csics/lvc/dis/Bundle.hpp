@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "csics/Bit.hpp"
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/FixedLayout.hpp"
+#include "csics/lvc/dis/Layout.hpp"
+#include "csics/lvc/dis/serde.hpp"
+#include "csics/serialization/serialization.hpp"
+
+namespace csics::lvc::dis {
+
+// PDUs in a bundle each start on a 64 bit boundary (IEEE 1278.1-2012
+// 5.3.2); the header length does not include the padding.
+constexpr std::size_t bundle_alignment = 8;
+
+constexpr std::size_t bundle_padded(std::size_t n) noexcept {
+    return (n + bundle_alignment - 1) & ~(bundle_alignment - 1);
+}
+
+struct BundlerConfig {
+    // Largest datagram payload: an Ethernet MTU less the IPv4 and UDP
+    // headers.
+    std::size_t max_datagram = 1472;
+    // Datagrams held before a flush is forced; one flush is one call to
+    // the sink, so one sendmmsg.
+    std::size_t max_datagrams = 64;
+    // Longest a PDU may wait for company before poll() flushes it.
+    std::chrono::microseconds max_latency{1000};
+    // Pack several PDUs per datagram. Without it every PDU gets its own
+    // datagram and only the system calls are batched, for receivers that
+    // predate DIS 7 bundling.
+    bool bundle = true;
+};
+
+struct BundlerStats {
+    std::size_t pdus = 0;
+    std::size_t datagrams = 0;
+    std::size_t flushes = 0;
+    std::size_t dropped = 0;  // datagrams the sink did not accept
+};
+
+// Outbound PDU bundler. PDUs are serialized straight into the datagram
+// buffer through the usual serialize_wire overloads and handed to a sink
+// in batches: flush(sink) calls sink(std::span<const BufferView>) once
+// with every pending datagram, and the sink returns how many it sent, as
+// in
+//
+//   bundler.add(pdu, [&](std::span<const BufferView> d) {
+//       return udp.send_batch(d, dest).messages;
+//   });
+//
+// add() flushes by itself when the datagram buffer is full; call poll()
+// from the send loop to keep to max_latency when traffic is light.
+template <serialization::WireSerializer S = FixedLayoutSerializer,
+          typename Clock = std::chrono::steady_clock>
+class PDUBundler {
+   public:
+    PDUBundler() : PDUBundler(BundlerConfig{}) {}
+    // max_datagrams is raised to 1 if it is 0, so there is always a
+    // datagram to write into.
+    explicit PDUBundler(const BundlerConfig& config)
+        : config_(sanitized(config)),
+          storage_(config_.max_datagram * config_.max_datagrams),
+          datagrams_() {}
+
+    const BundlerConfig& config() const noexcept { return config_; }
+    const BundlerStats& stats() const noexcept { return stats_; }
+
+    // PDUs and datagrams waiting for a flush.
+    std::size_t pending_pdus() const noexcept { return pending_pdus_; }
+    std::size_t pending_datagrams() const noexcept {
+        return datagrams_.size();
+    }
+
+    // Serializes `pdu` into the open datagram, or a new one if it does not
+    // fit, flushing through `sink` first if every datagram is taken.
+    // Returns BufferFull, and sends nothing, for a PDU larger than
+    // max_datagram.
+    template <typename PDU, typename Sink>
+    serialization::SerializationStatus add(const PDU& pdu, Sink&& sink) {
+        const std::size_t size = pdu_size_calc(pdu);
+        if (size > config_.max_datagram) {
+            return serialization::SerializationStatus::BufferFull;
+        }
+        std::size_t offset = datagrams_.empty()
+                                 ? config_.max_datagram
+                                 : bundle_padded(datagrams_.back().size());
+        if (!config_.bundle || offset + size > config_.max_datagram) {
+            if (datagrams_.size() == config_.max_datagrams) {
+                flush(sink);
+            }
+            if (datagrams_.empty()) {
+                oldest_ = Clock::now();
+            }
+            datagrams_.push_back(BufferView(slot(datagrams_.size()), 0));
+            offset = 0;
+        }
+
+        auto& dgram = datagrams_.back();
+        char* base = const_cast<char*>(dgram.data());
+        // zero the alignment padding left by the previous PDU
+        for (std::size_t i = dgram.size(); i < offset; ++i) {
+            base[i] = 0;
+        }
+        auto res = serialization::serialize(
+            serializer_, MutableBufferView(base + offset, size), pdu);
+        if (res.status != serialization::SerializationStatus::Ok) {
+            if (offset == 0) {
+                datagrams_.pop_back();
+            }
+            return res.status;
+        }
+        dgram = BufferView(base, offset + res.written_view.size());
+        ++pending_pdus_;
+        ++stats_.pdus;
+        return serialization::SerializationStatus::Ok;
+    }
+
+    // Hands every pending datagram to `sink` in one call. Returns how many
+    // it reported sent.
+    template <typename Sink>
+    std::size_t flush(Sink&& sink) {
+        if (datagrams_.empty()) {
+            return 0;
+        }
+        const std::size_t n = datagrams_.size();
+        const std::size_t sent = static_cast<std::size_t>(
+            sink(std::span<const BufferView>(datagrams_.data(), n)));
+        stats_.datagrams += sent;
+        stats_.dropped += n - std::min(sent, n);
+        ++stats_.flushes;
+        datagrams_.clear();
+        pending_pdus_ = 0;
+        return sent;
+    }
+
+    // Flushes if the oldest pending datagram has waited max_latency.
+    template <typename Sink>
+    std::size_t poll(Sink&& sink) {
+        if (datagrams_.empty() ||
+            Clock::now() - oldest_ < config_.max_latency) {
+            return 0;
+        }
+        return flush(sink);
+    }
+
+   private:
+    BundlerConfig config_;
+    S serializer_;
+    Buffer<char> storage_;
+    Buffer<BufferView> datagrams_;
+    std::size_t pending_pdus_ = 0;
+    typename Clock::time_point oldest_{};
+    BundlerStats stats_;
+
+    static BundlerConfig sanitized(BundlerConfig config) noexcept {
+        config.max_datagrams = std::max<std::size_t>(config.max_datagrams, 1);
+        return config;
+    }
+
+    char* slot(std::size_t i) noexcept {
+        return storage_.data() + i * config_.max_datagram;
+    }
+};
+
+// Calls f(BufferView) for each PDU in a received datagram, which holds one
+// PDU or a DIS 7 bundle. Stops at the first header that is truncated or
+// declares more bytes than remain; returns how many PDUs were visited.
+template <typename F>
+std::size_t for_each_bundled_pdu(BufferView datagram, F&& f) {
+    std::size_t count = 0;
+    std::size_t offset = 0;
+    while (datagram.size() - offset >= layout::header::size) {
+        const std::size_t length = load_big<std::uint16_t>(
+            datagram.data() + offset + layout::header::length);
+        if (length < layout::header::size ||
+            length > datagram.size() - offset) {
+            break;
+        }
+        f(BufferView(datagram.data() + offset, length));
+        ++count;
+        offset += bundle_padded(length);
+        if (offset >= datagram.size()) {
+            break;
+        }
+    }
+    return count;
+}
+
+}  // namespace csics::lvc::dis
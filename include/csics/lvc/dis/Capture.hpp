@@ -0,0 +1,830 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "csics/Bit.hpp"
+#include "csics/Buffer.hpp"
+#include "csics/io/file/MappedFile.hpp"
+#include "csics/lvc/dis/Bundle.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#ifdef CSICS_USE_ZSTD
+#include "csics/io/compression/Compressor.hpp"
+#include "csics/io/decompression/Decompressor.hpp"
+#endif
+
+// Capture logs of raw DIS traffic. A log is a file header, a run of chunks
+// and, once the recorder is closed, an index of the chunks and a trailer
+// pointing at it. Each chunk carries its time range and the PDU types in it
+// so a reader can seek and filter without touching the records, and is
+// optionally zstd compressed on its own. Every field is big endian.
+//
+//   file header   magic "CSICSDIS", version, flags, start (ns, UTC)
+//   chunk         header (see capture::chunk_header), then the records
+//   record        time (ns since start), DIS timestamp, length, PDU type,
+//                 then the PDU padded to 8 bytes
+//   index         "INDX", count, then per chunk its offset and header
+//   trailer       index offset, magic "CSICSEND"
+//
+// A log that was never closed has no index; the reader rebuilds it from
+// the chunk headers, losing only the chunk that was being written.
+namespace csics::lvc::dis {
+
+enum class CaptureStatus : std::uint8_t {
+    Ok,
+    NotOpen,
+    IOError,
+    InvalidPDU,
+    BadFile,
+    Unsupported,  // compression without CSICS_USE_ZSTD
+};
+
+// A set of PDU types, one bit per type.
+class PDUTypeSet {
+   public:
+    constexpr PDUTypeSet() = default;
+    constexpr PDUTypeSet(std::initializer_list<PDUType> types) {
+        for (auto t : types) {
+            insert(t);
+        }
+    }
+
+    static constexpr PDUTypeSet all() noexcept {
+        PDUTypeSet s;
+        for (auto& w : s.words_) {
+            w = ~std::uint64_t{0};
+        }
+        return s;
+    }
+
+    constexpr void insert(PDUType t) noexcept {
+        const auto i = static_cast<std::uint8_t>(t);
+        words_[i >> 6] |= std::uint64_t{1} << (i & 63);
+    }
+    constexpr bool contains(PDUType t) const noexcept {
+        const auto i = static_cast<std::uint8_t>(t);
+        return (words_[i >> 6] >> (i & 63)) & 1;
+    }
+    constexpr bool intersects(const PDUTypeSet& other) const noexcept {
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            if (words_[i] & other.words_[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+    constexpr bool empty() const noexcept {
+        return !intersects(all());
+    }
+
+    constexpr std::uint64_t word(std::size_t i) const noexcept {
+        return words_[i];
+    }
+    constexpr void word(std::size_t i, std::uint64_t w) noexcept {
+        words_[i] = w;
+    }
+    static constexpr std::size_t words = 4;
+
+   private:
+    std::array<std::uint64_t, words> words_{};
+};
+
+namespace capture {
+constexpr std::array<char, 8> file_magic = {'C', 'S', 'I', 'C',
+                                            'S', 'D', 'I', 'S'};
+constexpr std::array<char, 8> end_magic = {'C', 'S', 'I', 'C',
+                                           'S', 'E', 'N', 'D'};
+constexpr std::uint32_t chunk_magic = 0x43484E4B;  // "CHNK"
+constexpr std::uint32_t index_magic = 0x494E4458;  // "INDX"
+constexpr std::uint16_t version = 1;
+
+constexpr std::uint16_t file_compressed = 0x1;
+constexpr std::uint32_t chunk_compressed = 0x1;
+
+namespace file_header {
+constexpr std::size_t magic = 0;
+constexpr std::size_t version = 8;
+constexpr std::size_t flags = 10;
+constexpr std::size_t start = 16;
+constexpr std::size_t size = 24;
+}  // namespace file_header
+
+namespace chunk_header {
+constexpr std::size_t magic = 0;
+constexpr std::size_t flags = 4;
+constexpr std::size_t raw_size = 8;
+constexpr std::size_t stored_size = 12;
+constexpr std::size_t records = 16;
+constexpr std::size_t first = 24;
+constexpr std::size_t last = 32;
+constexpr std::size_t types = 40;
+constexpr std::size_t size = types + PDUTypeSet::words * 8;
+}  // namespace chunk_header
+
+namespace record {
+constexpr std::size_t time = 0;
+constexpr std::size_t timestamp = 8;
+constexpr std::size_t length = 12;
+constexpr std::size_t pdu_type = 14;
+constexpr std::size_t size = 16;
+}  // namespace record
+
+namespace index {
+constexpr std::size_t magic = 0;
+constexpr std::size_t count = 8;
+constexpr std::size_t entries = 16;
+constexpr std::size_t entry_size = 8 + chunk_header::size;
+}  // namespace index
+
+namespace trailer {
+constexpr std::size_t index_offset = 0;
+constexpr std::size_t magic = 8;
+constexpr std::size_t size = 16;
+}  // namespace trailer
+
+constexpr std::size_t record_alignment = 8;
+
+constexpr std::size_t record_size(std::size_t pdu_length) noexcept {
+    return record::size + ((pdu_length + record_alignment - 1) &
+                           ~(record_alignment - 1));
+}
+}  // namespace capture
+
+// One chunk of a log, as listed in its index.
+struct CaptureChunk {
+    std::uint64_t offset = 0;  // of the chunk header in the file
+    std::uint32_t raw_size = 0;
+    std::uint32_t stored_size = 0;
+    std::uint32_t records = 0;
+    bool compressed = false;
+    std::chrono::nanoseconds first{};
+    std::chrono::nanoseconds last{};
+    PDUTypeSet types;
+};
+
+// A PDU read back from a log. `pdu` points into the mapped file, or into
+// the reader's scratch buffer for compressed chunks, and is only valid
+// during the callback.
+struct CaptureRecord {
+    std::chrono::nanoseconds time;  // since the start of the capture
+    DISTimestamp timestamp;
+    PDUType type;
+    BufferView pdu;
+};
+
+struct CaptureConfig {
+    // Raw bytes of records gathered before a chunk is written out.
+    std::size_t chunk_size = 1 << 20;
+    // zstd compress each chunk, keeping it raw when that does not help.
+    bool compress = false;
+};
+
+struct CaptureStats {
+    std::size_t records = 0;
+    std::size_t chunks = 0;
+    std::size_t raw_bytes = 0;
+    std::size_t written_bytes = 0;
+};
+
+namespace detail {
+inline void store_chunk_header(char* p, const CaptureChunk& c) noexcept {
+    namespace ch = capture::chunk_header;
+    store_big<std::uint32_t>(p + ch::magic, capture::chunk_magic);
+    store_big<std::uint32_t>(p + ch::flags,
+                             c.compressed ? capture::chunk_compressed : 0);
+    store_big<std::uint32_t>(p + ch::raw_size, c.raw_size);
+    store_big<std::uint32_t>(p + ch::stored_size, c.stored_size);
+    store_big<std::uint32_t>(p + ch::records, c.records);
+    store_big<std::uint32_t>(p + ch::records + 4, 0);
+    store_big<std::int64_t>(p + ch::first, c.first.count());
+    store_big<std::int64_t>(p + ch::last, c.last.count());
+    for (std::size_t i = 0; i < PDUTypeSet::words; ++i) {
+        store_big<std::uint64_t>(p + ch::types + i * 8, c.types.word(i));
+    }
+}
+
+inline bool load_chunk_header(const char* p, CaptureChunk& c) noexcept {
+    namespace ch = capture::chunk_header;
+    if (load_big<std::uint32_t>(p + ch::magic) != capture::chunk_magic) {
+        return false;
+    }
+    c.compressed =
+        load_big<std::uint32_t>(p + ch::flags) & capture::chunk_compressed;
+    c.raw_size = load_big<std::uint32_t>(p + ch::raw_size);
+    c.stored_size = load_big<std::uint32_t>(p + ch::stored_size);
+    c.records = load_big<std::uint32_t>(p + ch::records);
+    c.first = std::chrono::nanoseconds(load_big<std::int64_t>(p + ch::first));
+    c.last = std::chrono::nanoseconds(load_big<std::int64_t>(p + ch::last));
+    for (std::size_t i = 0; i < PDUTypeSet::words; ++i) {
+        c.types.word(i, load_big<std::uint64_t>(p + ch::types + i * 8));
+    }
+    return c.compressed || c.raw_size == c.stored_size;
+}
+}  // namespace detail
+
+// Appends PDUs to a capture log. Records are gathered in memory and written
+// a chunk at a time, so record() is a copy in the common case; close() (or
+// the destructor) writes the last chunk and the index.
+class DISRecorder {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    DISRecorder() : DISRecorder(CaptureConfig{}) {}
+    explicit DISRecorder(const CaptureConfig& config) : config_(config) {}
+    ~DISRecorder() { close(); }
+    DISRecorder(const DISRecorder&) = delete;
+    DISRecorder& operator=(const DISRecorder&) = delete;
+
+    const CaptureConfig& config() const noexcept { return config_; }
+    const CaptureStats& stats() const noexcept { return stats_; }
+    bool is_open() const noexcept { return out_.is_open(); }
+
+    // Creates (or truncates) the log at `path`. Record times are measured
+    // from here.
+    CaptureStatus open(const std::string& path) {
+        close();
+#ifndef CSICS_USE_ZSTD
+        if (config_.compress) {
+            return CaptureStatus::Unsupported;
+        }
+#else
+        if (config_.compress) {
+            compressor_ = io::compression::ICompressor::create(
+                io::compression::CompressorType::ZSTD);
+            packed_.resize(config_.chunk_size + max_record +
+                           (config_.chunk_size + max_record) / 128 + 4096);
+        }
+#endif
+        out_.open(path, std::ios::binary | std::ios::trunc);
+        if (!out_) {
+            return CaptureStatus::IOError;
+        }
+        started_ = clock::now();
+        const auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch());
+
+        namespace fh = capture::file_header;
+        std::array<char, fh::size> header{};
+        std::memcpy(header.data() + fh::magic, capture::file_magic.data(),
+                    capture::file_magic.size());
+        store_big<std::uint16_t>(header.data() + fh::version,
+                                 capture::version);
+        store_big<std::uint16_t>(
+            header.data() + fh::flags,
+            config_.compress ? capture::file_compressed : 0);
+        store_big<std::int64_t>(header.data() + fh::start, wall.count());
+        out_.write(header.data(), header.size());
+
+        chunk_.resize(config_.chunk_size + max_record);
+        used_ = 0;
+        offset_ = fh::size;
+        last_ = std::chrono::nanoseconds(0);
+        open_chunk_ = CaptureChunk{};
+        index_.clear();
+        stats_ = CaptureStats{};
+        return out_ ? CaptureStatus::Ok : CaptureStatus::IOError;
+    }
+
+    // Records one PDU, timed now.
+    CaptureStatus record(BufferView pdu) {
+        return record(pdu, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               clock::now() - started_));
+    }
+
+    // Records one PDU at `at` since open(). Times never run backwards in a
+    // log: an earlier time is recorded as the latest one seen.
+    CaptureStatus record(BufferView pdu, std::chrono::nanoseconds at) {
+        if (!is_open()) {
+            return CaptureStatus::NotOpen;
+        }
+        PDUHeaderView header(pdu);
+        if (!header.valid() || header.length() < layout::header::size) {
+            return CaptureStatus::InvalidPDU;
+        }
+        const std::size_t length = header.length();
+        const std::size_t size = capture::record_size(length);
+        if (used_ != 0 && used_ + size > config_.chunk_size) {
+            if (auto s = flush(); s != CaptureStatus::Ok) {
+                return s;
+            }
+        }
+        at = std::max(at, last_);
+        last_ = at;
+
+        namespace rl = capture::record;
+        char* p = chunk_.data() + used_;
+        store_big<std::int64_t>(p + rl::time, at.count());
+        store_big<std::uint32_t>(p + rl::timestamp, header.timestamp().raw());
+        store_big<std::uint16_t>(p + rl::length,
+                                 static_cast<std::uint16_t>(length));
+        p[rl::pdu_type] = static_cast<char>(header.pdu_type());
+        p[rl::pdu_type + 1] = 0;
+        std::memcpy(p + rl::size, pdu.data(), length);
+        std::memset(p + rl::size + length, 0, size - rl::size - length);
+        used_ += size;
+
+        if (open_chunk_.records == 0) {
+            open_chunk_.first = at;
+        }
+        open_chunk_.last = at;
+        open_chunk_.types.insert(header.pdu_type());
+        ++open_chunk_.records;
+        ++stats_.records;
+        stats_.raw_bytes += size;
+        return CaptureStatus::Ok;
+    }
+
+    // Records every PDU in a received datagram, bundled or not.
+    CaptureStatus record_datagram(BufferView datagram,
+                                  std::chrono::nanoseconds at) {
+        CaptureStatus status = CaptureStatus::Ok;
+        const std::size_t n =
+            for_each_bundled_pdu(datagram, [&](BufferView pdu) {
+                if (status == CaptureStatus::Ok) {
+                    status = record(pdu, at);
+                }
+            });
+        return n == 0 ? CaptureStatus::InvalidPDU : status;
+    }
+    CaptureStatus record_datagram(BufferView datagram) {
+        return record_datagram(
+            datagram, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          clock::now() - started_));
+    }
+
+    // Writes out the open chunk. Records flushed here survive a crash.
+    CaptureStatus flush() {
+        if (!is_open()) {
+            return CaptureStatus::NotOpen;
+        }
+        if (used_ == 0) {
+            return CaptureStatus::Ok;
+        }
+        BufferView stored(chunk_.data(), used_);
+        open_chunk_.compressed = false;
+#ifdef CSICS_USE_ZSTD
+        if (compressor_) {
+            auto res = compressor_->finish(stored, packed_);
+            if (res.status ==
+                io::compression::CompressionStatus::InputBufferFinished) {
+                if (res.compressed < used_) {
+                    stored = BufferView(packed_.data(), res.compressed);
+                    open_chunk_.compressed = true;
+                }
+            } else {
+                // the frame was left half written; start the next afresh
+                compressor_ = io::compression::ICompressor::create(
+                    io::compression::CompressorType::ZSTD);
+            }
+        }
+#endif
+        open_chunk_.offset = offset_;
+        open_chunk_.raw_size = static_cast<std::uint32_t>(used_);
+        open_chunk_.stored_size = static_cast<std::uint32_t>(stored.size());
+
+        std::array<char, capture::chunk_header::size> header;
+        detail::store_chunk_header(header.data(), open_chunk_);
+        out_.write(header.data(), header.size());
+        out_.write(stored.data(), stored.size());
+        out_.flush();
+        if (!out_) {
+            return CaptureStatus::IOError;
+        }
+        offset_ += header.size() + stored.size();
+        index_.push_back(open_chunk_);
+        ++stats_.chunks;
+        stats_.written_bytes += header.size() + stored.size();
+        used_ = 0;
+        open_chunk_ = CaptureChunk{};
+        return CaptureStatus::Ok;
+    }
+
+    // Writes the last chunk, the index and the trailer.
+    CaptureStatus close() {
+        if (!is_open()) {
+            return CaptureStatus::NotOpen;
+        }
+        CaptureStatus status = flush();
+        if (status == CaptureStatus::Ok) {
+            namespace ix = capture::index;
+            std::array<char, ix::entries> head{};
+            store_big<std::uint32_t>(head.data() + ix::magic,
+                                     capture::index_magic);
+            store_big<std::uint64_t>(head.data() + ix::count, index_.size());
+            out_.write(head.data(), head.size());
+            std::array<char, ix::entry_size> entry;
+            for (const auto& c : index_) {
+                store_big<std::uint64_t>(entry.data(), c.offset);
+                detail::store_chunk_header(entry.data() + 8, c);
+                out_.write(entry.data(), entry.size());
+            }
+            std::array<char, capture::trailer::size> trailer;
+            store_big<std::uint64_t>(
+                trailer.data() + capture::trailer::index_offset, offset_);
+            std::memcpy(trailer.data() + capture::trailer::magic,
+                        capture::end_magic.data(), capture::end_magic.size());
+            out_.write(trailer.data(), trailer.size());
+            if (!out_) {
+                status = CaptureStatus::IOError;
+            }
+        }
+        out_.close();
+        return status;
+    }
+
+   private:
+    // The largest PDU a DIS header can declare, as a record.
+    static constexpr std::size_t max_record = capture::record_size(0xFFFF);
+
+    CaptureConfig config_;
+    std::ofstream out_;
+    Buffer<char> chunk_;
+    std::size_t used_ = 0;
+    std::uint64_t offset_ = 0;
+    CaptureChunk open_chunk_;
+    Buffer<CaptureChunk> index_;
+    clock::time_point started_{};
+    std::chrono::nanoseconds last_{};
+    CaptureStats stats_;
+#ifdef CSICS_USE_ZSTD
+    std::unique_ptr<io::compression::ICompressor> compressor_;
+    Buffer<char> packed_;
+#endif
+};
+
+// A capture log mapped for reading. Uncompressed chunks are read in place;
+// compressed ones are inflated a chunk at a time into a scratch buffer.
+class DISLog {
+   public:
+    CaptureStatus open(const std::string& path) {
+        close();
+        if (file_.open(path) != io::file::FileStatus::Ok) {
+            return CaptureStatus::IOError;
+        }
+        BufferView bv = file_.view();
+        namespace fh = capture::file_header;
+        if (bv.size() < fh::size ||
+            std::memcmp(bv.data() + fh::magic, capture::file_magic.data(),
+                        capture::file_magic.size()) != 0 ||
+            load_big<std::uint16_t>(bv.data() + fh::version) !=
+                capture::version) {
+            close();
+            return CaptureStatus::BadFile;
+        }
+        start_ = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(
+                    load_big<std::int64_t>(bv.data() + fh::start))));
+        if (!read_index()) {
+            recovered_ = true;
+            scan_chunks();
+        }
+        for (const auto& c : chunks_) {
+            records_ += c.records;
+#ifndef CSICS_USE_ZSTD
+            if (c.compressed) {
+                close();
+                return CaptureStatus::Unsupported;
+            }
+#endif
+        }
+        file_.advise_sequential();
+        return CaptureStatus::Ok;
+    }
+
+    void close() {
+        file_.close();
+        chunks_.clear();
+        records_ = 0;
+        recovered_ = false;
+    }
+
+    bool is_open() const noexcept { return file_.is_open(); }
+    // True if the log was not closed and its index was rebuilt by a scan.
+    bool recovered() const noexcept { return recovered_; }
+
+    std::chrono::system_clock::time_point start() const noexcept {
+        return start_;
+    }
+    std::span<const CaptureChunk> chunks() const noexcept {
+        return std::span<const CaptureChunk>(chunks_.data(), chunks_.size());
+    }
+    std::size_t records() const noexcept { return records_; }
+    // Time of the last record.
+    std::chrono::nanoseconds duration() const noexcept {
+        return chunks_.size() == 0 ? std::chrono::nanoseconds(0)
+                                   : chunks_[chunks_.size() - 1].last;
+    }
+
+    // The first chunk that can hold a record at or after `t`.
+    std::size_t seek(std::chrono::nanoseconds t) const noexcept {
+        auto c = chunks();
+        return static_cast<std::size_t>(
+            std::partition_point(c.begin(), c.end(),
+                                 [&](const CaptureChunk& chunk) {
+                                     return chunk.last < t;
+                                 }) -
+            c.begin());
+    }
+
+    // Calls f(const CaptureRecord&) for every record in [from, to) whose
+    // type is in `types`, in order. Chunks without a wanted type, or
+    // outside the range, are skipped unread. f may return false to stop.
+    template <typename F>
+    CaptureStatus for_each(
+        F&& f, std::chrono::nanoseconds from = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds to = std::chrono::nanoseconds::max(),
+        const PDUTypeSet& types = PDUTypeSet::all()) {
+        if (!is_open()) {
+            return CaptureStatus::NotOpen;
+        }
+        for (std::size_t i = seek(from); i < chunks_.size(); ++i) {
+            const auto& chunk = chunks_[i];
+            if (chunk.first >= to) {
+                break;
+            }
+            if (!chunk.types.intersects(types)) {
+                continue;
+            }
+            BufferView payload;
+            if (auto s = load_chunk(chunk, payload); s != CaptureStatus::Ok) {
+                return s;
+            }
+            bool stop = false;
+            auto s = for_each_record(payload, [&](const CaptureRecord& r) {
+                if (r.time < from || !types.contains(r.type)) {
+                    return true;
+                }
+                if (r.time >= to) {
+                    stop = true;
+                    return false;
+                }
+                if constexpr (std::is_same_v<std::invoke_result_t<
+                                                 F&, const CaptureRecord&>,
+                                             bool>) {
+                    stop = !f(r);
+                    return !stop;
+                } else {
+                    f(r);
+                    return true;
+                }
+            });
+            if (s != CaptureStatus::Ok || stop) {
+                return s;
+            }
+        }
+        return CaptureStatus::Ok;
+    }
+
+   private:
+    io::file::MappedFile file_;
+    Buffer<CaptureChunk> chunks_;
+    std::size_t records_ = 0;
+    bool recovered_ = false;
+    std::chrono::system_clock::time_point start_{};
+#ifdef CSICS_USE_ZSTD
+    std::unique_ptr<io::decompression::IDecompressor> decompressor_;
+    Buffer<char> scratch_;
+#endif
+
+    bool chunk_fits(const CaptureChunk& c, std::size_t end) const noexcept {
+        return c.offset >= capture::file_header::size &&
+               c.offset <= end &&
+               end - c.offset >= capture::chunk_header::size + c.stored_size;
+    }
+
+    bool read_index() {
+        BufferView bv = file_.view();
+        namespace ix = capture::index;
+        namespace tr = capture::trailer;
+        if (bv.size() < capture::file_header::size + ix::entries + tr::size) {
+            return false;
+        }
+        const char* trailer = bv.data() + bv.size() - tr::size;
+        if (std::memcmp(trailer + tr::magic, capture::end_magic.data(),
+                        capture::end_magic.size()) != 0) {
+            return false;
+        }
+        const std::uint64_t at =
+            load_big<std::uint64_t>(trailer + tr::index_offset);
+        const std::size_t index_end = bv.size() - tr::size;
+        if (at < capture::file_header::size || at > index_end ||
+            index_end - at < ix::entries ||
+            load_big<std::uint32_t>(bv.data() + at + ix::magic) !=
+                capture::index_magic) {
+            return false;
+        }
+        const std::uint64_t count =
+            load_big<std::uint64_t>(bv.data() + at + ix::count);
+        if ((index_end - at - ix::entries) / ix::entry_size < count) {
+            return false;
+        }
+        const char* entry = bv.data() + at + ix::entries;
+        for (std::uint64_t i = 0; i < count; ++i, entry += ix::entry_size) {
+            CaptureChunk c;
+            c.offset = load_big<std::uint64_t>(entry);
+            if (!detail::load_chunk_header(entry + 8, c) ||
+                !chunk_fits(c, at)) {
+                chunks_.clear();
+                return false;
+            }
+            chunks_.push_back(c);
+        }
+        return true;
+    }
+
+    void scan_chunks() {
+        BufferView bv = file_.view();
+        std::size_t offset = capture::file_header::size;
+        while (bv.size() - offset >= capture::chunk_header::size) {
+            CaptureChunk c;
+            c.offset = offset;
+            if (!detail::load_chunk_header(bv.data() + offset, c) ||
+                !chunk_fits(c, bv.size())) {
+                break;
+            }
+            chunks_.push_back(c);
+            offset += capture::chunk_header::size + c.stored_size;
+        }
+    }
+
+    CaptureStatus load_chunk(const CaptureChunk& c, BufferView& payload) {
+        BufferView stored(
+            file_.view().data() + c.offset + capture::chunk_header::size,
+            c.stored_size);
+        if (!c.compressed) {
+            payload = stored;
+            return CaptureStatus::Ok;
+        }
+#ifdef CSICS_USE_ZSTD
+        if (!decompressor_) {
+            decompressor_ = io::decompression::IDecompressor::create(
+                io::compression::CompressorType::ZSTD);
+        }
+        if (scratch_.size() < c.raw_size) {
+            scratch_.resize(c.raw_size);
+        }
+        decompressor_->reset();
+        auto res = decompressor_->decompress_buffer(
+            stored, MutableBufferView(scratch_.data(), c.raw_size));
+        if (res.status !=
+                io::compression::CompressionStatus::InputBufferFinished ||
+            res.decompressed != c.raw_size) {
+            return CaptureStatus::BadFile;
+        }
+        payload = BufferView(scratch_.data(), c.raw_size);
+        return CaptureStatus::Ok;
+#else
+        return CaptureStatus::Unsupported;
+#endif
+    }
+
+    // f returns false to stop.
+    template <typename F>
+    static CaptureStatus for_each_record(BufferView payload, F&& f) {
+        namespace rl = capture::record;
+        std::size_t offset = 0;
+        while (offset < payload.size()) {
+            if (payload.size() - offset < rl::size) {
+                return CaptureStatus::BadFile;
+            }
+            const char* p = payload.data() + offset;
+            const std::size_t length = load_big<std::uint16_t>(p + rl::length);
+            const std::size_t size = capture::record_size(length);
+            if (payload.size() - offset < size) {
+                return CaptureStatus::BadFile;
+            }
+            CaptureRecord r{
+                std::chrono::nanoseconds(load_big<std::int64_t>(p + rl::time)),
+                DISTimestamp(load_big<std::uint32_t>(p + rl::timestamp)),
+                static_cast<PDUType>(p[rl::pdu_type]),
+                BufferView(p + rl::size, length)};
+            if (!f(r)) {
+                break;
+            }
+            offset += size;
+        }
+        return CaptureStatus::Ok;
+    }
+};
+
+struct ReplayConfig {
+    // Playback rate against the capture clock: 1 is real time and 10 ten
+    // times faster. Zero or less sends as fast as the sink takes them.
+    double speed = 1.0;
+    PDUTypeSet types = PDUTypeSet::all();
+};
+
+// Plays a log back through a sink, paced to the capture times. The sink is
+// sink(BufferView pdu) or sink(const CaptureRecord&), and may return false
+// to pause; either of
+//
+//   replayer.play([&](BufferView pdu) { udp.send(pdu, dest); });
+//   replayer.play([&](BufferView pdu) { dispatcher.dispatch(pdu); });
+//
+// Seeking only moves the position: play() starts from the chunk holding it
+// through the log's index.
+class DISReplayer {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    explicit DISReplayer(DISLog& log) : DISReplayer(log, ReplayConfig{}) {}
+    DISReplayer(DISLog& log, const ReplayConfig& config)
+        : log_(log), config_(config) {}
+
+    const ReplayConfig& config() const noexcept { return config_; }
+    void speed(double s) noexcept { config_.speed = s; }
+    void types(const PDUTypeSet& t) noexcept { config_.types = t; }
+
+    // Capture time play() resumes from.
+    std::chrono::nanoseconds position() const noexcept { return position_; }
+    void seek(std::chrono::nanoseconds t) noexcept {
+        position_ = t;
+        played_at_position_ = 0;
+    }
+
+    // Plays from position() up to, not including, `until`, returning once
+    // the log or the range ends or the sink asks to stop. The first PDU
+    // goes out at once and the rest at their capture offsets from it.
+    template <typename Sink>
+    CaptureStatus play(
+        Sink&& sink,
+        std::chrono::nanoseconds until = std::chrono::nanoseconds::max()) {
+        const auto origin = position_;
+        const auto base = clock::now();
+        const double speed = config_.speed;
+        std::size_t skip = played_at_position_;
+        return log_.for_each(
+            [&](const CaptureRecord& r) {
+                if (r.time == origin && skip > 0) {
+                    --skip;
+                    return true;
+                }
+                if (speed > 0) {
+                    const auto due =
+                        base + std::chrono::duration_cast<clock::duration>(
+                                   std::chrono::duration<double, std::nano>(
+                                       double((r.time - origin).count()) /
+                                       speed));
+                    if (due > clock::now()) {
+                        std::this_thread::sleep_until(due);
+                    }
+                }
+                bool go = deliver(sink, r);
+                // PDUs can share a capture time, so count those played at
+                // the position to resume after them
+                if (r.time == position_) {
+                    ++played_at_position_;
+                } else {
+                    position_ = r.time;
+                    played_at_position_ = 1;
+                }
+                ++played_;
+                return go;
+            },
+            origin, until, config_.types);
+    }
+
+    std::size_t played() const noexcept { return played_; }
+
+   private:
+    DISLog& log_;
+    ReplayConfig config_;
+    std::chrono::nanoseconds position_{};
+    std::size_t played_at_position_ = 0;
+    std::size_t played_ = 0;
+
+    template <typename Sink>
+    static bool deliver(Sink& sink, const CaptureRecord& r) {
+        if constexpr (std::is_invocable_v<Sink&, const CaptureRecord&>) {
+            return call(sink, r);
+        } else {
+            return call(sink, r.pdu);
+        }
+    }
+
+    template <typename Sink, typename Arg>
+    static bool call(Sink& sink, const Arg& arg) {
+        if constexpr (std::is_same_v<std::invoke_result_t<Sink&, const Arg&>,
+                                     bool>) {
+            return sink(arg);
+        } else {
+            sink(arg);
+            return true;
+        }
+    }
+};
+
+}  // namespace csics::lvc::dis
@@ -1,51 +1,244 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
 #include "csics/Buffer.hpp"
+#include "csics/lvc/dis/Layout.hpp"
 #include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+#include "csics/lvc/dis/serde.hpp"
 #include "csics/serialization/serialization.hpp"
 namespace csics::lvc::dis {
 
+enum class DispatchStatus : std::uint8_t {
+    Handled,
+    Filtered,   // rejected by the exercise/entity filter
+    Unhandled,  // no handler for the PDU type
+    Malformed,  // too short, or failed to decode for a typed handler
+};
+
+// Exercise and entity pre-filters, checked on the raw header before any
+// decoding. The originating entity (entity, emitter, radio, firing entity)
+// directly follows the header in every PDU type handled here. ALL_SITES,
+// ALL_APPLIC and ALL_ENTITIES act as wildcards in the entity filter.
+class DISFilter {
+   public:
+    void exercise(std::uint8_t exercise_id) noexcept {
+        exercise_ = exercise_id;
+    }
+    void any_exercise() noexcept { exercise_.reset(); }
+
+    void entity(const EntityID& id) noexcept { entity_ = id; }
+    void any_entity() noexcept { entity_.reset(); }
+
+    bool accepts(BufferView bv) const noexcept {
+        if (exercise_ && PDUHeaderView(bv).exercise_id() != *exercise_) {
+            return false;
+        }
+        if (!entity_) {
+            return true;
+        }
+        if (bv.size() < layout::header::size + layout::id::size) {
+            return false;
+        }
+        const char* p = bv.data() + layout::header::size;
+        return matches(entity_->site(), ALL_SITES, p + layout::id::site) &&
+               matches(entity_->application(), ALL_APPLIC,
+                       p + layout::id::application) &&
+               matches(entity_->id(), ALL_ENTITIES, p + layout::id::entity);
+    }
+
+   private:
+    std::optional<std::uint8_t> exercise_;
+    std::optional<EntityID> entity_;
+
+    static bool matches(std::uint16_t want, std::uint16_t wildcard,
+                        const char* p) noexcept {
+        return want == wildcard || load_big<std::uint16_t>(p) == want;
+    }
+};
+
+namespace detail {
+template <typename PDU, typename F>
+constexpr bool is_view_handler() {
+    if constexpr (requires { typename pdu_view<PDU>::type; }) {
+        return std::is_invocable_v<F, pdu_view_t<PDU>>;
+    } else {
+        return false;
+    }
+}
+
+template <typename PDU, typename F>
+constexpr bool is_pdu_handler() {
+    return is_view_handler<PDU, F>() ||
+           std::is_invocable_v<F, const PDU&> ||
+           std::is_invocable_v<F, BufferView>;
+}
+
+// Calls f with the cheapest form it accepts: a zero-copy view, the raw
+// buffer, or (allocating only for variable-length records) a decoded PDU.
+template <typename PDU, typename F>
+DispatchStatus invoke_handler(F& f, BufferView bv,
+                              std::pmr::memory_resource* resource) {
+    if constexpr (is_view_handler<PDU, F>()) {
+        pdu_view_t<PDU> view(bv);
+        if (!view.valid()) {
+            return DispatchStatus::Malformed;
+        }
+        f(view);
+    } else if constexpr (std::is_invocable_v<F, BufferView>) {
+        f(bv);
+    } else {
+        serialization::DirectDeserializer deserializer(bv, resource);
+        auto res = deserialize_direct(deserializer,
+                                      serialization::detail::type_tag<PDU>{});
+        if (!res) {
+            return DispatchStatus::Malformed;
+        }
+        f(*res);
+    }
+    return DispatchStatus::Handled;
+}
+}  // namespace detail
+
+// Handler for one PDU type, for use with StaticDISDispatcher.
+template <typename PDU, typename F>
+struct PDUHandler {
+    static constexpr std::uint8_t pdu_type =
+        static_cast<std::uint8_t>(PDU::pdu_type);
+    F func;
+
+    DispatchStatus operator()(BufferView bv,
+                              std::pmr::memory_resource* resource = nullptr) {
+        return detail::invoke_handler<PDU>(func, bv, resource);
+    }
+};
+
+template <typename PDU, typename F>
+PDUHandler<PDU, std::decay_t<F>> on(F&& func) {
+    static_assert(detail::is_pdu_handler<PDU, std::decay_t<F>>(),
+                  "Handler function must be invocable with the PDU view, "
+                  "const PDU& or BufferView");
+    return {std::forward<F>(func)};
+}
+
+// Dispatcher with the handler set fixed at compile time: the PDU type is
+// matched against each handler's type inline, with no type erasure and no
+// allocation on the dispatch path.
+//
+//   auto dispatcher = make_dis_dispatcher(
+//       on<EntityStatePDU>([](const EntityStatePDUView& v) { ... }),
+//       on<TransmitterPDU>([](const TransmitterPDU& pdu) { ... }));
+//   dispatcher.filter().exercise(1);
+//   dispatcher.dispatch(datagram);
+template <typename... Handlers>
+class StaticDISDispatcher {
+   public:
+    explicit StaticDISDispatcher(Handlers... handlers)
+        : handlers_(std::move(handlers)...) {}
+
+    DISFilter& filter() noexcept { return filter_; }
+    const DISFilter& filter() const noexcept { return filter_; }
+
+    // Containers in PDUs decoded for typed handlers allocate from
+    // `resource`, e.g. an Arena reset after each receive batch; nullptr,
+    // the default, uses the global heap.
+    void resource(std::pmr::memory_resource* resource) noexcept {
+        resource_ = resource;
+    }
+
+    DispatchStatus dispatch(BufferView bv) {
+        if (bv.size() < layout::header::size) {
+            return DispatchStatus::Malformed;
+        }
+        if (!filter_.accepts(bv)) {
+            return DispatchStatus::Filtered;
+        }
+        const auto pdu_type = static_cast<std::uint8_t>(
+            bv[layout::header::pdu_type]);
+        DispatchStatus status = DispatchStatus::Unhandled;
+        std::apply(
+            [&](auto&... h) {
+                (void)((h.pdu_type == pdu_type &&
+                        (status = h(bv, resource_), true)) ||
+                       ...);
+            },
+            handlers_);
+        return status;
+    }
+
+   private:
+    std::tuple<Handlers...> handlers_;
+    DISFilter filter_;
+    std::pmr::memory_resource* resource_ = nullptr;
+};
+
+template <typename... Handlers>
+StaticDISDispatcher<Handlers...> make_dis_dispatcher(Handlers... handlers) {
+    return StaticDISDispatcher<Handlers...>(std::move(handlers)...);
+}
+
+// Dispatcher with handlers registered at runtime. Costs one indirect call
+// per PDU; prefer StaticDISDispatcher when the handler set is known up
+// front.
 class DISDispatcher {
    public:
-    using dispatch_func = std::function<void(BufferView)>;
-    static constexpr auto no_op = [](BufferView) {};
-    DISDispatcher() { dispatch_table_.fill(no_op); }
+    using dispatch_func =
+        std::function<DispatchStatus(BufferView, std::pmr::memory_resource*)>;
+    using error_func = std::function<void(DispatchStatus, BufferView)>;
 
     template <typename PDU, typename F>
     void on(F&& func) {
-        if constexpr (std::is_invocable_v<F, BufferView>) {
-            dispatch_table_[PDU::pdu_type] = func;
-        } else if constexpr (std::is_invocable_v<F, const PDU&>) {
-            dispatch_table_[PDU::pdu_type] =
-                [f = std::forward<F>(func)](BufferView bv) {
-                    PDU pdu;
-                    serialization::DirectDeserializer deserializer(bv);
-                    auto res = serialization::deserialize(deserializer, pdu);
-                    // TODO: handle deserialization errors properly
-                    f(*res);  // no error checking for now...
-                };
-        } else {
-            static_assert(std::is_invocable_v<F, BufferView> ||
-                              std::is_invocable_v<F, const PDU&>,
-                          "Handler function must be invocable with either "
-                          "BufferView or const PDU&");
-        }
-    }
-
-    void dispatch(BufferView bv) const {
-        if (bv.size() < 2) {
-            // Not enough data to read PDU type
-            return;
+        static_assert(detail::is_pdu_handler<PDU, std::decay_t<F>>(),
+                      "Handler function must be invocable with the PDU view, "
+                      "const PDU& or BufferView");
+        dispatch_table_[PDU::pdu_type] =
+            [f = std::forward<F>(func)](
+                BufferView bv, std::pmr::memory_resource* resource) mutable {
+                return detail::invoke_handler<PDU>(f, bv, resource);
+            };
+    }
+
+    // Called for PDUs that are malformed or fail to decode.
+    void on_error(error_func func) { on_error_ = std::move(func); }
+
+    DISFilter& filter() noexcept { return filter_; }
+    const DISFilter& filter() const noexcept { return filter_; }
+
+    // See StaticDISDispatcher::resource.
+    void resource(std::pmr::memory_resource* resource) noexcept {
+        resource_ = resource;
+    }
+
+    DispatchStatus dispatch(BufferView bv) const {
+        DispatchStatus status = DispatchStatus::Malformed;
+        if (bv.size() >= layout::header::size) {
+            status = filter_.accepts(bv) ? route(bv) : DispatchStatus::Filtered;
         }
-        PDUHeaderView header(bv);
-        std::uint8_t pdu_type = static_cast<std::uint8_t>(header.pdu_type());
-        if (pdu_type < dispatch_table_.size()) {
-            dispatch_table_[pdu_type](bv);
+        if (status == DispatchStatus::Malformed && on_error_) {
+            on_error_(status, bv);
         }
+        return status;
     }
 
    private:
-    std::array<dispatch_func, 255> dispatch_table_;
+    std::array<dispatch_func, 256> dispatch_table_;
+    error_func on_error_;
+    DISFilter filter_;
+    std::pmr::memory_resource* resource_ = nullptr;
+
+    DispatchStatus route(BufferView bv) const {
+        PDUHeaderView header(bv);
+        const auto& f =
+            dispatch_table_[static_cast<std::uint8_t>(header.pdu_type())];
+        return f ? f(bv, resource_) : DispatchStatus::Unhandled;
+    }
 };
 
 };  // namespace csics::lvc::dis
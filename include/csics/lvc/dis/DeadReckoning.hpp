@@ -0,0 +1,505 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <utility>
+
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace csics::lvc::dis {
+
+// Dead reckoning algorithms (IEEE 1278.1 Annex E), as carried in the
+// dead reckoning algorithm field of the entity state PDU. The letters are
+// Fixed/Rotating orientation, Position/Velocity (first or second order in
+// position) and World/Body axes for the acceleration.
+enum class DRAlgorithm : std::uint8_t {
+    Other = 0,
+    Static = 1,
+    FPW = 2,
+    RPW = 3,
+    RVW = 4,
+    FVW = 5,
+    FPB = 6,
+    RPB = 7,
+    RVB = 8,
+    FVB = 9,
+};
+
+constexpr bool rotates(DRAlgorithm a) noexcept {
+    return a == DRAlgorithm::RPW || a == DRAlgorithm::RVW ||
+           a == DRAlgorithm::RPB || a == DRAlgorithm::RVB;
+}
+
+// What an entity state PDU says about where an entity is going. Linear
+// velocity is in world coordinates; the linear acceleration is in world
+// or body coordinates depending on the algorithm and the angular velocity
+// is always in body coordinates.
+struct DRState {
+    WorldCoordinates location{};
+    EulerAngles orientation{};
+    Vector linear_velocity{};
+    Vector linear_acceleration{};
+    Vector angular_velocity{};
+    DRAlgorithm algorithm = DRAlgorithm::Other;
+};
+
+inline DRState dr_state(const EntityStatePDU& pdu) noexcept {
+    return {pdu.entity_location,
+            pdu.entity_orientation,
+            pdu.entity_linear_velocity,
+            pdu.dr_parameters.linear_acceleration,
+            pdu.dr_parameters.angular_velocity,
+            static_cast<DRAlgorithm>(pdu.dr_parameters.algorithm)};
+}
+
+inline DRState dr_state(const EntityStatePDUView& view) noexcept {
+    return {view.location(),
+            view.orientation(),
+            view.linear_velocity(),
+            view.dr_linear_acceleration(),
+            view.dr_angular_velocity(),
+            static_cast<DRAlgorithm>(view.dr_algorithm())};
+}
+
+// When an outbound entity must be re-published: the true state has drifted
+// from what remote simulations extrapolate by more than `position` metres
+// or `orientation` radians, or `heartbeat` seconds have passed. The
+// defaults are the IEEE 1278.1 ones.
+struct DRThresholds {
+    double position = 1.0;
+    float orientation = 3.0f * std::numbers::pi_v<float> / 180.0f;
+    double heartbeat = 5.0;
+};
+
+namespace detail {
+// Row-major 3x3, for the rotation matrices of Annex E.
+using Mat3 = std::array<double, 9>;
+using Vec3d = std::array<double, 3>;
+
+inline Vec3d to_vec3d(const Vector& v) noexcept {
+    return {v.template get<0>(), v.template get<1>(), v.template get<2>()};
+}
+
+inline Vec3d mul(const Mat3& m, const Vec3d& v) noexcept {
+    return {m[0] * v[0] + m[1] * v[1] + m[2] * v[2],
+            m[3] * v[0] + m[4] * v[1] + m[5] * v[2],
+            m[6] * v[0] + m[7] * v[1] + m[8] * v[2]};
+}
+
+inline Vec3d mul_transposed(const Mat3& m, const Vec3d& v) noexcept {
+    return {m[0] * v[0] + m[3] * v[1] + m[6] * v[2],
+            m[1] * v[0] + m[4] * v[1] + m[7] * v[2],
+            m[2] * v[0] + m[5] * v[1] + m[8] * v[2]};
+}
+
+inline Mat3 mul(const Mat3& a, const Mat3& b) noexcept {
+    Mat3 r{};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r[i * 3 + j] = a[i * 3] * b[j] + a[i * 3 + 1] * b[3 + j] +
+                           a[i * 3 + 2] * b[6 + j];
+        }
+    }
+    return r;
+}
+
+// World to body rotation for psi, theta, phi (z-y-x).
+inline Mat3 world_to_body(double psi, double theta, double phi) noexcept {
+    const double cp = std::cos(psi), sp = std::sin(psi);
+    const double ct = std::cos(theta), st = std::sin(theta);
+    const double cf = std::cos(phi), sf = std::sin(phi);
+    return {ct * cp,
+            ct * sp,
+            -st,
+            sf * st * cp - cf * sp,
+            sf * st * sp + cf * cp,
+            sf * ct,
+            cf * st * cp + sf * sp,
+            cf * st * sp - sf * cp,
+            cf * ct};
+}
+
+inline EulerAngles euler(const Mat3& r) noexcept {
+    return EulerAngles(static_cast<float>(std::atan2(r[1], r[0])),
+                       static_cast<float>(std::asin(std::clamp(-r[2], -1.0, 1.0))),
+                       static_cast<float>(std::atan2(r[5], r[8])));
+}
+
+// a * w w^T + b * I + c * skew(w)
+inline Mat3 rotation_terms(const Vec3d& w, double a, double b,
+                           double c) noexcept {
+    return {a * w[0] * w[0] + b, a * w[0] * w[1] - c * w[2],
+            a * w[0] * w[2] + c * w[1], a * w[1] * w[0] + c * w[2],
+            a * w[1] * w[1] + b, a * w[1] * w[2] - c * w[0],
+            a * w[2] * w[0] - c * w[1], a * w[2] * w[1] + c * w[0],
+            a * w[2] * w[2] + b};
+}
+
+// Below this angular rate (rad/s) the closed forms lose precision and the
+// first-order limits are used instead.
+constexpr double small_rate = 1e-6;
+
+// Orientation after dt under body rate w: DR(dt) * R0.
+inline Mat3 rotate(const Mat3& r0, const Vec3d& w, double mag,
+                   double dt) noexcept {
+    if (mag < small_rate) {
+        return r0;
+    }
+    const double wt = mag * dt;
+    const double c = std::cos(wt), s = std::sin(wt);
+    return mul(rotation_terms(w, (1.0 - c) / (mag * mag), c, -s / mag), r0);
+}
+
+// Body-axis displacement after dt for body velocity vb and acceleration ab,
+// in world coordinates: R0^T (R1 vb + R2 ab).
+inline Vec3d body_displacement(const Mat3& r0, const Vec3d& w, double mag,
+                               const Vec3d& vb, const Vec3d& ab,
+                               double dt) noexcept {
+    Mat3 r1, r2;
+    if (mag < small_rate) {
+        r1 = rotation_terms(w, 0.0, dt, 0.0);
+        r2 = rotation_terms(w, 0.0, 0.5 * dt * dt, 0.0);
+    } else {
+        const double wt = mag * dt;
+        const double c = std::cos(wt), s = std::sin(wt);
+        const double m2 = mag * mag, m3 = m2 * mag;
+        r1 = rotation_terms(w, (wt - s) / m3, s / mag, (1.0 - c) / m2);
+        r2 = rotation_terms(w, (0.5 * wt * wt - c - wt * s + 1.0) / (m2 * m2),
+                            (c + wt * s - 1.0) / m2, (s - wt * c) / m3);
+    }
+    const Vec3d v = mul(r1, vb);
+    const Vec3d a = mul(r2, ab);
+    return mul_transposed(r0, {v[0] + a[0], v[1] + a[1], v[2] + a[2]});
+}
+
+inline float angle_error(float a, float b) noexcept {
+    constexpr float two_pi = 2.0f * std::numbers::pi_v<float>;
+    const float d = std::fabs(a - b);
+    return std::min(d, two_pi - d);
+}
+}  // namespace detail
+
+// Location and orientation of `s` extrapolated by dt seconds.
+inline std::pair<WorldCoordinates, EulerAngles> extrapolate(
+    const DRState& s, double dt) noexcept {
+    using detail::Vec3d;
+    const Vec3d p0 = {s.location.x(), s.location.y(), s.location.z()};
+    const Vec3d v = detail::to_vec3d(s.linear_velocity);
+    const Vec3d a = detail::to_vec3d(s.linear_acceleration);
+    const Vec3d w = detail::to_vec3d(s.angular_velocity);
+    const double mag = std::sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    const auto& o = s.orientation;
+    const auto r0 = detail::world_to_body(o.psi(), o.theta(), o.phi());
+
+    Vec3d d = {0.0, 0.0, 0.0};
+    switch (s.algorithm) {
+        case DRAlgorithm::FPW:
+        case DRAlgorithm::RPW:
+        case DRAlgorithm::FPB:
+            d = {v[0] * dt, v[1] * dt, v[2] * dt};
+            break;
+        case DRAlgorithm::RVW:
+        case DRAlgorithm::FVW:
+            for (int i = 0; i < 3; ++i) {
+                d[i] = dt * (v[i] + 0.5 * a[i] * dt);
+            }
+            break;
+        case DRAlgorithm::FVB:
+            d = detail::body_displacement(r0, w, 0.0, detail::mul(r0, v), a,
+                                          dt);
+            break;
+        case DRAlgorithm::RPB:
+            d = detail::body_displacement(r0, w, mag, detail::mul(r0, v),
+                                          {0.0, 0.0, 0.0}, dt);
+            break;
+        case DRAlgorithm::RVB:
+            d = detail::body_displacement(r0, w, mag, detail::mul(r0, v), a,
+                                          dt);
+            break;
+        default:
+            break;
+    }
+    const WorldCoordinates p(p0[0] + d[0], p0[1] + d[1], p0[2] + d[2]);
+    if (!rotates(s.algorithm)) {
+        return {p, o};
+    }
+    return {p, detail::euler(detail::rotate(r0, w, mag, dt))};
+}
+
+// Location and orientation columns, one element per entity.
+struct KinematicColumns {
+    Buffer<double, 32> x, y, z;
+    Buffer<float, 32> psi, theta, phi;
+
+    std::size_t size() const noexcept { return x.size(); }
+
+    void resize(std::size_t n) {
+        for (auto* col : {&x, &y, &z}) {
+            col->resize(n);
+        }
+        for (auto* col : {&psi, &theta, &phi}) {
+            col->resize(n);
+        }
+    }
+};
+
+// Dead reckoning over many entities stored SoA. Each slot holds the last
+// state received (inbound) or published (outbound) for one entity and the
+// time it refers to; extrapolate() brings every slot to a common time in
+// two passes:
+//
+//   1. position for every algorithm except RPB and RVB is P0 + V dt +
+//      A dt^2 / 2 with per-slot V and A (zero where the algorithm ignores
+//      them, and body accelerations already rotated into the world frame),
+//      so the pass is branch-free and uses AVX2 or NEON when the target
+//      has them;
+//   2. slots with a rotating algorithm get their orientation, and RPB/RVB
+//      their position, from the closed forms of Annex E.
+//
+// Times are in seconds on any clock, as long as it is the same one for
+// set() and extrapolate().
+class DeadReckoningBatch {
+   public:
+    std::size_t size() const noexcept { return algorithm_.size(); }
+
+    std::size_t add(const DRState& s, double time) {
+        const std::size_t i = size();
+        resize(i + 1);
+        set(i, s, time);
+        return i;
+    }
+
+    void set(std::size_t i, const DRState& s, double time) noexcept {
+        using detail::Vec3d;
+        const auto& o = s.orientation;
+        const Vec3d v = detail::to_vec3d(s.linear_velocity);
+        Vec3d a = detail::to_vec3d(s.linear_acceleration);
+        Vec3d vl = v;
+        switch (s.algorithm) {
+            case DRAlgorithm::FPW:
+            case DRAlgorithm::RPW:
+            case DRAlgorithm::FPB:
+                a = {0.0, 0.0, 0.0};
+                break;
+            case DRAlgorithm::RVW:
+            case DRAlgorithm::FVW:
+                break;
+            case DRAlgorithm::FVB:
+                a = detail::mul_transposed(
+                    detail::world_to_body(o.psi(), o.theta(), o.phi()), a);
+                break;
+            default:  // static, unknown, and the pass 2 body-axis ones
+                vl = a = {0.0, 0.0, 0.0};
+                break;
+        }
+
+        t0_[i] = time;
+        x0_[i] = s.location.x();
+        y0_[i] = s.location.y();
+        z0_[i] = s.location.z();
+        vx_[i] = static_cast<float>(vl[0]);
+        vy_[i] = static_cast<float>(vl[1]);
+        vz_[i] = static_cast<float>(vl[2]);
+        hx_[i] = static_cast<float>(0.5 * a[0]);
+        hy_[i] = static_cast<float>(0.5 * a[1]);
+        hz_[i] = static_cast<float>(0.5 * a[2]);
+        psi0_[i] = o.psi();
+        theta0_[i] = o.theta();
+        phi0_[i] = o.phi();
+        extra_[i] = {s.linear_velocity, s.linear_acceleration,
+                     s.angular_velocity};
+        algorithm_[i] = s.algorithm;
+    }
+
+    // Moves the last slot into `i`, as SparseSet does on erase.
+    void swap_and_pop(std::size_t i) noexcept {
+        const std::size_t last = size() - 1;
+        if (i != last) {
+            t0_[i] = t0_[last];
+            x0_[i] = x0_[last];
+            y0_[i] = y0_[last];
+            z0_[i] = z0_[last];
+            vx_[i] = vx_[last];
+            vy_[i] = vy_[last];
+            vz_[i] = vz_[last];
+            hx_[i] = hx_[last];
+            hy_[i] = hy_[last];
+            hz_[i] = hz_[last];
+            psi0_[i] = psi0_[last];
+            theta0_[i] = theta0_[last];
+            phi0_[i] = phi0_[last];
+            extra_[i] = extra_[last];
+            algorithm_[i] = algorithm_[last];
+        }
+        resize(last);
+    }
+
+    void clear() noexcept { resize(0); }
+
+    // Time of the state held in slot i.
+    double time(std::size_t i) const noexcept { return t0_[i]; }
+    DRAlgorithm algorithm(std::size_t i) const noexcept {
+        return algorithm_[i];
+    }
+
+    // Extrapolated locations and orientations from the last extrapolate().
+    const KinematicColumns& current() const noexcept { return current_; }
+
+    WorldCoordinates location(std::size_t i) const noexcept {
+        return WorldCoordinates(current_.x[i], current_.y[i], current_.z[i]);
+    }
+    EulerAngles orientation(std::size_t i) const noexcept {
+        return EulerAngles(current_.psi[i], current_.theta[i],
+                           current_.phi[i]);
+    }
+
+    void extrapolate(double now) noexcept {
+        const std::size_t n = size();
+        linear_pass(now, n);
+        std::copy_n(psi0_.data(), n, current_.psi.data());
+        std::copy_n(theta0_.data(), n, current_.theta.data());
+        std::copy_n(phi0_.data(), n, current_.phi.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            if (rotates(algorithm_[i])) {
+                rotation_pass(i, now - t0_[i]);
+            }
+        }
+    }
+
+    // Extrapolates to `now` and appends to `stale` the slots whose true
+    // state, given column-wise in `truth`, is beyond the thresholds or
+    // whose heartbeat is due. Returns how many were appended. Publish
+    // those entities and set() their slots to what was sent.
+    std::size_t check(double now, const KinematicColumns& truth,
+                      const DRThresholds& thresholds,
+                      Buffer<std::uint32_t>& stale) {
+        extrapolate(now);
+        const std::size_t n = size();
+        const double max_d2 = thresholds.position * thresholds.position;
+        const std::size_t before = stale.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            const double dx = truth.x[i] - current_.x[i];
+            const double dy = truth.y[i] - current_.y[i];
+            const double dz = truth.z[i] - current_.z[i];
+            const float da = std::max(
+                {detail::angle_error(truth.psi[i], current_.psi[i]),
+                 detail::angle_error(truth.theta[i], current_.theta[i]),
+                 detail::angle_error(truth.phi[i], current_.phi[i])});
+            if (dx * dx + dy * dy + dz * dz > max_d2 ||
+                da > thresholds.orientation ||
+                now - t0_[i] >= thresholds.heartbeat) {
+                stale.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        return stale.size() - before;
+    }
+
+   private:
+    // The PDU's own velocity, acceleration and angular velocity, for the
+    // rotation pass.
+    struct Extra {
+        Vector velocity;
+        Vector acceleration;
+        Vector angular_velocity;
+    };
+
+    Buffer<double, 32> t0_, x0_, y0_, z0_;
+    Buffer<float, 32> vx_, vy_, vz_, hx_, hy_, hz_;
+    Buffer<float, 32> psi0_, theta0_, phi0_;
+    Buffer<Extra> extra_;
+    Buffer<DRAlgorithm> algorithm_;
+    KinematicColumns current_;
+
+    void resize(std::size_t n) {
+        for (auto* col : {&t0_, &x0_, &y0_, &z0_}) {
+            col->resize(n);
+        }
+        for (auto* col :
+             {&vx_, &vy_, &vz_, &hx_, &hy_, &hz_, &psi0_, &theta0_, &phi0_}) {
+            col->resize(n);
+        }
+        extra_.resize(n);
+        algorithm_.resize(n);
+        current_.resize(n);
+    }
+
+    void linear_pass(double now, std::size_t n) noexcept {
+        const double* t0 = t0_.data();
+        const double* p0[3] = {x0_.data(), y0_.data(), z0_.data()};
+        const float* v[3] = {vx_.data(), vy_.data(), vz_.data()};
+        const float* h[3] = {hx_.data(), hy_.data(), hz_.data()};
+        double* p[3] = {current_.x.data(), current_.y.data(),
+                        current_.z.data()};
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        const __m256d vnow = _mm256_set1_pd(now);
+        for (; i + 4 <= n; i += 4) {
+            const __m256d dt = _mm256_sub_pd(vnow, _mm256_loadu_pd(t0 + i));
+            for (int k = 0; k < 3; ++k) {
+                const __m256d vk = _mm256_cvtps_pd(_mm_loadu_ps(v[k] + i));
+                const __m256d hk = _mm256_cvtps_pd(_mm_loadu_ps(h[k] + i));
+                const __m256d d =
+                    _mm256_mul_pd(dt, _mm256_add_pd(vk, _mm256_mul_pd(hk, dt)));
+                _mm256_storeu_pd(p[k] + i,
+                                 _mm256_add_pd(_mm256_loadu_pd(p0[k] + i), d));
+            }
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const float64x2_t vnow = vdupq_n_f64(now);
+        for (; i + 2 <= n; i += 2) {
+            const float64x2_t dt = vsubq_f64(vnow, vld1q_f64(t0 + i));
+            for (int k = 0; k < 3; ++k) {
+                const float64x2_t vk = vcvt_f64_f32(vld1_f32(v[k] + i));
+                const float64x2_t hk = vcvt_f64_f32(vld1_f32(h[k] + i));
+                const float64x2_t d = vmulq_f64(dt, vfmaq_f64(vk, hk, dt));
+                vst1q_f64(p[k] + i, vaddq_f64(vld1q_f64(p0[k] + i), d));
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            const double dt = now - t0[i];
+            for (int k = 0; k < 3; ++k) {
+                p[k][i] = p0[k][i] + dt * (v[k][i] + h[k][i] * dt);
+            }
+        }
+    }
+
+    void rotation_pass(std::size_t i, double dt) noexcept {
+        using detail::Vec3d;
+        const Extra& e = extra_[i];
+        const Vec3d w = detail::to_vec3d(e.angular_velocity);
+        const double mag = std::sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+        const auto r0 = detail::world_to_body(psi0_[i], theta0_[i], phi0_[i]);
+        const auto o = detail::euler(detail::rotate(r0, w, mag, dt));
+        current_.psi[i] = o.psi();
+        current_.theta[i] = o.theta();
+        current_.phi[i] = o.phi();
+
+        const DRAlgorithm a = algorithm_[i];
+        if (a == DRAlgorithm::RPB || a == DRAlgorithm::RVB) {
+            const Vec3d ab = a == DRAlgorithm::RVB
+                                 ? detail::to_vec3d(e.acceleration)
+                                 : Vec3d{0.0, 0.0, 0.0};
+            const Vec3d d = detail::body_displacement(
+                r0, w, mag, detail::mul(r0, detail::to_vec3d(e.velocity)), ab,
+                dt);
+            current_.x[i] = x0_[i] + d[0];
+            current_.y[i] = y0_[i] + d[1];
+            current_.z[i] = z0_[i] + d[2];
+        }
+    }
+};
+
+}  // namespace csics::lvc::dis
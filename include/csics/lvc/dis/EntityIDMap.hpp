@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace csics::lvc::dis {
+
+namespace detail {
+// One control byte per slot: the top bit set for empty and deleted slots,
+// otherwise the low 7 bits of the key's hash.
+constexpr std::uint8_t ctrl_empty = 0x80;
+constexpr std::uint8_t ctrl_deleted = 0xFE;
+
+// Set bits of a group match, one (x86) or four (NEON) bits per slot.
+struct GroupMask {
+#if defined(__ARM_NEON) && defined(__aarch64__) && !defined(__SSE2__)
+    static constexpr int shift = 2;
+#else
+    static constexpr int shift = 0;
+#endif
+    std::uint64_t bits;
+
+    explicit operator bool() const noexcept { return bits != 0; }
+    std::size_t lowest() const noexcept {
+        return static_cast<std::size_t>(std::countr_zero(bits)) >> shift;
+    }
+    void clear_lowest() noexcept {
+        constexpr std::uint64_t lane = (std::uint64_t{1} << (1 << shift)) - 1;
+        bits &= ~(lane << (lowest() << shift));
+    }
+};
+
+// Sixteen control bytes compared at once.
+struct Group {
+    static constexpr std::size_t width = 16;
+
+#if defined(__SSE2__)
+    explicit Group(const std::uint8_t* p) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+    GroupMask match(std::uint8_t h) const noexcept {
+        return mask(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(h))));
+    }
+    GroupMask match_empty() const noexcept {
+        return match(ctrl_empty);
+    }
+    // Empty and deleted slots are the ones with the top bit set.
+    GroupMask match_free() const noexcept { return mask(ctrl); }
+
+   private:
+    __m128i ctrl;
+    static GroupMask mask(__m128i v) noexcept {
+        return GroupMask{static_cast<std::uint16_t>(_mm_movemask_epi8(v))};
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    explicit Group(const std::uint8_t* p) noexcept : ctrl(vld1q_u8(p)) {}
+    GroupMask match(std::uint8_t h) const noexcept {
+        return mask(vceqq_u8(ctrl, vdupq_n_u8(h)));
+    }
+    GroupMask match_empty() const noexcept { return match(ctrl_empty); }
+    GroupMask match_free() const noexcept {
+        return mask(vcltzq_s8(vreinterpretq_s8_u8(ctrl)));
+    }
+
+   private:
+    uint8x16_t ctrl;
+    // narrows each 0x00/0xFF byte to a nibble
+    static GroupMask mask(uint8x16_t v) noexcept {
+        return GroupMask{vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0)};
+    }
+#else
+    explicit Group(const std::uint8_t* p) noexcept {
+        std::memcpy(ctrl, p, width);
+    }
+    GroupMask match(std::uint8_t h) const noexcept {
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            bits |= std::uint64_t{ctrl[i] == h} << i;
+        }
+        return GroupMask{bits};
+    }
+    GroupMask match_empty() const noexcept { return match(ctrl_empty); }
+    GroupMask match_free() const noexcept {
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < width; ++i) {
+            bits |= std::uint64_t{(ctrl[i] & 0x80) != 0} << i;
+        }
+        return GroupMask{bits};
+    }
+
+   private:
+    std::uint8_t ctrl[width];
+#endif
+};
+
+// A 64 bit finalizer; packed ids differ mostly in their low bits.
+constexpr std::uint64_t mix(std::uint64_t k) noexcept {
+    k ^= k >> 33;
+    k *= 0xFF51AFD7ED558CCDull;
+    k ^= k >> 33;
+    k *= 0xC4CEB9FE1A85EC53ull;
+    k ^= k >> 33;
+    return k;
+}
+}  // namespace detail
+
+// Flat open-addressing map from EntityID (as EntityID::packed()) to a
+// trivially copyable value, for the per-PDU lookups of a DIS receiver.
+// Slots are probed sixteen at a time by comparing a byte of the hash for
+// each slot in one SIMD instruction, so a lookup is usually a single
+// group load and one key compare. Values move on rehash: do not hold
+// pointers from find() across an insert.
+template <typename V>
+    requires std::is_trivially_copyable_v<V>
+class EntityIDMap {
+   public:
+    EntityIDMap() = default;
+    explicit EntityIDMap(std::size_t n) { reserve(n); }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    std::size_t capacity() const noexcept { return ctrl_.size(); }
+
+    V* find(std::uint64_t key) noexcept {
+        const std::size_t i = find_slot(key);
+        return i == npos ? nullptr : &slots_[i].value;
+    }
+    const V* find(std::uint64_t key) const noexcept {
+        const std::size_t i = find_slot(key);
+        return i == npos ? nullptr : &slots_[i].value;
+    }
+    V* find(const EntityID& id) noexcept { return find(id.packed()); }
+    const V* find(const EntityID& id) const noexcept {
+        return find(id.packed());
+    }
+
+    bool contains(std::uint64_t key) const noexcept {
+        return find(key) != nullptr;
+    }
+
+    // Inserts `value` under `key` unless the key is present. Returns the
+    // stored value and whether it was inserted.
+    std::pair<V*, bool> try_emplace(std::uint64_t key, const V& value = V{}) {
+        if (V* v = find(key)) {
+            return {v, false};
+        }
+        if (growth_left_ == 0) {
+            rehash(size_ + 1 > capacity() * 7 / 16 ? capacity() * 2
+                                                   : capacity());
+        }
+        const std::size_t i = free_slot(detail::mix(key));
+        growth_left_ -= ctrl_[i] == detail::ctrl_empty;
+        set_ctrl(i, static_cast<std::uint8_t>(detail::mix(key) & 0x7F));
+        slots_[i] = Slot{key, value};
+        ++size_;
+        return {&slots_[i].value, true};
+    }
+
+    // The value under `key`, value-initialized first if absent.
+    V& operator[](std::uint64_t key) { return *try_emplace(key).first; }
+
+    bool erase(std::uint64_t key) noexcept {
+        const std::size_t i = find_slot(key);
+        if (i == npos) {
+            return false;
+        }
+        // A group that still has an empty slot never made a probe go past
+        // it, so the slot can be empty again; otherwise leave a tombstone.
+        detail::Group group(ctrl_.data() +
+                            (i & ~(detail::Group::width - 1)));
+        if (group.match_empty()) {
+            set_ctrl(i, detail::ctrl_empty);
+            ++growth_left_;
+        } else {
+            set_ctrl(i, detail::ctrl_deleted);
+        }
+        --size_;
+        return true;
+    }
+
+    void clear() noexcept {
+        if (ctrl_.size() == 0) {
+            return;
+        }
+        std::memset(ctrl_.data(), detail::ctrl_empty, ctrl_.size());
+        size_ = 0;
+        growth_left_ = max_load(capacity());
+    }
+
+    // Sizes the table to hold `n` keys without rehashing.
+    void reserve(std::size_t n) {
+        std::size_t cap = detail::Group::width;
+        while (max_load(cap) < n) {
+            cap *= 2;
+        }
+        if (cap > capacity()) {
+            rehash(cap);
+        }
+    }
+
+    // Calls f(key, value) for every entry, in no particular order.
+    template <typename F>
+    void for_each(F&& f) const {
+        for (std::size_t i = 0; i < ctrl_.size(); ++i) {
+            if (!(ctrl_[i] & 0x80)) {
+                f(slots_[i].key, slots_[i].value);
+            }
+        }
+    }
+
+   private:
+    // Key and value share a slot so a hit costs one more cache line after
+    // the control bytes.
+    struct Slot {
+        std::uint64_t key;
+        V value;
+    };
+
+    Buffer<std::uint8_t> ctrl_;
+    Buffer<Slot> slots_;
+    std::size_t size_ = 0;
+    std::size_t growth_left_ = 0;
+    std::size_t group_mask_ = 0;
+
+    static constexpr std::size_t npos = ~std::size_t{0};
+
+    std::size_t find_slot(std::uint64_t key) const noexcept {
+        if (size_ == 0) {
+            return npos;
+        }
+        const std::uint64_t h = detail::mix(key);
+        const auto h2 = static_cast<std::uint8_t>(h & 0x7F);
+        std::size_t g = (h >> 7) & group_mask_;
+        for (std::size_t step = 1;; ++step) {
+            const std::size_t base = g * detail::Group::width;
+            detail::Group group(ctrl_.data() + base);
+            for (auto m = group.match(h2); m; m.clear_lowest()) {
+                const std::size_t i = base + m.lowest();
+                if (slots_[i].key == key) {
+                    return i;
+                }
+            }
+            if (group.match_empty()) {
+                return npos;
+            }
+            g = (g + step) & group_mask_;
+        }
+    }
+
+    // At most 7/8 full, counting tombstones.
+    static constexpr std::size_t max_load(std::size_t cap) noexcept {
+        return cap - cap / 8;
+    }
+
+    void set_ctrl(std::size_t i, std::uint8_t c) noexcept { ctrl_[i] = c; }
+
+    std::size_t free_slot(std::uint64_t h) const noexcept {
+        std::size_t g = (h >> 7) & group_mask_;
+        for (std::size_t step = 1;; ++step) {
+            const std::size_t base = g * detail::Group::width;
+            auto m = detail::Group(ctrl_.data() + base).match_free();
+            if (m) {
+                return base + m.lowest();
+            }
+            g = (g + step) & group_mask_;
+        }
+    }
+
+    // Rebuilds into `cap` slots, dropping tombstones; `cap` may equal the
+    // current capacity when the table is mostly tombstones.
+    void rehash(std::size_t cap) {
+        cap = std::max(cap, detail::Group::width);
+        Buffer<std::uint8_t> old_ctrl(std::move(ctrl_));
+        Buffer<Slot> old_slots(std::move(slots_));
+
+        ctrl_ = Buffer<std::uint8_t>(cap, detail::ctrl_empty);
+        slots_ = Buffer<Slot>(cap);
+        group_mask_ = cap / detail::Group::width - 1;
+        growth_left_ = max_load(cap) - size_;
+
+        for (std::size_t i = 0; i < old_ctrl.size(); ++i) {
+            if (old_ctrl[i] & 0x80) {
+                continue;
+            }
+            const std::uint64_t h = detail::mix(old_slots[i].key);
+            const std::size_t j = free_slot(h);
+            set_ctrl(j, static_cast<std::uint8_t>(h & 0x7F));
+            slots_[j] = old_slots[i];
+        }
+    }
+};
+
+}  // namespace csics::lvc::dis
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "csics/Bit.hpp"
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/EntityIDMap.hpp"
+#include "csics/lvc/dis/Layout.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+
+namespace csics::lvc::dis {
+
+struct EntityTableConfig {
+    // Entities not heard from for this long are removed; the DIS default
+    // is 2.4 heartbeats of 5 s.
+    std::chrono::milliseconds timeout{12000};
+    // Updates arriving sooner than this after the last accepted one for
+    // the same entity are dropped. Zero keeps every update.
+    std::chrono::milliseconds min_interval{0};
+    // Drop updates whose DIS timestamp is not later than the stored one:
+    // duplicates and reordered datagrams.
+    bool drop_stale = true;
+    // Expiry resolution, and the number of ticks the timer wheel spans
+    // before entries go round again.
+    std::chrono::milliseconds tick{100};
+    std::size_t wheel_slots = 256;
+};
+
+enum class EntityUpdate : std::uint8_t {
+    Created,
+    Updated,
+    Stale,
+    Throttled,
+    Malformed,
+};
+
+struct EntityTableStats {
+    std::size_t created = 0;
+    std::size_t updated = 0;
+    std::size_t stale = 0;
+    std::size_t throttled = 0;
+    std::size_t malformed = 0;
+    std::size_t expired = 0;
+};
+
+// Latest state of every remote entity, one element per entity. Rows move
+// when entities are removed; address them through find().
+struct RemoteEntityColumns {
+    Buffer<std::uint64_t> keys;  // EntityID::packed()
+    Buffer<std::uint32_t> timestamps;  // DISTimestamp::raw()
+    Buffer<EntityType> types;
+    Buffer<std::uint8_t> force_ids;
+    Buffer<std::uint8_t> dr_algorithms;
+    Buffer<std::uint32_t> appearances;
+    Buffer<double> x, y, z;         // location, ECEF metres
+    Buffer<float> psi, theta, phi;  // orientation
+    Buffer<float> vx, vy, vz;       // linear velocity
+
+    std::size_t size() const noexcept { return keys.size(); }
+
+    EntityID entity_id(std::size_t i) const noexcept {
+        const std::uint64_t k = keys[i];
+        return EntityID(static_cast<std::uint16_t>(k >> 32),
+                        static_cast<std::uint16_t>(k >> 16),
+                        static_cast<std::uint16_t>(k));
+    }
+
+    template <typename F>
+    void for_each_column(F&& f) {
+        f(keys);
+        f(timestamps);
+        f(types);
+        f(force_ids);
+        f(dr_algorithms);
+        f(appearances);
+        for (auto* col : {&x, &y, &z}) {
+            f(*col);
+        }
+        for (auto* col : {&psi, &theta, &phi, &vx, &vy, &vz}) {
+            f(*col);
+        }
+    }
+};
+
+namespace detail {
+// True if DIS timestamp `a` is later than `b`. Timestamps count 2^31 units
+// per hour and wrap, so anything up to half an hour ahead is later.
+constexpr bool later(std::uint32_t a, std::uint32_t b) noexcept {
+    const std::uint32_t d = ((a >> 1) - (b >> 1)) & 0x7FFFFFFF;
+    return d != 0 && d < 0x40000000;
+}
+
+// Hashed timer wheel holding one entry per entity. Entries are not moved
+// when an entity is updated: when a slot comes due each entry is checked
+// against its entity's current deadline and either expired or put back in
+// the slot for that deadline, so an update costs nothing here.
+template <typename Clock>
+class TimerWheel {
+   public:
+    struct Entry {
+        std::uint64_t key;
+        std::uint32_t generation;
+    };
+
+    TimerWheel(typename Clock::duration tick, std::size_t slots)
+        : tick_(std::max(tick, typename Clock::duration(1))) {
+        slots_.resize(std::bit_ceil(std::max<std::size_t>(slots, 2)));
+    }
+
+    // Starts the wheel at `now`; call before the first schedule().
+    void start(typename Clock::time_point now) {
+        if (next_ == std::numeric_limits<std::int64_t>::min()) {
+            next_ = ticks_floor(now);
+        }
+    }
+
+    void schedule(Entry e, typename Clock::time_point deadline) {
+        slots_[slot(std::clamp(ticks_ceil(deadline), next_, last_tick()))]
+            .push_back(e);
+    }
+
+    // Visits the entries of every slot due by `now`. check(entry) returns
+    // the entry's deadline, or nothing to drop it; entries past `now` are
+    // handed to expire(entry) and the rest rescheduled.
+    template <typename Check, typename Expire>
+    void advance(typename Clock::time_point now, Check&& check,
+                 Expire&& expire) {
+        const std::int64_t target = ticks_floor(now);
+        if (next_ == std::numeric_limits<std::int64_t>::min() ||
+            target < next_) {
+            return;
+        }
+        if (target - next_ >= static_cast<std::int64_t>(slot_count())) {
+            next_ = target - static_cast<std::int64_t>(slot_count()) + 1;
+        }
+        for (; next_ <= target; ++next_) {
+            auto& s = slots_[slot(next_)];
+            if (s.size() == 0) {
+                continue;
+            }
+            std::swap(s, due_);
+            for (const auto& e : due_) {
+                auto deadline = check(e);
+                if (!deadline) {
+                    continue;
+                }
+                if (*deadline <= now) {
+                    expire(e);
+                } else {
+                    slots_[slot(std::min(ticks_ceil(*deadline), last_tick()))]
+                        .push_back(e);
+                }
+            }
+            due_.clear();
+        }
+    }
+
+    void clear() {
+        for (auto& s : slots_) {
+            s.clear();
+        }
+    }
+
+   private:
+    typename Clock::duration tick_;
+    Buffer<Buffer<Entry>> slots_;
+    Buffer<Entry> due_;
+    std::int64_t next_ = std::numeric_limits<std::int64_t>::min();
+
+    std::size_t slot_count() const noexcept { return slots_.size(); }
+    std::size_t slot(std::int64_t t) const noexcept {
+        return static_cast<std::size_t>(t) & (slot_count() - 1);
+    }
+    std::int64_t ticks_floor(typename Clock::time_point t) const noexcept {
+        auto d = t.time_since_epoch();
+        auto q = d / tick_;
+        return q * tick_ > d ? q - 1 : q;
+    }
+    std::int64_t ticks_ceil(typename Clock::time_point t) const noexcept {
+        auto q = ticks_floor(t);
+        return q * tick_ == t.time_since_epoch() ? q : q + 1;
+    }
+    std::int64_t last_tick() const noexcept {
+        return next_ + static_cast<std::int64_t>(slot_count()) - 1;
+    }
+};
+}  // namespace detail
+
+// Remote entity table keyed by EntityID, for DIS receivers. Entity state
+// PDUs update the entity's row in place, in O(1) through an EntityIDMap;
+// duplicates, reordered PDUs and updates faster than min_interval are
+// dropped; entities silent for `timeout` are removed by expire(), driven
+// by a timer wheel that looks at each entity about once per timeout
+// rather than on every call.
+//
+// Consumers read the state from columns(), and the keys of the entities
+// created or updated and of those expired since the last clear_events()
+// from updated() and expired(), e.g. to sync an ECS world:
+//
+//   table.update_batch(datagrams);
+//   table.expire();
+//   for (auto key : table.updated()) { auto i = *table.find(key); ... }
+//   for (auto key : table.expired()) { ... }
+//   table.clear_events();
+template <typename Clock = std::chrono::steady_clock>
+class RemoteEntityTable {
+   public:
+    using time_point = typename Clock::time_point;
+
+    RemoteEntityTable() : RemoteEntityTable(EntityTableConfig{}) {}
+    explicit RemoteEntityTable(const EntityTableConfig& config)
+        : config_(config), wheel_(config.tick, config.wheel_slots) {}
+
+    const EntityTableConfig& config() const noexcept { return config_; }
+    const EntityTableStats& stats() const noexcept { return stats_; }
+    const RemoteEntityColumns& columns() const noexcept { return columns_; }
+    std::size_t size() const noexcept { return columns_.size(); }
+
+    // Sizes the index for `n` entities.
+    void reserve(std::size_t n) { index_.reserve(n); }
+
+    // Row of the entity in columns(), or nothing.
+    std::optional<std::size_t> find(std::uint64_t key) const noexcept {
+        const std::uint32_t* i = index_.find(key);
+        return i ? std::optional<std::size_t>(*i) : std::nullopt;
+    }
+    std::optional<std::size_t> find(const EntityID& id) const noexcept {
+        return find(id.packed());
+    }
+
+    // When the entity's last accepted update arrived.
+    time_point last_update(std::size_t row) const noexcept {
+        return received_[row];
+    }
+
+    EntityUpdate update(BufferView pdu) { return update(pdu, Clock::now()); }
+    EntityUpdate update(BufferView pdu, time_point now) {
+        EntityStatePDUView view(pdu);
+        if (!view.valid() || view.header().length() > pdu.size()) {
+            ++stats_.malformed;
+            return EntityUpdate::Malformed;
+        }
+        return apply(pdu.data(), now);
+    }
+
+    // Applies a receive batch, skipping PDUs that are not entity states.
+    // Returns how many were created or updated.
+    std::size_t update_batch(std::span<const BufferView> pdus) {
+        return update_batch(pdus, Clock::now());
+    }
+    std::size_t update_batch(std::span<const BufferView> pdus,
+                             time_point now) {
+        std::size_t accepted = 0;
+        for (auto pdu : pdus) {
+            if (pdu.size() >= layout::header::size &&
+                PDUHeaderView(pdu).pdu_type() != PDUType::EntityState) {
+                continue;
+            }
+            const auto r = update(pdu, now);
+            accepted += r == EntityUpdate::Created || r == EntityUpdate::Updated;
+        }
+        return accepted;
+    }
+
+    // Removes the entities that timed out by `now`; returns how many.
+    std::size_t expire() { return expire(Clock::now()); }
+    std::size_t expire(time_point now) {
+        const std::size_t before = stats_.expired;
+        wheel_.advance(
+            now,
+            [&](const Entry& e) -> std::optional<time_point> {
+                const std::uint32_t* i = index_.find(e.key);
+                if (i == nullptr || generations_[*i] != e.generation) {
+                    return std::nullopt;
+                }
+                return received_[*i] + config_.timeout;
+            },
+            [&](const Entry& e) {
+                expired_.push_back(e.key);
+                remove_row(*index_.find(e.key));
+                ++stats_.expired;
+            });
+        return stats_.expired - before;
+    }
+
+    // Removes an entity at once, e.g. on a remove entity PDU. Not listed in
+    // expired().
+    bool remove(const EntityID& id) {
+        const std::uint32_t* i = index_.find(id.packed());
+        if (i == nullptr) {
+            return false;
+        }
+        remove_row(*i);
+        return true;
+    }
+
+    // Keys of the entities created or updated, and of those expired, since
+    // the last clear_events(). An entity appears at most once in each.
+    std::span<const std::uint64_t> updated() const noexcept {
+        return {updated_.data(), updated_.size()};
+    }
+    std::span<const std::uint64_t> expired() const noexcept {
+        return {expired_.data(), expired_.size()};
+    }
+    void clear_events() {
+        for (auto key : updated_) {
+            if (const std::uint32_t* i = index_.find(key)) {
+                flags_[*i] &= ~flag_updated;
+            }
+        }
+        updated_.clear();
+        expired_.clear();
+    }
+
+    void clear() {
+        index_.clear();
+        columns_.for_each_column([](auto& col) { col.clear(); });
+        received_.clear();
+        generations_.clear();
+        flags_.clear();
+        updated_.clear();
+        expired_.clear();
+        wheel_.clear();
+    }
+
+   private:
+    using Entry = typename detail::TimerWheel<Clock>::Entry;
+    static constexpr std::uint8_t flag_updated = 0x1;
+
+    EntityTableConfig config_;
+    EntityIDMap<std::uint32_t> index_;
+    RemoteEntityColumns columns_;
+    Buffer<time_point> received_;
+    Buffer<std::uint32_t> generations_;
+    Buffer<std::uint8_t> flags_;
+    Buffer<std::uint64_t> updated_;
+    Buffer<std::uint64_t> expired_;
+    detail::TimerWheel<Clock> wheel_;
+    std::uint32_t next_generation_ = 0;
+    EntityTableStats stats_;
+
+    static std::uint64_t wire_key(const char* p) noexcept {
+        return static_cast<std::uint64_t>(load_big<std::uint32_t>(p)) << 16 |
+               load_big<std::uint16_t>(p + 4);
+    }
+
+    EntityUpdate apply(const char* p, time_point now) {
+        namespace es = layout::entity_state;
+        const std::uint64_t key = wire_key(p + es::entity_id);
+        const std::uint32_t timestamp =
+            load_big<std::uint32_t>(p + layout::header::timestamp);
+
+        auto [slot, created] =
+            index_.try_emplace(key, static_cast<std::uint32_t>(size()));
+        const std::uint32_t row = *slot;
+        if (created) {
+            columns_.for_each_column([](auto& col) { col.push_back({}); });
+            columns_.keys[row] = key;
+            received_.push_back(now);
+            generations_.push_back(next_generation_);
+            flags_.push_back(0);
+            wheel_.start(now);
+            wheel_.schedule(Entry{key, next_generation_++},
+                            now + config_.timeout);
+            ++stats_.created;
+        } else {
+            if (config_.drop_stale &&
+                !detail::later(timestamp, columns_.timestamps[row])) {
+                ++stats_.stale;
+                return EntityUpdate::Stale;
+            }
+            if (now - received_[row] < config_.min_interval) {
+                ++stats_.throttled;
+                return EntityUpdate::Throttled;
+            }
+            received_[row] = now;
+            ++stats_.updated;
+        }
+
+        auto& c = columns_;
+        c.timestamps[row] = timestamp;
+        c.types[row] = load_type(p + es::entity_type);
+        c.force_ids[row] = static_cast<std::uint8_t>(p[es::force_id]);
+        c.dr_algorithms[row] = static_cast<std::uint8_t>(p[es::dr_algorithm]);
+        c.appearances[row] = load_big<std::uint32_t>(p + es::appearance);
+        c.x[row] = load_big<double>(p + es::location);
+        c.y[row] = load_big<double>(p + es::location + 8);
+        c.z[row] = load_big<double>(p + es::location + 16);
+        c.psi[row] = load_big<float>(p + es::orientation);
+        c.theta[row] = load_big<float>(p + es::orientation + 4);
+        c.phi[row] = load_big<float>(p + es::orientation + 8);
+        c.vx[row] = load_big<float>(p + es::linear_velocity);
+        c.vy[row] = load_big<float>(p + es::linear_velocity + 4);
+        c.vz[row] = load_big<float>(p + es::linear_velocity + 8);
+        if (!(flags_[row] & flag_updated)) {
+            flags_[row] |= flag_updated;
+            updated_.push_back(key);
+        }
+        return created ? EntityUpdate::Created : EntityUpdate::Updated;
+    }
+
+    static EntityType load_type(const char* p) noexcept {
+        return EntityType{static_cast<std::uint8_t>(p[0]),
+                          static_cast<std::uint8_t>(p[1]),
+                          load_big<std::uint16_t>(p + 2),
+                          static_cast<std::uint8_t>(p[4]),
+                          static_cast<std::uint8_t>(p[5]),
+                          static_cast<std::uint8_t>(p[6]),
+                          static_cast<std::uint8_t>(p[7])};
+    }
+
+    // Swaps the last row into `row` and drops the entity's index entry.
+    void remove_row(std::uint32_t row) {
+        const std::uint64_t key = columns_.keys[row];
+        if (flags_[row] & flag_updated) {
+            updated_.swap_and_pop(
+                std::find(updated_.begin(), updated_.end(), key));
+        }
+        const std::size_t last = size() - 1;
+        if (row != last) {
+            *index_.find(columns_.keys[last]) = row;
+        }
+        index_.erase(key);
+        columns_.for_each_column(
+            [&](auto& col) { col.swap_and_pop(col.begin() + row); });
+        received_.swap_and_pop(received_.begin() + row);
+        generations_.swap_and_pop(generations_.begin() + row);
+        flags_.swap_and_pop(flags_.begin() + row);
+    }
+};
+
+}  // namespace csics::lvc::dis
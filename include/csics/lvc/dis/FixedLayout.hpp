@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "csics/Bit.hpp"
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/Layout.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/serde.hpp"
+#include "csics/serialization/serialization.hpp"
+
+// Fixed-offset encoding of the entity state PDU. The output size is checked
+// once against pdu_size_calc and every field is then stored at its offset
+// from Layout.hpp, with no per-field bounds checks or view adjustments.
+namespace csics::lvc::dis {
+
+static_assert(layout::entity_state::size * 8 == 1152,
+              "entity state layout does not match pdu_size_calc");
+static_assert(layout::entity_state::variable_parameter_size * 8 == 128,
+              "variable parameter layout does not match pdu_size_calc");
+
+namespace detail {
+inline void store_id(char* p, const ID& id) noexcept {
+    store_big<std::uint16_t>(p + layout::id::site, id.site());
+    store_big<std::uint16_t>(p + layout::id::application, id.application());
+    store_big<std::uint16_t>(p + layout::id::entity, id.id());
+}
+
+inline void store_entity_type(char* p, const EntityType& t) noexcept {
+    p[0] = static_cast<char>(t.kind);
+    p[1] = static_cast<char>(t.domain);
+    store_big<std::uint16_t>(p + 2, t.country);
+    p[4] = static_cast<char>(t.category);
+    p[5] = static_cast<char>(t.subcategory);
+    p[6] = static_cast<char>(t.specific);
+    p[7] = static_cast<char>(t.extra);
+}
+
+inline void store_vector(char* p, const Vector& v) noexcept {
+    store_big<float>(p, v.get<0>());
+    store_big<float>(p + 4, v.get<1>());
+    store_big<float>(p + 8, v.get<2>());
+}
+
+inline void store_world(char* p, const WorldCoordinates& w) noexcept {
+    store_big<double>(p, w.x());
+    store_big<double>(p + 8, w.y());
+    store_big<double>(p + 16, w.z());
+}
+
+inline void store_euler(char* p, const EulerAngles& e) noexcept {
+    store_big<float>(p, e.psi());
+    store_big<float>(p + 4, e.theta());
+    store_big<float>(p + 8, e.phi());
+}
+
+inline void store_header(char* p, const PDUHeader& h,
+                         std::size_t length) noexcept {
+    namespace hl = layout::header;
+    p[hl::protocol_version] = static_cast<char>(h.protocol_version);
+    p[hl::exercise_id] = static_cast<char>(h.exercise_id);
+    p[hl::pdu_type] = static_cast<char>(h.pdu_type);
+    p[hl::protocol_family] = static_cast<char>(h.protocol_family);
+    store_big<std::uint32_t>(p + hl::timestamp, h.timestamp.raw());
+    store_big<std::uint16_t>(p + hl::length,
+                             static_cast<std::uint16_t>(length));
+    p[hl::status] = static_cast<char>(h.status);
+    p[hl::status + 1] = 0;
+}
+
+inline void store_dr_parameters(char* p,
+                                const DeadReckoningParameters& dr) noexcept {
+    namespace es = layout::entity_state;
+    p[0] = static_cast<char>(dr.algorithm);
+    p[es::dr_parameters_type - es::dr_algorithm] =
+        static_cast<char>(dr.params_type);
+    char* params = p + (es::dr_parameters - es::dr_algorithm);
+    std::memset(params, 0, es::dr_linear_acceleration - es::dr_parameters);
+    if (dr.params_type == 1) {
+        store_euler(params + 2, dr.fixed.local_angles);
+    } else if (dr.params_type == 2) {
+        store_big<std::uint16_t>(params, dr.rotating.quat.u0);
+        store_big<float>(params + 2, dr.rotating.quat.x);
+        store_big<float>(params + 6, dr.rotating.quat.y);
+        store_big<float>(params + 10, dr.rotating.quat.z);
+    }
+    store_vector(p + (es::dr_linear_acceleration - es::dr_algorithm),
+                 dr.linear_acceleration);
+    store_vector(p + (es::dr_angular_velocity - es::dr_algorithm),
+                 dr.angular_velocity);
+}
+
+// The fixed part of an entity state PDU declaring `length` bytes in total.
+inline void store_entity_state(char* p, const EntityStatePDU& pdu,
+                               std::size_t length) noexcept {
+    namespace es = layout::entity_state;
+    store_header(p, pdu.header, length);
+    store_id(p + es::entity_id, pdu.entity_id);
+    p[es::force_id] = static_cast<char>(pdu.force_id);
+    p[es::variable_parameter_count] =
+        static_cast<char>(pdu.variable_parameters.size());
+    store_entity_type(p + es::entity_type, pdu.entity_type);
+    store_entity_type(p + es::alternative_entity_type,
+                      pdu.alternative_entity_type);
+    store_vector(p + es::linear_velocity, pdu.entity_linear_velocity);
+    store_world(p + es::location, pdu.entity_location);
+    store_euler(p + es::orientation, pdu.entity_orientation);
+    store_big<std::uint32_t>(p + es::appearance, pdu.entity_appearance);
+    store_dr_parameters(p + es::dr_algorithm, pdu.dr_parameters);
+    p[es::marking] = static_cast<char>(pdu.entity_marking.character_set);
+    std::memcpy(p + es::marking + 1, pdu.entity_marking.marking,
+                sizeof(pdu.entity_marking.marking));
+    store_big<std::uint32_t>(p + es::capabilities, pdu.capabilities);
+}
+}  // namespace detail
+
+// Encodes `pdu` into the front of `bv`. Writes nothing and returns
+// BufferFull if the whole PDU does not fit.
+inline serialization::SerializationResult encode_fixed(
+    MutableBufferView bv, const EntityStatePDU& pdu) noexcept {
+    namespace es = layout::entity_state;
+    const std::size_t size = pdu_size_calc(pdu);
+    if (bv.size() < size) {
+        return {bv(0, 0), serialization::SerializationStatus::BufferFull};
+    }
+    char* p = bv.data();
+    detail::store_entity_state(p, pdu, size);
+    char* vp = p + es::variable_parameters;
+    for (const auto& param : pdu.variable_parameters) {
+        vp[0] = static_cast<char>(param.type);
+        std::memcpy(vp + 1, param.data, sizeof(param.data));
+        vp += es::variable_parameter_size;
+    }
+    return {bv(0, size), serialization::SerializationStatus::Ok};
+}
+
+// A DirectSerializer that takes the fixed-offset path for the PDUs that
+// have one and falls back to field-by-field writes for the rest.
+class FixedLayoutSerializer : public serialization::DirectSerializer {};
+
+inline serialization::SerializationResult serialize_wire(
+    FixedLayoutSerializer&, MutableBufferView& bv, const EntityStatePDU& pdu) {
+    return encode_fixed(bv, pdu);
+}
+
+// A pre-encoded entity state PDU without variable parameters, for periodic
+// re-publication. The fields that stay put between heartbeats are encoded
+// once into a template; write() copies it and stores only the kinematic
+// fields, straight into the output so the copy never re-reads bytes that
+// were just stored.
+class EntityStateImage {
+   public:
+    static constexpr std::size_t size = layout::entity_state::size;
+
+    EntityStateImage() : EntityStateImage(EntityStatePDU{}) {}
+    explicit EntityStateImage(const EntityStatePDU& pdu) noexcept
+        : timestamp_(pdu.header.timestamp),
+          linear_velocity_(pdu.entity_linear_velocity),
+          location_(pdu.entity_location),
+          orientation_(pdu.entity_orientation) {
+        detail::store_entity_state(bytes_.data(), pdu, size);
+        // variable parameters are not part of the image
+        bytes_[layout::entity_state::variable_parameter_count] = 0;
+    }
+
+    void timestamp(DISTimestamp t) noexcept { timestamp_ = t; }
+    void linear_velocity(const Vector& v) noexcept { linear_velocity_ = v; }
+    void location(const WorldCoordinates& w) noexcept { location_ = w; }
+    void orientation(const EulerAngles& e) noexcept { orientation_ = e; }
+
+    void appearance(std::uint32_t a) noexcept {
+        store_big<std::uint32_t>(
+            bytes_.data() + layout::entity_state::appearance, a);
+    }
+    void dr_parameters(const DeadReckoningParameters& dr) noexcept {
+        detail::store_dr_parameters(
+            bytes_.data() + layout::entity_state::dr_algorithm, dr);
+    }
+
+    // Copies the PDU into the front of `bv`, or returns BufferFull.
+    serialization::SerializationResult write(
+        MutableBufferView bv) const noexcept {
+        namespace es = layout::entity_state;
+        if (bv.size() < size) {
+            return {bv(0, 0), serialization::SerializationStatus::BufferFull};
+        }
+        char* p = bv.data();
+        std::memcpy(p, bytes_.data(), size);
+        store_big<std::uint32_t>(p + layout::header::timestamp,
+                                 timestamp_.raw());
+        detail::store_vector(p + es::linear_velocity, linear_velocity_);
+        detail::store_world(p + es::location, location_);
+        detail::store_euler(p + es::orientation, orientation_);
+        return {bv(0, size), serialization::SerializationStatus::Ok};
+    }
+
+   private:
+    std::array<char, size> bytes_;
+    DISTimestamp timestamp_;
+    Vector linear_velocity_;
+    WorldCoordinates location_;
+    EulerAngles orientation_;
+};
+
+}  // namespace csics::lvc::dis
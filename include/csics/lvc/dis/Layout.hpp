@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+
+// Byte offsets of PDU fields on the wire (IEEE 1278.1), relative to the
+// start of the PDU or of the enclosing record. These match what serde.hpp
+// writes and are what the zero-copy views in Views.hpp read from.
+namespace csics::lvc::dis::layout {
+
+namespace header {
+constexpr std::size_t protocol_version = 0;
+constexpr std::size_t exercise_id = 1;
+constexpr std::size_t pdu_type = 2;
+constexpr std::size_t protocol_family = 3;
+constexpr std::size_t timestamp = 4;
+constexpr std::size_t length = 8;
+constexpr std::size_t status = 10;
+constexpr std::size_t size = 12;
+}  // namespace header
+
+// EntityID, EventID etc: site, application, id
+namespace id {
+constexpr std::size_t site = 0;
+constexpr std::size_t application = 2;
+constexpr std::size_t entity = 4;
+constexpr std::size_t size = 6;
+}  // namespace id
+
+namespace entity_state {
+constexpr std::size_t entity_id = 12;
+constexpr std::size_t force_id = 18;
+constexpr std::size_t variable_parameter_count = 19;
+constexpr std::size_t entity_type = 20;
+constexpr std::size_t alternative_entity_type = 28;
+constexpr std::size_t linear_velocity = 36;
+constexpr std::size_t location = 48;
+constexpr std::size_t orientation = 72;
+constexpr std::size_t appearance = 84;
+constexpr std::size_t dr_algorithm = 88;
+constexpr std::size_t dr_parameters_type = 89;
+constexpr std::size_t dr_parameters = 90;  // 14 bytes
+constexpr std::size_t dr_linear_acceleration = 104;
+constexpr std::size_t dr_angular_velocity = 116;
+constexpr std::size_t marking = 128;  // character set + 11 characters
+constexpr std::size_t capabilities = 140;
+constexpr std::size_t variable_parameters = 144;
+constexpr std::size_t variable_parameter_size = 16;
+constexpr std::size_t size = 144;  // without variable parameters
+}  // namespace entity_state
+
+// munition type, warhead, fuse, quantity, rate
+namespace burst_descriptor {
+constexpr std::size_t munition = 0;
+constexpr std::size_t warhead = 8;
+constexpr std::size_t fuse = 10;
+constexpr std::size_t quantity = 12;
+constexpr std::size_t rate = 14;
+constexpr std::size_t size = 16;
+}  // namespace burst_descriptor
+
+namespace fire {
+constexpr std::size_t firing_entity_id = 12;
+constexpr std::size_t target_entity_id = 18;
+constexpr std::size_t munition_id = 24;
+constexpr std::size_t event_id = 30;
+constexpr std::size_t fire_mission_index = 36;
+constexpr std::size_t location = 40;
+constexpr std::size_t burst_descriptor = 64;
+constexpr std::size_t velocity = 80;
+constexpr std::size_t range = 92;
+constexpr std::size_t size = 96;
+}  // namespace fire
+
+namespace detonation {
+constexpr std::size_t firing_entity_id = 12;
+constexpr std::size_t target_entity_id = 18;
+constexpr std::size_t munition_id = 24;
+constexpr std::size_t event_id = 30;
+constexpr std::size_t velocity = 36;
+constexpr std::size_t location = 48;
+constexpr std::size_t burst_descriptor = 72;
+constexpr std::size_t entity_location = 88;
+constexpr std::size_t detonation_result = 100;
+constexpr std::size_t variable_parameter_count = 101;
+constexpr std::size_t variable_parameters = 104;
+constexpr std::size_t size = 104;  // without variable parameters
+}  // namespace detonation
+
+namespace emission {
+constexpr std::size_t emitter_id = 12;
+constexpr std::size_t event_id = 18;
+constexpr std::size_t state_update_indicator = 24;
+constexpr std::size_t system_count = 25;
+constexpr std::size_t systems = 28;
+constexpr std::size_t size = 28;  // without emitter systems
+
+namespace system {
+constexpr std::size_t record_length = 0;  // in 32 bit words
+constexpr std::size_t beam_count = 1;
+constexpr std::size_t emitter_name = 4;
+constexpr std::size_t function = 6;
+constexpr std::size_t emitter_number = 7;
+constexpr std::size_t location = 8;
+constexpr std::size_t beams = 20;
+constexpr std::size_t size = 20;  // without beams
+}  // namespace system
+
+namespace beam {
+constexpr std::size_t record_length = 0;  // in 32 bit words
+constexpr std::size_t beam_number = 1;
+constexpr std::size_t parameter_index = 2;
+constexpr std::size_t fundamental_parameters = 4;  // 5 floats
+constexpr std::size_t beam_data = 24;              // 5 floats
+constexpr std::size_t beam_function = 44;
+constexpr std::size_t number_of_targets = 45;
+constexpr std::size_t high_density_track_jam = 46;
+constexpr std::size_t beam_status = 47;
+constexpr std::size_t jamming_technique = 48;
+constexpr std::size_t track_jams = 52;
+constexpr std::size_t size = 52;  // without track/jam records
+}  // namespace beam
+
+namespace track_jam {
+constexpr std::size_t target = 0;
+constexpr std::size_t emitter_number = 6;
+constexpr std::size_t beam_number = 7;
+constexpr std::size_t size = 8;
+}  // namespace track_jam
+}  // namespace emission
+
+namespace transmitter {
+constexpr std::size_t radio_reference_id = 12;
+constexpr std::size_t radio_number = 18;
+constexpr std::size_t radio_type = 20;
+constexpr std::size_t transmit_state = 28;
+constexpr std::size_t input_source = 29;
+constexpr std::size_t variable_parameter_count = 30;  // DIS 7 only
+constexpr std::size_t antenna_location = 32;
+constexpr std::size_t relative_antenna_location = 56;
+constexpr std::size_t antenna_pattern_type = 68;
+constexpr std::size_t antenna_pattern_count = 70;
+constexpr std::size_t frequency = 72;
+constexpr std::size_t bandwidth = 80;
+constexpr std::size_t power = 84;
+constexpr std::size_t modulation_type = 88;
+constexpr std::size_t crypto_system = 96;
+constexpr std::size_t crypto_key_id = 98;
+constexpr std::size_t modulation_parameter_length = 100;
+constexpr std::size_t modulation_parameters = 104;
+constexpr std::size_t size = 104;  // without variable length fields
+
+// modulation parameters are padded to a 64 bit boundary
+constexpr std::size_t padded(std::size_t n) {
+    return (n + 7) & ~std::size_t{7};
+}
+
+namespace antenna_pattern {
+constexpr std::size_t beam_direction = 0;
+constexpr std::size_t azimuth_beamwidth = 12;
+constexpr std::size_t elevation_beamwidth = 16;
+constexpr std::size_t reference_system = 20;
+constexpr std::size_t e_z = 24;
+constexpr std::size_t e_x = 28;
+constexpr std::size_t phase = 32;
+constexpr std::size_t size = 40;
+}  // namespace antenna_pattern
+
+// record length is the whole record in bytes, including its padding to a
+// 64 bit boundary
+namespace variable_parameter {
+constexpr std::size_t type = 0;
+constexpr std::size_t record_length = 4;
+constexpr std::size_t data = 6;
+constexpr std::size_t size = 6;  // without data
+}  // namespace variable_parameter
+}  // namespace transmitter
+
+namespace signal {
+constexpr std::size_t radio_reference_id = 12;
+constexpr std::size_t radio_number = 18;
+constexpr std::size_t encoding_scheme = 20;
+constexpr std::size_t tdl_type = 22;
+constexpr std::size_t sample_rate = 24;
+constexpr std::size_t data_length = 28;  // in bits
+constexpr std::size_t samples = 30;
+constexpr std::size_t data = 32;
+constexpr std::size_t size = 32;  // without data
+
+// data is padded to a 32 bit boundary
+constexpr std::size_t padded(std::size_t n) {
+    return (n + 3) & ~std::size_t{3};
+}
+}  // namespace signal
+
+};  // namespace csics::lvc::dis::layout
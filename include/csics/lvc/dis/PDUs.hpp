@@ -22,6 +22,8 @@ enum class ProtocolVersion : std::uint8_t {
 enum class PDUType : std::uint8_t {
     Other = 0,
     EntityState = 1,
+    Fire = 2,
+    Detonation = 3,
     ElectromagneticEmission = 23,
     Transmitter = 25,
     Signal = 26,
@@ -142,6 +144,15 @@ struct ID {
     }
     constexpr void id(std::uint16_t entity_id) noexcept { id_ = entity_id; }
 
+    // Site, application and id packed into the low 48 bits in wire order,
+    // for use as a hash or sort key.
+    constexpr std::uint64_t packed() const noexcept {
+        return static_cast<std::uint64_t>(simulation_address.site_id) << 32 |
+               static_cast<std::uint64_t>(simulation_address.application_id)
+                   << 16 |
+               id_;
+    }
+
     bool operator==(const ID& other) const noexcept {
         return simulation_address == other.simulation_address &&
                id_ == other.id_;
@@ -178,6 +189,10 @@ using EntityID = ID;
 using ObjectID = ID;
 using EventID = ID;
 
+constexpr std::uint16_t ALL_APPLIC = 0xFFFF;
+constexpr std::uint16_t ALL_SITES = 0xFFFF;
+constexpr std::uint16_t ALL_ENTITIES = 0xFFFF;
+
 struct PDUHeader {
     ProtocolVersion protocol_version;
     std::uint8_t exercise_id;
@@ -201,6 +216,25 @@ class PDUHeaderView {
     PDUType pdu_type() const noexcept {
         return static_cast<PDUType>(be<std::uint8_t>(buffer_[2]).native());
     };
+    std::uint8_t protocol_family() const noexcept {
+        return be<std::uint8_t>(buffer_[3]).native();
+    }
+    DISTimestamp timestamp() const noexcept {
+        return DISTimestamp(load_big<std::uint32_t>(buffer_.data() + 4));
+    }
+    // PDU length in bytes, as declared in the header
+    std::uint16_t length() const noexcept {
+        return load_big<std::uint16_t>(buffer_.data() + 8);
+    }
+    std::uint8_t status() const noexcept {
+        return be<std::uint8_t>(buffer_[10]).native();
+    }
+
+    // True if the buffer holds a whole header and at least as many bytes as
+    // the header declares.
+    bool valid() const noexcept {
+        return buffer_.size() >= 12 && buffer_.size() >= length();
+    }
 
    private:
     BufferView buffer_;
@@ -340,6 +374,7 @@ struct RadioType6 {
     std::uint8_t entity_kind;
     std::uint8_t domain;
     std::uint16_t country_code;
+    std::uint8_t category;
     std::uint8_t nomenclature_version;
     std::uint16_t nomenclature;
 };
@@ -396,6 +431,61 @@ struct TransmitterPDU {
     Buffer<VariableTransmitterParameters> variable_parameters;
 };
 
+struct BurstDescriptor {
+    EntityType munition;
+    std::uint16_t warhead;
+    std::uint16_t fuse;
+    std::uint16_t quantity;
+    std::uint16_t rate;
+};
+
+struct FirePDU {  // DIS 6 and 7 compatible
+    static constexpr std::size_t pdu_type =
+        static_cast<std::size_t>(PDUType::Fire);
+    PDUHeader header = {ProtocolVersion::IEEE_1278_2012, 0, PDUType::Fire, DISTimestamp(0), 0, 0};
+    EntityID firing_entity_id;
+    EntityID target_entity_id;
+    EntityID munition_id;
+    EventID event_id;
+    std::uint32_t fire_mission_index;
+    WorldCoordinates location;
+    BurstDescriptor burst_descriptor;
+    Vector velocity;
+    float range;
+};
+
+struct DetonationPDU {  // DIS 6 and 7 compatible
+    static constexpr std::size_t pdu_type =
+        static_cast<std::size_t>(PDUType::Detonation);
+    PDUHeader header = {ProtocolVersion::IEEE_1278_2012, 0, PDUType::Detonation, DISTimestamp(0), 0, 0};
+    EntityID firing_entity_id;
+    EntityID target_entity_id;
+    EntityID munition_id;
+    EventID event_id;
+    Vector velocity;
+    WorldCoordinates location;
+    BurstDescriptor burst_descriptor;
+    EntityCoordinates entity_location;  // relative to the target
+    std::uint8_t detonation_result;
+    Buffer<VariableParameters> variable_parameters;
+};
+
+struct SignalPDU {
+    static constexpr std::size_t pdu_type =
+        static_cast<std::size_t>(PDUType::Signal);
+    PDUHeader header = {ProtocolVersion::IEEE_1278_2012, 0, PDUType::Signal, DISTimestamp(0), 0, 0};
+    ID radio_reference_id;  // in DIS 6 this is an **entity id**
+    std::uint16_t radio_number;
+    std::uint16_t encoding_scheme;  // class in the top 2 bits, then type
+    std::uint16_t tdl_type;
+    std::uint32_t sample_rate;
+    std::uint16_t samples;
+    // Encoded audio or data, a whole number of bytes. Not owned: when
+    // deserialized this points into the source datagram, which must outlive
+    // the PDU.
+    BufferView data;
+};
+
 template <typename T>
 struct pdu_type {
     static constexpr PDUType value = PDUType::Other;
@@ -406,6 +496,16 @@ struct pdu_type<EntityStatePDU> {
     static constexpr PDUType value = PDUType::EntityState;
 };
 
+template <>
+struct pdu_type<FirePDU> {
+    static constexpr PDUType value = PDUType::Fire;
+};
+
+template <>
+struct pdu_type<DetonationPDU> {
+    static constexpr PDUType value = PDUType::Detonation;
+};
+
 template <>
 struct pdu_type<ElectromagneticEmissionPDU> {
     static constexpr PDUType value = PDUType::ElectromagneticEmission;
@@ -416,4 +516,9 @@ struct pdu_type<TransmitterPDU> {
     static constexpr PDUType value = PDUType::Transmitter;
 };
 
+template <>
+struct pdu_type<SignalPDU> {
+    static constexpr PDUType value = PDUType::Signal;
+};
+
 };  // namespace csics::lvc::dis
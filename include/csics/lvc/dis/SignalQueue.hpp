@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+#include "csics/queue/SPSCQueue.hpp"
+
+// Hands signal PDU audio from the network thread to a decoding thread
+// through an SPSCQueue. Each queue slot holds a SignalFrame followed by the
+// encoded data, copied straight out of the datagram: one copy per PDU and no
+// allocation on either side.
+//
+//   dispatcher.on<SignalPDU>([&](const SignalPDUView& pdu) {
+//       if (enqueue_signal(writer, pdu) != queue::SPSCError::None) {
+//           ++dropped;
+//       }
+//   });
+//
+//   // decoding thread
+//   queue::SPSCQueue::ReadSlot slot;
+//   while (reader.acquire(slot) == queue::SPSCError::None) {
+//       auto signal = read_signal(slot);
+//       decode(signal.frame, signal.data);
+//       reader.commit(std::move(slot));
+//   }
+namespace csics::lvc::dis {
+
+// The signal header fields a decoder needs, in host byte order.
+struct SignalFrame {
+    std::uint64_t radio;      // radio reference id, as ID::packed()
+    std::uint32_t timestamp;  // raw DIS timestamp
+    std::uint32_t sample_rate;
+    std::uint16_t radio_number;
+    std::uint16_t encoding_scheme;
+    std::uint16_t tdl_type;
+    std::uint16_t samples;
+    std::uint16_t data_length;  // in bits
+};
+
+struct SignalSlot {
+    SignalFrame frame;
+    BufferView data;  // into the queue slot, valid until it is committed
+};
+
+// Copies the frame and data of a valid signal PDU into one queue slot.
+// Returns SPSCError::Full when the decoder has fallen behind, leaving the
+// PDU for the caller to drop or retry.
+inline queue::SPSCError enqueue_signal(queue::SPSCQueue::WriteHandle& writer,
+                                       const SignalPDUView& pdu) noexcept {
+    const BufferView data = pdu.data();
+    queue::SPSCQueue::WriteSlot slot;
+    if (auto err = writer.acquire(slot, sizeof(SignalFrame) + data.size());
+        err != queue::SPSCError::None) {
+        return err;
+    }
+    const SignalFrame frame{pdu.radio_reference_id().packed(),
+                            pdu.header().timestamp().raw(),
+                            pdu.sample_rate(),
+                            pdu.radio_number(),
+                            pdu.encoding_scheme(),
+                            pdu.tdl_type(),
+                            pdu.samples(),
+                            pdu.data_length()};
+    std::memcpy(slot.data, &frame, sizeof(frame));
+    if (!data.empty()) {
+        std::memcpy(slot.data + sizeof(frame), data.data(), data.size());
+    }
+    writer.commit(std::move(slot));
+    return queue::SPSCError::None;
+}
+
+// The frame and data of a slot written by enqueue_signal.
+inline SignalSlot read_signal(
+    const queue::SPSCQueue::ReadSlot& slot) noexcept {
+    SignalSlot out;
+    std::memcpy(&out.frame, slot.data, sizeof(out.frame));
+    out.data = BufferView(reinterpret_cast<const char*>(slot.data) +
+                              sizeof(out.frame),
+                          slot.size - sizeof(out.frame));
+    return out;
+}
+
+};  // namespace csics::lvc::dis
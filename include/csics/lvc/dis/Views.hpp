@@ -0,0 +1,841 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include "csics/Bit.hpp"
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/Layout.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+
+// Zero-copy views over DIS PDUs. Fields are decoded from the wire buffer on
+// access, and variable-length records (variable parameters, emitter
+// systems, beams, track/jams, antenna patterns) are walked lazily, so a
+// filter reading a couple of fields touches only those bytes and never
+// allocates. Views do not own the buffer.
+//
+// Construct a view, check valid() once, then read fields. valid() checks the
+// fixed part and the PDU type; record ranges additionally stop at the end of
+// the buffer, so a truncated PDU yields fewer records rather than reading
+// out of bounds.
+namespace csics::lvc::dis {
+
+namespace detail {
+template <typename T>
+inline T field(BufferView bv, std::size_t offset) noexcept {
+    return load_big<T>(bv.data() + offset);
+}
+
+inline EntityID id_field(BufferView bv, std::size_t offset) noexcept {
+    return EntityID(field<std::uint16_t>(bv, offset + layout::id::site),
+                    field<std::uint16_t>(bv, offset + layout::id::application),
+                    field<std::uint16_t>(bv, offset + layout::id::entity));
+}
+
+inline EntityType entity_type_field(BufferView bv,
+                                    std::size_t offset) noexcept {
+    return EntityType{field<std::uint8_t>(bv, offset),
+                      field<std::uint8_t>(bv, offset + 1),
+                      field<std::uint16_t>(bv, offset + 2),
+                      field<std::uint8_t>(bv, offset + 4),
+                      field<std::uint8_t>(bv, offset + 5),
+                      field<std::uint8_t>(bv, offset + 6),
+                      field<std::uint8_t>(bv, offset + 7)};
+}
+
+inline Vector vector_field(BufferView bv, std::size_t offset) noexcept {
+    return Vector(field<float>(bv, offset), field<float>(bv, offset + 4),
+                  field<float>(bv, offset + 8));
+}
+
+inline WorldCoordinates world_field(BufferView bv,
+                                    std::size_t offset) noexcept {
+    return WorldCoordinates(field<double>(bv, offset),
+                            field<double>(bv, offset + 8),
+                            field<double>(bv, offset + 16));
+}
+
+inline EulerAngles euler_field(BufferView bv, std::size_t offset) noexcept {
+    return EulerAngles(field<float>(bv, offset), field<float>(bv, offset + 4),
+                       field<float>(bv, offset + 8));
+}
+
+inline BurstDescriptor burst_field(BufferView bv, std::size_t offset) noexcept {
+    using namespace layout::burst_descriptor;
+    return BurstDescriptor{entity_type_field(bv, offset + munition),
+                           field<std::uint16_t>(bv, offset + warhead),
+                           field<std::uint16_t>(bv, offset + fuse),
+                           field<std::uint16_t>(bv, offset + quantity),
+                           field<std::uint16_t>(bv, offset + rate)};
+}
+}  // namespace detail
+
+// Lazy forward range over `count` consecutive variable-size records. Record
+// must be constructible from the BufferView starting at the record and
+// provide min_size and size_bytes(). Iteration ends early if a record would
+// run past the end of the buffer.
+template <typename Record>
+class RecordRange {
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Record;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(BufferView rest, std::size_t remaining)
+            : rest_(rest), remaining_(remaining) {
+            check();
+        }
+
+        Record operator*() const noexcept { return Record(rest_); }
+
+        iterator& operator++() noexcept {
+            rest_ += Record(rest_).size_bytes();
+            --remaining_;
+            check();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const iterator& o) const noexcept {
+            return remaining_ == o.remaining_;
+        }
+
+       private:
+        BufferView rest_;
+        std::size_t remaining_ = 0;
+
+        void check() noexcept {
+            if (remaining_ == 0) {
+                return;
+            }
+            if (rest_.size() < Record::min_size) {
+                remaining_ = 0;
+                return;
+            }
+            const std::size_t n = Record(rest_).size_bytes();
+            if (n < Record::min_size || n > rest_.size()) {
+                remaining_ = 0;
+            }
+        }
+    };
+
+    RecordRange() = default;
+    RecordRange(BufferView data, std::size_t count)
+        : data_(data), count_(count) {}
+
+    iterator begin() const noexcept { return iterator(data_, count_); }
+    iterator end() const noexcept { return iterator(); }
+
+    // Declared number of records; iteration yields fewer if truncated.
+    std::size_t size() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+
+    // Bytes spanned by the records that fit in the buffer.
+    std::size_t size_bytes() const noexcept {
+        std::size_t n = 0;
+        for (auto r : *this) {
+            n += r.size_bytes();
+        }
+        return n;
+    }
+
+   private:
+    BufferView data_;
+    std::size_t count_ = 0;
+};
+
+class VariableParameterView {
+   public:
+    static constexpr std::size_t min_size =
+        layout::entity_state::variable_parameter_size;
+
+    explicit VariableParameterView(BufferView bv) : bv_(bv) {}
+
+    std::uint8_t type() const noexcept {
+        return detail::field<std::uint8_t>(bv_, 0);
+    }
+    BufferView data() const noexcept { return bv_.subview(1, min_size - 1); }
+    std::size_t size_bytes() const noexcept { return min_size; }
+
+    VariableParameters value() const noexcept {
+        VariableParameters v;
+        v.type = type();
+        std::memcpy(v.data, bv_.data() + 1, sizeof(v.data));
+        return v;
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class EntityStatePDUView {
+   public:
+    explicit EntityStatePDUView(BufferView bv) : bv_(bv) {}
+
+    bool valid() const noexcept {
+        return bv_.size() >= layout::entity_state::size &&
+               header().pdu_type() == PDUType::EntityState;
+    }
+
+    PDUHeaderView header() const noexcept { return PDUHeaderView(bv_); }
+    BufferView buffer() const noexcept { return bv_; }
+
+    EntityID entity_id() const noexcept {
+        return detail::id_field(bv_, layout::entity_state::entity_id);
+    }
+    std::uint8_t force_id() const noexcept {
+        return detail::field<std::uint8_t>(bv_, layout::entity_state::force_id);
+    }
+    std::uint8_t variable_parameter_count() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::entity_state::variable_parameter_count);
+    }
+    EntityType entity_type() const noexcept {
+        return detail::entity_type_field(bv_,
+                                         layout::entity_state::entity_type);
+    }
+    EntityType alternative_entity_type() const noexcept {
+        return detail::entity_type_field(
+            bv_, layout::entity_state::alternative_entity_type);
+    }
+    Vector linear_velocity() const noexcept {
+        return detail::vector_field(bv_, layout::entity_state::linear_velocity);
+    }
+    WorldCoordinates location() const noexcept {
+        return detail::world_field(bv_, layout::entity_state::location);
+    }
+    EulerAngles orientation() const noexcept {
+        return detail::euler_field(bv_, layout::entity_state::orientation);
+    }
+    std::uint32_t appearance() const noexcept {
+        return detail::field<std::uint32_t>(bv_,
+                                            layout::entity_state::appearance);
+    }
+    std::uint8_t dr_algorithm() const noexcept {
+        return detail::field<std::uint8_t>(bv_,
+                                           layout::entity_state::dr_algorithm);
+    }
+    Vector dr_linear_acceleration() const noexcept {
+        return detail::vector_field(
+            bv_, layout::entity_state::dr_linear_acceleration);
+    }
+    Vector dr_angular_velocity() const noexcept {
+        return detail::vector_field(bv_,
+                                    layout::entity_state::dr_angular_velocity);
+    }
+
+    DeadReckoningParameters dr_parameters() const noexcept {
+        const std::size_t o = layout::entity_state::dr_parameters;
+        DeadReckoningParameters dr;
+        dr.algorithm = dr_algorithm();
+        dr.params_type = detail::field<std::uint8_t>(
+            bv_, layout::entity_state::dr_parameters_type);
+        if (dr.params_type == 1) {
+            dr.fixed.local_angles = detail::euler_field(bv_, o + 2);
+        } else if (dr.params_type == 2) {
+            dr.rotating.quat = DISQuat(detail::field<std::uint16_t>(bv_, o),
+                                       detail::field<float>(bv_, o + 2),
+                                       detail::field<float>(bv_, o + 6),
+                                       detail::field<float>(bv_, o + 10));
+        }
+        dr.linear_acceleration = dr_linear_acceleration();
+        dr.angular_velocity = dr_angular_velocity();
+        return dr;
+    }
+
+    EntityMarking marking() const noexcept {
+        EntityMarking m;
+        m.character_set =
+            detail::field<std::uint8_t>(bv_, layout::entity_state::marking);
+        std::memcpy(m.marking, bv_.data() + layout::entity_state::marking + 1,
+                    sizeof(m.marking));
+        return m;
+    }
+    // The marking characters, without trailing NULs.
+    std::string_view marking_text() const noexcept {
+        const char* p = bv_.data() + layout::entity_state::marking + 1;
+        std::size_t n = 0;
+        while (n < 11 && p[n] != '\0') {
+            ++n;
+        }
+        return {p, n};
+    }
+    std::uint32_t capabilities() const noexcept {
+        return detail::field<std::uint32_t>(bv_,
+                                            layout::entity_state::capabilities);
+    }
+
+    RecordRange<VariableParameterView> variable_parameters() const noexcept {
+        return {bv_ + layout::entity_state::variable_parameters,
+                variable_parameter_count()};
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class FirePDUView {
+   public:
+    explicit FirePDUView(BufferView bv) : bv_(bv) {}
+
+    bool valid() const noexcept {
+        return bv_.size() >= layout::fire::size &&
+               header().pdu_type() == PDUType::Fire;
+    }
+
+    PDUHeaderView header() const noexcept { return PDUHeaderView(bv_); }
+    BufferView buffer() const noexcept { return bv_; }
+
+    EntityID firing_entity_id() const noexcept {
+        return detail::id_field(bv_, layout::fire::firing_entity_id);
+    }
+    EntityID target_entity_id() const noexcept {
+        return detail::id_field(bv_, layout::fire::target_entity_id);
+    }
+    EntityID munition_id() const noexcept {
+        return detail::id_field(bv_, layout::fire::munition_id);
+    }
+    EventID event_id() const noexcept {
+        return detail::id_field(bv_, layout::fire::event_id);
+    }
+    std::uint32_t fire_mission_index() const noexcept {
+        return detail::field<std::uint32_t>(bv_,
+                                            layout::fire::fire_mission_index);
+    }
+    WorldCoordinates location() const noexcept {
+        return detail::world_field(bv_, layout::fire::location);
+    }
+    BurstDescriptor burst_descriptor() const noexcept {
+        return detail::burst_field(bv_, layout::fire::burst_descriptor);
+    }
+    Vector velocity() const noexcept {
+        return detail::vector_field(bv_, layout::fire::velocity);
+    }
+    float range() const noexcept {
+        return detail::field<float>(bv_, layout::fire::range);
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class DetonationPDUView {
+   public:
+    explicit DetonationPDUView(BufferView bv) : bv_(bv) {}
+
+    bool valid() const noexcept {
+        return bv_.size() >= layout::detonation::size &&
+               header().pdu_type() == PDUType::Detonation;
+    }
+
+    PDUHeaderView header() const noexcept { return PDUHeaderView(bv_); }
+    BufferView buffer() const noexcept { return bv_; }
+
+    EntityID firing_entity_id() const noexcept {
+        return detail::id_field(bv_, layout::detonation::firing_entity_id);
+    }
+    EntityID target_entity_id() const noexcept {
+        return detail::id_field(bv_, layout::detonation::target_entity_id);
+    }
+    EntityID munition_id() const noexcept {
+        return detail::id_field(bv_, layout::detonation::munition_id);
+    }
+    EventID event_id() const noexcept {
+        return detail::id_field(bv_, layout::detonation::event_id);
+    }
+    Vector velocity() const noexcept {
+        return detail::vector_field(bv_, layout::detonation::velocity);
+    }
+    WorldCoordinates location() const noexcept {
+        return detail::world_field(bv_, layout::detonation::location);
+    }
+    BurstDescriptor burst_descriptor() const noexcept {
+        return detail::burst_field(bv_, layout::detonation::burst_descriptor);
+    }
+    EntityCoordinates entity_location() const noexcept {
+        return detail::vector_field(bv_, layout::detonation::entity_location);
+    }
+    std::uint8_t detonation_result() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::detonation::detonation_result);
+    }
+    std::uint8_t variable_parameter_count() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::detonation::variable_parameter_count);
+    }
+
+    RecordRange<VariableParameterView> variable_parameters() const noexcept {
+        return {bv_ + layout::detonation::variable_parameters,
+                variable_parameter_count()};
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class TrackJamView {
+   public:
+    static constexpr std::size_t min_size = layout::emission::track_jam::size;
+
+    explicit TrackJamView(BufferView bv) : bv_(bv) {}
+
+    EntityID target() const noexcept {
+        return detail::id_field(bv_, layout::emission::track_jam::target);
+    }
+    std::uint8_t emitter_number() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::track_jam::emitter_number);
+    }
+    std::uint8_t beam_number() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::track_jam::beam_number);
+    }
+    std::size_t size_bytes() const noexcept { return min_size; }
+
+    TrackJam value() const noexcept {
+        return TrackJam{target(), emitter_number(), beam_number()};
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class BeamView {
+   public:
+    static constexpr std::size_t min_size = layout::emission::beam::size;
+
+    explicit BeamView(BufferView bv) : bv_(bv) {}
+
+    // Record length in 32 bit words, including the track/jam records.
+    std::uint8_t record_length() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::beam::record_length);
+    }
+    std::size_t size_bytes() const noexcept { return record_length() * 4u; }
+
+    std::uint8_t beam_number() const noexcept {
+        return detail::field<std::uint8_t>(bv_,
+                                           layout::emission::beam::beam_number);
+    }
+    std::uint16_t parameter_index() const noexcept {
+        return detail::field<std::uint16_t>(
+            bv_, layout::emission::beam::parameter_index);
+    }
+    EEFundamentalParameterData fundamental_parameters() const noexcept {
+        const std::size_t o = layout::emission::beam::fundamental_parameters;
+        return {detail::field<float>(bv_, o), detail::field<float>(bv_, o + 4),
+                detail::field<float>(bv_, o + 8),
+                detail::field<float>(bv_, o + 12),
+                detail::field<float>(bv_, o + 16)};
+    }
+    BeamData beam_data() const noexcept {
+        const std::size_t o = layout::emission::beam::beam_data;
+        return {detail::field<float>(bv_, o), detail::field<float>(bv_, o + 4),
+                detail::field<float>(bv_, o + 8),
+                detail::field<float>(bv_, o + 12),
+                detail::field<float>(bv_, o + 16)};
+    }
+    std::uint8_t beam_function() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::beam::beam_function);
+    }
+    std::uint8_t number_of_targets() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::beam::number_of_targets);
+    }
+    std::uint8_t high_density_track_jam() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::beam::high_density_track_jam);
+    }
+    std::uint8_t beam_status() const noexcept {
+        return detail::field<std::uint8_t>(bv_,
+                                           layout::emission::beam::beam_status);
+    }
+    JammingTechnique jamming_technique() const noexcept {
+        const std::size_t o = layout::emission::beam::jamming_technique;
+        return {detail::field<std::uint8_t>(bv_, o),
+                detail::field<std::uint8_t>(bv_, o + 1),
+                detail::field<std::uint8_t>(bv_, o + 2),
+                detail::field<std::uint8_t>(bv_, o + 3)};
+    }
+
+    // As in deserialize_direct, the number of track/jam records follows
+    // from the record length.
+    RecordRange<TrackJamView> track_jams() const noexcept {
+        const std::size_t n = size_bytes();
+        const std::size_t count =
+            n > min_size ? (n - min_size) / layout::emission::track_jam::size
+                         : 0;
+        return {bv_.subview(layout::emission::beam::track_jams, n - min_size),
+                count};
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class EmitterSystemView {
+   public:
+    static constexpr std::size_t min_size = layout::emission::system::size;
+
+    explicit EmitterSystemView(BufferView bv) : bv_(bv) {}
+
+    std::uint8_t record_length() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::system::record_length);
+    }
+    std::uint8_t beam_count() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::system::beam_count);
+    }
+    std::uint16_t emitter_name() const noexcept {
+        return detail::field<std::uint16_t>(
+            bv_, layout::emission::system::emitter_name);
+    }
+    std::uint8_t function() const noexcept {
+        return detail::field<std::uint8_t>(bv_,
+                                           layout::emission::system::function);
+    }
+    std::uint8_t emitter_number() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::system::emitter_number);
+    }
+    EntityCoordinates location() const noexcept {
+        return detail::vector_field(bv_, layout::emission::system::location);
+    }
+
+    RecordRange<BeamView> beams() const noexcept {
+        return {bv_ + layout::emission::system::beams, beam_count()};
+    }
+
+    // The 8 bit record length overflows for systems with many beams, so the
+    // size is measured by walking the beams instead.
+    std::size_t size_bytes() const noexcept {
+        return min_size + beams().size_bytes();
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class ElectromagneticEmissionPDUView {
+   public:
+    explicit ElectromagneticEmissionPDUView(BufferView bv) : bv_(bv) {}
+
+    bool valid() const noexcept {
+        return bv_.size() >= layout::emission::size &&
+               header().pdu_type() == PDUType::ElectromagneticEmission;
+    }
+
+    PDUHeaderView header() const noexcept { return PDUHeaderView(bv_); }
+    BufferView buffer() const noexcept { return bv_; }
+
+    EntityID emitter_id() const noexcept {
+        return detail::id_field(bv_, layout::emission::emitter_id);
+    }
+    EventID event_id() const noexcept {
+        return detail::id_field(bv_, layout::emission::event_id);
+    }
+    std::uint8_t state_update_indicator() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::emission::state_update_indicator);
+    }
+    std::uint8_t system_count() const noexcept {
+        return detail::field<std::uint8_t>(bv_, layout::emission::system_count);
+    }
+
+    RecordRange<EmitterSystemView> systems() const noexcept {
+        return {bv_ + layout::emission::systems, system_count()};
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class AntennaPatternView {
+   public:
+    static constexpr std::size_t min_size =
+        layout::transmitter::antenna_pattern::size;
+
+    explicit AntennaPatternView(BufferView bv) : bv_(bv) {}
+
+    std::size_t size_bytes() const noexcept { return min_size; }
+
+    BeamAntennaPattern value() const noexcept {
+        using namespace layout::transmitter::antenna_pattern;
+        return BeamAntennaPattern{
+            detail::euler_field(bv_, beam_direction),
+            detail::field<float>(bv_, azimuth_beamwidth),
+            detail::field<float>(bv_, elevation_beamwidth),
+            detail::field<std::uint8_t>(bv_, reference_system),
+            detail::field<float>(bv_, e_z),
+            detail::field<float>(bv_, e_x),
+            detail::field<float>(bv_, phase)};
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class VariableTransmitterParameterView {
+   public:
+    static constexpr std::size_t min_size =
+        layout::transmitter::variable_parameter::size;
+
+    explicit VariableTransmitterParameterView(BufferView bv) : bv_(bv) {}
+
+    std::uint32_t type() const noexcept {
+        return detail::field<std::uint32_t>(
+            bv_, layout::transmitter::variable_parameter::type);
+    }
+    // Whole record in bytes, including padding.
+    std::size_t size_bytes() const noexcept {
+        return detail::field<std::uint16_t>(
+            bv_, layout::transmitter::variable_parameter::record_length);
+    }
+    // Record data including any trailing padding.
+    BufferView data() const noexcept {
+        return bv_.subview(min_size, size_bytes() - min_size);
+    }
+
+   private:
+    BufferView bv_;
+};
+
+class TransmitterPDUView {
+   public:
+    explicit TransmitterPDUView(BufferView bv) : bv_(bv) {}
+
+    bool valid() const noexcept {
+        return bv_.size() >= layout::transmitter::size &&
+               header().pdu_type() == PDUType::Transmitter &&
+               bv_.size() >= antenna_patterns_offset();
+    }
+
+    PDUHeaderView header() const noexcept { return PDUHeaderView(bv_); }
+    BufferView buffer() const noexcept { return bv_; }
+
+    ID radio_reference_id() const noexcept {
+        return detail::id_field(bv_, layout::transmitter::radio_reference_id);
+    }
+    std::uint16_t radio_number() const noexcept {
+        return detail::field<std::uint16_t>(bv_,
+                                            layout::transmitter::radio_number);
+    }
+    RadioType radio_type() const noexcept {
+        const std::size_t o = layout::transmitter::radio_type;
+        RadioType t;
+        if (header().protocol_version() == ProtocolVersion::IEEE_1278_1998) {
+            t.dis6 = RadioType6{detail::field<std::uint8_t>(bv_, o),
+                                detail::field<std::uint8_t>(bv_, o + 1),
+                                detail::field<std::uint16_t>(bv_, o + 2),
+                                detail::field<std::uint8_t>(bv_, o + 4),
+                                detail::field<std::uint8_t>(bv_, o + 5),
+                                detail::field<std::uint16_t>(bv_, o + 6)};
+        } else {
+            t.dis7 = RadioType7{detail::field<std::uint8_t>(bv_, o),
+                                detail::field<std::uint8_t>(bv_, o + 1),
+                                detail::field<std::uint16_t>(bv_, o + 2),
+                                detail::field<std::uint8_t>(bv_, o + 4),
+                                detail::field<std::uint8_t>(bv_, o + 5),
+                                detail::field<std::uint8_t>(bv_, o + 6),
+                                detail::field<std::uint8_t>(bv_, o + 7)};
+        }
+        return t;
+    }
+    std::uint8_t transmit_state() const noexcept {
+        return detail::field<std::uint8_t>(bv_,
+                                           layout::transmitter::transmit_state);
+    }
+    std::uint8_t input_source() const noexcept {
+        return detail::field<std::uint8_t>(bv_,
+                                           layout::transmitter::input_source);
+    }
+    // Always 0 for DIS 6, where the field is padding.
+    std::uint16_t variable_parameter_count() const noexcept {
+        if (header().protocol_version() == ProtocolVersion::IEEE_1278_1998) {
+            return 0;
+        }
+        return detail::field<std::uint16_t>(
+            bv_, layout::transmitter::variable_parameter_count);
+    }
+    WorldCoordinates antenna_location() const noexcept {
+        return detail::world_field(bv_, layout::transmitter::antenna_location);
+    }
+    EntityCoordinates relative_antenna_location() const noexcept {
+        return detail::vector_field(
+            bv_, layout::transmitter::relative_antenna_location);
+    }
+    std::uint16_t antenna_pattern_type() const noexcept {
+        return detail::field<std::uint16_t>(
+            bv_, layout::transmitter::antenna_pattern_type);
+    }
+    std::uint16_t antenna_pattern_count() const noexcept {
+        return detail::field<std::uint16_t>(
+            bv_, layout::transmitter::antenna_pattern_count);
+    }
+    std::uint64_t frequency() const noexcept {
+        return detail::field<std::uint64_t>(bv_,
+                                            layout::transmitter::frequency);
+    }
+    float bandwidth() const noexcept {
+        return detail::field<float>(bv_, layout::transmitter::bandwidth);
+    }
+    float power() const noexcept {
+        return detail::field<float>(bv_, layout::transmitter::power);
+    }
+    ModulationType modulation_type() const noexcept {
+        const std::size_t o = layout::transmitter::modulation_type;
+        return {detail::field<std::uint16_t>(bv_, o),
+                detail::field<std::uint16_t>(bv_, o + 2),
+                detail::field<std::uint16_t>(bv_, o + 4),
+                detail::field<std::uint16_t>(bv_, o + 6)};
+    }
+    std::uint16_t crypto_system() const noexcept {
+        return detail::field<std::uint16_t>(bv_,
+                                            layout::transmitter::crypto_system);
+    }
+    std::uint16_t crypto_key_id() const noexcept {
+        return detail::field<std::uint16_t>(bv_,
+                                            layout::transmitter::crypto_key_id);
+    }
+    std::uint8_t modulation_parameter_length() const noexcept {
+        return detail::field<std::uint8_t>(
+            bv_, layout::transmitter::modulation_parameter_length);
+    }
+    BufferView modulation_parameters() const noexcept {
+        return bv_.subview(layout::transmitter::modulation_parameters,
+                           modulation_parameter_length());
+    }
+
+    RecordRange<AntennaPatternView> antenna_patterns() const noexcept {
+        return {bv_ + antenna_patterns_offset(), antenna_pattern_count()};
+    }
+
+    RecordRange<VariableTransmitterParameterView> variable_parameters()
+        const noexcept {
+        return {bv_ + antenna_patterns_offset() +
+                    antenna_pattern_count() *
+                        layout::transmitter::antenna_pattern::size,
+                variable_parameter_count()};
+    }
+
+   private:
+    BufferView bv_;
+
+    std::size_t antenna_patterns_offset() const noexcept {
+        return layout::transmitter::modulation_parameters +
+               layout::transmitter::padded(modulation_parameter_length());
+    }
+};
+
+// The encoded audio (or tactical data link message) of a signal PDU is
+// data(), a view into the datagram: hand it to a decoder or copy it into a
+// queue slot without going through an owned SignalPDU.
+class SignalPDUView {
+   public:
+    explicit SignalPDUView(BufferView bv) : bv_(bv) {}
+
+    bool valid() const noexcept {
+        return bv_.size() >= layout::signal::size &&
+               header().pdu_type() == PDUType::Signal &&
+               bv_.size() >= layout::signal::data + data_bytes();
+    }
+
+    PDUHeaderView header() const noexcept { return PDUHeaderView(bv_); }
+    BufferView buffer() const noexcept { return bv_; }
+
+    ID radio_reference_id() const noexcept {
+        return detail::id_field(bv_, layout::signal::radio_reference_id);
+    }
+    std::uint16_t radio_number() const noexcept {
+        return detail::field<std::uint16_t>(bv_, layout::signal::radio_number);
+    }
+    std::uint16_t encoding_scheme() const noexcept {
+        return detail::field<std::uint16_t>(bv_,
+                                            layout::signal::encoding_scheme);
+    }
+    // Top two bits of the encoding scheme: 0 for encoded audio.
+    std::uint8_t encoding_class() const noexcept {
+        return static_cast<std::uint8_t>(encoding_scheme() >> 14);
+    }
+    // Low 14 bits of the encoding scheme, e.g. 4 for 16 bit linear PCM.
+    std::uint16_t encoding_type() const noexcept {
+        return encoding_scheme() & 0x3FFF;
+    }
+    std::uint16_t tdl_type() const noexcept {
+        return detail::field<std::uint16_t>(bv_, layout::signal::tdl_type);
+    }
+    std::uint32_t sample_rate() const noexcept {
+        return detail::field<std::uint32_t>(bv_, layout::signal::sample_rate);
+    }
+    // Length of the data in bits.
+    std::uint16_t data_length() const noexcept {
+        return detail::field<std::uint16_t>(bv_, layout::signal::data_length);
+    }
+    std::uint16_t samples() const noexcept {
+        return detail::field<std::uint16_t>(bv_, layout::signal::samples);
+    }
+
+    // The data, rounded up to whole bytes.
+    BufferView data() const noexcept {
+        return bv_.subview(layout::signal::data, data_bytes());
+    }
+
+   private:
+    BufferView bv_;
+
+    std::size_t data_bytes() const noexcept {
+        return (std::size_t{data_length()} + 7) / 8;
+    }
+};
+
+// View type for a PDU, e.g. pdu_view_t<EntityStatePDU> is EntityStatePDUView.
+template <typename PDU>
+struct pdu_view {};
+
+template <>
+struct pdu_view<EntityStatePDU> {
+    using type = EntityStatePDUView;
+};
+
+template <>
+struct pdu_view<FirePDU> {
+    using type = FirePDUView;
+};
+
+template <>
+struct pdu_view<DetonationPDU> {
+    using type = DetonationPDUView;
+};
+
+template <>
+struct pdu_view<ElectromagneticEmissionPDU> {
+    using type = ElectromagneticEmissionPDUView;
+};
+
+template <>
+struct pdu_view<TransmitterPDU> {
+    using type = TransmitterPDUView;
+};
+
+template <>
+struct pdu_view<SignalPDU> {
+    using type = SignalPDUView;
+};
+
+template <typename PDU>
+using pdu_view_t = typename pdu_view<PDU>::type;
+
+};  // namespace csics::lvc::dis
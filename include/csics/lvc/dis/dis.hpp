@@ -1,13 +1,19 @@
 #pragma once
 
-#include <cstdint>
-namespace csics::lvc::dis {
-    constexpr std::uint16_t ALL_APPLIC = 0xFFFF;
-    constexpr std::uint16_t ALL_SITES = 0xFFFF;
-    constexpr std::uint16_t ALL_ENTITIES = 0xFFFF;
-};
-
+#include "csics/lvc/dis/Layout.hpp"
 #include "csics/lvc/dis/PDUs.hpp"
 #include "csics/lvc/dis/Time.hpp"
 #include "csics/lvc/dis/DISDispatch.hpp"
+#include "csics/lvc/dis/Bundle.hpp"
+#ifdef CSICS_BUILD_IO
+#include "csics/lvc/dis/Capture.hpp"
+#endif
+#include "csics/lvc/dis/DeadReckoning.hpp"
+#include "csics/lvc/dis/EntityIDMap.hpp"
+#include "csics/lvc/dis/EntityTable.hpp"
+#include "csics/lvc/dis/FixedLayout.hpp"
 #include "csics/lvc/dis/serde.hpp"
+#ifdef CSICS_BUILD_QUEUE
+#include "csics/lvc/dis/SignalQueue.hpp"
+#endif
+#include "csics/lvc/dis/Views.hpp"
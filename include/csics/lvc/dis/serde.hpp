@@ -1,14 +1,18 @@
 #pragma once
 #include <cassert>
+#include <cstring>
 
 #include "PDUs.hpp"
 #include "csics/lvc/dis/PDUs.hpp"
 #include "csics/serialization/serialization.hpp"
 
 namespace csics::lvc::dis {
-// TODO:
-// FIX ERROR HANDLING
-// CURRENTLY ERROR HANDLING SUCKS IN HERE
+namespace detail {
+using serialization::first_error;
+using serialization::invalid_data;
+using serialization::make_buffer;
+using serialization::tag_field;
+}  // namespace detail
 
 template <typename PDU>
 constexpr size_t pdu_size_calc(const PDU&);
@@ -44,21 +48,36 @@ inline size_t pdu_size_calc(const ElectromagneticEmissionPDU& pdu) {
 
 template <>
 inline size_t pdu_size_calc(const TransmitterPDU& pdu) {
-    size_t m = pdu.modulation_parameters.size() + 8 -
-               (pdu.modulation_parameters.size() %
-                8);  // modulation parameters are padded to the next byte
+    // modulation parameters are padded to the next 64 bit boundary
+    size_t m = (pdu.modulation_parameters.size() + 7) / 8 * 8;
     size_t size_bits = 832 + m * 8 + pdu.antenna_patterns.size() * 320;
 
     for (const auto& var_param : pdu.variable_parameters) {
-        // data: K_i + P_i, where K_i is the size of the data in bits and P_i is
-        // the padding
-        size_bits +=
-            var_param.data.size() * 8 + (8 - (var_param.data.size() % 8));
+        // 48 bit type and length, then the data padded so the whole record
+        // ends on a 64 bit boundary
+        size_bits += (6 + var_param.data.size() + 7) / 8 * 64;
     }
 
     return size_bits / 8;  // convert bits to bytes
 }
 
+template <>
+constexpr inline size_t pdu_size_calc(const FirePDU&) {
+    return 768 / 8;  // FirePDU is 768 bits
+}
+
+template <>
+constexpr inline size_t pdu_size_calc(const DetonationPDU& pdu) {
+    // 832 bits + 128 bits per variable parameter
+    return (832 + 128 * pdu.variable_parameters.size()) / 8;
+}
+
+template <>
+inline size_t pdu_size_calc(const SignalPDU& pdu) {
+    // 256 bits, then the data padded to a 32 bit boundary
+    return 32 + (pdu.data.size() + 3) / 4 * 4;
+}
+
 template <serialization::WireSerializer S>
 constexpr void serialize_pdu_header(S& s, MutableBufferView& bv,
                                     const PDUHeader& pdu,
@@ -86,9 +105,12 @@ expected<PDUHeader, typename D::error_type> deserialize_direct(
     auto status = d.template read<std::uint8_t>();
     std::ignore = d.template read<std::uint8_t>();  // padding
 
-    if (!protocol_version || !exercise_id || !pdu_type || !protocol_family ||
-        !timestamp || !pdu_length || !status) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "protocol_version", protocol_version, "exercise_id", exercise_id,
+            "pdu_type", pdu_type, "protocol_family", protocol_family,
+            "timestamp", timestamp, "pdu_length", pdu_length,
+            "status", status)) {
+        return *err;
     }
 
     return PDUHeader{static_cast<ProtocolVersion>(*protocol_version),
@@ -118,8 +140,10 @@ expected<EntityID, typename D::error_type> deserialize_direct(
     auto application_id = d.template read<be<std::uint16_t>>();
     auto entity_id = d.template read<be<std::uint16_t>>();
 
-    if (!site_id || !application_id || !entity_id) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "site_id", site_id, "application_id", application_id,
+            "entity_id", entity_id)) {
+        return *err;
     }
 
     return EntityID(site_id->native(), application_id->native(),
@@ -153,9 +177,11 @@ expected<EntityType, typename D::error_type> deserialize_direct(
     auto specific = d.template read<std::uint8_t>();
     auto extra = d.template read<std::uint8_t>();
 
-    if (!kind || !domain || !country || !category || !subcategory ||
-        !specific || !extra) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "kind", kind, "domain", domain, "country", country,
+            "category", category, "subcategory", subcategory,
+            "specific", specific, "extra", extra)) {
+        return *err;
     }
 
     return EntityType{*kind,     *domain,      country->native(),
@@ -181,8 +207,9 @@ expected<Vector, typename D::error_type> deserialize_direct(
     auto y = d.template read<be<float>>();
     auto z = d.template read<be<float>>();
 
-    if (!x || !y || !z) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "x", x, "y", y, "z", z)) {
+        return *err;
     }
 
     return Vector(x->native(), y->native(), z->native());
@@ -206,8 +233,9 @@ expected<WorldCoordinates, typename D::error_type> deserialize_direct(
     auto y = d.template read<be<double>>();
     auto z = d.template read<be<double>>();
 
-    if (!x || !y || !z) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "x", x, "y", y, "z", z)) {
+        return *err;
     }
 
     return WorldCoordinates(x->native(), y->native(), z->native());
@@ -231,8 +259,9 @@ expected<EulerAngles, typename D::error_type> deserialize_direct(
     auto theta = d.template read<be<float>>();
     auto phi = d.template read<be<float>>();
 
-    if (!psi || !theta || !phi) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "psi", psi, "theta", theta, "phi", phi)) {
+        return *err;
     }
 
     return EulerAngles(psi->native(), theta->native(), phi->native());
@@ -258,8 +287,9 @@ expected<DISQuat, typename D::error_type> deserialize_direct(
     auto y = d.template read<be<float>>();
     auto z = d.template read<be<float>>();
 
-    if (!u0 || !x || !y || !z) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "u0", u0, "x", x, "y", y, "z", z)) {
+        return *err;
     }
 
     return DISQuat{u0->native(), x->native(), y->native(), z->native()};
@@ -294,8 +324,9 @@ expected<DeadReckoningParameters, typename D::error_type> deserialize_direct(
     auto algorithm = d.template read<std::uint8_t>();
     auto params_type = d.template read<std::uint8_t>();
 
-    if (!algorithm || !params_type) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "algorithm", algorithm, "params_type", params_type)) {
+        return *err;
     }
 
     DeadReckoningParameters params;
@@ -308,21 +339,20 @@ expected<DeadReckoningParameters, typename D::error_type> deserialize_direct(
         auto local_angles = deserialize_direct(
             d, serialization::detail::type_tag<EulerAngles>{});
         if (!local_angles) {
-            return unexpect;
+            return detail::tag_field(local_angles.error(), "dr_parameters.local_angles");
         }
         params.fixed.local_angles = *local_angles;
     } else if (params.params_type == 2) {
         auto quat =
             deserialize_direct(d, serialization::detail::type_tag<DISQuat>{});
         if (!quat) {
-            return unexpect;
+            return detail::tag_field(quat.error(), "dr_parameters.quat");
         }
         params.rotating.quat = *quat;
     } else {
         // this should never happen, but if it does, we just leave the
         // parameters as zeros
-        std::ignore = d.template read<std::uint64_t>();  // pad to align the
-                                                         // linear acceleration
+        std::ignore = d.skip(14);  // pad to align the linear acceleration
     }
 
     auto linear_acceleration =
@@ -330,8 +360,10 @@ expected<DeadReckoningParameters, typename D::error_type> deserialize_direct(
     auto angular_velocity =
         deserialize_direct(d, serialization::detail::type_tag<Vector>{});
 
-    if (!linear_acceleration || !angular_velocity) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "linear_acceleration", linear_acceleration,
+            "angular_velocity", angular_velocity)) {
+        return *err;
     }
 
     params.linear_acceleration = *linear_acceleration;
@@ -355,8 +387,9 @@ constexpr serialization::SerializationResult serialize_wire(
         serialize_wire(s, bv_, pdu.entity_linear_velocity).written_view.size();
     bv_ += serialize_wire(s, bv_, pdu.entity_location).written_view.size();
     bv_ += serialize_wire(s, bv_, pdu.entity_orientation).written_view.size();
-    s.write(bv_, pdu.entity_appearance);  // for now, we just write the raw 32
-                                          // bit value of the appearance
+    s.write(bv_, be<std::uint32_t>(
+                     pdu.entity_appearance));  // for now, we just write the raw
+                                               // 32 bit value of the appearance
     bv_ += serialize_wire(s, bv_, pdu.dr_parameters).written_view.size();
     s.write(bv_,
             pdu.entity_marking.character_set);  // just 12 bytes in a row, no
@@ -364,8 +397,9 @@ constexpr serialization::SerializationResult serialize_wire(
     for (const auto& byte : pdu.entity_marking.marking) {
         s.write(bv_, byte);
     }
-    s.write(bv_, pdu.capabilities);  // for now, we just write the raw 32 bit
-                                     // value of the capabilities
+    s.write(bv_, be<std::uint32_t>(
+                     pdu.capabilities));  // for now, we just write the raw 32
+                                          // bit value of the capabilities
     for (const auto& var_param : pdu.variable_parameters) {
         s.write(bv_, var_param.type);
         for (const auto& byte : var_param.data) {
@@ -379,7 +413,6 @@ constexpr serialization::SerializationResult serialize_wire(
 template <serialization::Deserializer D>
 expected<EntityStatePDU, typename D::error_type> deserialize_direct(
     D& d, serialization::detail::type_tag<EntityStatePDU> = {}) {
-    std::cerr << "Inside deserialize_direct for EntityStatePDU" << std::endl;
     auto header =
         deserialize_direct(d, serialization::detail::type_tag<PDUHeader>{});
     auto entity_id =
@@ -396,57 +429,63 @@ expected<EntityStatePDU, typename D::error_type> deserialize_direct(
         d, serialization::detail::type_tag<WorldCoordinates>{});
     auto entity_orientation =
         deserialize_direct(d, serialization::detail::type_tag<EulerAngles>{});
-    auto entity_appearance = d.template read<std::uint32_t>();
+    auto entity_appearance = d.template read<be<std::uint32_t>>();
     auto dr_parameters = deserialize_direct(
         d, serialization::detail::type_tag<DeadReckoningParameters>{});
 
+    if (auto err = detail::first_error<typename D::error_type>(
+            "header", header, "entity_id", entity_id, "force_id", force_id,
+            "variable_parameter_count", num_variable_parameters,
+            "entity_type", entity_type,
+            "alternative_entity_type", alternative_entity_type,
+            "entity_linear_velocity", entity_linear_velocity,
+            "entity_location", entity_location,
+            "entity_orientation", entity_orientation,
+            "entity_appearance", entity_appearance,
+            "dr_parameters", dr_parameters)) {
+        return *err;
+    }
+
     EntityMarking entity_marking;
     auto marking_character_set = d.template read<std::uint8_t>();
     if (!marking_character_set) {
-        std::cerr << "Failed to read marking character set" << std::endl;
-        return unexpect;
+        return detail::tag_field(marking_character_set.error(),
+                                 "entity_marking");
     }
     entity_marking.character_set = *marking_character_set;
 
     for (std::size_t i = 0; i < 11; ++i) {
         auto byte = d.template read<std::uint8_t>();
         if (!byte) {
-            std::cerr << "Failed to read byte " << i << " of entity marking"
-                      << std::endl;
-            return unexpect;
+            return detail::tag_field(byte.error(), "entity_marking");
         }
         entity_marking.marking[i] = *byte;
     }
 
-    auto capabilities = d.template read<std::uint32_t>();
+    auto capabilities = d.template read<be<std::uint32_t>>();
+    if (!capabilities) {
+        return detail::tag_field(capabilities.error(), "capabilities");
+    }
 
-    Buffer<VariableParameters> variable_parameters;
+    auto variable_parameters = detail::make_buffer<VariableParameters>(d);
+    variable_parameters.reserve(*num_variable_parameters);
     for (std::size_t i = 0; i < *num_variable_parameters; ++i) {
         VariableParameters var_param;
-        var_param.type = *d.template read<std::uint8_t>();
+        auto type = d.template read<std::uint8_t>();
+        if (!type) {
+            return detail::tag_field(type.error(), "variable_parameters");
+        }
+        var_param.type = *type;
         for (std::size_t j = 0; j < sizeof(var_param.data); ++j) {
             auto byte = d.template read<std::uint8_t>();
             if (!byte) {
-                std::cerr << "Failed to read byte " << j
-                          << " of variable parameter " << i << " with error "
-                          << (int)byte.error() << std::endl;
-                return unexpect;
+                return detail::tag_field(byte.error(), "variable_parameters");
             }
             var_param.data[j] = *byte;
         }
         variable_parameters.push_back(var_param);
     }
 
-    if (!header || !entity_id || !force_id || !entity_type ||
-        !alternative_entity_type || !entity_linear_velocity ||
-        !entity_location || !entity_orientation || !entity_appearance ||
-        !dr_parameters || !marking_character_set || !capabilities) {
-        std::cerr
-            << "Failed to read one of the required fields for EntityStatePDU"
-            << std::endl;
-        return unexpect;
-    }
-
     return EntityStatePDU{*header,
                           *entity_id,
                           *force_id,
@@ -455,10 +494,10 @@ expected<EntityStatePDU, typename D::error_type> deserialize_direct(
                           *entity_linear_velocity,
                           *entity_location,
                           *entity_orientation,
-                          *entity_appearance,
+                          entity_appearance->native(),
                           *dr_parameters,
                           entity_marking,
-                          *capabilities,
+                          capabilities->native(),
                           std::move(variable_parameters)};
 };
 
@@ -484,9 +523,13 @@ expected<EEFundamentalParameterData, typename D::error_type> deserialize_direct(
     auto pulse_repetition_frequency = d.template read<be<float>>();
     auto pulse_width = d.template read<be<float>>();
 
-    if (!center_frequency || !frequency_range || !effective_radiated_power ||
-        !pulse_repetition_frequency || !pulse_width) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "center_frequency", center_frequency,
+            "frequency_range", frequency_range,
+            "effective_radiated_power", effective_radiated_power,
+            "pulse_repetition_frequency", pulse_repetition_frequency,
+            "pulse_width", pulse_width)) {
+        return *err;
     }
 
     return EEFundamentalParameterData{
@@ -517,9 +560,13 @@ expected<BeamData, typename D::error_type> deserialize_direct(
     auto beam_elevation_sweep = d.template read<be<float>>();
     auto beam_sweep_sync = d.template read<be<float>>();
 
-    if (!beam_azimuth_center || !beam_elevation_center || !beam_azimuth_sweep ||
-        !beam_elevation_sweep || !beam_sweep_sync) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "beam_azimuth_center", beam_azimuth_center,
+            "beam_elevation_center", beam_elevation_center,
+            "beam_azimuth_sweep", beam_azimuth_sweep,
+            "beam_elevation_sweep", beam_elevation_sweep,
+            "beam_sweep_sync", beam_sweep_sync)) {
+        return *err;
     }
 
     return BeamData{beam_azimuth_center->native(),
@@ -537,6 +584,7 @@ constexpr serialization::SerializationResult serialize_radio_type(
         s.write(bv_, pdu.dis6.entity_kind);
         s.write(bv_, pdu.dis6.domain);
         s.write(bv_, be<std::uint16_t>(pdu.dis6.country_code));
+        s.write(bv_, pdu.dis6.category);
         s.write(bv_, pdu.dis6.nomenclature_version);
         s.write(bv_, be<std::uint16_t>(pdu.dis6.nomenclature));
     } else if (protocol_version == ProtocolVersion::IEEE_1278_2012) {
@@ -567,17 +615,22 @@ expected<RadioType, typename D::error_type> deserialize_radio_type(
         auto entity_kind = d.template read<std::uint8_t>();
         auto domain = d.template read<std::uint8_t>();
         auto country_code = d.template read<be<std::uint16_t>>();
+        auto category = d.template read<std::uint8_t>();
         auto nomenclature_version = d.template read<std::uint8_t>();
         auto nomenclature = d.template read<be<std::uint16_t>>();
 
-        if (!entity_kind || !domain || !country_code || !nomenclature_version ||
-            !nomenclature) {
-            return unexpect;
+        if (auto err = detail::first_error<typename D::error_type>(
+                "entity_kind", entity_kind, "domain", domain,
+                "country_code", country_code, "category", category,
+                "nomenclature_version", nomenclature_version,
+                "nomenclature", nomenclature)) {
+            return *err;
         }
 
         radio_type.dis6.entity_kind = *entity_kind;
         radio_type.dis6.domain = *domain;
         radio_type.dis6.country_code = country_code->native();
+        radio_type.dis6.category = *category;
         radio_type.dis6.nomenclature_version = *nomenclature_version;
         radio_type.dis6.nomenclature = nomenclature->native();
     } else if (protocol_version == ProtocolVersion::IEEE_1278_2012) {
@@ -589,9 +642,12 @@ expected<RadioType, typename D::error_type> deserialize_radio_type(
         auto specific = d.template read<std::uint8_t>();
         auto extra = d.template read<std::uint8_t>();
 
-        if (!entity_kind || !domain || !country_code || !category ||
-            !subcategory || !specific || !extra) {
-            return unexpect;
+        if (auto err = detail::first_error<typename D::error_type>(
+                "entity_kind", entity_kind, "domain", domain,
+                "country_code", country_code, "category", category,
+                "subcategory", subcategory, "specific", specific,
+                "extra", extra)) {
+            return *err;
         }
 
         radio_type.dis7.entity_kind = *entity_kind;
@@ -602,7 +658,7 @@ expected<RadioType, typename D::error_type> deserialize_radio_type(
         radio_type.dis7.specific = *specific;
         radio_type.dis7.extra = *extra;
     } else {
-        return unexpect;
+        return detail::invalid_data(d, "radio_type");
     };
 
     return radio_type;
@@ -628,8 +684,10 @@ expected<JammingTechnique, typename D::error_type> deserialize_direct(
     auto subcategory = d.template read<std::uint8_t>();
     auto specific = d.template read<std::uint8_t>();
 
-    if (!kind || !category || !subcategory || !specific) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "kind", kind, "category", category, "subcategory", subcategory,
+            "specific", specific)) {
+        return *err;
     }
 
     return JammingTechnique{*kind, *category, *subcategory, *specific};
@@ -654,8 +712,10 @@ expected<TrackJam, typename D::error_type> deserialize_direct(
     auto emitter_number = d.template read<std::uint8_t>();
     auto beam_number = d.template read<std::uint8_t>();
 
-    if (!track_jam_target || !emitter_number || !beam_number) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "track_jam_target", track_jam_target,
+            "emitter_number", emitter_number, "beam_number", beam_number)) {
+        return *err;
     }
 
     return TrackJam{*track_jam_target, *emitter_number, *beam_number};
@@ -707,11 +767,16 @@ expected<Beam, typename D::error_type> deserialize_direct(
     auto jamming_technique = deserialize_direct(
         d, serialization::detail::type_tag<JammingTechnique>{});
 
-    if (!record_length || !beam_number || !beam_parameter_index ||
-        !fundamental_parameters || !beam_data || !beam_function ||
-        !number_of_targets || !high_density_track_jam || !beam_status ||
-        !jamming_technique) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "record_length", record_length, "beam_number", beam_number,
+            "beam_parameter_index", beam_parameter_index,
+            "fundamental_parameters", fundamental_parameters,
+            "beam_data", beam_data, "beam_function", beam_function,
+            "number_of_targets", number_of_targets,
+            "high_density_track_jam", high_density_track_jam,
+            "beam_status", beam_status,
+            "jamming_technique", jamming_technique)) {
+        return *err;
     }
 
     // calculate how many track jams there are based on the record length
@@ -720,12 +785,13 @@ expected<Beam, typename D::error_type> deserialize_direct(
 
     std::optional<Buffer<TrackJam>> track_jams;
     if (track_jams_size > 0) {
-        Buffer<TrackJam> jams;
+        auto jams = detail::make_buffer<TrackJam>(d);
+        jams.reserve(track_jams_size);
         for (size_t i = 0; i < track_jams_size; ++i) {
             auto track_jam = deserialize_direct(
                 d, serialization::detail::type_tag<TrackJam>{});
             if (!track_jam) {
-                return unexpect;
+                return detail::tag_field(track_jam.error(), "track_jams");
             }
             jams.push_back(*track_jam);
         }
@@ -786,19 +852,23 @@ expected<EmitterSystem, typename D::error_type> deserialize_direct(
     auto emitter_location = deserialize_direct(
         d, serialization::detail::type_tag<EntityCoordinates>{});
 
-    if (!record_length || !num_beams || !emitter_name || !function ||
-        !emitter_number || !emitter_location) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "record_length", record_length, "num_beams", num_beams,
+            "emitter_name", emitter_name, "function", function,
+            "emitter_number", emitter_number,
+            "emitter_location", emitter_location)) {
+        return *err;
     }
 
-    Buffer<Beam> beams;
+    auto beams = detail::make_buffer<Beam>(d);
+    beams.reserve(*num_beams);
     for (size_t i = 0; i < *num_beams; ++i) {
         auto beam =
             deserialize_direct(d, serialization::detail::type_tag<Beam>{});
         if (!beam) {
-            return unexpect;
+            return detail::tag_field(beam.error(), "beams");
         }
-        beams.push_back(*beam);
+        beams.push_back(std::move(*beam));
     }
 
     return EmitterSystem{emitter_name->native(), *function, *emitter_number,
@@ -838,19 +908,22 @@ expected<ElectromagneticEmissionPDU, typename D::error_type> deserialize_direct(
     std::ignore =
         d.template read<std::uint16_t>();  // pad to align the emitter systems
 
-    if (!header || !emitter_id || !event_id || !state_update_indicator ||
-        !num_emitter_systems) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "header", header, "emitter_id", emitter_id, "event_id", event_id,
+            "state_update_indicator", state_update_indicator,
+            "num_emitter_systems", num_emitter_systems)) {
+        return *err;
     }
 
-    Buffer<EmitterSystem> emitter_systems;
+    auto emitter_systems = detail::make_buffer<EmitterSystem>(d);
+    emitter_systems.reserve(*num_emitter_systems);
     for (size_t i = 0; i < *num_emitter_systems; ++i) {
         auto emitter_system = deserialize_direct(
             d, serialization::detail::type_tag<EmitterSystem>{});
         if (!emitter_system) {
-            return unexpect;
+            return detail::tag_field(emitter_system.error(), "emitter_systems");
         }
-        emitter_systems.push_back(*emitter_system);
+        emitter_systems.push_back(std::move(*emitter_system));
     }
 
     return ElectromagneticEmissionPDU{*header, *emitter_id, *event_id,
@@ -878,9 +951,12 @@ expected<ModulationType, typename D::error_type> deserialize_direct(
     auto detail_modulation = d.template read<be<std::uint16_t>>();
     auto radio_system = d.template read<be<std::uint16_t>>();
 
-    if (!spread_spectrum || !major_modulation || !detail_modulation ||
-        !radio_system) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "spread_spectrum", spread_spectrum,
+            "major_modulation", major_modulation,
+            "detail_modulation", detail_modulation,
+            "radio_system", radio_system)) {
+        return *err;
     }
 
     return ModulationType{spread_spectrum->native(), major_modulation->native(),
@@ -918,9 +994,13 @@ expected<BeamAntennaPattern, typename D::error_type> deserialize_direct(
     auto phase = d.template read<be<float>>();
     std::ignore = d.skip(4);
 
-    if (!beam_direction || !azimuth_beamwidth || !elevation_beamwidth ||
-        !reference_system || !e_z || !e_x || !phase) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "beam_direction", beam_direction,
+            "azimuth_beamwidth", azimuth_beamwidth,
+            "elevation_beamwidth", elevation_beamwidth,
+            "reference_system", reference_system, "e_z", e_z, "e_x", e_x,
+            "phase", phase)) {
+        return *err;
     }
 
     return BeamAntennaPattern{*beam_direction,
@@ -939,7 +1019,9 @@ constexpr serialization::SerializationResult serialize_wire(
     serialize_pdu_header(s, bv_, pdu.header, pdu_size_calc(pdu));
     bv_ += serialize_wire(s, bv_, pdu.radio_reference_id).written_view.size();
     s.write(bv_, be<std::uint16_t>(pdu.radio_number));
-    bv_ += serialize_wire(s, bv_, pdu.radio_type).written_view.size();
+    bv_ += serialize_radio_type(s, bv_, pdu.radio_type,
+                                pdu.header.protocol_version)
+               .written_view.size();
     s.write(bv_, std::uint8_t(pdu.transmit_state));
     s.write(bv_, std::uint8_t(pdu.input_source));
     if (pdu.header.protocol_version == ProtocolVersion::IEEE_1278_1998) {
@@ -961,12 +1043,14 @@ constexpr serialization::SerializationResult serialize_wire(
     s.write(bv_, be<std::uint16_t>(pdu.crypto_system));
     s.write(bv_, be<std::uint16_t>(pdu.crypto_key_id));
     s.write(bv_, std::uint8_t(pdu.modulation_parameters.size()));
-    s.pad(bv, 3);
+    s.pad(bv_, 3);
     for (const auto& mod_param : pdu.modulation_parameters) {
         s.write(bv_,
                 std::uint8_t(mod_param));  // for now they're represented as raw
                                            // bytes rather than structs.
     }
+    // pad to the next 64 bit boundary
+    s.pad(bv_, (8 - (pdu.modulation_parameters.size() % 8)) % 8);
 
     for (const auto& antenna_pattern : pdu.antenna_patterns) {
         bv_ += serialize_wire(s, bv_, antenna_pattern).written_view.size();
@@ -974,7 +1058,7 @@ constexpr serialization::SerializationResult serialize_wire(
 
     for (const auto& var_param : pdu.variable_parameters) {
         size_t required_padding =
-            (8 - (var_param.data.size() % 8)) %
+            (8 - ((6 + var_param.data.size()) % 8)) %
             8;  // calculate padding needed to align to next 8 byte boundary
         s.write(bv_, be<std::uint32_t>(var_param.type));
         s.write(bv_,
@@ -984,11 +1068,10 @@ constexpr serialization::SerializationResult serialize_wire(
                                          // record in bytes (6 bytes for the
                                          // type and length fields, plus the
                                          // data and padding)
-        for (const auto& byte : var_param.data) {
-            s.write(bv_, byte);
-        }
-        s.pad(bv, required_padding);  // pad to align the data to the next 8
-                                      // byte boundary
+        serialization::write_bytes(
+            s, bv_, BufferView(var_param.data.data(), var_param.data.size()));
+        s.pad(bv_, required_padding);  // pad to align the data to the next 8
+                                       // byte boundary
     }
     return {bv(0, bv.size() - bv_.size()),
             serialization::SerializationStatus::Ok};
@@ -999,6 +1082,9 @@ expected<TransmitterPDU, typename D::error_type> deserialize_direct(
     D& d, serialization::detail::type_tag<TransmitterPDU> = {}) {
     auto header =
         deserialize_direct(d, serialization::detail::type_tag<PDUHeader>{});
+    if (!header) {
+        return detail::tag_field(header.error(), "header");
+    }
     auto radio_reference_id =
         deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
     auto radio_number = d.template read<be<std::uint16_t>>();
@@ -1010,7 +1096,10 @@ expected<TransmitterPDU, typename D::error_type> deserialize_direct(
     // but reading it for DIS 6 doesn't cause any issues since it's just padding
     // in that case
     std::optional<std::uint16_t> variable_parameter_count;
-    variable_parameter_count = d.template read<be<std::uint16_t>>();
+    if (auto count = d.template read<be<std::uint16_t>>();
+        count && header->protocol_version != ProtocolVersion::IEEE_1278_1998) {
+        variable_parameter_count = count->native();
+    }
 
     auto antenna_location = deserialize_direct(
         d, serialization::detail::type_tag<WorldCoordinates>{});
@@ -1029,62 +1118,88 @@ expected<TransmitterPDU, typename D::error_type> deserialize_direct(
     std::ignore = d.template read<std::uint16_t>();
     std::ignore = d.template read<std::uint8_t>();  // 3 byte padding
 
-    if (!header || !radio_reference_id || !radio_number || !radio_type ||
-        !transmit_state || !input_source || !antenna_location ||
-        !relative_antenna_location || !antenna_pattern_type ||
-        !num_antenna_patterns || !center_frequency ||
-        !transmit_frequency_bandwidth || !power || !modulation_type ||
-        !crypto_system || !crypto_key_id || !num_modulation_parameters) {
-        return unexpect;
+    if (auto err = detail::first_error<typename D::error_type>(
+            "header", header, "radio_reference_id", radio_reference_id,
+            "radio_number", radio_number, "radio_type", radio_type,
+            "transmit_state", transmit_state, "input_source", input_source,
+            "antenna_location", antenna_location,
+            "relative_antenna_location", relative_antenna_location,
+            "antenna_pattern_type", antenna_pattern_type,
+            "num_antenna_patterns", num_antenna_patterns,
+            "center_frequency", center_frequency,
+            "transmit_frequency_bandwidth", transmit_frequency_bandwidth,
+            "power", power, "modulation_type", modulation_type,
+            "crypto_system", crypto_system, "crypto_key_id", crypto_key_id,
+            "num_modulation_parameters", num_modulation_parameters)) {
+        return *err;
     }
 
-    Buffer<uint8_t> modulation_parameters;
+    auto modulation_parameters = detail::make_buffer<std::uint8_t>(d);
+    modulation_parameters.reserve(*num_modulation_parameters);
     for (size_t i = 0; i < *num_modulation_parameters; ++i) {
         auto mod_param = d.template read<std::uint8_t>();
         if (!mod_param) {
-            return unexpect;
+            return detail::tag_field(mod_param.error(), "modulation_parameters");
         }
         modulation_parameters.push_back(*mod_param);
     }
+    // skip padding to the next 64 bit boundary
+    if (const size_t padding = (8 - (*num_modulation_parameters % 8)) % 8;
+        padding > 0) {
+        std::ignore = d.skip(padding);
+    }
 
-    Buffer<BeamAntennaPattern> antenna_patterns;
+    auto antenna_patterns = detail::make_buffer<BeamAntennaPattern>(d);
     for (size_t i = 0; i < num_antenna_patterns->native(); ++i) {
         auto antenna_pattern = deserialize_direct(
             d, serialization::detail::type_tag<BeamAntennaPattern>{});
         if (!antenna_pattern) {
-            return unexpect;
+            return detail::tag_field(antenna_pattern.error(), "antenna_patterns");
         }
         antenna_patterns.push_back(*antenna_pattern);
     }
 
-    Buffer<VariableTransmitterParameters> variable_parameters;
+    auto variable_parameters =
+        detail::make_buffer<VariableTransmitterParameters>(d);
     if (variable_parameter_count) {
         for (size_t i = 0; i < *variable_parameter_count; ++i) {
-            VariableTransmitterParameters var_param;
+            VariableTransmitterParameters var_param{
+                0, detail::make_buffer<std::uint8_t>(d)};
             auto type = d.template read<be<std::uint32_t>>();
             auto length = d.template read<be<std::uint16_t>>();
-            std::ignore = d.template read<std::uint16_t>();  // padding
-            if (!type || !length) {
-                return unexpect;
+            if (auto err = detail::first_error<typename D::error_type>(
+                    "variable_parameters", type, "variable_parameters",
+                    length)) {
+                return *err;
+            }
+            if (length->native() < 6) {
+                return detail::invalid_data(d, "variable_parameters");
             }
             var_param.type = type->native();
+            // the record length includes the padding, and the padding can't be
+            // told apart from the data, so the data keeps it
             size_t data_length =
                 length->native() - 6;  // subtract the size of the type and
                                        // length fields to get the data length
-            for (size_t j = 0; j < data_length; ++j) {
-                auto byte = d.template read<std::uint8_t>();
-                if (!byte) {
-                    return unexpect;
+            if constexpr (requires { d.read_bytes(data_length); }) {
+                // bounds checked before anything is allocated
+                auto bytes = d.read_bytes(data_length);
+                if (!bytes) {
+                    return detail::tag_field(bytes.error(),
+                                             "variable_parameters");
+                }
+                var_param.data.append(
+                    reinterpret_cast<const std::uint8_t*>(bytes->data()),
+                    bytes->size());
+            } else {
+                for (size_t j = 0; j < data_length; ++j) {
+                    auto byte = d.template read<std::uint8_t>();
+                    if (!byte) {
+                        return detail::tag_field(byte.error(),
+                                                 "variable_parameters");
+                    }
+                    var_param.data.push_back(*byte);
                 }
-                var_param.data.push_back(*byte);
-            }
-            // skip padding to align to next 8 byte boundary
-            size_t total_length =
-                6 + data_length;  // total length of the record
-            size_t padding =
-                (8 - (total_length % 8)) % 8;  // calculate required padding
-            if (padding > 0) {
-                std::ignore = d.skip(padding);
             }
             variable_parameters.push_back(std::move(var_param));
         }
@@ -1110,4 +1225,265 @@ expected<TransmitterPDU, typename D::error_type> deserialize_direct(
                           std::move(variable_parameters)};
 }
 
+template <serialization::WireSerializer S>
+constexpr serialization::SerializationResult serialize_wire(
+    S& s, MutableBufferView& bv, const BurstDescriptor& pdu) {
+    auto bv_ = bv;
+    bv_ += serialize_wire(s, bv_, pdu.munition).written_view.size();
+    s.write(bv_, be<std::uint16_t>(pdu.warhead));
+    s.write(bv_, be<std::uint16_t>(pdu.fuse));
+    s.write(bv_, be<std::uint16_t>(pdu.quantity));
+    s.write(bv_, be<std::uint16_t>(pdu.rate));
+    return {bv(0, bv.size() - bv_.size()),
+            serialization::SerializationStatus::Ok};
+}
+
+template <serialization::Deserializer D>
+expected<BurstDescriptor, typename D::error_type> deserialize_direct(
+    D& d, serialization::detail::type_tag<BurstDescriptor> = {}) {
+    auto munition =
+        deserialize_direct(d, serialization::detail::type_tag<EntityType>{});
+    auto warhead = d.template read<be<std::uint16_t>>();
+    auto fuse = d.template read<be<std::uint16_t>>();
+    auto quantity = d.template read<be<std::uint16_t>>();
+    auto rate = d.template read<be<std::uint16_t>>();
+
+    if (auto err = detail::first_error<typename D::error_type>(
+            "munition", munition, "warhead", warhead, "fuse", fuse,
+            "quantity", quantity, "rate", rate)) {
+        return *err;
+    }
+
+    return BurstDescriptor{*munition, warhead->native(), fuse->native(),
+                           quantity->native(), rate->native()};
+}
+
+template <serialization::WireSerializer S>
+constexpr serialization::SerializationResult serialize_wire(
+    S& s, MutableBufferView& bv, const FirePDU& pdu) {
+    auto bv_ = bv;
+    serialize_pdu_header(s, bv_, pdu.header, pdu_size_calc(pdu));
+    bv_ += serialize_wire(s, bv_, pdu.firing_entity_id).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.target_entity_id).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.munition_id).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.event_id).written_view.size();
+    s.write(bv_, be<std::uint32_t>(pdu.fire_mission_index));
+    bv_ += serialize_wire(s, bv_, pdu.location).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.burst_descriptor).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.velocity).written_view.size();
+    s.write(bv_, be<float>(pdu.range));
+    return {bv(0, bv.size() - bv_.size()),
+            serialization::SerializationStatus::Ok};
+}
+
+template <serialization::Deserializer D>
+expected<FirePDU, typename D::error_type> deserialize_direct(
+    D& d, serialization::detail::type_tag<FirePDU> = {}) {
+    auto header =
+        deserialize_direct(d, serialization::detail::type_tag<PDUHeader>{});
+    auto firing_entity_id =
+        deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
+    auto target_entity_id =
+        deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
+    auto munition_id =
+        deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
+    auto event_id =
+        deserialize_direct(d, serialization::detail::type_tag<EventID>{});
+    auto fire_mission_index = d.template read<be<std::uint32_t>>();
+    auto location = deserialize_direct(
+        d, serialization::detail::type_tag<WorldCoordinates>{});
+    auto burst_descriptor = deserialize_direct(
+        d, serialization::detail::type_tag<BurstDescriptor>{});
+    auto velocity =
+        deserialize_direct(d, serialization::detail::type_tag<Vector>{});
+    auto range = d.template read<be<float>>();
+
+    if (auto err = detail::first_error<typename D::error_type>(
+            "header", header, "firing_entity_id", firing_entity_id,
+            "target_entity_id", target_entity_id, "munition_id", munition_id,
+            "event_id", event_id, "fire_mission_index", fire_mission_index,
+            "location", location, "burst_descriptor", burst_descriptor,
+            "velocity", velocity, "range", range)) {
+        return *err;
+    }
+
+    return FirePDU{*header,
+                   *firing_entity_id,
+                   *target_entity_id,
+                   *munition_id,
+                   *event_id,
+                   fire_mission_index->native(),
+                   *location,
+                   *burst_descriptor,
+                   *velocity,
+                   range->native()};
+}
+
+template <serialization::WireSerializer S>
+constexpr serialization::SerializationResult serialize_wire(
+    S& s, MutableBufferView& bv, const DetonationPDU& pdu) {
+    auto bv_ = bv;
+    serialize_pdu_header(s, bv_, pdu.header, pdu_size_calc(pdu));
+    bv_ += serialize_wire(s, bv_, pdu.firing_entity_id).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.target_entity_id).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.munition_id).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.event_id).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.velocity).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.location).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.burst_descriptor).written_view.size();
+    bv_ += serialize_wire(s, bv_, pdu.entity_location).written_view.size();
+    s.write(bv_, pdu.detonation_result);
+    s.write(bv_, std::uint8_t(pdu.variable_parameters.size()));
+    s.pad(bv_, 2);
+    for (const auto& var_param : pdu.variable_parameters) {
+        s.write(bv_, var_param.type);
+        for (const auto& byte : var_param.data) {
+            s.write(bv_, byte);
+        }
+    }
+    return {bv(0, bv.size() - bv_.size()),
+            serialization::SerializationStatus::Ok};
+}
+
+template <serialization::Deserializer D>
+expected<DetonationPDU, typename D::error_type> deserialize_direct(
+    D& d, serialization::detail::type_tag<DetonationPDU> = {}) {
+    auto header =
+        deserialize_direct(d, serialization::detail::type_tag<PDUHeader>{});
+    auto firing_entity_id =
+        deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
+    auto target_entity_id =
+        deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
+    auto munition_id =
+        deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
+    auto event_id =
+        deserialize_direct(d, serialization::detail::type_tag<EventID>{});
+    auto velocity =
+        deserialize_direct(d, serialization::detail::type_tag<Vector>{});
+    auto location = deserialize_direct(
+        d, serialization::detail::type_tag<WorldCoordinates>{});
+    auto burst_descriptor = deserialize_direct(
+        d, serialization::detail::type_tag<BurstDescriptor>{});
+    auto entity_location =
+        deserialize_direct(d, serialization::detail::type_tag<Vector>{});
+    auto detonation_result = d.template read<std::uint8_t>();
+    auto num_variable_parameters = d.template read<std::uint8_t>();
+    std::ignore = d.skip(2);
+
+    if (auto err = detail::first_error<typename D::error_type>(
+            "header", header, "firing_entity_id", firing_entity_id,
+            "target_entity_id", target_entity_id, "munition_id", munition_id,
+            "event_id", event_id, "velocity", velocity, "location", location,
+            "burst_descriptor", burst_descriptor,
+            "entity_location", entity_location,
+            "detonation_result", detonation_result,
+            "variable_parameter_count", num_variable_parameters)) {
+        return *err;
+    }
+
+    auto variable_parameters = detail::make_buffer<VariableParameters>(d);
+    variable_parameters.reserve(*num_variable_parameters);
+    for (std::size_t i = 0; i < *num_variable_parameters; ++i) {
+        VariableParameters var_param;
+        auto type = d.template read<std::uint8_t>();
+        if (!type) {
+            return detail::tag_field(type.error(), "variable_parameters");
+        }
+        var_param.type = *type;
+        for (std::size_t j = 0; j < sizeof(var_param.data); ++j) {
+            auto byte = d.template read<std::uint8_t>();
+            if (!byte) {
+                return detail::tag_field(byte.error(), "variable_parameters");
+            }
+            var_param.data[j] = *byte;
+        }
+        variable_parameters.push_back(var_param);
+    }
+
+    return DetonationPDU{*header,
+                         *firing_entity_id,
+                         *target_entity_id,
+                         *munition_id,
+                         *event_id,
+                         *velocity,
+                         *location,
+                         *burst_descriptor,
+                         *entity_location,
+                         *detonation_result,
+                         std::move(variable_parameters)};
+}
+
+template <serialization::WireSerializer S>
+serialization::SerializationResult serialize_wire(S& s, MutableBufferView& bv,
+                                                  const SignalPDU& pdu) {
+    const std::size_t size = pdu_size_calc(pdu);
+    // the data length field counts bits in 16 bits
+    if (pdu.data.size() > 0xFFFF / 8) {
+        return {bv(0, 0), serialization::SerializationStatus::Failed};
+    }
+    // the data may be referenced rather than copied into bv
+    if (bv.size() < size - pdu.data.size() +
+                        serialization::staged_size(s, pdu.data.size())) {
+        return {bv(0, 0), serialization::SerializationStatus::BufferFull};
+    }
+    auto bv_ = bv;
+    serialize_pdu_header(s, bv_, pdu.header, size);
+    bv_ += serialize_wire(s, bv_, pdu.radio_reference_id).written_view.size();
+    s.write(bv_, be<std::uint16_t>(pdu.radio_number));
+    s.write(bv_, be<std::uint16_t>(pdu.encoding_scheme));
+    s.write(bv_, be<std::uint16_t>(pdu.tdl_type));
+    s.write(bv_, be<std::uint32_t>(pdu.sample_rate));
+    s.write(bv_, be<std::uint16_t>(pdu.data.size() * 8));  // in bits
+    s.write(bv_, be<std::uint16_t>(pdu.samples));
+    // the audio is already encoded, so it goes out as one blob
+    serialization::write_bytes(s, bv_, pdu.data);
+    s.pad(bv_, (4 - pdu.data.size() % 4) % 4);
+    return {bv(0, bv.size() - bv_.size()),
+            serialization::SerializationStatus::Ok};
+}
+
+// The data is returned as a view into the deserializer's buffer, not copied.
+template <serialization::Deserializer D>
+    requires requires(D& d, std::size_t n) { d.read_bytes(n); }
+expected<SignalPDU, typename D::error_type> deserialize_direct(
+    D& d, serialization::detail::type_tag<SignalPDU> = {}) {
+    auto header =
+        deserialize_direct(d, serialization::detail::type_tag<PDUHeader>{});
+    auto radio_reference_id =
+        deserialize_direct(d, serialization::detail::type_tag<EntityID>{});
+    auto radio_number = d.template read<be<std::uint16_t>>();
+    auto encoding_scheme = d.template read<be<std::uint16_t>>();
+    auto tdl_type = d.template read<be<std::uint16_t>>();
+    auto sample_rate = d.template read<be<std::uint32_t>>();
+    auto data_length = d.template read<be<std::uint16_t>>();
+    auto samples = d.template read<be<std::uint16_t>>();
+
+    if (auto err = detail::first_error<typename D::error_type>(
+            "header", header, "radio_reference_id", radio_reference_id,
+            "radio_number", radio_number, "encoding_scheme", encoding_scheme,
+            "tdl_type", tdl_type, "sample_rate", sample_rate,
+            "data_length", data_length, "samples", samples)) {
+        return *err;
+    }
+
+    // data length is in bits; a partial last byte is kept whole
+    const std::size_t bytes = (data_length->native() + 7u) / 8;
+    auto data = d.read_bytes(bytes);
+    if (!data) {
+        return detail::tag_field(data.error(), "data");
+    }
+    if (const std::size_t padding = (4 - bytes % 4) % 4; padding > 0) {
+        std::ignore = d.skip(padding);
+    }
+
+    return SignalPDU{*header,
+                     *radio_reference_id,
+                     radio_number->native(),
+                     encoding_scheme->native(),
+                     tdl_type->native(),
+                     sample_rate->native(),
+                     samples->native(),
+                     *data};
+}
+
 };  // namespace csics::lvc::dis
@@ -1,3 +1,4 @@
+#pragma once
 
 #include <optional>
 
@@ -10,12 +11,7 @@ class SPSCMessageQueue {
         sizeof(T) > kCacheLineSize           // and ensures that at least capacity messages can fit in the queue
             ? sizeof(T) + (kCacheLineSize - sizeof(T) % kCacheLineSize)
             : kCacheLineSize;
-    SPSCMessageQueue(size_t capacity) : queue_(capacity * read_size) {
-        std::cerr << "Initialized SPSCMessageQueue with capacity for "
-                  << capacity << " messages of size " << sizeof(T)
-                  << " bytes each (total " << queue_.capacity() << " bytes)"
-                  << std::endl;
-    }
+    SPSCMessageQueue(size_t capacity) : queue_(capacity * read_size) {}
     SPSCMessageQueue(const SPSCMessageQueue&) = delete;
     SPSCMessageQueue& operator=(const SPSCMessageQueue&) = delete;
     SPSCMessageQueue(SPSCMessageQueue&&) noexcept
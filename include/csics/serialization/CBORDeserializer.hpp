@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "csics/Buffer.hpp"
+#include "csics/serialization/CBORSerializer.hpp"
+#include "csics/serialization/Common.hpp"
+#include "csics/serialization/Concepts.hpp"
+#include "csics/serialization/Deserializer.hpp"
+
+namespace csics::serialization {
+
+template <typename T>
+concept CBORPrimitive =
+    std::is_arithmetic_v<T> || std::same_as<T, std::string_view> ||
+    std::same_as<T, std::string> || std::same_as<T, BufferView> ||
+    std::same_as<T, std::nullptr_t>;
+
+// Reads CBOR written by CBORSerializer, or any CBOR with the same shape,
+// into field-listed types. Struct fields are looked up by key; fields in
+// the order they were written are found without searching, and unknown
+// fields are skipped using their length prefixes.
+//
+// Text and byte strings are read as views into the input (std::string_view
+// and BufferView), valid while the input is. Indefinite-length strings are
+// skipped but cannot be read, and tags are not interpreted.
+class CBORDeserializer {
+   public:
+    using error_type = DeserializationError;
+    using exact_primitives = CBORSerializer::exact_primitives;
+    using convertible_primitives = CBORSerializer::convertible_primitives;
+
+    explicit CBORDeserializer(BufferView data) : data_(data) {}
+
+    // Bytes consumed so far.
+    std::size_t offset() const noexcept { return pos_; }
+
+    template <CBORPrimitive T>
+    expected<T, error_type> read() {
+        if constexpr (std::same_as<T, bool>) {
+            return read_bool();
+        } else if constexpr (std::same_as<T, std::nullptr_t>) {
+            if (auto r = read_null(); !r) {
+                return r.error();
+            }
+            return nullptr;
+        } else if constexpr (std::is_integral_v<T>) {
+            return read_integer<T>();
+        } else if constexpr (std::is_floating_point_v<T>) {
+            auto v = read_double();
+            if (!v) {
+                return v.error();
+            }
+            return static_cast<T>(*v);
+        } else if constexpr (std::same_as<T, BufferView>) {
+            auto s = read_string(cbor::bytes);
+            if (!s) {
+                return s.error();
+            }
+            return BufferView(s->data(), s->size());
+        } else if constexpr (std::same_as<T, std::string_view>) {
+            return read_string(cbor::text);
+        } else {
+            auto s = read_string(cbor::text);
+            if (!s) {
+                return s.error();
+            }
+            return std::string(*s);
+        }
+    }
+
+    template <typename T>
+    expected<T, error_type> read_iterable(T& out) {
+        auto count = read_container(cbor::array);
+        if (!count) {
+            return count.error();
+        }
+        out.clear();
+        for (std::size_t i = 0; more(*count, i); ++i) {
+            typename T::value_type value{};
+            auto res = deserialize(*this, value);
+            if (!res) {
+                return res.error();
+            }
+            if constexpr (requires { out.push_back(std::move(*res)); }) {
+                out.push_back(std::move(*res));
+            } else {
+                out.insert(out.end(), std::move(*res));
+            }
+        }
+        return std::move(out);
+    }
+
+    template <typename T>
+    expected<T, error_type> read_map(T& out) {
+        auto count = read_container(cbor::map);
+        if (!count) {
+            return count.error();
+        }
+        out.clear();
+        for (std::size_t i = 0; more(*count, i); ++i) {
+            auto key = read_string(cbor::text);
+            if (!key) {
+                return key.error();
+            }
+            typename T::mapped_type value{};
+            auto res = deserialize(*this, value);
+            if (!res) {
+                return res.error();
+            }
+            out.emplace(typename T::key_type(*key), std::move(*res));
+        }
+        return std::move(out);
+    }
+
+    // Keyed access to maps, as in JSONDeserializer.
+    expected<void, error_type> begin_obj();
+    expected<void, error_type> field(std::string_view key);
+    expected<void, error_type> end_obj();
+
+    // Skips the item at the cursor.
+    expected<void, error_type> skip();
+
+   private:
+    static constexpr std::size_t indefinite = ~std::size_t{0};
+
+    struct Header {
+        std::uint8_t major;
+        std::uint8_t info;  // the low five bits of the initial byte
+        std::uint64_t arg;
+    };
+
+    // A map being read: where its first key is, how many pairs it has
+    // (or indefinite) and how many pairs precede the cursor.
+    struct Frame {
+        std::size_t start;
+        std::size_t count;
+        std::size_t index;
+    };
+
+    BufferView data_;
+    std::size_t pos_ = 0;
+    Buffer<Frame> frames_;
+
+    unexpected<error_type> invalid(std::size_t at) const {
+        return unexpected<error_type>(
+            error_type(DeserializationStatus::InvalidData, at));
+    }
+    unexpected<error_type> empty() const {
+        return unexpected<error_type>(
+            error_type(DeserializationStatus::BufferEmpty, data_.size()));
+    }
+
+    // Parses the header at p and moves p past it.
+    expected<Header, error_type> header(std::size_t& p) const;
+    // Moves p past the item at p.
+    expected<void, error_type> skip_item(std::size_t& p,
+                                         std::size_t depth) const;
+    bool at_break(std::size_t p) const noexcept {
+        return p < data_.size() &&
+               static_cast<std::uint8_t>(data_.data()[p]) == cbor::break_code;
+    }
+    // Whether element i of a container of `count` elements follows, eating
+    // the break that ends an indefinite-length one.
+    bool more(std::size_t count, std::size_t i) noexcept {
+        if (count != indefinite) {
+            return i < count;
+        }
+        if (at_break(pos_)) {
+            ++pos_;
+            return false;
+        }
+        return pos_ < data_.size();
+    }
+
+    expected<std::size_t, error_type> read_container(std::uint8_t major);
+    expected<std::string_view, error_type> read_string(std::uint8_t major);
+    expected<bool, error_type> read_bool();
+    expected<void, error_type> read_null();
+    expected<double, error_type> read_double();
+
+    template <typename T>
+    expected<T, error_type> read_integer() {
+        const std::size_t at = pos_;
+        auto h = header(pos_);
+        if (!h) {
+            return h.error();
+        }
+        constexpr auto max = static_cast<std::uint64_t>(
+            std::numeric_limits<T>::max());
+        if (h->major == cbor::unsigned_int && h->info < 28 &&
+            h->arg <= max) {
+            return static_cast<T>(h->arg);
+        }
+        if constexpr (std::is_signed_v<T>) {
+            // -1 - arg fits when arg <= max
+            if (h->major == cbor::negative_int && h->info < 28 &&
+                h->arg <= max) {
+                return static_cast<T>(-1 - static_cast<std::int64_t>(h->arg));
+            }
+        }
+        pos_ = at;
+        return invalid(at);
+    }
+};
+
+};  // namespace csics::serialization
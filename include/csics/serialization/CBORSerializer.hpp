@@ -0,0 +1,302 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include "csics/Bit.hpp"
+#include "csics/serialization/Serializer.hpp"
+
+namespace csics::serialization {
+
+template <typename T>
+concept CBORIsNull =
+    std::same_as<T, std::nullptr_t> || std::same_as<T, std::nullopt_t>;
+
+// CBOR (RFC 8949) major types.
+namespace cbor {
+constexpr std::uint8_t unsigned_int = 0;
+constexpr std::uint8_t negative_int = 1;
+constexpr std::uint8_t bytes = 2;
+constexpr std::uint8_t text = 3;
+constexpr std::uint8_t array = 4;
+constexpr std::uint8_t map = 5;
+constexpr std::uint8_t simple = 7;
+
+constexpr std::uint8_t false_value = 0xF4;
+constexpr std::uint8_t true_value = 0xF5;
+constexpr std::uint8_t null_value = 0xF6;
+constexpr std::uint8_t float32 = 0xFA;
+constexpr std::uint8_t float64 = 0xFB;
+constexpr std::uint8_t break_code = 0xFF;
+
+// Size of an item header carrying `arg`: arguments below 24 fit in the
+// initial byte, larger ones follow it in 1, 2, 4 or 8 bytes.
+constexpr std::size_t header_size(std::uint64_t arg) noexcept {
+    return arg < 24 ? 1 : arg <= 0xFF ? 2 : arg <= 0xFFFF ? 3
+                      : arg <= 0xFFFFFFFF ? 5 : 9;
+}
+
+// Writes a header at out, which must hold header_size(arg) bytes.
+constexpr char* write_header(char* out, std::uint8_t major,
+                             std::uint64_t arg) noexcept {
+    const auto initial = static_cast<std::uint8_t>(major << 5);
+    if (arg < 24) {
+        *out++ = static_cast<char>(initial | arg);
+        return out;
+    }
+    const std::size_t n = header_size(arg) - 1;
+    *out++ = static_cast<char>(initial | (n == 1   ? 24
+                                          : n == 2 ? 25
+                                          : n == 4 ? 26
+                                                   : 27));
+    for (std::size_t i = n; i-- > 0;) {
+        *out++ = static_cast<char>(arg >> (8 * i));
+    }
+    return out;
+}
+
+// Whether v survives a round trip through float, so it can be written in
+// four bytes instead of eight.
+constexpr bool fits_float(double v) noexcept {
+    return static_cast<double>(static_cast<float>(v)) == v;
+}
+}  // namespace cbor
+
+namespace detail {
+// The key of field I of T as a CBOR text string, built at compile time.
+template <typename T, std::size_t I>
+struct cbor_key_literal {
+    static constexpr std::string_view name =
+        std::get<I>(get_fields<T>()).name();
+    static constexpr std::size_t size =
+        cbor::header_size(name.size()) + name.size();
+    static constexpr std::array<char, size> text = [] {
+        std::array<char, size> out{};
+        char* p = cbor::write_header(out.data(), cbor::text, name.size());
+        for (char c : name) {
+            *p++ = c;
+        }
+        return out;
+    }();
+};
+}  // namespace detail
+
+// Writes CBOR through the same field lists as JSONSerializer. Structs are
+// maps keyed by field name, written as definite-length maps with each key
+// copied from a literal encoded at compile time. Integers take the fewest
+// bytes that hold them, doubles are written as floats when that is exact,
+// and BufferView values are written as byte strings.
+class CBORSerializer {
+   public:
+    using exact_primitives =
+        std::tuple<bool, int, std::int64_t, std::uint64_t, double,
+                   std::string_view, std::nullptr_t, BufferView>;
+    using convertible_primitives =
+        std::tuple<std::int64_t, double, std::string_view>;
+
+    // Containers of known size get definite-length headers; the overloads
+    // without a count start indefinite-length ones closed by end_obj and
+    // end_array.
+    SerializationStatus begin_obj(MutableBufferView& bv, std::size_t n) {
+        return header(bv, cbor::map, n);
+    }
+    SerializationStatus begin_array(MutableBufferView& bv, std::size_t n) {
+        return header(bv, cbor::array, n);
+    }
+    SerializationStatus end_obj(MutableBufferView&, std::size_t) {
+        return SerializationStatus::Ok;
+    }
+    SerializationStatus end_array(MutableBufferView&, std::size_t) {
+        return SerializationStatus::Ok;
+    }
+    SerializationStatus begin_obj(MutableBufferView& bv) {
+        return put(bv, (cbor::map << 5) | 31);
+    }
+    SerializationStatus end_obj(MutableBufferView& bv) {
+        return put(bv, cbor::break_code);
+    }
+    SerializationStatus begin_array(MutableBufferView& bv) {
+        return put(bv, (cbor::array << 5) | 31);
+    }
+    SerializationStatus end_array(MutableBufferView& bv) {
+        return put(bv, cbor::break_code);
+    }
+    SerializationStatus separator(MutableBufferView&) {
+        return SerializationStatus::Ok;
+    }
+
+    SerializationStatus key(MutableBufferView& bv, std::string_view key) {
+        return string(bv, cbor::text, key.data(), key.size());
+    }
+
+    template <typename T, std::size_t I>
+    SerializationStatus key(MutableBufferView& bv, static_key<T, I>) {
+        constexpr auto& text = detail::cbor_key_literal<T, I>::text;
+        if (text.size() > bv.size()) {
+            return SerializationStatus::BufferFull;
+        }
+        std::memcpy(bv.data(), text.data(), text.size());
+        bv += text.size();
+        return SerializationStatus::Ok;
+    }
+
+    template <typename T>
+    SerializationStatus value(MutableBufferView& bv, T&& value) {
+        using D = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<D, bool>) {
+            return put(bv, value ? cbor::true_value : cbor::false_value);
+        } else if constexpr (std::is_integral_v<D>) {
+            if constexpr (std::is_signed_v<D>) {
+                if (value < 0) {
+                    // -1 - value, without overflow
+                    return header(bv, cbor::negative_int,
+                                  ~static_cast<std::uint64_t>(value));
+                }
+            }
+            return header(bv, cbor::unsigned_int,
+                          static_cast<std::uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<D>) {
+            return write_float(bv, static_cast<double>(value));
+        } else if constexpr (std::is_same_v<D, BufferView>) {
+            return bytes(bv, value);
+        } else if constexpr (CBORIsNull<D>) {
+            return put(bv, cbor::null_value);
+        } else if constexpr (std::convertible_to<D, std::string_view>) {
+            const std::string_view s(value);
+            return string(bv, cbor::text, s.data(), s.size());
+        } else {
+            static_assert([] { return false; }(), "Unsupported type for value");
+            return SerializationStatus::Ok;
+        }
+    }
+
+    // Byte strings: the whole string, or only its header for writers that
+    // place the contents elsewhere (see GatherSerializer).
+    SerializationStatus bytes(MutableBufferView& bv, BufferView data) {
+        return string(bv, cbor::bytes, data.data(), data.size());
+    }
+    static SerializationStatus bytes_header(MutableBufferView& bv,
+                                            std::size_t n) {
+        return header(bv, cbor::bytes, n);
+    }
+
+    static constexpr std::size_t key_overhead() { return 1; }
+    static constexpr std::size_t obj_overhead() { return 2; }
+    static constexpr std::size_t array_overhead() { return 2; }
+    static constexpr std::size_t meta_overhead() { return 2; }
+    template <typename T>
+    static constexpr std::size_t value_overhead() {
+        return 9;
+    }
+
+    // Exact sizes, for serialized_size.
+    static constexpr std::size_t obj_overhead(std::size_t n) {
+        return cbor::header_size(n);
+    }
+    static constexpr std::size_t array_overhead(std::size_t n) {
+        return cbor::header_size(n);
+    }
+    static constexpr std::size_t separator_size() { return 0; }
+    static constexpr std::size_t key_size(std::string_view key) {
+        return cbor::header_size(key.size()) + key.size();
+    }
+    template <typename T, std::size_t I>
+    static constexpr std::size_t key_size(static_key<T, I>) {
+        return detail::cbor_key_literal<T, I>::size;
+    }
+    template <typename T>
+    static constexpr std::size_t value_size(const T& value) {
+        if constexpr (std::is_same_v<T, bool> || CBORIsNull<T>) {
+            return 1;
+        } else if constexpr (std::is_integral_v<T>) {
+            if constexpr (std::is_signed_v<T>) {
+                if (value < 0) {
+                    return cbor::header_size(
+                        ~static_cast<std::uint64_t>(value));
+                }
+            }
+            return cbor::header_size(static_cast<std::uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return cbor::fits_float(static_cast<double>(value)) ? 5 : 9;
+        } else if constexpr (std::is_same_v<T, BufferView>) {
+            return cbor::header_size(value.size()) + value.size();
+        } else {
+            const std::string_view s(value);
+            return cbor::header_size(s.size()) + s.size();
+        }
+    }
+    template <typename T>
+        requires std::is_arithmetic_v<T> || CBORIsNull<T>
+    static constexpr std::size_t max_value_size() {
+        if constexpr (std::is_same_v<T, bool> || CBORIsNull<T>) {
+            return 1;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return 9;
+        } else {
+            return 1 + sizeof(T);
+        }
+    }
+
+   private:
+    static SerializationStatus put(MutableBufferView& bv, std::uint8_t b) {
+        if (bv.size() == 0) {
+            return SerializationStatus::BufferFull;
+        }
+        bv[0] = static_cast<char>(b);
+        bv += 1;
+        return SerializationStatus::Ok;
+    }
+
+    static SerializationStatus header(MutableBufferView& bv,
+                                      std::uint8_t major, std::uint64_t arg) {
+        const std::size_t n = cbor::header_size(arg);
+        if (n > bv.size()) {
+            return SerializationStatus::BufferFull;
+        }
+        cbor::write_header(bv.data(), major, arg);
+        bv += n;
+        return SerializationStatus::Ok;
+    }
+
+    static SerializationStatus string(MutableBufferView& bv,
+                                      std::uint8_t major, const char* data,
+                                      std::size_t size) {
+        if (cbor::header_size(size) + size > bv.size()) {
+            return SerializationStatus::BufferFull;
+        }
+        char* p = cbor::write_header(bv.data(), major, size);
+        if (size > 0) {
+            std::memcpy(p, data, size);
+        }
+        bv += cbor::header_size(size) + size;
+        return SerializationStatus::Ok;
+    }
+
+    static SerializationStatus write_float(MutableBufferView& bv, double v) {
+        if (cbor::fits_float(v)) {
+            if (bv.size() < 5) {
+                return SerializationStatus::BufferFull;
+            }
+            bv[0] = static_cast<char>(cbor::float32);
+            const auto bits = hton(std::bit_cast<std::uint32_t>(
+                static_cast<float>(v)));
+            std::memcpy(bv.data() + 1, &bits, 4);
+            bv += 5;
+        } else {
+            if (bv.size() < 9) {
+                return SerializationStatus::BufferFull;
+            }
+            bv[0] = static_cast<char>(cbor::float64);
+            const auto bits = hton(std::bit_cast<std::uint64_t>(v));
+            std::memcpy(bv.data() + 1, &bits, 8);
+            bv += 9;
+        }
+        return SerializationStatus::Ok;
+    }
+};
+
+};  // namespace csics::serialization
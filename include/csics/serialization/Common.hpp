@@ -1,6 +1,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+
 #include "csics/Buffer.hpp"
 namespace csics::serialization {
 enum class SerializationStatus {
@@ -16,6 +19,57 @@ enum class DeserializationStatus {
     InvalidData,
 };
 
+// Why and where deserialization failed. `offset` is the number of bytes
+// consumed from the deserializer's buffer when the failure was detected, and
+// `field` names the member of the value being decoded, if known.
+struct DeserializationError {
+    DeserializationStatus reason = DeserializationStatus::InvalidData;
+    std::size_t offset = 0;
+    const char* field = nullptr;
+
+    constexpr DeserializationError() = default;
+    constexpr DeserializationError(DeserializationStatus reason,
+                                   std::size_t offset = 0,
+                                   const char* field = nullptr)
+        : reason(reason), offset(offset), field(field) {}
+
+    constexpr bool operator==(DeserializationStatus status) const noexcept {
+        return reason == status;
+    }
+};
+
+// Optional trace hook for debugging decoders, compiled in only with
+// CSICS_SERIALIZATION_TRACE. Without it trace() is an empty inline function
+// and guarded call sites compile away, so decoding never does I/O.
+#ifdef CSICS_SERIALIZATION_TRACE
+inline constexpr bool trace_enabled = true;
+#else
+inline constexpr bool trace_enabled = false;
+#endif
+
+// event is e.g. "deserialize" or "error", detail the type or field name.
+using trace_hook = void (*)(std::string_view event, std::string_view detail,
+                            std::size_t offset);
+
+inline trace_hook& trace_hook_ref() noexcept {
+    static trace_hook hook = nullptr;
+    return hook;
+}
+
+inline void set_trace_hook(trace_hook hook) noexcept {
+    trace_hook_ref() = hook;
+}
+
+inline void trace([[maybe_unused]] std::string_view event,
+                  [[maybe_unused]] std::string_view detail,
+                  [[maybe_unused]] std::size_t offset = 0) {
+    if constexpr (trace_enabled) {
+        if (auto hook = trace_hook_ref()) {
+            hook(event, detail, offset);
+        }
+    }
+}
+
 struct SerializationResult {
     MutableBufferView written_view;
     SerializationStatus status;
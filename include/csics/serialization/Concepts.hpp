@@ -40,6 +40,7 @@ concept StructuralSerializer =
         { s.begin_array(bv) } -> std::same_as<SerializationStatus>;
         { s.end_array(bv) } -> std::same_as<SerializationStatus>;
         { s.key(bv, key) } -> std::same_as<SerializationStatus>;
+        { s.separator(bv) } -> std::same_as<SerializationStatus>;
         { S::key_overhead() } -> std::convertible_to<std::size_t>;
         { S::obj_overhead() } -> std::convertible_to<std::size_t>;
         { S::array_overhead() } -> std::convertible_to<std::size_t>;
@@ -64,6 +65,21 @@ concept StructuralSerializer =
         } -> std::same_as<SerializationStatus>;
     } && std::default_initializable<S>;
 
+// Structural serializers that can report the exact size of what they write,
+// for sizing an output buffer before serializing.
+template <typename S>
+concept SizedSerializer =
+    StructuralSerializer<S> && requires(const S s, std::string_view key) {
+        { s.separator_size() } -> std::convertible_to<std::size_t>;
+        { s.key_size(key) } -> std::convertible_to<std::size_t>;
+        { s.value_size(int{}) } -> std::convertible_to<std::size_t>;
+        { s.value_size(double{}) } -> std::convertible_to<std::size_t>;
+        { s.value_size(bool{}) } -> std::convertible_to<std::size_t>;
+        {
+            s.value_size(std::string_view{})
+        } -> std::convertible_to<std::size_t>;
+    };
+
 template <typename S>
 concept WireSerializer = requires(S s, MutableBufferView bv) {
     { s.write(bv, 0) } -> std::same_as<SerializationStatus>;
@@ -81,6 +97,20 @@ concept Deserializer = requires(D d) {
     } -> std::same_as<expected<uint8_t, typename D::error_type>>;
 } && std::constructible_from<D, BufferView>;
 
+// Deserializers of keyed formats, where struct fields are looked up by name
+// rather than read in field-list order.
+template <typename D>
+concept ObjectDeserializer =
+    Deserializer<D> && requires(D d, std::string_view key) {
+        {
+            d.begin_obj()
+        } -> std::same_as<expected<void, typename D::error_type>>;
+        {
+            d.field(key)
+        } -> std::same_as<expected<void, typename D::error_type>>;
+        { d.end_obj() } -> std::same_as<expected<void, typename D::error_type>>;
+    };
+
 template <typename T, typename D>
 concept PrimitiveDeserializable = Deserializer<D> && requires(D d) {
     {
@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include <optional>
+#include <typeinfo>
+
+#include "csics/serialization/Common.hpp"
 #include "csics/serialization/Concepts.hpp"
 
 namespace csics::serialization {
@@ -15,34 +19,61 @@ struct De {
     }
 
    private:
+    // Fields are read in field-list order, or looked up by name when the
+    // deserializer reads a keyed format. The value is moved into the result,
+    // leaving `t` unspecified.
     template <Deserializer D, typename T>
-        requires StructSerializable<std::remove_cvref_t<T>, D>
-    static constexpr auto apply(D& d, T& t) {
-        auto fields = get_fields<T>();
-        return std::apply(
+        requires StructSerializable<std::remove_cvref_t<T>, D> &&
+                 (!DirectDeserializable<std::remove_cvref_t<T>, D>)
+    static constexpr expected<std::remove_cvref_t<T>, typename D::error_type>
+    apply(D& d, T& t) {
+        using E = typename D::error_type;
+        if constexpr (ObjectDeserializer<D>) {
+            if (auto r = d.begin_obj(); !r) {
+                return E(r.error());
+            }
+        }
+        std::optional<E> error;
+        std::apply(
             [&](auto&&... field) {
-                expected<void, typename D::error_type> res{};
-                bool success = true;
-
                 (
                     [&] {
-                        if (!success) {
+                        if (error) {
                             return;
                         }
-                        res = apply(d, t.*(field.ptr()));
-                        if (!res.has_value()) {
-                            success = false;
+                        if constexpr (ObjectDeserializer<D>) {
+                            if (auto r = d.field(field.name()); !r) {
+                                error = E(r.error());
+                                return;
+                            }
+                        }
+                        auto res = apply(d, t.*(field.ptr()));
+                        if (!res) {
+                            error = tag_field(E(res.error()),
+                                              field.name().data());
                             return;
                         }
-                        t.*(field.ptr()) = std::move(res.value());
+                        t.*(field.ptr()) = std::move(*res);
                     }(),
                     ...);
             },
-            fields);
+            get_fields<T>());
+        if (error) {
+            return *error;
+        }
+        if constexpr (ObjectDeserializer<D>) {
+            if (auto r = d.end_obj(); !r) {
+                return E(r.error());
+            }
+        }
+        return std::move(t);
     }
 
+    // A trivially copyable type with its own deserialize_direct (e.g. a
+    // fixed size wire record) is decoded by that, not copied byte for byte.
     template <Deserializer D, typename T>
-        requires PrimitiveDeserializable<std::remove_cvref_t<T>, D>
+        requires PrimitiveDeserializable<std::remove_cvref_t<T>, D> &&
+                 (!DirectDeserializable<std::remove_cvref_t<T>, D>)
     static constexpr expected<T, typename D::error_type> apply(D& d, T& t) {
         auto res = d.template read<std::remove_cvref_t<T>>();
         if (!res.has_value()) {
@@ -71,12 +102,69 @@ struct De {
     template <Deserializer D, typename T>
         requires DirectDeserializable<std::remove_cvref_t<T>, D>
     static constexpr auto apply(D& d, T&) {
-        std::cerr << "Applying direct deserialization for type "
-                  << typeid(T).name() << std::endl;
+        if constexpr (trace_enabled) {
+            trace("deserialize", typeid(T).name());
+        }
         return deserialize_direct(d, detail::type_tag<T>{});
     }
 };
 
 constexpr De deserialize{};
 
+// Helpers for deserialize_direct implementations, so errors keep the reason
+// and offset reported by the deserializer and gain a field name.
+
+// Sets the field of a structured error. Enclosing decoders overwrite the
+// names set by nested ones, so the field ends up naming the member of the
+// top-level value; the offset still points at the failing byte.
+template <typename E>
+constexpr E tag_field(E error, const char* field) {
+    if constexpr (requires { error.field; }) {
+        error.field = field;
+    }
+    if constexpr (trace_enabled) {
+        trace("error", field);
+    }
+    return error;
+}
+
+// First failed result among ("name", result) pairs, tagged with its name.
+template <typename E>
+constexpr std::optional<E> first_error() {
+    return std::nullopt;
+}
+
+template <typename E, typename R, typename... Rest>
+constexpr std::optional<E> first_error(const char* field, const R& result,
+                                       const Rest&... rest) {
+    if (!result) {
+        return tag_field(E(result.error()), field);
+    }
+    return first_error<E>(rest...);
+}
+
+// InvalidData error at the deserializer's current position.
+template <Deserializer D>
+constexpr typename D::error_type invalid_data(const D& d, const char* field) {
+    using E = typename D::error_type;
+    if constexpr (requires { d.offset(); }) {
+        return tag_field(E(DeserializationStatus::InvalidData, d.offset()),
+                         field);
+    } else {
+        return tag_field(E(DeserializationStatus::InvalidData), field);
+    }
+}
+
+// An empty Buffer<T> for a deserialize_direct implementation to fill,
+// allocating from the deserializer's memory resource when it has one.
+template <typename T, typename D>
+Buffer<T> make_buffer(D& d) {
+    if constexpr (requires { d.resource(); }) {
+        if (auto* resource = d.resource()) {
+            return Buffer<T>(*resource);
+        }
+    }
+    return Buffer<T>();
+}
+
 };  // namespace csics::serialization
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <optional>
 
 #include "csics/Bit.hpp"
@@ -17,8 +18,9 @@ class DirectSerializer {
     SerializationStatus write(MutableBufferView& bv, T&& t) {
         // direct byte-wise copying of the object into the buffer.
         if (sizeof(T) > bv.size()) {
-            std::cerr << "Buffer too small to write type of size " << sizeof(T)
-                      << " bytes, only " << bv.size() << " bytes left\n";
+            if constexpr (trace_enabled) {
+                trace("buffer_full", "write", bv.size());
+            }
             return SerializationStatus::BufferFull;
         }
         std::memcpy(bv.data(), &t, sizeof(T));
@@ -31,6 +33,21 @@ class DirectSerializer {
         return write(bv, t.repr_);
     }
 
+    // Copies a blob of raw bytes in one go.
+    SerializationStatus bytes(MutableBufferView& bv, BufferView data) {
+        if (data.size() > bv.size()) {
+            if constexpr (trace_enabled) {
+                trace("buffer_full", "bytes", bv.size());
+            }
+            return SerializationStatus::BufferFull;
+        }
+        if (data.size() > 0) {
+            std::memcpy(bv.data(), data.data(), data.size());
+        }
+        bv += data.size();
+        return SerializationStatus::Ok;
+    }
+
     SerializationStatus pad(MutableBufferView& bv, std::size_t padding_bytes) {
         if (padding_bytes > bv.size()) {
             return SerializationStatus::BufferFull;
@@ -43,8 +60,17 @@ class DirectSerializer {
 
 class DirectDeserializer {
    public:
-    using error_type = DeserializationStatus;
-    DirectDeserializer(BufferView bv) : bv_(bv) {}
+    using error_type = DeserializationError;
+    DirectDeserializer(BufferView bv) : bv_(bv), size_(bv.size()) {}
+    // Containers in the decoded values allocate from `resource`, e.g. an
+    // Arena reset once the batch they were decoded from is done with.
+    DirectDeserializer(BufferView bv, std::pmr::memory_resource* resource)
+        : bv_(bv), size_(bv.size()), resource_(resource) {}
+
+    // Bytes consumed so far.
+    std::size_t offset() const noexcept { return size_ - bv_.size(); }
+    std::size_t remaining() const noexcept { return bv_.size(); }
+    std::pmr::memory_resource* resource() const noexcept { return resource_; }
 
     template <typename T>
         requires is_endian_wrapper<T>::value ||
@@ -53,35 +79,54 @@ class DirectDeserializer {
         if constexpr (is_endian_wrapper<T>::value) {
             using UnderlyingT = typename T::value_type;
             if (sizeof(UnderlyingT) > bv_.size()) {
-                return unexpected(DeserializationStatus::BufferEmpty);
+                return buffer_empty();
             }
             UnderlyingT repr;
             std::memcpy(&repr, bv_.data(), sizeof(UnderlyingT));
             bv_ += sizeof(UnderlyingT);
             T value;
             value.repr_ = repr;
-            return expected<T, DeserializationStatus>(value);
+            return expected<T, error_type>(value);
         } else if constexpr (std::is_trivially_copyable_v<
                                  std::remove_cvref_t<T>>) {
             if (sizeof(T) > bv_.size()) {
-                return unexpected(DeserializationStatus::BufferEmpty);
+                return buffer_empty();
             }
             T value;
             std::memcpy(&value, bv_.data(), sizeof(T));
             bv_ += sizeof(T);
-            return expected<T, DeserializationStatus>(value);
+            return expected<T, error_type>(value);
         }
     }
 
     expected<void, error_type> skip(std::size_t bytes) {
         if (bytes > bv_.size()) {
-            return unexpected(DeserializationStatus::BufferEmpty);
+            return buffer_empty();
         }
         bv_ += bytes;
-        return expected<void, DeserializationStatus>();
+        return expected<void, error_type>();
+    }
+
+    // Returns a view of the next `bytes` bytes without copying them.
+    expected<BufferView, error_type> read_bytes(std::size_t bytes) {
+        if (bytes > bv_.size()) {
+            return buffer_empty();
+        }
+        BufferView view = bv_.head(bytes);
+        bv_ += bytes;
+        return expected<BufferView, error_type>(view);
     }
 
    private:
     BufferView bv_;
+    std::size_t size_;
+    std::pmr::memory_resource* resource_ = nullptr;
+
+    unexpected<error_type> buffer_empty() const {
+        if constexpr (trace_enabled) {
+            trace("error", "buffer_empty", offset());
+        }
+        return error_type(DeserializationStatus::BufferEmpty, offset());
+    }
 };
 };  // namespace csics::serialization
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "csics/Buffer.hpp"
+#include "csics/serialization/Common.hpp"
+
+namespace csics::serialization {
+
+// Writes a blob of raw bytes: s.bytes(bv, data) when S has it, one byte at
+// a time through s.write otherwise.
+template <typename S>
+constexpr SerializationStatus write_bytes(S& s, MutableBufferView& bv,
+                                          BufferView data) {
+    if constexpr (requires { s.bytes(bv, data); }) {
+        return s.bytes(bv, data);
+    } else {
+        for (const char c : data) {
+            auto status = s.write(bv, static_cast<std::uint8_t>(c));
+            if (status != SerializationStatus::Ok) {
+                return status;
+            }
+        }
+        return SerializationStatus::Ok;
+    }
+}
+
+// How many bytes of an n byte blob passed to write_bytes land in the output
+// buffer; less than n for serializers that reference blobs instead.
+template <typename S>
+constexpr std::size_t staged_size(const S& s, std::size_t n) {
+    if constexpr (requires { s.staged_size(n); }) {
+        return s.staged_size(n);
+    } else {
+        return n;
+    }
+}
+
+// Serializer adaptor for scatter-gather output. Blobs of at least
+// `threshold` bytes written through write_bytes (BufferView values, DIS
+// variable parameter data and signal samples) are not copied: S writes
+// any length prefix they carry, and the blob is recorded by reference at
+// that point in the output. Everything else is written by S as usual.
+//
+// chunks() then splits what serialize() wrote around those references,
+// giving the full encoding as a chunk list for sendmsg/writev:
+//
+//   GatherSerializer<DirectSerializer> s;
+//   auto res = serialize(s, staging, pdu);
+//   udp.send_gather(s.chunks(res.written_view), dest);
+//   s.clear();
+//
+// Referenced blobs must outlive the chunk list. Call clear() before
+// serializing the next message.
+template <typename S>
+class GatherSerializer : public S {
+   public:
+    static constexpr std::size_t default_threshold = 256;
+
+    GatherSerializer() = default;
+    explicit GatherSerializer(std::size_t threshold) : threshold_(threshold) {}
+
+    std::size_t threshold() const noexcept { return threshold_; }
+
+    SerializationStatus bytes(MutableBufferView& bv, BufferView data) {
+        if (data.size() < threshold_) {
+            return write_bytes(static_cast<S&>(*this), bv, data);
+        }
+        if constexpr (requires { S::bytes_header(bv, data.size()); }) {
+            auto status = S::bytes_header(bv, data.size());
+            if (status != SerializationStatus::Ok) {
+                return status;
+            }
+        }
+        refs_.push_back(Ref{bv.data(), data});
+        referenced_ += data.size();
+        return SerializationStatus::Ok;
+    }
+
+    std::size_t staged_size(std::size_t n) const noexcept {
+        return n < threshold_ ? n : 0;
+    }
+
+    // Bytes recorded by reference since the last clear().
+    std::size_t referenced() const noexcept { return referenced_; }
+
+    // The encoding of `written`, the view returned by serialize(), in
+    // order: staged bytes interleaved with the referenced blobs. Valid
+    // until the next call or clear().
+    std::span<const BufferView> chunks(BufferView written) {
+        chunks_.clear();
+        const char* at = written.data();
+        for (const auto& ref : refs_) {
+            if (ref.at > at) {
+                chunks_.push_back(
+                    BufferView(at, static_cast<std::size_t>(ref.at - at)));
+                at = ref.at;
+            }
+            if (ref.data.size() > 0) {
+                chunks_.push_back(ref.data);
+            }
+        }
+        const char* end = written.data() + written.size();
+        if (end > at) {
+            chunks_.push_back(
+                BufferView(at, static_cast<std::size_t>(end - at)));
+        }
+        return {chunks_.data(), chunks_.size()};
+    }
+
+    void clear() {
+        refs_.clear();
+        chunks_.clear();
+        referenced_ = 0;
+    }
+
+   private:
+    // A blob that follows the staged bytes before `at`.
+    struct Ref {
+        const char* at;
+        BufferView data;
+    };
+
+    std::size_t threshold_ = default_threshold;
+    std::size_t referenced_ = 0;
+    Buffer<Ref> refs_;
+    Buffer<BufferView> chunks_;
+};
+
+};  // namespace csics::serialization
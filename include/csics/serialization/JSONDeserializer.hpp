@@ -0,0 +1,213 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "csics/Buffer.hpp"
+#include "csics/serialization/Common.hpp"
+#include "csics/serialization/Concepts.hpp"
+#include "csics/serialization/Deserializer.hpp"
+
+namespace csics::serialization {
+
+template <typename T>
+concept JSONPrimitive =
+    std::is_arithmetic_v<T> || std::same_as<T, std::string_view> ||
+    std::same_as<T, std::string> || std::same_as<T, std::nullptr_t>;
+
+// Reads JSON into the same field-listed types JSONSerializer writes.
+//
+// Parsing is two-stage. The constructor scans the whole input 64 bytes at a
+// time (SSE2/NEON where available) and records the offset of every
+// structural character, string and scalar outside strings. Reads then walk
+// that index on demand: only values that are read get decoded, and other
+// values are skipped by index without looking at their bytes. Object fields
+// are looked up by key, fastest when they appear in field-list order.
+//
+// Nothing is copied from the input: std::string_view values point into it,
+// except strings with escapes, which are unescaped into scratch space owned
+// by the deserializer. Either way the views are valid while both the input
+// and the deserializer are. Types read as elements of arrays and maps must
+// be default constructible.
+class JSONDeserializer {
+   public:
+    using error_type = DeserializationError;
+    using exact_primitives =
+        std::tuple<bool, int, double, std::string_view, std::nullptr_t>;
+    using convertible_primitives = std::tuple<double, std::string_view>;
+
+    // Inputs of 4 GiB or more are rejected: every read fails with
+    // InvalidData at offset 0.
+    explicit JSONDeserializer(BufferView json);
+
+    // Byte offset of the next value to be read.
+    std::size_t offset() const noexcept { return position(cur_); }
+
+    // Number of entries in the structural index.
+    std::size_t structural_count() const noexcept { return count_; }
+
+    template <JSONPrimitive T>
+    expected<T, error_type> read() {
+        if (!ok_) {
+            return error_type(DeserializationStatus::InvalidData, error_at_);
+        }
+        if constexpr (std::same_as<T, bool>) {
+            return read_bool();
+        } else if constexpr (std::same_as<T, std::nullptr_t>) {
+            if (auto r = read_literal("null"); !r) {
+                return r.error();
+            }
+            return nullptr;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return read_number<T>();
+        } else if constexpr (std::same_as<T, std::string_view>) {
+            return read_string_view();
+        } else {
+            return read_string();
+        }
+    }
+
+    // JSON arrays into containers with push_back or insert.
+    template <typename T>
+    expected<T, error_type> read_iterable(T& out) {
+        if (auto r = begin_array(); !r) {
+            return error_type(r.error());
+        }
+        out.clear();
+        bool more = !at(']');
+        while (more) {
+            typename T::value_type value{};
+            auto res = deserialize(*this, value);
+            if (!res) {
+                return res.error();
+            }
+            if constexpr (requires { out.push_back(std::move(*res)); }) {
+                out.push_back(std::move(*res));
+            } else {
+                out.insert(out.end(), std::move(*res));
+            }
+            auto next = next_element(']');
+            if (!next) {
+                return next.error();
+            }
+            more = *next;
+        }
+        return std::move(out);
+    }
+
+    // JSON objects into maps keyed by strings.
+    template <typename T>
+    expected<T, error_type> read_map(T& out) {
+        if (auto r = begin_obj(); !r) {
+            return error_type(r.error());
+        }
+        ObjectFrame frame{*this};
+        out.clear();
+        bool more = !at('}');
+        while (more) {
+            auto key = read_key();
+            if (!key) {
+                return key.error();
+            }
+            typename T::mapped_type value{};
+            auto res = deserialize(*this, value);
+            if (!res) {
+                return res.error();
+            }
+            out.emplace(typename T::key_type(*key), std::move(*res));
+            auto next = next_element('}');
+            if (!next) {
+                return next.error();
+            }
+            more = *next;
+        }
+        return std::move(out);
+    }
+
+    // Object access for field-listed types. begin_obj enters the object at
+    // the cursor, field positions the cursor at the value of `key` and
+    // end_obj leaves the object whatever has been read from it.
+    expected<void, error_type> begin_obj();
+    expected<void, error_type> field(std::string_view key);
+    expected<void, error_type> end_obj();
+
+    // Skips the value at the cursor.
+    expected<void, error_type> skip();
+
+   private:
+    BufferView json_;
+    Buffer<std::uint32_t> index_;  // offsets of structural characters
+    std::size_t count_ = 0;
+    std::size_t cur_ = 0;  // position in index_
+    Buffer<std::uint32_t> objects_;  // index of the first key of each
+                                     // object entered
+    Buffer<char> scratch_;  // unescaped strings
+    std::size_t scratch_used_ = 0;
+    bool ok_ = true;
+    std::size_t error_at_ = 0;
+
+    void build_index();
+
+    std::size_t position(std::size_t i) const noexcept {
+        return i < count_ ? index_[i] : json_.size();
+    }
+    char token(std::size_t i) const noexcept {
+        return i < count_ ? json_.data()[index_[i]] : '\0';
+    }
+    bool at(char c) const noexcept { return token(cur_) == c; }
+
+    // Bytes of the scalar or string starting at index entry i, up to the
+    // next entry with trailing whitespace removed.
+    std::string_view token_text(std::size_t i) const noexcept;
+
+    unexpected<error_type> invalid() const {
+        return unexpected<error_type>(
+            error_type(DeserializationStatus::InvalidData, offset()));
+    }
+
+    expected<void, error_type> begin_array();
+    // After an element: true if another follows, false past the closing
+    // bracket.
+    expected<bool, error_type> next_element(char close);
+    expected<std::string_view, error_type> read_key();
+    void pop_object() noexcept;
+    // Leaves the object entered by begin_obj on every exit from a read.
+    struct ObjectFrame {
+        JSONDeserializer& d;
+        ~ObjectFrame() { d.pop_object(); }
+    };
+    std::size_t skip_from(std::size_t i) const noexcept;
+
+    expected<bool, error_type> read_bool();
+    expected<void, error_type> read_literal(std::string_view literal);
+    expected<std::string_view, error_type> read_string_view();
+    expected<std::string, error_type> read_string();
+    // The raw contents of the string at the cursor, without its quotes.
+    expected<std::string_view, error_type> raw_string();
+
+    template <typename T>
+    expected<T, error_type> read_number() {
+        const std::string_view text = token_text(cur_);
+        if (text.empty()) {
+            return invalid();
+        }
+        const char* first = text.data();
+        const char* last = first + text.size();
+        T value{};
+        const auto res = std::from_chars(first, last, value);
+        if (res.ec != std::errc{} || res.ptr != last) {
+            return invalid();
+        }
+        ++cur_;
+        return value;
+    }
+};
+
+};  // namespace csics::serialization
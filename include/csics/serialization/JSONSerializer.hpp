@@ -1,9 +1,16 @@
-
 #pragma once
 
-#include "csics/serialization/Serializer.hpp"
-#include <memory>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <optional>
+#include <string_view>
+
+#include "csics/serialization/Serializer.hpp"
 
 namespace csics::serialization {
 
@@ -11,33 +18,265 @@ template <typename T>
 concept JSONIsNull =
     std::same_as<T, std::nullptr_t> || std::same_as<T, std::nullopt_t>;
 
+namespace detail {
+
+// Length of s as a JSON string body.
+constexpr std::size_t json_escaped_size(std::string_view s) {
+    std::size_t n = 0;
+    for (char c : s) {
+        if (c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' ||
+            c == '\r' || c == '\t') {
+            n += 2;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            n += 6;
+        } else {
+            n += 1;
+        }
+    }
+    return n;
+}
+
+// Writes s as a JSON string body to out, which must hold
+// json_escaped_size(s) bytes. Returns the end of the written bytes.
+constexpr char* json_escape(std::string_view s, char* out) {
+    constexpr char hex[] = "0123456789abcdef";
+    for (char c : s) {
+        const auto u = static_cast<unsigned char>(c);
+        if (c != '"' && c != '\\' && u >= 0x20) {
+            *out++ = c;
+            continue;
+        }
+        *out++ = '\\';
+        switch (c) {
+            case '"':
+            case '\\':
+                *out++ = c;
+                break;
+            case '\b':
+                *out++ = 'b';
+                break;
+            case '\f':
+                *out++ = 'f';
+                break;
+            case '\n':
+                *out++ = 'n';
+                break;
+            case '\r':
+                *out++ = 'r';
+                break;
+            case '\t':
+                *out++ = 't';
+                break;
+            default:
+                *out++ = 'u';
+                *out++ = '0';
+                *out++ = '0';
+                *out++ = hex[u >> 4];
+                *out++ = hex[u & 0xF];
+        }
+    }
+    return out;
+}
+
+// The key of field I of T as written in an object: the separator from the
+// previous member, if any, then the quoted, escaped name and a colon.
+template <typename T, std::size_t I>
+struct json_key_literal {
+    static constexpr std::string_view name =
+        std::get<I>(get_fields<T>()).name();
+    static constexpr std::size_t size =
+        json_escaped_size(name) + 3 + (I > 0 ? 1 : 0);
+    static constexpr std::array<char, size> text = [] {
+        std::array<char, size> out{};
+        char* p = out.data();
+        if (I > 0) {
+            *p++ = ',';
+        }
+        *p++ = '"';
+        p = json_escape(name, p);
+        *p++ = '"';
+        *p = ':';
+        return out;
+    }();
+};
+
+inline constexpr char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536"
+    "37383940414243444546474849505152535455565758596061626364656667686970717273"
+    "7475767778798081828384858687888990919293949596979899";
+
+// Decimal digits in v, without a loop: the bit length gives the digit count
+// to within one, and one table compare settles it.
+constexpr std::size_t decimal_digits(std::uint64_t v) noexcept {
+    constexpr std::uint64_t pow10[] = {1ull,
+                                       10ull,
+                                       100ull,
+                                       1000ull,
+                                       10000ull,
+                                       100000ull,
+                                       1000000ull,
+                                       10000000ull,
+                                       100000000ull,
+                                       1000000000ull,
+                                       10000000000ull,
+                                       100000000000ull,
+                                       1000000000000ull,
+                                       10000000000000ull,
+                                       100000000000000ull,
+                                       1000000000000000ull,
+                                       10000000000000000ull,
+                                       100000000000000000ull,
+                                       1000000000000000000ull,
+                                       10000000000000000000ull};
+    const std::size_t t =
+        static_cast<std::size_t>(std::bit_width(v | 1) * 1233) >> 12;
+    return t + ((v | 1) >= pow10[t]);
+}
+
+// Writes v in decimal at out, two digits at a time from the end. Returns the
+// end of the written digits.
+constexpr char* write_decimal(std::uint64_t v, char* out) noexcept {
+    char* const end = out + decimal_digits(v);
+    char* p = end;
+    while (v >= 100) {
+        const std::size_t i = (v % 100) * 2;
+        v /= 100;
+        *--p = digit_pairs[i + 1];
+        *--p = digit_pairs[i];
+    }
+    if (v >= 10) {
+        *--p = digit_pairs[v * 2 + 1];
+        *--p = digit_pairs[v * 2];
+    } else {
+        *--p = static_cast<char>('0' + v);
+    }
+    return end;
+}
+
+}  // namespace detail
+
+// Writes compact JSON. The serializer is stateless: the serialize driver
+// places separators, and struct keys are written from literals built at
+// compile time from the field lists. Every write is checked against the
+// space left in the view; one that does not fit returns BufferFull without
+// advancing the view.
 class JSONSerializer {
    public:
     using exact_primitives =
         std::tuple<bool, int, double, std::string_view, std::nullptr_t>;
     using convertible_primitives = std::tuple<std::string_view>;
-    JSONSerializer();
-    ~JSONSerializer();
-
-    SerializationStatus begin_obj(MutableBufferView& bv);
-    SerializationStatus end_obj(MutableBufferView& bv);
-    SerializationStatus begin_array(MutableBufferView& bv);
-    SerializationStatus end_array(MutableBufferView& bv);
-    SerializationStatus key(MutableBufferView& bv, std::string_view key);
+
+    SerializationStatus begin_obj(MutableBufferView& bv) {
+        return put(bv, '{');
+    }
+    SerializationStatus end_obj(MutableBufferView& bv) { return put(bv, '}'); }
+    SerializationStatus begin_array(MutableBufferView& bv) {
+        return put(bv, '[');
+    }
+    SerializationStatus end_array(MutableBufferView& bv) {
+        return put(bv, ']');
+    }
+    SerializationStatus separator(MutableBufferView& bv) {
+        return put(bv, ',');
+    }
+
+    SerializationStatus key(MutableBufferView& bv, std::string_view key) {
+        const std::size_t n = detail::json_escaped_size(key) + 3;
+        if (n > bv.size()) {
+            return SerializationStatus::BufferFull;
+        }
+        char* p = bv.c();
+        *p++ = '"';
+        p = detail::json_escape(key, p);
+        *p++ = '"';
+        *p = ':';
+        bv += n;
+        return SerializationStatus::Ok;
+    }
+
+    // Field keys, separator included, copied from their literal.
+    template <typename T, std::size_t I>
+    SerializationStatus key(MutableBufferView& bv, static_key<T, I>) {
+        constexpr auto& text = detail::json_key_literal<T, I>::text;
+        if (text.size() > bv.size()) {
+            return SerializationStatus::BufferFull;
+        }
+        std::memcpy(bv.c(), text.data(), text.size());
+        bv += text.size();
+        return SerializationStatus::Ok;
+    }
+
+    // Exact sizes of what the writes above produce, for serialized_size.
+    static constexpr std::size_t separator_size() { return 1; }
+    static constexpr std::size_t key_size(std::string_view key) {
+        return detail::json_escaped_size(key) + 3;
+    }
+    template <typename T, std::size_t I>
+    static constexpr std::size_t key_size(static_key<T, I>) {
+        return detail::json_key_literal<T, I>::size;
+    }
+    template <typename T>
+    static std::size_t value_size(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            return value ? 4 : 5;
+        } else if constexpr (std::is_integral_v<T>) {
+            if constexpr (std::is_signed_v<T>) {
+                return detail::decimal_digits(
+                           value < 0 ? 0 - static_cast<std::uint64_t>(value)
+                                     : static_cast<std::uint64_t>(value)) +
+                       (value < 0);
+            } else {
+                return detail::decimal_digits(value);
+            }
+        } else if constexpr (std::is_floating_point_v<T>) {
+            if (!std::isfinite(static_cast<double>(value))) {
+                return 4;
+            }
+            char tmp[32];
+            return static_cast<std::size_t>(
+                std::to_chars(tmp, tmp + sizeof(tmp),
+                              static_cast<double>(value))
+                    .ptr -
+                tmp);
+        } else if constexpr (std::convertible_to<T, std::string_view>) {
+            return detail::json_escaped_size(std::string_view(value)) + 2;
+        } else {
+            static_assert(JSONIsNull<T>, "Unsupported type for value_size");
+            return 4;
+        }
+    }
+
+    // Longest text of a value of type T, for types whose text is bounded.
+    template <typename T>
+        requires std::is_arithmetic_v<T> || JSONIsNull<T>
+    static constexpr std::size_t max_value_size() {
+        if constexpr (std::is_same_v<T, bool>) {
+            return 5;
+        } else if constexpr (std::is_integral_v<T>) {
+            return detail::decimal_digits(static_cast<std::uint64_t>(
+                       std::numeric_limits<T>::max())) +
+                   std::is_signed_v<T>;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return 24;  // -2.2250738585072014e-308
+        } else {
+            return 4;
+        }
+    }
+
     template <typename T>
     SerializationStatus value(MutableBufferView& bv, T&& value) {
         using D = std::decay_t<T>;
 
         if constexpr (std::is_same_v<D, bool>) {
-            return write_bool(bv, value);
+            return value ? literal(bv, "true") : literal(bv, "false");
         } else if constexpr (std::is_integral_v<D>) {
-            return write_int(bv, static_cast<std::int64_t>(value));
+            return write_int(bv, value);
         } else if constexpr (std::is_floating_point_v<D>) {
             return write_number(bv, static_cast<double>(value));
         } else if constexpr (std::convertible_to<D, std::string_view>) {
             return write_string(bv, std::string_view(value));
         } else if constexpr (JSONIsNull<D>) {
-            return write_null(bv);
+            return literal(bv, "null");
         } else {
             static_assert([] { return false; }(), "Unsupported type for value");
             return SerializationStatus::Ok;  // Unreachable, but satisfies
@@ -77,15 +316,94 @@ class JSONSerializer {
     }
 
    private:
-    struct Impl;
-    std::unique_ptr<Impl> impl_;
-
-    SerializationStatus write_string(MutableBufferView& bv,
-                                     std::string_view str);
-    SerializationStatus write_number(MutableBufferView& bv, double num);
-    SerializationStatus write_bool(MutableBufferView& bv, bool value);
-    SerializationStatus write_null(MutableBufferView& bv);
-    SerializationStatus write_int(MutableBufferView& bv, std::int64_t num);
+    static SerializationStatus put(MutableBufferView& bv, char c) {
+        if (bv.size() == 0) {
+            return SerializationStatus::BufferFull;
+        }
+        *bv.c() = c;
+        bv += 1;
+        return SerializationStatus::Ok;
+    }
+
+    static SerializationStatus literal(MutableBufferView& bv,
+                                       std::string_view text) {
+        if (text.size() > bv.size()) {
+            return SerializationStatus::BufferFull;
+        }
+        std::memcpy(bv.c(), text.data(), text.size());
+        bv += text.size();
+        return SerializationStatus::Ok;
+    }
+
+    template <typename I>
+    static SerializationStatus write_int(MutableBufferView& bv, I num) {
+        char tmp[24];
+        char* p = tmp;
+        std::uint64_t magnitude;
+        if constexpr (std::is_signed_v<I>) {
+            // negate in unsigned arithmetic so the minimum value works
+            const bool negative = num < 0;
+            *p = '-';
+            p += negative;
+            magnitude = negative ? 0 - static_cast<std::uint64_t>(num)
+                                 : static_cast<std::uint64_t>(num);
+        } else {
+            magnitude = num;
+        }
+        p = detail::write_decimal(magnitude, p);
+        return literal(bv, std::string_view(tmp, p - tmp));
+    }
+
+    // Shortest text that reads back as the same double. JSON has no
+    // infinities or NaN, so those are written as null.
+    static SerializationStatus write_number(MutableBufferView& bv,
+                                           double num) {
+        if (!std::isfinite(num)) {
+            return literal(bv, "null");
+        }
+        auto [ptr, ec] = std::to_chars(bv.c(), bv.c() + bv.size(), num);
+        if (ec != std::errc{}) {
+            return SerializationStatus::BufferFull;
+        }
+        bv += ptr - bv.c();
+        return SerializationStatus::Ok;
+    }
+
+    // Runs without escapes are copied whole; the rare escaped character is
+    // written on its own.
+    static SerializationStatus write_string(MutableBufferView& bv,
+                                            std::string_view str) {
+        auto out = bv;
+        if (out.size() < str.size() + 2) {
+            return SerializationStatus::BufferFull;
+        }
+        *out.c() = '"';
+        out += 1;
+        std::size_t i = 0;
+        while (i < str.size()) {
+            std::size_t run = i;
+            while (run < str.size() && str[run] != '"' && str[run] != '\\' &&
+                   static_cast<unsigned char>(str[run]) >= 0x20) {
+                ++run;
+            }
+            // room for the run, then an escape or the closing quote
+            if (out.size() < run - i + (run == str.size() ? 1 : 7)) {
+                return SerializationStatus::BufferFull;
+            }
+            std::memcpy(out.c(), str.data() + i, run - i);
+            out += run - i;
+            if (run == str.size()) {
+                break;
+            }
+            char* end = detail::json_escape(str.substr(run, 1), out.c());
+            out += end - out.c();
+            i = run + 1;
+        }
+        *out.c() = '"';
+        out += 1;
+        bv = out;
+        return SerializationStatus::Ok;
+    }
 };
 
 };  // namespace csics::serialization
@@ -6,6 +6,8 @@
 #error \
     "Serialization support is not enabled. Please define CSICS_BUILD_SERIALIZATION to use serialization."
 #endif
+#include <optional>
+
 #include "csics/Buffer.hpp"
 #include "csics/serialization/Common.hpp"
 #include "csics/serialization/Concepts.hpp"
@@ -15,6 +17,11 @@ namespace csics::serialization {
 // TODO: Replace std::string_view with a more efficient key representation
 // or at least with something not from the standard library to avoid ABI issues.
 
+// The key of field I of T, for serializers that write field keys from
+// literals built at compile time instead of from the name at runtime.
+template <typename T, std::size_t I>
+struct static_key {};
+
 struct serializer {
     template <Serializer S, typename T>
     SerializationResult operator()(S& s, MutableBufferView bv, T&& obj) const {
@@ -22,23 +29,105 @@ struct serializer {
     }
 
    private:
+    // Serializers whose containers carry their length up front take the
+    // element count where it is known; the count is nullopt otherwise.
+    template <typename R>
+    static constexpr std::optional<std::size_t> count(const R& r) {
+        if constexpr (std::ranges::sized_range<const R>) {
+            return std::ranges::size(r);
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    template <typename S>
+    static constexpr SerializationStatus begin_obj(S& s, MutableBufferView& bv,
+                                                std::optional<std::size_t> n) {
+        if constexpr (requires { s.begin_obj(bv, std::size_t{}); }) {
+            if (n) {
+                return s.begin_obj(bv, *n);
+            }
+        }
+        return s.begin_obj(bv);
+    }
+
+    template <typename S>
+    static constexpr SerializationStatus end_obj(S& s, MutableBufferView& bv,
+                                                std::optional<std::size_t> n) {
+        if constexpr (requires { s.end_obj(bv, std::size_t{}); }) {
+            if (n) {
+                return s.end_obj(bv, *n);
+            }
+        }
+        return s.end_obj(bv);
+    }
+
+    template <typename S>
+    static constexpr SerializationStatus begin_array(S& s, MutableBufferView& bv,
+                                                std::optional<std::size_t> n) {
+        if constexpr (requires { s.begin_array(bv, std::size_t{}); }) {
+            if (n) {
+                return s.begin_array(bv, *n);
+            }
+        }
+        return s.begin_array(bv);
+    }
+
+    template <typename S>
+    static constexpr SerializationStatus end_array(S& s, MutableBufferView& bv,
+                                                std::optional<std::size_t> n) {
+        if constexpr (requires { s.end_array(bv, std::size_t{}); }) {
+            if (n) {
+                return s.end_array(bv, *n);
+            }
+        }
+        return s.end_array(bv);
+    }
+
+    // Fields are unrolled at compile time, so the separator before each key
+    // is known statically and no per-object state is needed.
     template <StructuralSerializer S, typename T>
         requires StructSerializable<std::remove_cvref_t<T>, S>
     static constexpr SerializationResult apply(S& s, MutableBufferView& bv,
                                                T&& obj) {
-        auto fields = get_fields<T>();
+        using CleanT = std::remove_cvref_t<T>;
+        constexpr std::size_t n = std::tuple_size_v<decltype(get_fields<T>())>;
         auto bv_ = bv;
-        s.begin_obj(bv_);
-        std::apply(
-            [&](auto&&... field) {
-                (...,
-                 (s.key(bv_, field.name()),
-                  bv_ += apply(s, bv_, obj.*(field.ptr()))
-                             .written_view.size()));  // Serialize each field
-            },
-            fields);
-        s.end_obj(bv_);
-        return {bv(0, bv.size() - bv_.size()), SerializationStatus::Ok};
+        auto status = begin_obj(s, bv_, n);
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((status == SerializationStatus::Ok &&
+              (status = write_field<CleanT, Is>(s, bv_, obj), true)),
+             ...);
+        }(std::make_index_sequence<n>{});
+        if (status == SerializationStatus::Ok) {
+            status = end_obj(s, bv_, n);
+        }
+        return {bv(0, bv.size() - bv_.size()), status};
+    }
+
+    template <typename CleanT, std::size_t I, StructuralSerializer S,
+              typename T>
+    static constexpr SerializationStatus write_field(S& s,
+                                                     MutableBufferView& bv,
+                                                     T& obj) {
+        constexpr auto field = std::get<I>(get_fields<CleanT>());
+        SerializationStatus status = SerializationStatus::Ok;
+        if constexpr (requires { s.key(bv, static_key<CleanT, I>{}); }) {
+            status = s.key(bv, static_key<CleanT, I>{});
+        } else {
+            if constexpr (I > 0) {
+                status = s.separator(bv);
+            }
+            if (status == SerializationStatus::Ok) {
+                status = s.key(bv, field.name());
+            }
+        }
+        if (status != SerializationStatus::Ok) {
+            return status;
+        }
+        auto res = apply(s, bv, obj.*(field.ptr()));
+        bv += res.written_view.size();
+        return res.status;
     }
 
     template <StructuralSerializer S, typename T>
@@ -46,16 +135,28 @@ struct serializer {
     static constexpr SerializationResult apply(S& s, MutableBufferView& bv,
                                                T&& iterable) {
         auto bv_ = bv;
-        s.begin_array(bv_);
+        const auto n = count(iterable);
+        auto status = begin_array(s, bv_, n);
+        bool first = true;
         for (const auto& item : iterable) {
-            auto res = apply(s, bv_, item);
-            if (res.status != SerializationStatus::Ok) {
-                return {bv(0, bv.size() - bv_.size()), res.status};
+            if (status != SerializationStatus::Ok) {
+                break;
             }
+            if (!first) {
+                status = s.separator(bv_);
+                if (status != SerializationStatus::Ok) {
+                    break;
+                }
+            }
+            first = false;
+            auto res = apply(s, bv_, item);
             bv_ += res.written_view.size();
+            status = res.status;
         }
-        s.end_array(bv_);
-        return {bv(0, bv.size() - bv_.size()), SerializationStatus::Ok};
+        if (status == SerializationStatus::Ok) {
+            status = end_array(s, bv_, n);
+        }
+        return {bv(0, bv.size() - bv_.size()), status};
     }
 
     template <StructuralSerializer S, typename T>
@@ -63,17 +164,31 @@ struct serializer {
     static constexpr SerializationResult apply(S& s, MutableBufferView& bv,
                                                T&& map) {
         auto bv_ = bv;
-        s.begin_obj(bv_);
+        const auto n = count(map);
+        auto status = begin_obj(s, bv_, n);
+        bool first = true;
         for (const auto& [key, value] : map) {
-            s.key(bv_, key);
-            auto res = apply(s, bv_, value);
-            if (res.status != SerializationStatus::Ok) {
-                return {bv(0, bv.size() - bv_.size()), res.status};
+            if (status != SerializationStatus::Ok) {
+                break;
+            }
+            if (!first) {
+                status = s.separator(bv_);
+            }
+            first = false;
+            if (status == SerializationStatus::Ok) {
+                status = s.key(bv_, key);
             }
+            if (status != SerializationStatus::Ok) {
+                break;
+            }
+            auto res = apply(s, bv_, value);
             bv_ += res.written_view.size();
+            status = res.status;
+        }
+        if (status == SerializationStatus::Ok) {
+            status = end_obj(s, bv_, n);
         }
-        s.end_obj(bv_);
-        return {bv(0, bv.size() - bv_.size()), SerializationStatus::Ok};
+        return {bv(0, bv.size() - bv_.size()), status};
     }
 
     template <StructuralSerializer S, typename T>
@@ -82,7 +197,15 @@ struct serializer {
     constexpr static SerializationResult apply(S& s, MutableBufferView& bv,
                                                T&& value) {
         auto bv_ = bv;
-        auto status = s.value(bv_, value);
+        SerializationStatus status;
+        // byte blobs go through bytes() where the serializer has it, so
+        // gathering serializers can reference them instead of copying
+        if constexpr (std::same_as<std::remove_cvref_t<T>, BufferView> &&
+                      requires { s.bytes(bv_, value); }) {
+            status = s.bytes(bv_, value);
+        } else {
+            status = s.value(bv_, value);
+        }
         return {bv(0, bv.size() - bv_.size()), status};
     }
 
@@ -105,6 +228,175 @@ struct serializer {
 
 inline constexpr serializer serialize{};
 
+namespace detail {
+// Container overhead for n elements, for serializers whose container headers
+// depend on the count.
+template <typename S>
+constexpr std::size_t obj_overhead(std::size_t n) {
+    if constexpr (requires { S::obj_overhead(n); }) {
+        return S::obj_overhead(n);
+    } else {
+        return S::obj_overhead();
+    }
+}
+
+template <typename S>
+constexpr std::size_t array_overhead(std::size_t n) {
+    if constexpr (requires { S::array_overhead(n); }) {
+        return S::array_overhead(n);
+    } else {
+        return S::array_overhead();
+    }
+}
+}  // namespace detail
+
+// Exact number of bytes serialize() writes for obj, computed in one pass
+// over obj without writing anything.
+struct sizer {
+    template <SizedSerializer S, typename T>
+    constexpr std::size_t operator()(const S& s, const T& obj) const {
+        return apply(s, obj);
+    }
+
+   private:
+    template <SizedSerializer S, typename T>
+        requires StructSerializable<T, S>
+    static constexpr std::size_t apply(const S& s, const T& obj) {
+        constexpr std::size_t n = std::tuple_size_v<decltype(get_fields<T>())>;
+        return detail::obj_overhead<S>(n) +
+               [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                   return (std::size_t{0} + ... + field_size<T, Is>(s, obj));
+               }(std::make_index_sequence<n>{});
+    }
+
+    template <typename T, std::size_t I, SizedSerializer S>
+    static constexpr std::size_t field_size(const S& s, const T& obj) {
+        constexpr auto field = std::get<I>(get_fields<T>());
+        std::size_t key;
+        if constexpr (requires { s.key_size(static_key<T, I>{}); }) {
+            key = s.key_size(static_key<T, I>{});
+        } else {
+            key = (I > 0 ? s.separator_size() : 0) + s.key_size(field.name());
+        }
+        return key + apply(s, obj.*(field.ptr()));
+    }
+
+    template <SizedSerializer S, typename T>
+        requires IterableSerializable<T, S>
+    static constexpr std::size_t apply(const S& s, const T& iterable) {
+        std::size_t size = 0;
+        std::size_t count = 0;
+        for (const auto& item : iterable) {
+            size += apply(s, item);
+            ++count;
+        }
+        if constexpr (std::ranges::sized_range<const T>) {
+            size += detail::array_overhead<S>(count);
+        } else {
+            size += S::array_overhead();
+        }
+        return size + (count > 0 ? (count - 1) * s.separator_size() : 0);
+    }
+
+    template <SizedSerializer S, typename T>
+        requires MapSerializable<T, S>
+    static constexpr std::size_t apply(const S& s, const T& map) {
+        std::size_t size = detail::obj_overhead<S>(map.size());
+        std::size_t count = 0;
+        for (const auto& [key, value] : map) {
+            size += s.key_size(key) + apply(s, value);
+            ++count;
+        }
+        return size + (count > 0 ? (count - 1) * s.separator_size() : 0);
+    }
+
+    template <SizedSerializer S, typename T>
+        requires PrimitiveSerializable<T, S> && (!MapSerializable<T, S>)
+    static constexpr std::size_t apply(const S& s, const T& value) {
+        return s.value_size(value);
+    }
+
+    template <SizedSerializer S, typename T, std::endian Endian>
+        requires PrimitiveSerializable<T, S> && (!MapSerializable<T, S>)
+    static constexpr std::size_t apply(const S& s,
+                                       const endian<T, Endian>& value) {
+        return s.value_size(value.repr_);
+    }
+};
+
+inline constexpr sizer serialized_size{};
+
+namespace detail {
+inline constexpr std::size_t unbounded = ~std::size_t{0};
+
+// Largest serialized size of any T, or unbounded.
+template <typename S, typename T>
+consteval std::size_t bounded_size() {
+    if constexpr (StructSerializable<T, S>) {
+        constexpr std::size_t n = std::tuple_size_v<decltype(get_fields<T>())>;
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            std::size_t total = obj_overhead<S>(n);
+            bool bounded = true;
+            (
+                [&] {
+                    using V = typename std::remove_cvref_t<decltype(std::get<
+                        Is>(get_fields<T>()))>::value_type;
+                    constexpr std::size_t v = bounded_size<S, V>();
+                    if constexpr (requires {
+                                      S::key_size(static_key<T, Is>{});
+                                  }) {
+                        total += S::key_size(static_key<T, Is>{});
+                    } else {
+                        total += (Is > 0 ? S::separator_size() : 0) +
+                                 S::key_size(
+                                     std::get<Is>(get_fields<T>()).name());
+                    }
+                    bounded = bounded && v != unbounded;
+                    total += v == unbounded ? 0 : v;
+                }(),
+                ...);
+            return bounded ? total : unbounded;
+        }(std::make_index_sequence<n>{});
+    } else if constexpr (requires { std::tuple_size<T>::value; } &&
+                         std::ranges::range<T>) {
+        constexpr std::size_t n = std::tuple_size_v<T>;
+        constexpr std::size_t v =
+            bounded_size<S, std::ranges::range_value_t<T>>();
+        if constexpr (v == unbounded) {
+            return unbounded;
+        } else {
+            return array_overhead<S>(n) + n * v +
+                   (n > 0 ? (n - 1) * S::separator_size() : 0);
+        }
+    } else if constexpr (requires { S::template max_value_size<T>(); }) {
+        return S::template max_value_size<T>();
+    } else {
+        return unbounded;
+    }
+}
+}  // namespace detail
+
+// Largest serialized size of any value of T: a compile time constant for
+// types whose serialized size is bounded, i.e. that hold no strings or
+// variable length containers.
+template <SizedSerializer S, typename T>
+    requires(detail::bounded_size<S, std::remove_cvref_t<T>>() !=
+             detail::unbounded)
+consteval std::size_t max_size() {
+    return detail::bounded_size<S, std::remove_cvref_t<T>>();
+}
+
+// Appends obj to out, growing it once to the exact serialized size.
+template <SizedSerializer S, typename T>
+SerializationResult serialize_to(S& s, Buffer<char>& out, const T& obj) {
+    const std::size_t start = out.size();
+    const std::size_t size = serialized_size(s, obj);
+    char* p = out.append_uninitialized(size);
+    auto res = serialize(s, MutableBufferView(p, size), obj);
+    out.resize(start + res.written_view.size());
+    return res;
+}
+
 template <typename T, typename Member>
 struct SerializableField {
     using name_type = std::string_view;
@@ -113,9 +405,12 @@ struct SerializableField {
 
     std::string_view name_;
     value_type class_type::* ptr_;
+    // Wire id for tagged formats; 0 means the field's position plus one.
+    std::uint32_t id_ = 0;
 
     constexpr auto name() const noexcept { return name_; }
     constexpr value_type class_type::* ptr() const noexcept { return ptr_; }
+    constexpr std::uint32_t id() const noexcept { return id_; }
 };
 
 template <typename T, typename Member>
@@ -123,6 +418,15 @@ consteval Field auto make_field(std::string_view name, Member T::* ptr) {
     return SerializableField<T, Member>{name, ptr};
 }
 
+// A field with a fixed wire id, so tagged data written before fields were
+// added, removed or reordered still decodes. Ids must be unique and
+// nonzero.
+template <typename T, typename Member>
+consteval Field auto make_field(std::string_view name, Member T::* ptr,
+                                std::uint32_t id) {
+    return SerializableField<T, Member>{name, ptr, id};
+}
+
 template <typename... Fields>
 consteval FieldList auto make_fields(Fields... field) {
     return std::tuple{field...};
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "csics/Buffer.hpp"
+#include "csics/serialization/Common.hpp"
+#include "csics/serialization/Concepts.hpp"
+#include "csics/serialization/Deserializer.hpp"
+#include "csics/serialization/TaggedSerializer.hpp"
+
+namespace csics::serialization {
+
+// Reads the tagged format written by TaggedSerializer into field-listed
+// structs through deserialize(). Fields are matched by id; unknown ones are
+// skipped using their wire type and length alone, and missing ones keep
+// their default value. std::string_view and BufferView members are read as
+// views into the input, valid while the input is.
+class TaggedDeserializer {
+   public:
+    using error_type = DeserializationError;
+
+    explicit TaggedDeserializer(BufferView data) : data_(data) {}
+
+    // Bytes consumed so far.
+    std::size_t offset() const noexcept { return pos_; }
+
+    // Raw little-endian values, so the wire overloads work too.
+    template <tagged::Fixed T>
+    expected<T, error_type> read() {
+        if (!need(sizeof(T), data_.size())) {
+            return error_;
+        }
+        const T v = tagged::load<T>(data_.data() + pos_);
+        pos_ += sizeof(T);
+        return v;
+    }
+
+    template <typename T>
+        requires StructSerializableImpl<T>
+    expected<T, error_type> read_message() {
+        static_assert(tagged::ids_valid<T>(),
+                      "field ids must be unique, nonzero and below 2^29");
+        T out{};
+        if (!value(out, data_.size())) {
+            return error_;
+        }
+        return out;
+    }
+
+   private:
+    BufferView data_;
+    std::size_t pos_ = 0;
+    error_type error_;
+
+    bool fail(DeserializationStatus status) {
+        error_ = error_type(status, pos_);
+        if constexpr (trace_enabled) {
+            trace("error", "tagged", pos_);
+        }
+        return false;
+    }
+
+    // Checks that n bytes follow before stop, the end of the enclosing
+    // value. Running past the input is BufferEmpty; past a length that is
+    // still inside it, InvalidData.
+    bool need(std::size_t n, std::size_t stop) {
+        if (pos_ <= stop && n <= stop - pos_) {
+            return true;
+        }
+        return fail(n > data_.size() - pos_ ? DeserializationStatus::BufferEmpty
+                                            : DeserializationStatus::InvalidData);
+    }
+
+    // Reads a u32 length and checks that many bytes follow before stop.
+    bool length(std::size_t& n, std::size_t stop) {
+        if (!need(4, stop)) {
+            return false;
+        }
+        n = load_little<std::uint32_t>(data_.data() + pos_);
+        pos_ += 4;
+        return need(n, stop);
+    }
+
+    bool key(std::uint64_t& out, std::size_t stop) {
+        if (!need(1, stop)) {
+            return false;
+        }
+        auto b = static_cast<std::uint8_t>(data_.data()[pos_++]);
+        out = b & 0x7F;
+        for (unsigned shift = 7; b >= 0x80; shift += 7) {
+            if (shift > 28) {
+                return fail(DeserializationStatus::InvalidData);
+            }
+            if (!need(1, stop)) {
+                return false;
+            }
+            b = static_cast<std::uint8_t>(data_.data()[pos_++]);
+            out |= std::uint64_t{b & 0x7Fu} << shift;
+        }
+        return true;
+    }
+
+    // Reads a run's count and wire types, leaving pos_ at its values.
+    bool run_header(std::size_t& count, const char*& types, std::size_t stop) {
+        if (!need(1, stop)) {
+            return false;
+        }
+        count = static_cast<std::uint8_t>(data_.data()[pos_++]);
+        if (!need((count + 3) / 4, stop)) {
+            return false;
+        }
+        types = data_.data() + pos_;
+        pos_ += (count + 3) / 4;
+        return true;
+    }
+
+    static tagged::WireType run_type(const char* types, std::size_t j) {
+        return static_cast<tagged::WireType>(
+            (static_cast<std::uint8_t>(types[j / 4]) >> (2 * (j % 4))) & 3);
+    }
+
+    bool skip(tagged::WireType type, std::size_t stop) {
+        if (type == tagged::WireType::bytes) {
+            std::size_t n;
+            if (!length(n, stop)) {
+                return false;
+            }
+            pos_ += n;
+            return true;
+        }
+        if (type == tagged::WireType::run) {
+            std::size_t count;
+            const char* types;
+            if (!run_header(count, types, stop)) {
+                return false;
+            }
+            std::size_t n = 0;
+            for (std::size_t j = 0; j < count; ++j) {
+                n += std::size_t{1}
+                     << static_cast<std::uint8_t>(run_type(types, j));
+            }
+            if (!need(n, stop)) {
+                return false;
+            }
+            pos_ += n;
+            return true;
+        }
+        if (static_cast<std::uint8_t>(type) > 3) {
+            return fail(DeserializationStatus::InvalidData);
+        }
+        const std::size_t n = std::size_t{1} << static_cast<std::uint8_t>(type);
+        if (!need(n, stop)) {
+            return false;
+        }
+        pos_ += n;
+        return true;
+    }
+
+    template <typename T>
+    bool fields(T& obj, std::size_t stop) {
+        constexpr std::size_t n = std::tuple_size_v<decltype(get_fields<T>())>;
+        // Fields written by the same version of T come in declaration
+        // order, so each is first checked against the next key expected.
+        bool ok = true;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((ok && next_field<T, Is>(obj, stop, ok)) && ...);
+        }(std::make_index_sequence<n>{});
+        if (!ok) {
+            return false;
+        }
+        while (pos_ < stop) {
+            std::uint64_t k;
+            if (!key(k, stop)) {
+                return false;
+            }
+            const auto id = static_cast<std::uint32_t>(k >> 3);
+            const auto type = static_cast<tagged::WireType>(k & 7);
+            if (type != tagged::WireType::run) {
+                if (!field_by_id(obj, id, type, stop)) {
+                    return false;
+                }
+                continue;
+            }
+            std::size_t count;
+            const char* types;
+            if (!run_header(count, types, stop)) {
+                return false;
+            }
+            for (std::size_t j = 0; j < count; ++j) {
+                if (!field_by_id(obj, static_cast<std::uint32_t>(id + j),
+                                 run_type(types, j), stop)) {
+                    return false;
+                }
+            }
+        }
+        return pos_ == stop || fail(DeserializationStatus::InvalidData);
+    }
+
+    // Reads the value of the field with `id`, or skips it if T has none.
+    template <typename T>
+    bool field_by_id(T& obj, std::uint32_t id, tagged::WireType type,
+                     std::size_t stop) {
+        constexpr std::size_t n = std::tuple_size_v<decltype(get_fields<T>())>;
+        bool known = false;
+        bool ok = true;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((id == tagged::field_id<T, Is>() &&
+              (known = true, ok = field<T, Is>(obj, type, stop), true)) ||
+             ...);
+        }(std::make_index_sequence<n>{});
+        if (!ok) {
+            return false;
+        }
+        return known || skip(type, stop);
+    }
+
+    // Reads field I if its key, or the header of the run it starts, is
+    // next; false if it is not or on error, which clears ok. Fields inside
+    // a run are only reached after their run's header has matched.
+    template <typename T, std::size_t I>
+    bool next_field(T& obj, std::size_t stop, bool& ok) {
+        constexpr auto f = std::get<I>(get_fields<T>());
+        using V = typename decltype(f)::value_type;
+        using K = tagged::field_prefix<T, I>;
+        const char* p = data_.data() + pos_;
+        if (pos_ > stop) {
+            return ok = fail(DeserializationStatus::InvalidData);
+        }
+        if constexpr (tagged::Fixed<V>) {
+            if (stop - pos_ < K::size + sizeof(V) || !prefix_at<T, I>(p)) {
+                return false;
+            }
+            obj.*(f.ptr()) = tagged::load<V>(p + K::size);
+            pos_ += K::size + sizeof(V);
+            return true;
+        } else {
+            if (stop - pos_ < K::size ||
+                std::memcmp(p, K::bytes.data(), K::size) != 0) {
+                return false;
+            }
+            pos_ += K::size;
+            ok = field<T, I>(obj, tagged::wire_type<typename K::value_type>(),
+                             stop);
+            return ok;
+        }
+    }
+
+    // Whether p starts with what is written before field I's value.
+    template <typename T, std::size_t I>
+    static bool prefix_at(const char* p) noexcept {
+        using K = tagged::field_prefix<T, I>;
+        if constexpr (K::size == 0) {
+            return true;
+        } else {
+            return std::memcmp(p, K::bytes.data(), K::size) == 0;
+        }
+    }
+
+    template <typename T, std::size_t I>
+    static constexpr std::size_t field_size() noexcept {
+        using K = tagged::field_prefix<T, I>;
+        return K::size + sizeof(typename K::value_type);
+    }
+
+    // Reads the fields of T from p, which holds fixed_fields_size<T>()
+    // bytes, if they are exactly T's fields in order.
+    template <typename T>
+    static bool fixed_fields(T& obj, const char* p) {
+        constexpr std::size_t n = std::tuple_size_v<decltype(get_fields<T>())>;
+        const bool match = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            std::size_t at = 0;
+            return (prefix_at<T, Is>(p + std::exchange(
+                                             at, at + field_size<T, Is>())) &&
+                    ...);
+        }(std::make_index_sequence<n>{});
+        if (!match) {
+            return false;
+        }
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            std::size_t at = 0;
+            ((at += tagged::field_prefix<T, Is>::size,
+              obj.*(std::get<Is>(get_fields<T>()).ptr()) =
+                  tagged::load<typename tagged::key_literal<T, Is>::value_type>(
+                      p + at),
+              at += sizeof(typename tagged::key_literal<T, Is>::value_type)),
+             ...);
+        }(std::make_index_sequence<n>{});
+        return true;
+    }
+
+    template <typename T, std::size_t I>
+    bool field(T& obj, tagged::WireType type, std::size_t stop) {
+        constexpr auto f = std::get<I>(get_fields<T>());
+        using V = typename decltype(f)::value_type;
+        using Inner = typename tagged::optional_traits<V>::type;
+        bool ok;
+        if (type != tagged::wire_type<Inner>()) {
+            ok = fail(DeserializationStatus::InvalidData);
+        } else if constexpr (tagged::optional_traits<V>::optional) {
+            Inner v{};
+            ok = value(v, stop);
+            if (ok) {
+                obj.*(f.ptr()) = std::move(v);
+            }
+        } else {
+            ok = value(obj.*(f.ptr()), stop);
+        }
+        if (!ok) {
+            // the outermost struct names the field last
+            error_.field = f.name().data();
+        }
+        return ok;
+    }
+
+    // Reads one value that has to end by stop.
+    template <typename V>
+    bool value(V& v, std::size_t end) {
+        if constexpr (tagged::Fixed<V>) {
+            if (!need(sizeof(V), end)) {
+                return false;
+            }
+            v = tagged::load<V>(data_.data() + pos_);
+            pos_ += sizeof(V);
+            return true;
+        } else {
+            std::size_t n;
+            if (!length(n, end)) {
+                return false;
+            }
+            const char* p = data_.data() + pos_;
+            const std::size_t stop = pos_ + n;
+            if constexpr (std::same_as<V, std::string_view>) {
+                v = std::string_view(p, n);
+            } else if constexpr (std::same_as<V, BufferView>) {
+                v = BufferView(p, n);
+            } else if constexpr (std::same_as<V, std::string>) {
+                v.assign(p, n);
+            } else if constexpr (tagged::Packed<V>) {
+                using E = std::ranges::range_value_t<V>;
+                if (n % sizeof(E) != 0) {
+                    return fail(DeserializationStatus::InvalidData);
+                }
+                const std::size_t count = n / sizeof(E);
+                if constexpr (requires { v.resize(count); }) {
+                    v.resize(count);
+                } else if (count != std::ranges::size(v)) {
+                    return fail(DeserializationStatus::InvalidData);
+                }
+                if constexpr (std::endian::native == std::endian::little) {
+                    if (n > 0) {
+                        std::memcpy(std::ranges::data(v), p, n);
+                    }
+                } else {
+                    E* out = std::ranges::data(v);
+                    for (std::size_t i = 0; i < count; ++i) {
+                        out[i] = tagged::load<E>(p + i * sizeof(E));
+                    }
+                }
+            } else if constexpr (StructSerializableImpl<V>) {
+                if constexpr (tagged::fixed_fields_size<V>() > 0) {
+                    // written by this version of V: every key where expected
+                    if (n == tagged::fixed_fields_size<V>() &&
+                        fixed_fields(v, p)) {
+                        pos_ = stop;
+                        return true;
+                    }
+                }
+                return fields(v, stop);
+            } else if constexpr (MapLike<V>) {
+                v.clear();
+                while (pos_ < stop) {
+                    typename V::key_type key{};
+                    typename V::mapped_type mapped{};
+                    if (!value(key, stop) || !value(mapped, stop)) {
+                        return false;
+                    }
+                    v.emplace(std::move(key), std::move(mapped));
+                }
+                return pos_ == stop ||
+                       fail(DeserializationStatus::InvalidData);
+            } else if constexpr (std::ranges::range<V>) {
+                using E = std::ranges::range_value_t<V>;
+                if constexpr (requires(E e) { v.push_back(std::move(e)); }) {
+                    v.clear();
+                    while (pos_ < stop) {
+                        E e{};
+                        if (!value(e, stop)) {
+                            return false;
+                        }
+                        v.push_back(std::move(e));
+                    }
+                } else {
+                    // fixed size, e.g. std::array
+                    for (auto& e : v) {
+                        if (pos_ >= stop) {
+                            return fail(DeserializationStatus::InvalidData);
+                        }
+                        if (!value(e, stop)) {
+                            return false;
+                        }
+                    }
+                }
+                return pos_ == stop ||
+                       fail(DeserializationStatus::InvalidData);
+            } else {
+                static_assert([] { return false; }(),
+                              "Unsupported type for the tagged format");
+            }
+            pos_ = stop;
+            return true;
+        }
+    }
+};
+
+template <typename T>
+    requires StructSerializableImpl<T>
+expected<T, DeserializationError> deserialize_direct(TaggedDeserializer& d,
+                                                     detail::type_tag<T>) {
+    return d.read_message<T>();
+}
+
+};  // namespace csics::serialization
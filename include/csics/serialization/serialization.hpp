@@ -5,4 +5,10 @@
 #include "csics/serialization/Serializer.hpp"
 #include "csics/serialization/JSONSerializer.hpp"
 #include "csics/serialization/DirectSerializer.hpp"
+#include "csics/serialization/GatherSerializer.hpp"
 #include "csics/serialization/Deserializer.hpp"
+#include "csics/serialization/JSONDeserializer.hpp"
+#include "csics/serialization/CBORSerializer.hpp"
+#include "csics/serialization/CBORDeserializer.hpp"
+#include "csics/serialization/TaggedSerializer.hpp"
+#include "csics/serialization/TaggedDeserializer.hpp"
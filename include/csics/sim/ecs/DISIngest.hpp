@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "csics/Bit.hpp"
+#include "csics/Buffer.hpp"
+#include "csics/lvc/dis/DISDispatch.hpp"
+#include "csics/lvc/dis/EntityIDMap.hpp"
+#include "csics/lvc/dis/Layout.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/sim/ecs/Entity.hpp"
+#include "csics/sim/ecs/SparseSet.hpp"
+
+namespace csics::sim::ecs {
+
+// Kinematic fields of the entity state PDUs accepted in the last batch, one
+// element per PDU in arrival order.
+struct EntityStateColumns {
+    Buffer<std::uint64_t> keys;  // EntityID::packed()
+    Buffer<Entity> entities;
+    Buffer<double> x, y, z;         // location, ECEF metres
+    Buffer<float> psi, theta, phi;  // orientation
+    Buffer<float> vx, vy, vz;       // linear velocity
+
+    std::size_t size() const noexcept { return keys.size(); }
+
+    void resize(std::size_t n) {
+        keys.resize(n);
+        entities.resize(n);
+        for (auto* col : {&x, &y, &z}) {
+            col->resize(n);
+        }
+        for (auto* col : {&psi, &theta, &phi, &vx, &vy, &vz}) {
+            col->resize(n);
+        }
+    }
+};
+
+struct IngestStats {
+    std::size_t accepted = 0;
+    std::size_t skipped = 0;    // other PDU types, or rejected by the filter
+    std::size_t malformed = 0;  // truncated or inconsistent header
+    std::size_t created = 0;    // new entities added to the world
+};
+
+// Batch ingest of entity state PDUs into ECS component storage, for a
+// receive batch (a recvmmsg result, a queue drain) rather than one
+// datagram at a time. Each batch runs in passes over the whole batch:
+//
+//   1. validate every header and apply the filter, keeping the indices of
+//      the accepted PDUs;
+//   2. decode location, orientation and velocity straight from the wire
+//      into the columns (no PDU objects, no allocation once warm);
+//   3. resolve each EntityID to a world Entity, creating unknown ones;
+//   4. upsert each column into its SparseSet.
+//
+// An entity that appears several times in a batch ends with its last
+// update. Location, Orientation and Velocity must be registered with the
+// world and constructible from three doubles, floats and floats.
+//
+// The ingest keeps its own EntityID-to-Entity map; call forget() when
+// removing an ingested entity from the world.
+template <typename Location = lvc::dis::WorldCoordinates,
+          typename Orientation = lvc::dis::EulerAngles,
+          typename Velocity = lvc::dis::Vector>
+class EntityStateIngest {
+   public:
+    lvc::dis::DISFilter& filter() noexcept { return filter_; }
+    const lvc::dis::DISFilter& filter() const noexcept { return filter_; }
+
+    template <typename World>
+    IngestStats ingest(World& world, std::span<const BufferView> datagrams) {
+        IngestStats stats = decode(datagrams);
+        stats.created = resolve(world);
+
+        const auto n = columns_.size();
+        const auto& c = columns_;
+        auto& locations = world.template get_component_set<Location>();
+        for (std::size_t i = 0; i < n; ++i) {
+            locations.insert(c.entities[i], Location(c.x[i], c.y[i], c.z[i]));
+        }
+        auto& orientations = world.template get_component_set<Orientation>();
+        for (std::size_t i = 0; i < n; ++i) {
+            orientations.insert(c.entities[i],
+                                Orientation(c.psi[i], c.theta[i], c.phi[i]));
+        }
+        auto& velocities = world.template get_component_set<Velocity>();
+        for (std::size_t i = 0; i < n; ++i) {
+            velocities.insert(c.entities[i],
+                              Velocity(c.vx[i], c.vy[i], c.vz[i]));
+        }
+        return stats;
+    }
+
+    // Passes 1 and 2 only: fills columns() with entities left null.
+    IngestStats decode(std::span<const BufferView> datagrams) {
+        IngestStats stats;
+        accepted_.clear();
+        for (std::size_t i = 0; i < datagrams.size(); ++i) {
+            switch (classify(datagrams[i])) {
+                case Accept:
+                    accepted_.push_back(static_cast<std::uint32_t>(i));
+                    break;
+                case Skip:
+                    ++stats.skipped;
+                    break;
+                case Malformed:
+                    ++stats.malformed;
+                    break;
+            }
+        }
+        stats.accepted = accepted_.size();
+
+        namespace es = lvc::dis::layout::entity_state;
+        auto& c = columns_;
+        c.resize(accepted_.size());
+        for (std::size_t i = 0; i < accepted_.size(); ++i) {
+            const char* p = datagrams[accepted_[i]].data();
+            c.keys[i] = wire_key(p + es::entity_id);
+            c.entities[i] = Entity();
+            c.x[i] = load_big<double>(p + es::location);
+            c.y[i] = load_big<double>(p + es::location + 8);
+            c.z[i] = load_big<double>(p + es::location + 16);
+            c.psi[i] = load_big<float>(p + es::orientation);
+            c.theta[i] = load_big<float>(p + es::orientation + 4);
+            c.phi[i] = load_big<float>(p + es::orientation + 8);
+            c.vx[i] = load_big<float>(p + es::linear_velocity);
+            c.vy[i] = load_big<float>(p + es::linear_velocity + 4);
+            c.vz[i] = load_big<float>(p + es::linear_velocity + 8);
+        }
+        return stats;
+    }
+
+    const EntityStateColumns& columns() const noexcept { return columns_; }
+
+    // The world entity for `id`, or a null Entity if it was never ingested.
+    Entity find(const lvc::dis::EntityID& id) const {
+        const std::uint64_t key = id.packed();
+        const std::uint32_t* page = pages_.find(key >> page_bits);
+        return page ? slots_[slot(*page, key)] : Entity();
+    }
+
+    bool forget(const lvc::dis::EntityID& id) {
+        const std::uint64_t key = id.packed();
+        const std::uint32_t* page = pages_.find(key >> page_bits);
+        if (!page) {
+            return false;
+        }
+        Entity& e = slots_[slot(*page, key)];
+        if (!e.valid()) {
+            return false;
+        }
+        e = Entity();
+        --size_;
+        return true;
+    }
+
+    // Number of EntityIDs currently mapped.
+    std::size_t size() const noexcept { return size_; }
+
+   private:
+    enum Verdict { Accept, Skip, Malformed };
+
+    lvc::dis::DISFilter filter_;
+    EntityStateColumns columns_;
+    Buffer<std::uint32_t> accepted_;
+
+    // EntityID to Entity, in pages of consecutive entity numbers: the map
+    // holds a page number per page of EntityIDs, slots_ the entities of
+    // each page, null where unmapped. Senders number their entities
+    // densely, so a batch touches few pages and walks their slots in
+    // order, where one map lookup per PDU would miss cache on each.
+    // Pages are kept once allocated.
+    static constexpr int page_bits = 6;
+    static constexpr std::uint64_t page_size = std::uint64_t{1} << page_bits;
+    lvc::dis::EntityIDMap<std::uint32_t> pages_;
+    Buffer<Entity> slots_;
+    std::size_t size_ = 0;
+
+    static std::size_t slot(std::uint32_t page, std::uint64_t key) noexcept {
+        return std::size_t{page} * page_size + (key & (page_size - 1));
+    }
+
+    Verdict classify(BufferView bv) const noexcept {
+        namespace layout = lvc::dis::layout;
+        if (bv.size() < layout::header::size) {
+            return Malformed;
+        }
+        lvc::dis::PDUHeaderView header(bv);
+        if (header.pdu_type() != lvc::dis::PDUType::EntityState) {
+            return Skip;
+        }
+        if (bv.size() < layout::entity_state::size ||
+            header.length() < layout::entity_state::size ||
+            header.length() > bv.size()) {
+            return Malformed;
+        }
+        return filter_.accepts(bv) ? Accept : Skip;
+    }
+
+    static std::uint64_t wire_key(const char* p) noexcept {
+        return static_cast<std::uint64_t>(load_big<std::uint32_t>(p)) << 16 |
+               load_big<std::uint16_t>(p + 4);
+    }
+
+    template <typename World>
+    std::size_t resolve(World& world) {
+        std::size_t created = 0;
+        auto& c = columns_;
+        // consecutive PDUs are usually on the same page as the one before
+        std::uint64_t last = ~std::uint64_t{0};
+        std::uint32_t page = 0;
+        for (std::size_t i = 0; i < c.size(); ++i) {
+            const std::uint64_t key = c.keys[i];
+            if (key >> page_bits != last) {
+                last = key >> page_bits;
+                const auto next = static_cast<std::uint32_t>(pages_.size());
+                auto [p, inserted] = pages_.try_emplace(last, next);
+                if (inserted) {
+                    slots_.resize(slots_.size() + page_size);  // null
+                }
+                page = *p;
+            }
+            Entity& e = slots_[slot(page, key)];
+            if (!e.valid()) {
+                e = world.add_entity();
+                ++created;
+                ++size_;
+            }
+            c.entities[i] = e;
+        }
+        return created;
+    }
+};
+
+};  // namespace csics::sim::ecs
@@ -0,0 +1,480 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "csics/Buffer.hpp"
+#include "csics/sim/ecs/Entity.hpp"
+#include "csics/sim/ecs/Hierarchy.hpp"
+#include "csics/sim/ecs/SparseSet.hpp"
+#include "csics/sim/ecs/Traits.hpp"
+#include "csics/sim/ecs/View.hpp"
+
+namespace csics::sim::ecs {
+
+using ComponentId = std::uint32_t;
+inline constexpr ComponentId kInvalidComponent =
+    std::numeric_limits<ComponentId>::max();
+
+// Type-erased component storage used by DynamicWorld. Pointers passed in and
+// out refer to a single component object (or element_size() raw bytes for
+// pools registered without a C++ type).
+class IComponentPool {
+   public:
+    virtual ~IComponentPool() = default;
+
+    virtual std::size_t element_size() const noexcept = 0;
+    virtual std::size_t element_align() const noexcept = 0;
+    virtual std::size_t size() const noexcept = 0;
+    virtual const Buffer<Entity>& entities() const noexcept = 0;
+
+    virtual bool contains(const Entity& e) const noexcept = 0;
+    virtual void* get(const Entity& e) noexcept = 0;
+    virtual const void* get(const Entity& e) const noexcept = 0;
+
+    // Copies the component at `src` onto `e`, replacing any existing one.
+    virtual void insert_copy(const Entity& e, const void* src) = 0;
+    // Moves the component at `src` onto `e`. `src` must still be destroyed.
+    virtual void insert_move(const Entity& e, void* src) = 0;
+    // Copy-constructs a component at uninitialized storage `dst`, staged
+    // outside the pool, from the one at `src`.
+    virtual void copy_construct(void* dst, const void* src) const = 0;
+    // Ends the lifetime of a component staged outside the pool.
+    virtual void destroy(void* obj) noexcept = 0;
+    virtual void remove(const Entity& e) = 0;
+};
+
+// Pool for a C++ component type; the storage is a plain SparseSet so the
+// usual View works on it.
+template <Component C>
+class ComponentPool final : public IComponentPool {
+   public:
+    std::size_t element_size() const noexcept override { return sizeof(C); }
+    std::size_t element_align() const noexcept override { return alignof(C); }
+    std::size_t size() const noexcept override { return set_.size(); }
+    const Buffer<Entity>& entities() const noexcept override {
+        return set_.entities();
+    }
+
+    bool contains(const Entity& e) const noexcept override {
+        return set_.contains(e);
+    }
+    void* get(const Entity& e) noexcept override { return set_.at(e); }
+    const void* get(const Entity& e) const noexcept override {
+        return set_.at(e);
+    }
+
+    void insert_copy(const Entity& e, const void* src) override {
+        set_.insert(e, *static_cast<const C*>(src));
+    }
+    void insert_move(const Entity& e, void* src) override {
+        set_.insert(e, std::move(*static_cast<C*>(src)));
+    }
+    void copy_construct(void* dst, const void* src) const override {
+        std::construct_at(static_cast<C*>(dst), *static_cast<const C*>(src));
+    }
+    void destroy(void* obj) noexcept override {
+        std::destroy_at(static_cast<C*>(obj));
+    }
+    void remove(const Entity& e) override { set_.remove(e); }
+
+    SparseSet<C>& set() noexcept { return set_; }
+    const SparseSet<C>& set() const noexcept { return set_; }
+
+   private:
+    SparseSet<C> set_;
+};
+
+// Pool for components only known at runtime (e.g. defined in a scenario
+// file) as a size and alignment. Elements are trivially copyable bytes laid
+// out densely with the same sparse/dense scheme as SparseSet.
+class RawComponentPool final : public IComponentPool {
+   public:
+    static constexpr std::size_t kMaxAlign = 64;
+
+    RawComponentPool(std::size_t size, std::size_t align);
+
+    std::size_t element_size() const noexcept override { return size_; }
+    std::size_t element_align() const noexcept override { return align_; }
+    std::size_t size() const noexcept override { return entities_.size(); }
+    const Buffer<Entity>& entities() const noexcept override {
+        return entities_;
+    }
+
+    bool contains(const Entity& e) const noexcept override;
+    void* get(const Entity& e) noexcept override;
+    const void* get(const Entity& e) const noexcept override;
+
+    void insert_copy(const Entity& e, const void* src) override;
+    void insert_move(const Entity& e, void* src) override {
+        insert_copy(e, src);
+    }
+    void copy_construct(void* dst, const void* src) const override {
+        std::memcpy(dst, src, size_);
+    }
+    void destroy(void*) noexcept override {}
+    void remove(const Entity& e) override;
+
+    // Dense element i, in entities() order.
+    std::byte* at_index(std::size_t i) noexcept {
+        return dense_.data() + i * stride_;
+    }
+
+   private:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    std::size_t size_;
+    std::size_t align_;
+    std::size_t stride_;
+    Buffer<std::byte, kMaxAlign> dense_;
+    Buffer<std::size_t> sparse_;
+    Buffer<Entity> entities_;
+};
+
+// Deferred structural changes recorded by systems. Command records live in a
+// flat buffer; component payloads are constructed in place in fixed blocks
+// that never move, so non-trivially-relocatable components are safe and a
+// steady-state tick does not allocate.
+class CommandBuffer {
+   public:
+    enum class Op : std::uint8_t { AddComponent, RemoveComponent, DestroyEntity };
+
+    struct Command {
+        Op op;
+        ComponentId component;
+        Entity entity;
+        void* payload;
+    };
+
+    // Returns storage for a payload and makes room for the command that will
+    // own it, so push() after constructing the payload cannot throw. Storage
+    // for a payload that is never pushed is reclaimed by clear().
+    void* allocate(std::size_t size, std::size_t align);
+
+    // Records a command owning `payload`, which must already be constructed
+    // in storage from allocate().
+    void push(Op op, ComponentId component, const Entity& e,
+              void* payload = nullptr);
+
+    const Buffer<Command>& commands() const noexcept { return commands_; }
+    bool empty() const noexcept { return commands_.empty(); }
+
+    // Forgets every command but keeps the payload blocks for reuse. Payloads
+    // must already have been destroyed.
+    void clear() noexcept;
+
+   private:
+    static constexpr std::size_t kBlockSize = 16 * 1024;
+    static constexpr std::size_t kBlockAlign = 64;
+
+    struct Block {
+        Buffer<std::byte, kBlockAlign> data;
+        std::size_t used = 0;
+    };
+
+    Buffer<Command> commands_;
+    std::vector<Block> blocks_;
+    std::size_t current_ = 0;
+};
+
+namespace detail {
+std::uint32_t next_component_type_index() noexcept;
+
+// Process-wide dense index per component type, used instead of RTTI to map
+// a C++ type to its per-world ComponentId.
+template <typename C>
+std::uint32_t component_type_index() noexcept {
+    static const std::uint32_t index = next_component_type_index();
+    return index;
+}
+}  // namespace detail
+
+// World whose components, layers and hooks are registered at runtime rather
+// than baked into template parameters like StaticWorld. Typed components are
+// stored in SparseSets, so systems written for StaticWorld (View-based, with
+// optional dt and context arguments) run unchanged; components only known at
+// runtime are registered by name and size and accessed as raw bytes.
+//
+//   DynamicWorld world;
+//   world.register_component<Position>("position");
+//   auto fuel = world.register_component("fuel", sizeof(float));
+//   auto layer = world.add_layer();
+//   world.add_system(layer, MoveSystem{});
+//   world.run(dt);
+//
+// Systems run sequentially; each layer's hook runs after its systems and
+// before their deferred commands are applied, as in StaticWorld.
+class DynamicWorld {
+   public:
+    class Context;
+    using System = std::function<void(DynamicWorld&, double, Context&)>;
+    using Hook = std::function<void(DynamicWorld&)>;
+
+    DynamicWorld();
+    ~DynamicWorld();
+    DynamicWorld(DynamicWorld&&) noexcept;
+    DynamicWorld& operator=(DynamicWorld&&) noexcept;
+    DynamicWorld(const DynamicWorld&) = delete;
+    DynamicWorld& operator=(const DynamicWorld&) = delete;
+
+    // Registers C, returning its id. Registering the same type again returns
+    // the existing id. An empty name registers the type anonymously.
+    template <Component C>
+    ComponentId register_component(std::string_view name = {}) {
+        using T = std::remove_cvref_t<C>;
+        if (auto id = component_id<T>(); id != kInvalidComponent) {
+            return id;
+        }
+        const auto id =
+            add_pool(name, std::make_unique<ComponentPool<T>>());
+        const auto index = detail::component_type_index<T>();
+        if (index >= type_slots_.size()) {
+            const auto old_size = type_slots_.size();
+            type_slots_.resize(index + 1);
+            std::fill(type_slots_.begin() + old_size, type_slots_.end(),
+                      kInvalidComponent);
+        }
+        type_slots_[index] = id;
+        return id;
+    }
+
+    // Registers a component known only by name and layout. Registering an
+    // existing name with the same layout returns the existing id.
+    ComponentId register_component(std::string_view name, std::size_t size,
+                                   std::size_t align = alignof(std::max_align_t));
+
+    ComponentId component_id(std::string_view name) const;
+
+    template <Component C>
+    ComponentId component_id() const noexcept {
+        const auto index =
+            detail::component_type_index<std::remove_cvref_t<C>>();
+        return index < type_slots_.size() ? type_slots_[index]
+                                          : kInvalidComponent;
+    }
+
+    std::size_t component_count() const noexcept { return pools_.size(); }
+    std::string_view component_name(ComponentId id) const {
+        return names_.at(id);
+    }
+    IComponentPool& pool(ComponentId id);
+    const IComponentPool& pool(ComponentId id) const;
+
+    Entity add_entity();
+    // Removes `e` and, if it is part of the hierarchy, all its descendants.
+    void remove_entity(const Entity& e);
+    bool has_entity(const Entity& e) const noexcept;
+    const Buffer<Entity>& entities() const noexcept { return entities_; }
+
+    // See StaticWorld::set_parent.
+    bool set_parent(const Entity& child, const Entity& parent);
+    Hierarchy& hierarchy() noexcept { return hierarchy_; }
+    const Hierarchy& hierarchy() const noexcept { return hierarchy_; }
+
+    template <Component Cc>
+    void add_component(const Entity& e, Cc&& component) {
+        using C = std::remove_cvref_t<Cc>;
+        get_component_set<C>().insert(e, std::forward<Cc>(component));
+    }
+
+    template <Component Cc, typename... Args>
+    void add_component(const Entity& e, Args&&... args) {
+        using C = std::remove_cvref_t<Cc>;
+        get_component_set<C>().emplace(e, std::forward<Args>(args)...);
+    }
+
+    // Copies pool(id).element_size() bytes (or a C object for typed pools)
+    // from `data`.
+    void add_component(const Entity& e, ComponentId id, const void* data);
+
+    template <Component Cc>
+    SparseSet<std::remove_cvref_t<Cc>>& get_component_set() {
+        using C = std::remove_cvref_t<Cc>;
+        const auto id = component_id<C>();
+        CSICS_RUNTIME_ASSERT(id != kInvalidComponent,
+                             "Component not registered in the world");
+        return static_cast<ComponentPool<C>&>(*pools_[id]).set();
+    }
+
+    template <Component Cc>
+    auto& get_component(const Entity& e) {
+        auto* comp = get_component_set<Cc>().at(e);
+        CSICS_RUNTIME_ASSERT(comp != nullptr,
+                             "Entity does not have the requested component");
+        return *comp;
+    }
+
+    template <Component Cc>
+    void remove_component(const Entity& e) {
+        get_component_set<Cc>().remove(e);
+    }
+
+    // Returns nullptr if `e` does not hold the component.
+    void* get_component(const Entity& e, ComponentId id);
+    const void* get_component(const Entity& e, ComponentId id) const;
+    void remove_component(const Entity& e, ComponentId id);
+
+    // Calls f(entity, components) for every entity holding all of `ids`,
+    // where components[i] points at the component for ids[i]. Driving the
+    // loop from the smallest pool mirrors View.
+    template <typename F>
+    void each(std::span<const ComponentId> ids, F&& f) {
+        CSICS_RUNTIME_ASSERT(!ids.empty() && ids.size() <= kMaxEachComponents,
+                             "each() takes between 1 and 16 components");
+        IComponentPool* pools[kMaxEachComponents];
+        void* ptrs[kMaxEachComponents];
+        const IComponentPool* smallest = nullptr;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            pools[i] = &pool(ids[i]);
+            if (smallest == nullptr || pools[i]->size() < smallest->size()) {
+                smallest = pools[i];
+            }
+        }
+        const auto& driver = smallest->entities();
+        for (std::size_t n = 0; n < driver.size(); ++n) {
+            const Entity& e = driver[n];
+            bool all = true;
+            for (std::size_t i = 0; i < ids.size() && all; ++i) {
+                ptrs[i] = pools[i]->get(e);
+                all = ptrs[i] != nullptr;
+            }
+            if (all) {
+                f(e, std::span<void* const>(ptrs, ids.size()));
+            }
+        }
+    }
+
+    // Appends a layer and returns its index. Layers run in creation order.
+    std::size_t add_layer();
+    std::size_t layer_count() const noexcept { return layers_.size(); }
+
+    // Adds a system to `layer`. Accepts anything StaticWorld does (a callable
+    // taking a View, optionally followed by dt and a context) or a System
+    // taking the world itself, which is how runtime-defined components are
+    // processed. View components are registered on first use.
+    template <typename S>
+    void add_system(std::size_t layer, S system) {
+        if constexpr (std::is_invocable_v<S&, DynamicWorld&, double,
+                                          Context&>) {
+            add_erased_system(layer, System(std::move(system)));
+        } else {
+            using view_type = typename system_traits<S>::view_type;
+            using components = typename view_traits<view_type>::components;
+            // pools are heap allocated, so the set pointers stay valid for
+            // the lifetime of the world, including across moves
+            auto sets = [&]<typename... Cs>(std::tuple<Cs...>) {
+                return std::make_tuple(&register_set<std::remove_const_t<Cs>>()...);
+            }(components{});
+            add_erased_system(
+                layer, [system = std::move(system), sets](
+                           DynamicWorld&, double dt, Context& ctx) mutable {
+                    auto v = std::apply(
+                        [](auto*... s) { return view_type(*s...); }, sets);
+                    if constexpr (SystemWithContext<S, Context>) {
+                        system(v, dt, ctx);
+                    } else if constexpr (SystemWithDt<S>) {
+                        system(v, dt);
+                    } else {
+                        system(v);
+                    }
+                });
+        }
+    }
+
+    // Sets the hook run after `layer`'s systems, replacing any previous one.
+    void set_hook(std::size_t layer, Hook hook);
+
+    void run(double dt);
+
+    // Handed to systems for deferred structural changes, which are applied
+    // after the layer (and its hook) finishes. New entities are created
+    // immediately so components can be queued against them.
+    class Context {
+       public:
+        Entity add_entity() { return world_->add_entity(); }
+
+        template <Component Cc, typename... Args>
+        void add_component(const Entity& e, Args&&... args) {
+            using C = std::remove_cvref_t<Cc>;
+            const auto id = world_->component_id<C>();
+            CSICS_RUNTIME_ASSERT(id != kInvalidComponent,
+                                 "Component not registered in the world");
+            CSICS_RUNTIME_ASSERT(world_->has_entity(e),
+                                 "Entity not found in world entities.");
+            void* p = commands_.allocate(sizeof(C), alignof(C));
+            new (p) C{std::forward<Args>(args)...};
+            commands_.push(CommandBuffer::Op::AddComponent, id, e, p);
+        }
+
+        // Queues a copy of the component at `data`; see
+        // DynamicWorld::add_component(e, id, data).
+        void add_component(const Entity& e, ComponentId id, const void* data);
+
+        template <Component Cc>
+        void remove_component(const Entity& e) {
+            remove_component(e, world_->component_id<std::remove_cvref_t<Cc>>());
+        }
+
+        void remove_component(const Entity& e, ComponentId id);
+        void destroy_entity(const Entity& e);
+
+        DynamicWorld& world() noexcept { return *world_; }
+
+       private:
+        friend class DynamicWorld;
+
+        explicit Context(DynamicWorld* world) : world_(world) {}
+
+        DynamicWorld* world_;
+        CommandBuffer commands_;
+    };
+
+   private:
+    static constexpr std::size_t kMaxEachComponents = 16;
+
+    struct LayerEntry {
+        std::vector<System> systems;
+        std::vector<Context> contexts;
+        Hook hook;
+    };
+
+    std::vector<std::unique_ptr<IComponentPool>> pools_;
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, ComponentId> ids_by_name_;
+    Buffer<ComponentId> type_slots_;
+
+    // entities_ is dense; slots_ maps an entity id to its index in entities_
+    Buffer<Entity> entities_;
+    Buffer<std::uint32_t> slots_;
+    Buffer<std::uint32_t> generations_;
+    Buffer<std::uint32_t> dead_entities_;
+    Hierarchy hierarchy_;
+
+    std::vector<LayerEntry> layers_;
+
+    ComponentId add_pool(std::string_view name,
+                         std::unique_ptr<IComponentPool> pool);
+    void add_erased_system(std::size_t layer, System system);
+    void apply(Context& ctx);
+    void remove_single_entity(const Entity& e);
+
+    template <Component C>
+    SparseSet<C>& register_set() {
+        const auto id = register_component<C>();
+        return static_cast<ComponentPool<C>&>(*pools_[id]).set();
+    }
+};
+
+};  // namespace csics::sim::ecs
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "csics/Buffer.hpp"
+#include "csics/sim/ecs/Entity.hpp"
+#include "csics/sim/ecs/SparseSet.hpp"
+
+namespace csics::sim::ecs {
+
+// Parent/child relationships between entities, e.g. platform -> emitter ->
+// beam. Nodes are kept in a flat array in depth-first pre-order, so
+//   - every parent precedes its children, and propagating transforms from
+//     parents to children is a single forward pass over contiguous arrays;
+//   - an entity's subtree is the contiguous range [index, index +
+//     subtree_size), so reparenting is a block rotate and removing a
+//     subtree is a single erase.
+// Structural changes are O(n) in the worst case (they shift the tail of the
+// arrays); traversal never chases entity ids.
+class Hierarchy {
+   public:
+    static constexpr std::uint32_t npos =
+        std::numeric_limits<std::uint32_t>::max();
+
+    static bool is_null(const Entity& e) noexcept {
+        return e.id == std::numeric_limits<std::uint32_t>::max();
+    }
+
+    // Adds `e` as a root, or as the last child of `parent` if it is given.
+    // `parent` must already be in the hierarchy.
+    void add(const Entity& e, const Entity& parent = Entity{}) {
+        CSICS_RUNTIME_ASSERT(index_of(e) == npos,
+                             "Entity already in the hierarchy");
+        ensure_index(e.id);
+        if (is_null(parent)) {
+            push_node(e, parent, npos, 0);
+            index_[e.id] = static_cast<std::uint32_t>(entities_.size() - 1);
+            return;
+        }
+        const std::uint32_t p = index_of(parent);
+        CSICS_RUNTIME_ASSERT(p != npos, "Parent not in the hierarchy");
+        const std::uint32_t pos = p + subtree_[p];
+        push_node(e, parent, p, depth_[p] + 1);
+        move_block(static_cast<std::uint32_t>(entities_.size() - 1), 1, pos);
+        adjust_ancestors(p, 1);
+        reindex(pos);
+    }
+
+    // Moves `e` and its subtree under `new_parent`, or makes it a root if
+    // `new_parent` is null. Returns false (and changes nothing) if
+    // `new_parent` is `e` or one of its descendants.
+    bool reparent(const Entity& e, const Entity& new_parent) {
+        const std::uint32_t s = index_of(e);
+        CSICS_RUNTIME_ASSERT(s != npos, "Entity not in the hierarchy");
+        const std::uint32_t n = subtree_[s];
+
+        std::uint32_t t = npos;
+        std::uint32_t dest = static_cast<std::uint32_t>(entities_.size());
+        std::uint32_t depth = 0;
+        if (!is_null(new_parent)) {
+            t = index_of(new_parent);
+            CSICS_RUNTIME_ASSERT(t != npos, "Parent not in the hierarchy");
+            if (t >= s && t < s + n) {
+                return false;
+            }
+            dest = t + subtree_[t];
+            depth = depth_[t] + 1;
+        }
+
+        if (parent_index_[s] != npos) {
+            adjust_ancestors(parent_index_[s], -static_cast<std::int64_t>(n));
+        }
+        if (t != npos) {
+            adjust_ancestors(t, n);
+        }
+        const std::int64_t depth_delta =
+            static_cast<std::int64_t>(depth) - depth_[s];
+        for (std::uint32_t i = s; i < s + n; ++i) {
+            depth_[i] = static_cast<std::uint32_t>(depth_[i] + depth_delta);
+        }
+        parents_[s] = new_parent;
+
+        move_block(s, n, dest);
+        reindex(std::min(s, dest));
+        return true;
+    }
+
+    // Removes `e` and all of its descendants, calling f(entity) for each of
+    // them in pre-order (parents first). f must not modify the hierarchy.
+    template <typename F>
+    void remove_subtree(const Entity& e, F&& f) {
+        const std::uint32_t s = index_of(e);
+        if (s == npos) {
+            return;
+        }
+        const std::uint32_t n = subtree_[s];
+        for (std::uint32_t i = s; i < s + n; ++i) {
+            f(entities_[i]);
+            index_[entities_[i].id] = npos;
+        }
+        if (parent_index_[s] != npos) {
+            adjust_ancestors(parent_index_[s], -static_cast<std::int64_t>(n));
+        }
+        visit_nodes([&](auto& buf) {
+            buf.erase(buf.begin() + s, buf.begin() + s + n);
+        });
+        reindex(s);
+    }
+
+    void remove_subtree(const Entity& e) {
+        remove_subtree(e, [](const Entity&) {});
+    }
+
+    bool contains(const Entity& e) const noexcept {
+        return index_of(e) != npos;
+    }
+
+    // Position of `e` in the pre-order arrays, or npos.
+    std::uint32_t index_of(const Entity& e) const noexcept {
+        if (e.id >= index_.size() || index_[e.id] == npos) {
+            return npos;
+        }
+        const std::uint32_t i = index_[e.id];
+        return entities_[i].generation == e.generation ? i : npos;
+    }
+
+    // Null Entity if `e` is a root.
+    Entity parent(const Entity& e) const {
+        const std::uint32_t i = index_of(e);
+        CSICS_RUNTIME_ASSERT(i != npos, "Entity not in the hierarchy");
+        return parents_[i];
+    }
+
+    std::uint32_t depth(const Entity& e) const {
+        const std::uint32_t i = index_of(e);
+        CSICS_RUNTIME_ASSERT(i != npos, "Entity not in the hierarchy");
+        return depth_[i];
+    }
+
+    // `e` followed by all of its descendants, in pre-order.
+    BasicBufferView<const Entity> subtree(const Entity& e) const {
+        const std::uint32_t i = index_of(e);
+        CSICS_RUNTIME_ASSERT(i != npos, "Entity not in the hierarchy");
+        return {entities_.data() + i, subtree_[i]};
+    }
+
+    // Calls f(child) for each direct child of `e`, skipping over
+    // grandchildren without visiting them.
+    template <typename F>
+    void for_each_child(const Entity& e, F&& f) const {
+        const std::uint32_t i = index_of(e);
+        CSICS_RUNTIME_ASSERT(i != npos, "Entity not in the hierarchy");
+        for (std::uint32_t c = i + 1; c < i + subtree_[i]; c += subtree_[c]) {
+            f(entities_[c]);
+        }
+    }
+
+    std::size_t size() const noexcept { return entities_.size(); }
+    bool empty() const noexcept { return entities_.empty(); }
+
+    // Pre-order arrays, parallel to each other.
+    BasicBufferView<const Entity> entities() const noexcept {
+        return entities_;
+    }
+    BasicBufferView<const std::uint32_t> parent_indices() const noexcept {
+        return parent_index_;
+    }
+    BasicBufferView<const std::uint32_t> depths() const noexcept {
+        return depth_;
+    }
+
+    // Linear propagation over arrays laid out in hierarchy order:
+    //   out[i] = compose(parent ? &out[parent] : nullptr, local[i])
+    template <typename L, typename W, typename F>
+    void propagate(BasicBufferView<const L> local, BasicBufferView<W> out,
+                   F&& compose) const {
+        CSICS_RUNTIME_ASSERT(local.size() >= size() && out.size() >= size(),
+                             "Propagation arrays smaller than the hierarchy");
+        for (std::size_t i = 0; i < entities_.size(); ++i) {
+            const std::uint32_t p = parent_index_[i];
+            out[i] = compose(p == npos ? nullptr : &out[p], local[i]);
+        }
+    }
+
+    // Propagates component sets, e.g. entity-relative coordinates to world
+    // coordinates: for every node holding L, the W component is set to
+    // compose(parent_world_or_null, local). Nodes without L pass their
+    // parent's world value through to their children.
+    template <Component L, Component W, typename F>
+    void propagate(const SparseSet<L>& local, SparseSet<W>& out,
+                   F&& compose) const {
+        // nearest node at or above each position that holds L, whose world
+        // value is already in `out` since parents come first
+        source_.resize(entities_.size());
+        for (std::size_t i = 0; i < entities_.size(); ++i) {
+            const std::uint32_t p = parent_index_[i];
+            const std::uint32_t from = p == npos ? npos : source_[p];
+            if (const L* l = local.at(entities_[i])) {
+                const W* base =
+                    from == npos ? nullptr : out.at(entities_[from]);
+                out.insert(entities_[i], compose(base, *l));
+                source_[i] = static_cast<std::uint32_t>(i);
+            } else {
+                source_[i] = from;
+            }
+        }
+    }
+
+    // Calls f on each backing array in a fixed order. Used by snapshots.
+    template <typename F>
+    void visit_storage(F&& f) {
+        visit_nodes(f);
+        f(index_);
+    }
+
+    template <typename F>
+    void visit_storage(F&& f) const {
+        f(entities_);
+        f(parents_);
+        f(parent_index_);
+        f(depth_);
+        f(subtree_);
+        f(index_);
+    }
+
+   private:
+    Buffer<Entity> entities_;
+    Buffer<Entity> parents_;
+    Buffer<std::uint32_t> parent_index_;
+    Buffer<std::uint32_t> depth_;
+    Buffer<std::uint32_t> subtree_;
+    // entity id -> position in the arrays above
+    Buffer<std::uint32_t> index_;
+    // propagate() scratch, kept to avoid allocating every pass
+    mutable Buffer<std::uint32_t> source_;
+
+    template <typename F>
+    void visit_nodes(F&& f) {
+        f(entities_);
+        f(parents_);
+        f(parent_index_);
+        f(depth_);
+        f(subtree_);
+    }
+
+    void ensure_index(std::uint32_t id) {
+        if (id >= index_.size()) {
+            const std::size_t old_size = index_.size();
+            index_.resize(std::max<std::size_t>(id + 1, old_size * 2));
+            std::fill(index_.begin() + old_size, index_.end(), npos);
+        }
+    }
+
+    void push_node(const Entity& e, const Entity& parent, std::uint32_t p,
+                   std::uint32_t depth) {
+        entities_.push_back(e);
+        parents_.push_back(parent);
+        parent_index_.push_back(p);
+        depth_.push_back(depth);
+        subtree_.push_back(1);
+    }
+
+    void adjust_ancestors(std::uint32_t p, std::int64_t delta) {
+        while (p != npos) {
+            subtree_[p] = static_cast<std::uint32_t>(subtree_[p] + delta);
+            p = parent_index_[p];
+        }
+    }
+
+    // Moves the block [s, s + n) so that it starts where position `dest`
+    // was; dest must lie outside the block.
+    void move_block(std::uint32_t s, std::uint32_t n, std::uint32_t dest) {
+        if (dest < s) {
+            visit_nodes([&](auto& buf) {
+                std::rotate(buf.begin() + dest, buf.begin() + s,
+                            buf.begin() + s + n);
+            });
+        } else if (dest > s + n) {
+            visit_nodes([&](auto& buf) {
+                std::rotate(buf.begin() + s, buf.begin() + s + n,
+                            buf.begin() + dest);
+            });
+        }
+    }
+
+    // Positions from `from` onwards have moved: refresh the id index and
+    // the parent positions. Parents precede children, so nodes before
+    // `from` are unaffected.
+    void reindex(std::uint32_t from) {
+        for (std::size_t i = from; i < entities_.size(); ++i) {
+            index_[entities_[i].id] = static_cast<std::uint32_t>(i);
+        }
+        for (std::size_t i = from; i < entities_.size(); ++i) {
+            parent_index_[i] =
+                is_null(parents_[i]) ? npos : index_[parents_[i].id];
+        }
+    }
+};
+
+};  // namespace csics::sim::ecs
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "csics/Buffer.hpp"
+#ifdef CSICS_BUILD_SERIALIZATION
+#include "csics/serialization/serialization.hpp"
+#endif
+
+namespace csics::sim::ecs {
+
+inline constexpr std::size_t kSnapshotAlignment = 64;
+inline constexpr std::size_t kSnapshotPageSize = 4096;
+
+// One contiguous array captured in a snapshot. Offsets are relative to the
+// start of the snapshot blob and always kSnapshotAlignment aligned.
+struct SnapshotSection {
+    std::uint64_t offset;
+    std::uint64_t count;
+    std::uint32_t elem_size;
+    std::uint32_t reserved;
+
+    constexpr std::uint64_t bytes() const noexcept {
+        return count * elem_size;
+    }
+};
+
+namespace detail {
+constexpr std::size_t snapshot_align(std::size_t n) noexcept {
+    return (n + kSnapshotAlignment - 1) & ~(kSnapshotAlignment - 1);
+}
+};  // namespace detail
+
+// A full byte copy of a world's state: every backing array is memcpy'd into a
+// single aligned blob, described by a section table. The storage is kept
+// across clear(), so a snapshot reused every frame stops allocating once it
+// has grown to the size of the world.
+class WorldSnapshot {
+   public:
+    WorldSnapshot() = default;
+
+    void clear() {
+        data_.resize(0);
+        sections_.resize(0);
+    }
+
+    template <typename T, std::size_t A, CapacityPolicy P>
+    void capture(const Buffer<T, A, P>& buf) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Snapshots require trivially copyable storage");
+        append_section(buf.data(), buf.size(), sizeof(T));
+    }
+
+    void append_section(const void* src, std::size_t count,
+                        std::size_t elem_size) {
+        char* dst = reserve_section(count, elem_size);
+        if (count != 0) {
+            std::memcpy(dst, src, count * elem_size);
+        }
+    }
+
+    // Appends an uninitialized section and returns a pointer to it.
+    char* reserve_section(std::size_t count, std::size_t elem_size) {
+        const std::size_t start = data_.size();
+        const std::size_t offset = detail::snapshot_align(start);
+        data_.resize(offset + count * elem_size);
+        std::memset(data_.data() + start, 0, offset - start);
+        sections_.push_back(SnapshotSection{
+            offset, count, static_cast<std::uint32_t>(elem_size), 0});
+        return data_.data() + offset;
+    }
+
+    // Copies section `index` back into `buf`. Returns false if the section
+    // does not exist or was captured from a different element type.
+    template <typename T, std::size_t A, CapacityPolicy P>
+    bool restore_section(std::size_t index, Buffer<T, A, P>& buf) const {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Snapshots require trivially copyable storage");
+        if (index >= sections_.size() ||
+            sections_[index].elem_size != sizeof(T)) {
+            return false;
+        }
+        const auto& section = sections_[index];
+        buf.resize(section.count);
+        if (section.count != 0) {
+            std::memcpy(static_cast<void*>(buf.data()),
+                        data_.data() + section.offset, section.bytes());
+        }
+        return true;
+    }
+
+    std::size_t section_count() const noexcept { return sections_.size(); }
+    BasicBufferView<const SnapshotSection> sections() const noexcept {
+        return sections_;
+    }
+
+    BufferView section(std::size_t index) const noexcept {
+        const auto& s = sections_[index];
+        return BufferView(data_.data() + s.offset, s.bytes());
+    }
+
+    MutableBufferView section(std::size_t index) noexcept {
+        const auto& s = sections_[index];
+        return MutableBufferView(data_.data() + s.offset, s.bytes());
+    }
+
+    BufferView data() const noexcept { return data_; }
+    MutableBufferView data() noexcept { return data_; }
+    std::size_t size_bytes() const noexcept { return data_.size(); }
+
+    bool operator==(const WorldSnapshot& other) const noexcept {
+        if (sections_.size() != other.sections_.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < sections_.size(); ++i) {
+            if (sections_[i].count != other.sections_[i].count ||
+                sections_[i].elem_size != other.sections_[i].elem_size) {
+                return false;
+            }
+        }
+        return data() == other.data();
+    }
+
+   private:
+    Buffer<char, kSnapshotAlignment> data_;
+    Buffer<SnapshotSection> sections_;
+};
+
+// The pages (kSnapshotPageSize bytes of a section) that differ between a base
+// snapshot and the current world. Pages are found by comparing the live arrays
+// against the base, so producing a delta costs one read of the world plus one
+// read of the base; only changed pages are copied.
+class DeltaSnapshot {
+   public:
+    struct Page {
+        std::uint32_t section;
+        std::uint32_t index;   // page number within the section
+        std::uint64_t offset;  // offset of the page payload in data()
+        std::uint64_t bytes;
+    };
+
+    void clear() {
+        sections_.resize(0);
+        pages_.resize(0);
+        data_.resize(0);
+    }
+
+    template <typename T, std::size_t A, CapacityPolicy P>
+    void diff_section(const WorldSnapshot& base, const Buffer<T, A, P>& buf) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Snapshots require trivially copyable storage");
+        diff_section(base, buf.data(), buf.size(), sizeof(T));
+    }
+
+    void diff_section(const WorldSnapshot& base, const void* src,
+                      std::size_t count, std::size_t elem_size) {
+        const auto index = static_cast<std::uint32_t>(sections_.size());
+        sections_.push_back(SnapshotSection{
+            0, count, static_cast<std::uint32_t>(elem_size), 0});
+
+        BufferView old;
+        if (index < base.section_count() &&
+            base.sections()[index].elem_size == elem_size) {
+            old = base.section(index);
+        }
+
+        const char* cur = static_cast<const char*>(src);
+        const std::size_t bytes = count * elem_size;
+        for (std::size_t off = 0; off < bytes; off += kSnapshotPageSize) {
+            const std::size_t len = std::min(kSnapshotPageSize, bytes - off);
+            if (off + len <= old.size() &&
+                std::memcmp(cur + off, old.data() + off, len) == 0) {
+                continue;
+            }
+            pages_.push_back(
+                Page{index, static_cast<std::uint32_t>(off / kSnapshotPageSize),
+                     data_.size(), len});
+            data_.append(cur + off, len);
+        }
+    }
+
+    // Rolls `snap` forward so it equals the state the delta was taken from.
+    // `snap` must be the base the delta was computed against. When no
+    // section changed size only the dirty pages are written.
+    void apply_to(WorldSnapshot& snap) const {
+        bool same_layout = snap.section_count() == sections_.size();
+        for (std::size_t i = 0; same_layout && i < sections_.size(); ++i) {
+            same_layout = snap.sections()[i].count == sections_[i].count &&
+                          snap.sections()[i].elem_size == sections_[i].elem_size;
+        }
+
+        if (!same_layout) {
+            WorldSnapshot next;
+            for (std::size_t i = 0; i < sections_.size(); ++i) {
+                const auto& s = sections_[i];
+                char* dst = next.reserve_section(s.count, s.elem_size);
+                if (i < snap.section_count() &&
+                    snap.sections()[i].elem_size == s.elem_size) {
+                    BufferView old = snap.section(i);
+                    std::memcpy(dst, old.data(),
+                                std::min<std::size_t>(old.size(), s.bytes()));
+                }
+            }
+            snap = std::move(next);
+        }
+
+        for (const auto& page : pages_) {
+            MutableBufferView dst = snap.section(page.section);
+            std::memcpy(dst.data() + page.index * kSnapshotPageSize,
+                        data_.data() + page.offset, page.bytes);
+        }
+    }
+
+    std::size_t page_count() const noexcept { return pages_.size(); }
+    BasicBufferView<const Page> pages() const noexcept { return pages_; }
+    BufferView data() const noexcept { return data_; }
+    std::size_t size_bytes() const noexcept { return data_.size(); }
+
+   private:
+    Buffer<SnapshotSection> sections_;
+    Buffer<Page> pages_;
+    Buffer<char, kSnapshotAlignment> data_;
+};
+
+#ifdef CSICS_BUILD_SERIALIZATION
+
+// On-disk layout (all header fields little endian):
+//   u32 magic 'CSWS', u16 version, u16 flags, u32 section count, u32 reserved,
+//   u64 blob size, then per section u64 offset, u64 count, u32 elem size,
+//   u32 reserved, followed by the raw blob.
+// The blob holds the arrays in host byte order; flags bit 0 records a big
+// endian host and loading on a host of the other order is rejected.
+inline constexpr std::uint32_t kSnapshotMagic = 0x53575343;  // "CSWS"
+inline constexpr std::uint16_t kSnapshotVersion = 1;
+
+namespace detail {
+constexpr std::uint16_t snapshot_host_flags() noexcept {
+    return std::endian::native == std::endian::big ? 1 : 0;
+}
+};  // namespace detail
+
+inline std::size_t snapshot_wire_size(const WorldSnapshot& snap) noexcept {
+    return 24 + snap.section_count() * 24 + snap.size_bytes();
+}
+
+template <serialization::WireSerializer S>
+serialization::SerializationResult serialize_wire(S& s, MutableBufferView& bv,
+                                                  const WorldSnapshot& snap) {
+    if (bv.size() < snapshot_wire_size(snap)) {
+        return {bv(0, 0), serialization::SerializationStatus::BufferFull};
+    }
+    auto bv_ = bv;
+    s.write(bv_, le<std::uint32_t>(kSnapshotMagic));
+    s.write(bv_, le<std::uint16_t>(kSnapshotVersion));
+    s.write(bv_, le<std::uint16_t>(detail::snapshot_host_flags()));
+    s.write(bv_, le<std::uint32_t>(snap.section_count()));
+    s.pad(bv_, 4);
+    s.write(bv_, le<std::uint64_t>(snap.size_bytes()));
+    for (const auto& section : snap.sections()) {
+        s.write(bv_, le<std::uint64_t>(section.offset));
+        s.write(bv_, le<std::uint64_t>(section.count));
+        s.write(bv_, le<std::uint32_t>(section.elem_size));
+        s.pad(bv_, 4);
+    }
+    // the blob is already in its final form, copy it in one go
+    if (snap.size_bytes() != 0) {
+        std::memcpy(bv_.data(), snap.data().data(), snap.size_bytes());
+        bv_ += snap.size_bytes();
+    }
+    return {bv(0, bv.size() - bv_.size()),
+            serialization::SerializationStatus::Ok};
+}
+
+template <serialization::Deserializer D>
+    requires requires(D& d, std::size_t n) {
+        d.read_bytes(n);
+        d.remaining();
+    }
+expected<WorldSnapshot, typename D::error_type> deserialize_direct(
+    D& d, serialization::detail::type_tag<WorldSnapshot> = {}) {
+    using E = typename D::error_type;
+    auto invalid = [&d](const char* field) {
+        return unexpected<E>(serialization::invalid_data(d, field));
+    };
+
+    auto magic = d.template read<le<std::uint32_t>>();
+    auto version = d.template read<le<std::uint16_t>>();
+    auto flags = d.template read<le<std::uint16_t>>();
+    auto section_count = d.template read<le<std::uint32_t>>();
+    auto reserved = d.template read<le<std::uint32_t>>();
+    auto blob_size = d.template read<le<std::uint64_t>>();
+    if (auto err = serialization::first_error<E>(
+            "magic", magic, "version", version, "flags", flags,
+            "section_count", section_count, "reserved", reserved,
+            "blob_size", blob_size)) {
+        return *err;
+    }
+    if (magic->native() != kSnapshotMagic) {
+        return invalid("magic");
+    }
+    if (version->native() != kSnapshotVersion) {
+        return invalid("version");
+    }
+    if (flags->native() != detail::snapshot_host_flags()) {
+        return invalid("flags");
+    }
+    // sizes are untrusted: the section table and blob have to be in the
+    // input before anything is allocated for them
+    const std::uint64_t table_size =
+        std::uint64_t{section_count->native()} * 24;
+    if (table_size > d.remaining() ||
+        blob_size->native() > d.remaining() - table_size) {
+        return invalid("blob_size");
+    }
+
+    WorldSnapshot snap;
+    for (std::uint32_t i = 0; i < section_count->native(); ++i) {
+        auto offset = d.template read<le<std::uint64_t>>();
+        auto count = d.template read<le<std::uint64_t>>();
+        auto elem_size = d.template read<le<std::uint32_t>>();
+        auto pad = d.template read<le<std::uint32_t>>();
+        if (auto err = serialization::first_error<E>(
+                "sections", offset, "sections", count, "sections", elem_size,
+                "sections", pad)) {
+            return *err;
+        }
+        // the sections so far plus this one have to fit in the blob
+        const std::size_t start = detail::snapshot_align(snap.size_bytes());
+        if (elem_size->native() == 0 || start > blob_size->native() ||
+            count->native() >
+                (blob_size->native() - start) / elem_size->native()) {
+            return invalid("sections");
+        }
+        snap.reserve_section(count->native(), elem_size->native());
+        if (snap.sections()[i].offset != offset->native()) {
+            return invalid("sections");
+        }
+    }
+    if (snap.size_bytes() != blob_size->native()) {
+        return invalid("blob_size");
+    }
+
+    auto blob = d.read_bytes(blob_size->native());
+    if (!blob) {
+        return serialization::tag_field(blob.error(), "blob");
+    }
+    if (blob->size() != 0) {
+        std::memcpy(snap.data().data(), blob->data(), blob->size());
+    }
+    return snap;
+}
+
+#endif
+
+};  // namespace csics::sim::ecs
@@ -8,12 +8,15 @@ template <typename T>
 concept Component = true;  // maybe constraints later, but for now we can just
                            // allow any type as a component
 
+// N is the initial size of the sparse index; it grows on demand when an
+// entity with a larger id is inserted.
 template <Component C, std::size_t N = 1000>
 class SparseSet {
    public:
     using value_type = C;
-    SparseSet()
-        : dense_(), sparse_(N, std::numeric_limits<std::size_t>::max()) {}
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    SparseSet() : dense_(), sparse_(N, npos) {}
 
     SparseSet(const SparseSet&) = default;
     SparseSet(SparseSet&&) = default;
@@ -31,13 +34,12 @@ class SparseSet {
 
     template <typename Cc = C>
     void insert(Entity entity, Cc&& component) {
-        CSICS_RUNTIME_ASSERT(entity.id < N,
-                             "insert: Entity ID exceeds maximum capacity "
-                             "(entity.id: " +
-                                 std::to_string(entity.id) + ")");
-        if (sparse_[entity.id] == std::numeric_limits<std::size_t>::max()) {
+        if (entity.id >= sparse_.size()) [[unlikely]] {
+            grow_sparse(entity.id);
+        }
+        if (sparse_[entity.id] == npos) {
             sparse_[entity.id] = dense_.size();
-            dense_.push_back(component);
+            dense_.push_back(std::forward<Cc>(component));
             entities_.push_back(entity);
         } else {
             dense_[sparse_[entity.id]] = std::forward<Cc>(component);
@@ -45,11 +47,7 @@ class SparseSet {
     }
 
     const C* at(Entity entity) const {
-        CSICS_RUNTIME_ASSERT(entity.id < N,
-                             "at: Entity ID exceeds maximum capacity "
-                             "(entity.id: " +
-                                 std::to_string(entity.id) + ")");
-        if (sparse_[entity.id] != std::numeric_limits<std::size_t>::max()) {
+        if (entity.id < sparse_.size() && sparse_[entity.id] != npos) {
             if (entities_[sparse_[entity.id]].generation != entity.generation) {
                 return nullptr;
             }
@@ -60,11 +58,7 @@ class SparseSet {
     }
 
     C* at(Entity entity) {
-        CSICS_RUNTIME_ASSERT(entity.id < N,
-                             "at: Entity ID exceeds maximum capacity "
-                             "(entity.id: " +
-                                 std::to_string(entity.id) + ")");
-        if (sparse_[entity.id] != std::numeric_limits<std::size_t>::max()) {
+        if (entity.id < sparse_.size() && sparse_[entity.id] != npos) {
             if (entities_[sparse_[entity.id]].generation != entity.generation) {
                 return nullptr;
             }
@@ -75,25 +69,20 @@ class SparseSet {
     }
 
     bool contains(Entity entity) const {
-        CSICS_RUNTIME_ASSERT(entity.id < N,
-                             "contains: Entity ID exceeds maximum capacity "
-                             "(entity.id: " +
-                                 std::to_string(entity.id) + ")");
-        return sparse_[entity.id] != std::numeric_limits<std::size_t>::max();
+        return entity.id < sparse_.size() && sparse_[entity.id] != npos;
     }
 
     constexpr size_t size() const { return dense_.size(); }
     constexpr bool empty() const { return dense_.empty(); }
 
     void remove(Entity entity) {
-        if (entity.id >= N ||
-            sparse_[entity.id] == std::numeric_limits<std::size_t>::max() ||
+        if (entity.id >= sparse_.size() || sparse_[entity.id] == npos ||
             dense_.empty()) {
             return;
         }
         dense_[sparse_[entity.id]] =
-            dense_[dense_.size() -
-                   1];  // Move the last component to the removed spot
+            std::move(dense_[dense_.size() -
+                             1]);  // Move the last component to the removed spot
         auto last_entity =
             entities_[entities_.size() -
                       1];  // Move the last entity to the removed spot
@@ -101,9 +90,7 @@ class SparseSet {
             sparse_[entity.id];  // Update the sparse index for the moved
                                  // entity
         entities_[sparse_[entity.id]] = last_entity;  // Update the entity list
-        sparse_[entity.id] =
-            std::numeric_limits<std::size_t>::max();  // Mark the removed entity
-                                                      // as not present
+        sparse_[entity.id] = npos;  // Mark the removed entity as not present
         dense_.pop_back();
         entities_.pop_back();
     }
@@ -119,10 +106,32 @@ class SparseSet {
     auto begin() const { return dense_.begin(); }
     auto end() const { return dense_.end(); }
 
+    // Calls f on each backing array (dense, sparse, entities) in a fixed
+    // order. Used by snapshots to copy the set in bulk.
+    template <typename F>
+    void visit_storage(F&& f) {
+        f(dense_);
+        f(sparse_);
+        f(entities_);
+    }
+
+    template <typename F>
+    void visit_storage(F&& f) const {
+        f(dense_);
+        f(sparse_);
+        f(entities_);
+    }
+
    private:
     Buffer<C> dense_;
     Buffer<size_t> sparse_;
     Buffer<Entity> entities_;
+
+    void grow_sparse(std::uint32_t id) {
+        const std::size_t old_size = sparse_.size();
+        sparse_.resize(std::max<std::size_t>(id + 1, old_size * 2));
+        std::fill(sparse_.begin() + old_size, sparse_.end(), npos);
+    }
 };
 
 };  // namespace csics::sim::ecs
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+
+#include "csics/Buffer.hpp"
+#include "csics/geo/Coordinates.hpp"
+#include "csics/geo/Ops.hpp"
+#include "csics/geo/SpatialGrid.hpp"
+#include "csics/sim/ecs/Entity.hpp"
+#include "csics/sim/ecs/SparseSet.hpp"
+
+namespace csics::sim::ecs {
+
+// Default projection from a position component to ECEF. Accepts geocentric
+// and geodetic coordinate types as well as plain structs with x, y, z
+// members holding ECEF metres.
+struct ToECEF {
+    template <typename C>
+    geo::Geocentric<double> operator()(const C& c) const {
+        if constexpr (geo::GeocentricLike<C>) {
+            return {c.x(), c.y(), c.z()};
+        } else if constexpr (geo::GeodeticLike<C>) {
+            auto p = geo::to_geocentric(c);
+            return {p.x(), p.y(), p.z()};
+        } else {
+            return {static_cast<double>(c.x), static_cast<double>(c.y),
+                    static_cast<double>(c.z)};
+        }
+    }
+};
+
+// Spatial index over the entities holding position component C. Call
+// update() once per tick (e.g. from a hook) with the component set; only
+// entities whose cell changed are re-bucketed, and entities that lost the
+// component are dropped. Queries return live Entity handles.
+template <Component C, typename Projection = ToECEF>
+class SpatialIndex {
+   public:
+    explicit SpatialIndex(double cell_size, Projection projection = {})
+        : grid_(cell_size), projection_(projection) {}
+
+    void update(const SparseSet<C>& set) {
+        ++epoch_;
+        const auto& entities = set.entities();
+        const auto components = set.components();
+        for (std::size_t i = 0; i < entities.size(); ++i) {
+            upsert(entities[i], components[i]);
+        }
+
+        // every entity in the set is now in the grid, so a size mismatch
+        // means some grid entries are stale
+        if (grid_.size() != set.size()) {
+            scratch_.clear();
+            grid_.for_each([&](std::uint32_t id, double, double, double) {
+                if (seen_[id] != epoch_) {
+                    scratch_.push_back(id);
+                }
+            });
+            for (auto id : scratch_) {
+                grid_.remove(id);
+            }
+        }
+    }
+
+    void update(const Entity& e, const C& component) {
+        upsert(e, component);
+    }
+
+    void remove(const Entity& e) { grid_.remove(e.id); }
+
+    template <typename E>
+    void query_radius(const geo::Geocentric<double, E>& center, double radius,
+                      Buffer<Entity>& out) const {
+        grid_.for_each_in_radius(center, radius, [&](std::uint32_t id, double) {
+            out.push_back(entity_of(id));
+        });
+    }
+
+    template <typename E>
+    void query_box(const geo::Geocentric<double, E>& lo,
+                   const geo::Geocentric<double, E>& hi,
+                   Buffer<Entity>& out) const {
+        ids_.clear();
+        grid_.query_box(lo, hi, ids_);
+        for (auto id : ids_) {
+            out.push_back(entity_of(id));
+        }
+    }
+
+    // Appends the k nearest entities to `out`, closest first.
+    template <typename E>
+    void query_knn(const geo::Geocentric<double, E>& center, std::size_t k,
+                   Buffer<Entity>& out) const {
+        neighbours_.clear();
+        grid_.query_knn(center, k, neighbours_);
+        for (const auto& n : neighbours_) {
+            out.push_back(entity_of(n.id));
+        }
+    }
+
+    const geo::SpatialGrid& grid() const noexcept { return grid_; }
+    std::size_t size() const noexcept { return grid_.size(); }
+
+   private:
+    geo::SpatialGrid grid_;
+    Projection projection_;
+    Buffer<std::uint32_t> seen_;
+    Buffer<std::uint32_t> generations_;
+    Buffer<std::uint32_t> scratch_;
+    mutable Buffer<std::uint32_t> ids_;
+    mutable Buffer<geo::SpatialGrid::Neighbour> neighbours_;
+    std::uint32_t epoch_ = 0;
+
+    void upsert(const Entity& e, const C& component) {
+        if (e.id >= seen_.size()) {
+            const std::size_t old_size = seen_.size();
+            const std::size_t size =
+                std::max<std::size_t>(e.id + 1, old_size * 2);
+            seen_.resize(size);
+            generations_.resize(size);
+            std::fill(seen_.begin() + old_size, seen_.end(), 0);
+        }
+        seen_[e.id] = epoch_;
+        generations_[e.id] = e.generation;
+        const auto p = projection_(component);
+        grid_.insert(e.id, p.x(), p.y(), p.z());
+    }
+
+    Entity entity_of(std::uint32_t id) const {
+        Entity e;
+        e.id = id;
+        e.generation = generations_[id];
+        return e;
+    }
+};
+
+};  // namespace csics::sim::ecs
@@ -8,6 +8,8 @@
 
 #include "csics/executor/Concept.hpp"
 #include "csics/executor/Executors.hpp"
+#include "csics/sim/ecs/Hierarchy.hpp"
+#include "csics/sim/ecs/Snapshot.hpp"
 #include "csics/sim/ecs/Traits.hpp"
 #include "csics/sim/ecs/View.hpp"
 namespace csics::sim::ecs {
@@ -105,19 +107,33 @@ class StaticWorld<std::tuple<Layers...>, std::tuple<Components...>,
         std::get<SparseSet<C>>(components_).remove(e);
     }
 
+    // Removes `e` and, if it is part of the hierarchy, all its descendants.
     void remove_entity(const Entity& e) {
-        auto it = std::find_if(
-            entities_.begin(), entities_.end(),
-            [&](const Entity& entity) { return entity.id == e.id; });
-        CSICS_RUNTIME_ASSERT(it != entities_.end(),
-                             "Entity not found in world entities.");
-        dead_entities_.push_back(e.id);
-        entities_.erase(it);
-        std::apply(
-            [&](auto&&... sets) { (sets.remove(e), ...); },
-            std::make_tuple(std::get<SparseSet<Components>>(components_)...));
+        if (hierarchy_.contains(e)) {
+            hierarchy_.remove_subtree(
+                e, [&](const Entity& d) { remove_single_entity(d); });
+        } else {
+            remove_single_entity(e);
+        }
+    }
+
+    // Attaches `child` under `parent`, moving its subtree if it already has
+    // a parent; a null `parent` makes it a root. Returns false if that would
+    // create a cycle.
+    bool set_parent(const Entity& child, const Entity& parent) {
+        if (!Hierarchy::is_null(parent) && !hierarchy_.contains(parent)) {
+            hierarchy_.add(parent);
+        }
+        if (!hierarchy_.contains(child)) {
+            hierarchy_.add(child, parent);
+            return true;
+        }
+        return hierarchy_.reparent(child, parent);
     }
 
+    Hierarchy& hierarchy() noexcept { return hierarchy_; }
+    const Hierarchy& hierarchy() const noexcept { return hierarchy_; }
+
     bool has_entity(const Entity& e) const {
         auto it = std::find_if(
             entities_.begin(), entities_.end(),
@@ -125,6 +141,45 @@ class StaticWorld<std::tuple<Layers...>, std::tuple<Components...>,
         return it != entities_.end();
     }
 
+    // Captures the entity bookkeeping and every component set into `out`,
+    // reusing its storage. All components must be trivially copyable.
+    void snapshot(WorldSnapshot& out) const {
+        out.clear();
+        visit_state([&](const auto& buf) { out.capture(buf); });
+    }
+
+    WorldSnapshot snapshot() const {
+        WorldSnapshot snap;
+        snapshot(snap);
+        return snap;
+    }
+
+    // Records only the pages that changed since `base` into `out`.
+    void snapshot_delta(const WorldSnapshot& base, DeltaSnapshot& out) const {
+        out.clear();
+        visit_state([&](const auto& buf) { out.diff_section(base, buf); });
+    }
+
+    // Rolls the world back to `snap`. Returns false and leaves the world
+    // untouched if the snapshot was taken from a differently shaped world.
+    bool restore(const WorldSnapshot& snap) {
+        std::size_t i = 0;
+        bool compatible = true;
+        visit_state([&](const auto& buf) {
+            using T = typename std::remove_cvref_t<decltype(buf)>::value_type;
+            compatible = compatible && i < snap.section_count() &&
+                         snap.sections()[i].elem_size == sizeof(T);
+            ++i;
+        });
+        if (!compatible || i != snap.section_count()) {
+            return false;
+        }
+
+        i = 0;
+        visit_state([&](auto& buf) { snap.restore_section(i++, buf); });
+        return true;
+    }
+
     void run(double dt) {
         [&]<size_t... Is>(std::index_sequence<Is...>) {
             (std::apply(
@@ -190,7 +245,11 @@ class StaticWorld<std::tuple<Layers...>, std::tuple<Components...>,
                                              remove_component<C>(action.e);
                                          } else if constexpr (ActionType::
                                                                   type == 2) {
-                                             remove_entity(action.e);
+                                             // may already be gone with
+                                             // a destroyed ancestor
+                                             if (has_entity(action.e)) {
+                                                 remove_entity(action.e);
+                                             }
                                          }
                                      },
                                      action);
@@ -306,6 +365,7 @@ class StaticWorld<std::tuple<Layers...>, std::tuple<Components...>,
                 [&](const Entity& entity) { return entity.id == e.id; });
             CSICS_RUNTIME_ASSERT(it != world.entities_.end(),
                                  "Entity not found in world entities.");
+            (void)it;  // disable warning in release builds
             deferred_actions.push_back(RemoveComponent<C>{.e = e});
         }
 
@@ -315,17 +375,52 @@ class StaticWorld<std::tuple<Layers...>, std::tuple<Components...>,
                 [&](const Entity& entity) { return entity.id == e.id; });
             CSICS_RUNTIME_ASSERT(it != world.entities_.end(),
                                  "Entity not found in world entities.");
+            (void)it;  // disable warning in release builds
             deferred_actions.push_back(DestroyEntity{.e = e});
         }
     };
 
    protected:
+    void remove_single_entity(const Entity& e) {
+        auto it = std::find_if(
+            entities_.begin(), entities_.end(),
+            [&](const Entity& entity) { return entity.id == e.id; });
+        CSICS_RUNTIME_ASSERT(it != entities_.end(),
+                             "Entity not found in world entities.");
+        dead_entities_.push_back(e.id);
+        entities_.erase(it);
+        (std::get<SparseSet<Components>>(components_).remove(e), ...);
+    }
+
+    template <typename F>
+    void visit_state(F&& f) const {
+        static_assert((std::is_trivially_copyable_v<Components> && ...),
+                      "Snapshots require trivially copyable components");
+        f(entities_);
+        f(dead_entities_);
+        f(generations_);
+        hierarchy_.visit_storage(f);
+        (std::get<SparseSet<Components>>(components_).visit_storage(f), ...);
+    }
+
+    template <typename F>
+    void visit_state(F&& f) {
+        static_assert((std::is_trivially_copyable_v<Components> && ...),
+                      "Snapshots require trivially copyable components");
+        f(entities_);
+        f(dead_entities_);
+        f(generations_);
+        hierarchy_.visit_storage(f);
+        (std::get<SparseSet<Components>>(components_).visit_storage(f), ...);
+    }
+
     std::tuple<Layers...> layers_;
     std::tuple<Hooks...> hooks_;
     std::tuple<SparseSet<Components>...> components_;
     Buffer<Entity> entities_;
     Buffer<std::uint32_t> dead_entities_;
     Buffer<std::uint32_t> generations_;
+    Hierarchy hierarchy_;
     Executor executor_;
 
     friend class WorldContext;
@@ -1,5 +1,14 @@
 #pragma once
+#include "csics/sim/ecs/DynamicWorld.hpp"
+#ifdef CSICS_BUILD_LVC
+#include "csics/sim/ecs/DISIngest.hpp"
+#endif
 #include "csics/sim/ecs/Entity.hpp"
+#include "csics/sim/ecs/Hierarchy.hpp"
+#include "csics/sim/ecs/Snapshot.hpp"
 #include "csics/sim/ecs/SparseSet.hpp"
+#ifdef CSICS_BUILD_GEO
+#include "csics/sim/ecs/SpatialIndex.hpp"
+#endif
 #include "csics/sim/ecs/View.hpp"
 #include "csics/sim/ecs/World.hpp"
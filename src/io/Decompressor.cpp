@@ -0,0 +1,21 @@
+#include <csics/io/decompression/Decompressor.hpp>
+
+#include <stdexcept>
+
+#ifdef CSICS_USE_ZSTD
+#include "ZSTDDecompressor.hpp"
+#endif
+
+namespace csics::io::decompression {
+
+    std::unique_ptr<IDecompressor> IDecompressor::create(CompressorType type) {
+        switch (type) {
+#ifdef CSICS_USE_ZSTD
+            case CompressorType::ZSTD:
+                return std::make_unique<ZSTDDecompressor>();
+#endif
+            default:
+                throw std::invalid_argument("Unsupported decompressor type");
+        }
+    }
+};
@@ -0,0 +1,84 @@
+#include "ZSTDDecompressor.hpp"
+#include <zstd.h>
+
+#include <stdexcept>
+
+namespace csics::io::decompression {
+ZSTDDecompressor::ZSTDDecompressor() : stream_(nullptr) {
+    stream_ = ZSTD_createDStream();
+    if (stream_ == nullptr) {
+        throw std::runtime_error("Failed to create ZSTD decompressor stream");
+    }
+    std::size_t ret = ZSTD_initDStream(static_cast<ZSTD_DStream*>(stream_));
+    if (ZSTD_isError(ret)) {
+        ZSTD_freeDStream(static_cast<ZSTD_DStream*>(stream_));
+        throw std::runtime_error(
+            "Failed to initialize ZSTD decompressor stream");
+    }
+}
+
+ZSTDDecompressor::~ZSTDDecompressor() {
+    if (stream_ != nullptr) {
+        ZSTD_freeDStream(static_cast<ZSTD_DStream*>(stream_));
+        stream_ = nullptr;
+    }
+}
+
+void ZSTDDecompressor::reset() {
+    ZSTD_DCtx_reset(static_cast<ZSTD_DStream*>(stream_),
+                    ZSTD_reset_session_only);
+}
+
+DecompressionResult ZSTDDecompressor::decompress_partial(
+    BufferView in, MutableBufferView out) {
+    ZSTD_DStream* stream = static_cast<ZSTD_DStream*>(stream_);
+    ZSTD_outBuffer o_buf{};
+    o_buf.dst = out.data();
+    o_buf.pos = 0;
+    o_buf.size = out.size();
+
+    ZSTD_inBuffer i_buf{};
+    i_buf.src = in.data();
+    i_buf.pos = 0;
+    i_buf.size = in.size();
+
+    std::size_t ret = ZSTD_decompressStream(stream, &o_buf, &i_buf);
+
+    DecompressionResult r{};
+    r.decompressed = o_buf.pos;
+    r.input_consumed = i_buf.pos;
+
+    if (ZSTD_isError(ret)) {
+        reset();
+        r.status = CompressionStatus::NonFatalError;
+    } else if (ret == 0) {
+        r.status = CompressionStatus::InputBufferFinished;
+    } else if (out.size() == o_buf.pos) {
+        r.status = CompressionStatus::OutputBufferFull;
+    } else {
+        r.status = CompressionStatus::NeedsInput;
+    }
+
+    return r;
+}
+
+DecompressionResult ZSTDDecompressor::decompress_buffer(
+    BufferView in, MutableBufferView out) {
+    std::size_t total_input_consumed = 0;
+    std::size_t total_decompressed = 0;
+    DecompressionResult r{};
+    do {
+        r = decompress_partial(in, out);
+        in += r.input_consumed;
+        out += r.decompressed;
+        total_input_consumed += r.input_consumed;
+        total_decompressed += r.decompressed;
+    } while (r.status == CompressionStatus::NeedsInput && !in.empty() &&
+             (r.input_consumed != 0 || r.decompressed != 0));
+
+    return DecompressionResult{.decompressed = total_decompressed,
+                               .input_consumed = total_input_consumed,
+                               .status = r.status};
+}
+
+};  // namespace csics::io::decompression
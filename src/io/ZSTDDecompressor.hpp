@@ -0,0 +1,19 @@
+#pragma once
+#include <csics/io/decompression/Decompressor.hpp>
+
+namespace csics::io::decompression {
+
+class ZSTDDecompressor : public IDecompressor {
+   public:
+    explicit ZSTDDecompressor();
+    ~ZSTDDecompressor();
+    DecompressionResult decompress_partial(BufferView in,
+                                           MutableBufferView out) override;
+    DecompressionResult decompress_buffer(BufferView in,
+                                          MutableBufferView out) override;
+    void reset() override;
+
+   private:
+    void* stream_;
+};
+};  // namespace csics::io::decompression
@@ -0,0 +1,97 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include <csics/io/file/MappedFile.hpp>
+
+namespace csics::io::file {
+struct MappedFile::Internal {
+    void* data;
+    std::size_t size;
+    Internal() : data(nullptr), size(0) {}
+    ~Internal() { unmap(); }
+    void unmap() {
+        if (data != nullptr) {
+            ::munmap(data, size);
+        }
+        data = nullptr;
+        size = 0;
+    }
+};
+
+MappedFile::MappedFile() : internal_(new Internal()) {}
+
+MappedFile::~MappedFile() { delete internal_; }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : internal_(other.internal_) {
+    other.internal_ = nullptr;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        delete internal_;
+        internal_ = other.internal_;
+        other.internal_ = nullptr;
+    }
+    return *this;
+}
+
+FileStatus MappedFile::open(const std::string& path) {
+    if (internal_ == nullptr) {
+        internal_ = new Internal();
+    }
+    internal_->unmap();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT ? FileStatus::NotFound : FileStatus::Error;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return FileStatus::Error;
+    }
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (size == 0) {
+        // mmap refuses empty mappings; an empty file is an empty view
+        ::close(fd);
+        return FileStatus::Ok;
+    }
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return FileStatus::Error;
+    }
+    internal_->data = data;
+    internal_->size = size;
+    return FileStatus::Ok;
+}
+
+void MappedFile::close() {
+    if (internal_ != nullptr) {
+        internal_->unmap();
+    }
+}
+
+bool MappedFile::is_open() const noexcept {
+    return internal_ != nullptr && internal_->data != nullptr;
+}
+
+BufferView MappedFile::view() const noexcept {
+    if (internal_ == nullptr) {
+        return BufferView();
+    }
+    return BufferView(static_cast<const char*>(internal_->data),
+                      internal_->size);
+}
+
+void MappedFile::advise_sequential() const noexcept {
+    if (is_open()) {
+        ::madvise(internal_->data, internal_->size, MADV_SEQUENTIAL);
+    }
+}
+
+};  // namespace csics::io::file
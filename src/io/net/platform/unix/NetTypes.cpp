@@ -24,8 +24,8 @@ namespace csics::io::net {
             return std::nullopt;  // unsupported address family
         }
 
-        IPAddress ip(addr->sin_addr.s_addr);
-        uint16_t port = ne<uint16_t>(addr->sin_port).native();
+        IPAddress ip(ntohl(addr->sin_addr.s_addr));
+        uint16_t port = ntohs(addr->sin_port);
         return SockAddr(ip, port);
     }
 
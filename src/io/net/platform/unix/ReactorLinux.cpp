@@ -0,0 +1,660 @@
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <csics/io/net/Reactor.hpp>
+#include <csics/io/net/TCPEndpoint.hpp>
+#include <csics/io/net/UDPEndpoint.hpp>
+
+namespace csics::io::net {
+namespace {
+// user_data of operations whose completions carry no data
+constexpr std::uint64_t internal_op = std::uint64_t{1} << 63;
+// most entries a provided buffer ring takes; ids stay below no_buffer
+constexpr std::size_t max_buffers = 32768;
+constexpr std::size_t max_events = 64;
+
+int io_uring_setup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                   unsigned flags, void* arg, std::size_t arg_size) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit,
+                                      min_complete, flags, arg, arg_size));
+}
+
+int io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(
+        ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+unsigned load_acquire(const unsigned* p) {
+    return std::atomic_ref<const unsigned>(*p).load(std::memory_order_acquire);
+}
+
+void store_release(unsigned* p, unsigned v) {
+    std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release);
+}
+}  // namespace
+
+struct Reactor::Internal {
+    struct Endpoint {
+        int fd;
+        bool datagram;
+        bool active;
+        // nothing is receiving on it, and it has to be armed again once
+        // there are buffers: the multishot receive ended, or with epoll its
+        // fd was parked while the pool was empty
+        bool rearm;
+    };
+
+    ReactorConfig config;
+    ReactorBackend backend = ReactorBackend::Epoll;
+    Buffer<char> pool;
+    queue::SPSCMessageQueue<Completion> completions;
+    // buffer ids handed back by release, recycled on the reactor thread
+    queue::SPSCMessageQueue<std::uint16_t> returned;
+    std::vector<Endpoint> endpoints;
+    std::size_t dropped = 0;
+
+    // epoll
+    int epfd = -1;
+    std::vector<std::uint16_t> free_buffers;
+
+    // io_uring
+    int ring_fd = -1;
+    void* sq_ptr = MAP_FAILED;
+    std::size_t sq_size = 0;
+    void* cq_ptr = MAP_FAILED;
+    std::size_t cq_size = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqes_size = 0;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned sq_local_tail = 0;
+    unsigned to_submit = 0;
+    io_uring_buf_ring* buf_ring = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    std::size_t buf_ring_size = 0;
+    unsigned buf_tail = 0;
+    // buffers in the ring, so a receive that ran out is only resubmitted
+    // once there is somewhere to put data
+    std::size_t available = 0;
+    // shared by every multishot recvmsg; only the name and control lengths
+    // are read, and they are the same for all
+    struct msghdr udp_msg{};
+
+    explicit Internal(const ReactorConfig& c)
+        : config(c),
+          pool(c.buffer_count * c.buffer_size),
+          completions(c.completion_capacity),
+          returned(2 * c.buffer_count) {
+        udp_msg.msg_namelen = sizeof(sockaddr_in);
+        if (config.force_epoll || !setup_io_uring()) {
+            teardown_io_uring();
+            setup_epoll();
+        }
+    }
+
+    ~Internal() {
+        teardown_io_uring();
+        if (epfd != -1) {
+            ::close(epfd);
+        }
+    }
+
+    char* buffer(std::uint16_t id) {
+        return pool.data() + std::size_t{id} * config.buffer_size;
+    }
+
+    void setup_epoll() {
+        backend = ReactorBackend::Epoll;
+        epfd = ::epoll_create1(EPOLL_CLOEXEC);
+        free_buffers.reserve(config.buffer_count);
+        for (std::size_t i = config.buffer_count; i-- > 0;) {
+            free_buffers.push_back(static_cast<std::uint16_t>(i));
+        }
+    }
+
+    bool setup_io_uring() {
+        io_uring_params p{};
+        p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+        // multishot receives post one completion per datagram, so the
+        // completion ring is sized for a full buffer pool
+        p.cq_entries = static_cast<unsigned>(
+            std::max(config.buffer_count, 2 * config.ring_entries));
+        ring_fd = io_uring_setup(static_cast<unsigned>(config.ring_entries), &p);
+        if (ring_fd < 0 && errno == EINVAL) {
+            // kernels before 5.19 have no COOP_TASKRUN
+            p = {};
+            p.flags = IORING_SETUP_CQSIZE;
+            p.cq_entries = static_cast<unsigned>(
+                std::max(config.buffer_count, 2 * config.ring_entries));
+            ring_fd =
+                io_uring_setup(static_cast<unsigned>(config.ring_entries), &p);
+        }
+        if (ring_fd < 0 || !(p.features & IORING_FEAT_EXT_ARG)) {
+            return false;
+        }
+
+        sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+        sq_ptr = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) {
+            return false;
+        }
+        if (!single_mmap) {
+            cq_ptr = ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring_fd,
+                            IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) {
+                return false;
+            }
+        }
+        sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(
+            ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sq_ptr);
+        char* cq = static_cast<char*>(single_mmap ? sq_ptr : cq_ptr);
+        sq_head = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_entries = p.sq_entries;
+        sq_local_tail = *sq_tail;
+        cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+        buf_ring_size = config.buffer_count * sizeof(io_uring_buf);
+        buf_ring = static_cast<io_uring_buf_ring*>(
+            ::mmap(nullptr, buf_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (buf_ring == MAP_FAILED) {
+            return false;
+        }
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<std::uint64_t>(buf_ring);
+        reg.ring_entries = static_cast<std::uint32_t>(config.buffer_count);
+        reg.bgid = 0;
+        if (io_uring_register(ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            return false;
+        }
+        for (std::size_t i = 0; i < config.buffer_count; ++i) {
+            add_to_ring(static_cast<std::uint16_t>(i));
+        }
+        publish_ring();
+        backend = ReactorBackend::IoUring;
+        return true;
+    }
+
+    void teardown_io_uring() {
+        if (buf_ring != MAP_FAILED) {
+            ::munmap(buf_ring, buf_ring_size);
+            buf_ring = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+        }
+        if (sqes != MAP_FAILED) {
+            ::munmap(sqes, sqes_size);
+            sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        }
+        if (cq_ptr != MAP_FAILED) {
+            ::munmap(cq_ptr, cq_size);
+            cq_ptr = MAP_FAILED;
+        }
+        if (sq_ptr != MAP_FAILED) {
+            ::munmap(sq_ptr, sq_size);
+            sq_ptr = MAP_FAILED;
+        }
+        if (ring_fd != -1) {
+            ::close(ring_fd);
+            ring_fd = -1;
+        }
+        available = 0;
+    }
+
+    // The ring is an array of io_uring_buf whose first entry's resv field
+    // is the tail. Indexed by hand, as under C++ the header's flexible array
+    // member does not start at offset 0.
+    io_uring_buf* ring_bufs() {
+        return reinterpret_cast<io_uring_buf*>(buf_ring);
+    }
+
+    void add_to_ring(std::uint16_t id) {
+        io_uring_buf& b = ring_bufs()[buf_tail & (config.buffer_count - 1)];
+        b.addr = reinterpret_cast<std::uint64_t>(buffer(id));
+        b.len = static_cast<std::uint32_t>(config.buffer_size);
+        b.bid = id;
+        ++buf_tail;
+        ++available;
+    }
+
+    void publish_ring() {
+        std::atomic_ref<std::uint16_t>(ring_bufs()[0].resv)
+            .store(static_cast<std::uint16_t>(buf_tail),
+                   std::memory_order_release);
+    }
+
+    // Hands a buffer back to whichever backend is running.
+    void recycle(std::uint16_t id) {
+        if (backend == ReactorBackend::IoUring) {
+            add_to_ring(id);
+        } else {
+            free_buffers.push_back(id);
+        }
+    }
+
+    void recycle_returned() {
+        std::uint16_t id;
+        bool any = false;
+        while (returned.try_pop(id) == queue::SPSCError::None) {
+            recycle(id);
+            any = true;
+        }
+        if (!any) {
+            return;
+        }
+        if (backend == ReactorBackend::IoUring) {
+            publish_ring();
+        } else {
+            for (std::uint32_t id = 0; id < endpoints.size(); ++id) {
+                if (endpoints[id].active && endpoints[id].rearm) {
+                    watch(id, EPOLLIN);
+                }
+            }
+        }
+    }
+
+    // Queues a completion, giving its buffer straight back when the queue
+    // is full.
+    bool push(const Completion& c) {
+        if (completions.try_push(c) == queue::SPSCError::None) {
+            return true;
+        }
+        ++dropped;
+        if (c.buffer != Completion::no_buffer) {
+            recycle(c.buffer);
+        }
+        return false;
+    }
+
+    io_uring_sqe* next_sqe() {
+        if (sq_local_tail - load_acquire(sq_head) >= sq_entries) {
+            submit(0, 0, nullptr);
+        }
+        const unsigned index = sq_local_tail & sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array[index] = index;
+        ++sq_local_tail;
+        ++to_submit;
+        return sqe;
+    }
+
+    int submit(unsigned wait, unsigned flags, io_uring_getevents_arg* arg) {
+        store_release(sq_tail, sq_local_tail);
+        int ret = io_uring_enter(ring_fd, to_submit, wait, flags, arg,
+                                 arg != nullptr ? sizeof(*arg) : 0);
+        if (ret > 0) {
+            to_submit -= std::min(to_submit, static_cast<unsigned>(ret));
+        }
+        return ret;
+    }
+
+    void arm(std::uint32_t id) {
+        Endpoint& ep = endpoints[id];
+        io_uring_sqe* sqe = next_sqe();
+        sqe->fd = ep.fd;
+        sqe->user_data = id;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        if (ep.datagram) {
+            sqe->opcode = IORING_OP_RECVMSG;
+            sqe->addr = reinterpret_cast<std::uint64_t>(&udp_msg);
+            sqe->len = 1;
+        } else {
+            sqe->opcode = IORING_OP_RECV;
+        }
+        ep.rearm = false;
+    }
+
+    void cancel(std::uint32_t id) {
+        io_uring_sqe* sqe = next_sqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = id;
+        sqe->user_data = internal_op;
+    }
+
+    std::size_t run_io_uring(int timeout_ms) {
+        for (std::uint32_t id = 0; id < endpoints.size() && available > 0;
+             ++id) {
+            if (endpoints[id].active && endpoints[id].rearm) {
+                arm(id);
+            }
+        }
+
+        __kernel_timespec ts{};
+        io_uring_getevents_arg arg{};
+        arg.sigmask_sz = _NSIG / 8;
+        unsigned wait = 0;
+        if (timeout_ms != 0) {
+            wait = 1;
+            if (timeout_ms > 0) {
+                ts.tv_sec = timeout_ms / 1000;
+                ts.tv_nsec = (timeout_ms % 1000) * 1000000LL;
+                arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+            }
+        }
+        if (submit(wait, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg) <
+                0 &&
+            errno != ETIME && errno != EINTR && errno != EBUSY) {
+            return 0;
+        }
+
+        std::size_t queued = 0;
+        unsigned head = *cq_head;
+        const unsigned tail = load_acquire(cq_tail);
+        for (; head != tail; ++head) {
+            queued += complete(cqes[head & cq_mask]);
+        }
+        store_release(cq_head, head);
+        publish_ring();
+        return queued;
+    }
+
+    std::size_t complete(const io_uring_cqe& cqe) {
+        if (cqe.user_data & internal_op) {
+            return 0;
+        }
+        const auto id = static_cast<std::uint32_t>(cqe.user_data);
+        Endpoint& ep = endpoints[id];
+        const bool more = cqe.flags & IORING_CQE_F_MORE;
+        std::uint16_t bid = Completion::no_buffer;
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            bid = static_cast<std::uint16_t>(cqe.flags >>
+                                             IORING_CQE_BUFFER_SHIFT);
+            --available;
+        }
+
+        if (bid != Completion::no_buffer && (!ep.active || cqe.res < 0)) {
+            add_to_ring(bid);
+            bid = Completion::no_buffer;
+        }
+        if (!ep.active) {
+            return 0;
+        }
+
+        if (cqe.res < 0) {
+            if (cqe.res == -ENOBUFS) {
+                ep.rearm = !more;
+                return 0;
+            }
+            ep.active = false;
+            return push(Completion{id, NetStatus::Error, Completion::no_buffer,
+                                   0, 0, SockAddr()});
+        }
+        if (bid == Completion::no_buffer) {
+            // end of stream
+            ep.active = false;
+            return push(Completion{id, NetStatus::Disconnected,
+                                   Completion::no_buffer, 0, 0, SockAddr()});
+        }
+
+        Completion c{id, NetStatus::Success, bid, 0,
+                     static_cast<std::uint32_t>(cqe.res), SockAddr()};
+        if (ep.datagram) {
+            // recvmsg_out, then the reserved name and control space, then
+            // the payload
+            const char* b = buffer(bid);
+            io_uring_recvmsg_out out;
+            std::memcpy(&out, b, sizeof(out));
+            c.offset = static_cast<std::uint32_t>(
+                sizeof(out) + udp_msg.msg_namelen + udp_msg.msg_controllen);
+            c.size = std::min<std::uint32_t>(
+                out.payloadlen, static_cast<std::uint32_t>(cqe.res) - c.offset);
+            c.source = SockAddr::from_native(b + sizeof(out), out.namelen)
+                           .value_or(SockAddr());
+        }
+        ep.rearm = !more;
+        return push(c);
+    }
+
+    std::size_t run_epoll(int timeout_ms) {
+        epoll_event events[max_events];
+        const int n = ::epoll_wait(epfd, events, max_events, timeout_ms);
+        std::size_t queued = 0;
+        for (int i = 0; i < n; ++i) {
+            const auto id = static_cast<std::uint32_t>(events[i].data.u32);
+            if (!endpoints[id].active) {
+                continue;
+            }
+            queued += endpoints[id].datagram ? drain_datagrams(id)
+                                             : drain_stream(id);
+            // epoll is level triggered, so an fd left readable while every
+            // buffer is out would wake each wait at once; park it instead
+            // until recycle_returned hands buffers back
+            if (endpoints[id].active && free_buffers.empty()) {
+                watch(id, 0);
+            }
+        }
+        return queued;
+    }
+
+    // Sets the events epoll reports for an endpoint; none parks it.
+    void watch(std::uint32_t id, std::uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u32 = id;
+        ::epoll_ctl(epfd, EPOLL_CTL_MOD, endpoints[id].fd, &ev);
+        endpoints[id].rearm = events == 0;
+    }
+
+    std::size_t drain_datagrams(std::uint32_t id) {
+        constexpr std::size_t chunk = 64;
+        struct mmsghdr msgs[chunk];
+        struct iovec iovs[chunk];
+        struct sockaddr_in addrs[chunk];
+        std::uint16_t ids[chunk];
+        std::size_t queued = 0;
+        while (!free_buffers.empty()) {
+            const std::size_t n = std::min(chunk, free_buffers.size());
+            for (std::size_t i = 0; i < n; ++i) {
+                ids[i] = free_buffers.back();
+                free_buffers.pop_back();
+                iovs[i].iov_base = buffer(ids[i]);
+                iovs[i].iov_len = config.buffer_size;
+                msgs[i] = {};
+                msgs[i].msg_hdr.msg_name = &addrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            int received = ::recvmmsg(endpoints[id].fd, msgs,
+                                      static_cast<unsigned int>(n),
+                                      MSG_DONTWAIT, nullptr);
+            const std::size_t got =
+                received > 0 ? static_cast<std::size_t>(received) : 0;
+            for (std::size_t i = n; i-- > got;) {
+                free_buffers.push_back(ids[i]);
+            }
+            for (std::size_t i = 0; i < got; ++i) {
+                queued += push(Completion{
+                    id, NetStatus::Success, ids[i], 0, msgs[i].msg_len,
+                    SockAddr::from_native(&addrs[i], msgs[i].msg_hdr.msg_namelen)
+                        .value_or(SockAddr())});
+            }
+            if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                drop(id);
+                queued += push(Completion{id, NetStatus::Error,
+                                          Completion::no_buffer, 0, 0,
+                                          SockAddr()});
+            }
+            if (got < n) {
+                break;
+            }
+        }
+        return queued;
+    }
+
+    std::size_t drain_stream(std::uint32_t id) {
+        std::size_t queued = 0;
+        while (!free_buffers.empty()) {
+            const std::uint16_t bid = free_buffers.back();
+            ssize_t received = ::recv(endpoints[id].fd, buffer(bid),
+                                      config.buffer_size, MSG_DONTWAIT);
+            if (received > 0) {
+                free_buffers.pop_back();
+                queued += push(Completion{id, NetStatus::Success, bid, 0,
+                                          static_cast<std::uint32_t>(received),
+                                          SockAddr()});
+                continue;
+            }
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            drop(id);
+            queued += push(Completion{
+                id, received == 0 ? NetStatus::Disconnected : NetStatus::Error,
+                Completion::no_buffer, 0, 0, SockAddr()});
+            break;
+        }
+        return queued;
+    }
+
+    void drop(std::uint32_t id) {
+        endpoints[id].active = false;
+        ::epoll_ctl(epfd, EPOLL_CTL_DEL, endpoints[id].fd, nullptr);
+    }
+};
+
+Reactor::Reactor(ReactorConfig config) : internal_(nullptr) {
+    config.buffer_count =
+        std::bit_ceil(std::clamp<std::size_t>(config.buffer_count, 1, max_buffers));
+    config.completion_capacity =
+        std::bit_ceil(std::max<std::size_t>(config.completion_capacity, 2));
+    internal_ = new Internal(config);
+}
+
+Reactor::~Reactor() { delete internal_; }
+
+Reactor::Reactor(Reactor&& other) noexcept : internal_(other.internal_) {
+    other.internal_ = nullptr;
+}
+
+Reactor& Reactor::operator=(Reactor&& other) noexcept {
+    if (this != &other) {
+        delete internal_;
+        internal_ = other.internal_;
+        other.internal_ = nullptr;
+    }
+    return *this;
+}
+
+ReactorBackend Reactor::backend() const noexcept { return internal_->backend; }
+
+std::optional<std::uint32_t> Reactor::add(UDPEndpoint& endpoint) {
+    return add_(endpoint.native_handle(), true);
+}
+
+std::optional<std::uint32_t> Reactor::add(TCPEndpoint& endpoint) {
+    return add_(endpoint.native_handle(), false);
+}
+
+std::optional<std::uint32_t> Reactor::add_(int fd, bool datagram) {
+    if (internal_ == nullptr || fd == -1) {
+        return std::nullopt;
+    }
+    const auto id = static_cast<std::uint32_t>(internal_->endpoints.size());
+    if (internal_->backend == ReactorBackend::Epoll) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u32 = id;
+        if (::epoll_ctl(internal_->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            return std::nullopt;
+        }
+        internal_->endpoints.push_back({fd, datagram, true, false});
+    } else {
+        // armed on the next run_once, along with any other new endpoints
+        internal_->endpoints.push_back({fd, datagram, true, true});
+    }
+    return id;
+}
+
+NetStatus Reactor::remove(std::uint32_t endpoint) {
+    if (internal_ == nullptr || endpoint >= internal_->endpoints.size() ||
+        !internal_->endpoints[endpoint].active) {
+        return NetStatus::Error;
+    }
+    if (internal_->backend == ReactorBackend::Epoll) {
+        internal_->drop(endpoint);
+    } else {
+        internal_->endpoints[endpoint].active = false;
+        if (!internal_->endpoints[endpoint].rearm) {
+            internal_->cancel(endpoint);
+        }
+    }
+    return NetStatus::Success;
+}
+
+std::size_t Reactor::run_once(int timeout_ms) {
+    if (internal_ == nullptr) {
+        return 0;
+    }
+    internal_->recycle_returned();
+    return internal_->backend == ReactorBackend::IoUring
+               ? internal_->run_io_uring(timeout_ms)
+               : internal_->run_epoll(timeout_ms);
+}
+
+queue::SPSCMessageQueue<Completion>& Reactor::completions() noexcept {
+    return internal_->completions;
+}
+
+BufferView Reactor::data(const Completion& completion) const noexcept {
+    if (completion.buffer == Completion::no_buffer) {
+        return BufferView();
+    }
+    return BufferView(internal_->buffer(completion.buffer) + completion.offset,
+                      completion.size);
+}
+
+void Reactor::release(const Completion& completion) {
+    if (completion.buffer != Completion::no_buffer) {
+        std::ignore = internal_->returned.try_push(completion.buffer);
+    }
+}
+
+std::size_t Reactor::dropped() const noexcept { return internal_->dropped; }
+
+};  // namespace csics::io::net
@@ -1,6 +1,8 @@
+#include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <poll.h>
+#include <sys/uio.h>
 
 #include <csics/io/net/TCPEndpoint.hpp>
 
@@ -45,6 +47,27 @@ NetResult TCPEndpoint::send(BufferView data) {
                         static_cast<std::size_t>(bytesSent)};
 };
 
+NetResult TCPEndpoint::send_gather(std::span<const BufferView> chunks) {
+    if (internal_ == nullptr || internal_->sockfd == -1 ||
+        chunks.size() > max_gather_chunks) {
+        return NetResult{NetStatus::Error, 0};
+    }
+    struct iovec iovs[max_gather_chunks];
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        iovs[i].iov_base = const_cast<char*>(chunks[i].data());
+        iovs[i].iov_len = chunks[i].size();
+    }
+    struct msghdr msg{};
+    msg.msg_iov = iovs;
+    msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(chunks.size());
+    ssize_t bytesSent = ::sendmsg(internal_->sockfd, &msg, 0);
+    if (bytesSent < 0) {
+        return NetResult{NetStatus::Error, 0};
+    }
+    return NetResult{NetStatus::Success,
+                        static_cast<std::size_t>(bytesSent)};
+}
+
 NetStatus TCPEndpoint::connect_(SockAddr addr) {
     if (internal_ == nullptr) {
         return NetStatus::Error;
@@ -55,10 +78,14 @@ NetStatus TCPEndpoint::connect_(SockAddr addr) {
         return NetStatus::Error;
     }
 
+    struct sockaddr_in native_addr{};
+    std::size_t native_addr_size;
+    addr.to_native(&native_addr, native_addr_size);
+
     // Connect to the server
     int result = ::connect(internal_->sockfd,
-                           reinterpret_cast<const struct sockaddr*>(&addr),
-                           sizeof(addr));
+                           reinterpret_cast<const struct sockaddr*>(&native_addr),
+                           static_cast<socklen_t>(native_addr_size));
     if (result < 0) {
         close(internal_->sockfd);
         internal_->sockfd = -1;
@@ -83,6 +110,10 @@ NetResult TCPEndpoint::recv(BufferView buffer) {
                         static_cast<std::size_t>(bytesReceived)};
 }
 
+int TCPEndpoint::native_handle() const noexcept {
+    return internal_ == nullptr ? -1 : internal_->sockfd;
+}
+
 PollStatus TCPEndpoint::poll(int timeout_ms) {
 
     if (internal_ == nullptr || internal_->sockfd == -1) {
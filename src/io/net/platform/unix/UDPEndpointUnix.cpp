@@ -2,6 +2,11 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #include <poll.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 
 #include <csics/io/net/UDPEndpoint.hpp>
 
@@ -50,6 +55,142 @@ NetResult UDPEndpoint::send(BufferView data, const SockAddr& dest) {
     return NetResult{NetStatus::Success, static_cast<std::size_t>(bytesSent)};
 };
 
+NetResult UDPEndpoint::send_gather(std::span<const BufferView> chunks,
+                                   const SockAddr& dest) {
+    if (internal_ == nullptr || internal_->sockfd == -1 ||
+        chunks.size() > max_gather_chunks) {
+        return NetResult{NetStatus::Error, 0};
+    }
+    struct sockaddr_in dest_addr{};
+    std::size_t dest_addr_size;
+    dest.to_native(&dest_addr, dest_addr_size);
+
+    struct iovec iovs[max_gather_chunks];
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        iovs[i].iov_base = const_cast<char*>(chunks[i].data());
+        iovs[i].iov_len = chunks[i].size();
+    }
+    struct msghdr msg{};
+    msg.msg_name = &dest_addr;
+    msg.msg_namelen = static_cast<socklen_t>(dest_addr_size);
+    msg.msg_iov = iovs;
+    msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(chunks.size());
+    ssize_t bytesSent = ::sendmsg(internal_->sockfd, &msg, 0);
+    if (bytesSent < 0) {
+        return NetResult{NetStatus::Error, 0};
+    }
+    return NetResult{NetStatus::Success, static_cast<std::size_t>(bytesSent)};
+}
+
+namespace {
+// Sends datagrams[i] to dests[i], or every datagram to dests[0] when there
+// is only one destination.
+NetBatchResult send_datagrams(int sockfd, std::span<const BufferView> datagrams,
+                              std::span<const SockAddr> dests) {
+    NetBatchResult result{NetStatus::Success, 0, 0};
+    struct sockaddr_in dest_addr{};
+    std::size_t dest_addr_size = 0;
+    if (dests.size() == 1) {
+        dests[0].to_native(&dest_addr, dest_addr_size);
+    }
+#if defined(__linux__)
+    constexpr std::size_t chunk = 64;
+    struct mmsghdr msgs[chunk];
+    struct iovec iovs[chunk];
+    struct sockaddr_in addrs[chunk];
+    while (result.messages < datagrams.size()) {
+        const std::size_t n =
+            std::min(chunk, datagrams.size() - result.messages);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& d = datagrams[result.messages + i];
+            iovs[i].iov_base = const_cast<char*>(d.data());
+            iovs[i].iov_len = d.size();
+            msgs[i] = {};
+            if (dests.size() == 1) {
+                msgs[i].msg_hdr.msg_name = &dest_addr;
+            } else {
+                dests[result.messages + i].to_native(&addrs[i],
+                                                     dest_addr_size);
+                msgs[i].msg_hdr.msg_name = &addrs[i];
+            }
+            msgs[i].msg_hdr.msg_namelen = static_cast<socklen_t>(dest_addr_size);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int sent = ::sendmmsg(sockfd, msgs, static_cast<unsigned int>(n), 0);
+        if (sent < 0) {
+            result.status = NetStatus::Error;
+            return result;
+        }
+        for (int i = 0; i < sent; ++i) {
+            result.bytes_transferred += msgs[i].msg_len;
+        }
+        result.messages += static_cast<std::size_t>(sent);
+        if (static_cast<std::size_t>(sent) < n) {
+            result.status = NetStatus::Error;
+            return result;
+        }
+    }
+#else
+    for (std::size_t i = 0; i < datagrams.size(); ++i) {
+        if (dests.size() != 1) {
+            dests[i].to_native(&dest_addr, dest_addr_size);
+        }
+        const auto& d = datagrams[i];
+        ssize_t sent = ::sendto(
+            sockfd, d.data(), d.size(), 0,
+            reinterpret_cast<const struct sockaddr*>(&dest_addr),
+            dest_addr_size);
+        if (sent < 0) {
+            result.status = NetStatus::Error;
+            return result;
+        }
+        result.bytes_transferred += static_cast<std::size_t>(sent);
+        ++result.messages;
+    }
+#endif
+    return result;
+}
+
+bool would_block(int err) { return err == EAGAIN || err == EWOULDBLOCK; }
+
+#if defined(SO_TIMESTAMPNS)
+std::chrono::nanoseconds kernel_timestamp(const struct msghdr& msg) {
+    for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c != nullptr;
+         c = CMSG_NXTHDR(const_cast<struct msghdr*>(&msg), c)) {
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts;
+            std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            return std::chrono::seconds(ts.tv_sec) +
+                   std::chrono::nanoseconds(ts.tv_nsec);
+        }
+    }
+    return std::chrono::nanoseconds(0);
+}
+#endif
+}  // namespace
+
+NetBatchResult UDPEndpoint::send_batch(std::span<const BufferView> datagrams,
+                                       const SockAddr& dest) {
+    if (internal_ == nullptr || internal_->sockfd == -1) {
+        return NetBatchResult{NetStatus::Error, 0, 0};
+    }
+    return send_datagrams(internal_->sockfd, datagrams,
+                          std::span<const SockAddr>(&dest, 1));
+}
+
+NetBatchResult UDPEndpoint::send_batch(std::span<const BufferView> datagrams,
+                                       std::span<const SockAddr> dests) {
+    if (internal_ == nullptr || internal_->sockfd == -1 ||
+        datagrams.size() != dests.size()) {
+        return NetBatchResult{NetStatus::Error, 0, 0};
+    }
+    if (datagrams.empty()) {
+        return NetBatchResult{NetStatus::Success, 0, 0};
+    }
+    return send_datagrams(internal_->sockfd, datagrams, dests);
+}
+
 NetStatus UDPEndpoint::bind(const Port port) {
     if (internal_ == nullptr) {
         return NetStatus::Error;
@@ -124,6 +265,147 @@ NetResult UDPEndpoint::recv(MutableBufferView buffer, SockAddr& src) {
                         static_cast<std::size_t>(bytesReceived)};
 }
 
+NetBatchResult UDPEndpoint::recv_batch(std::span<MutableBufferView> buffers,
+                                       std::span<SockAddr> sources,
+                                       std::span<std::size_t> sizes,
+                                       RecvMode mode) {
+    return recv_batch(buffers, sources, sizes, {}, mode);
+}
+
+NetBatchResult UDPEndpoint::recv_batch(
+    std::span<MutableBufferView> buffers, std::span<SockAddr> sources,
+    std::span<std::size_t> sizes,
+    std::span<std::chrono::nanoseconds> timestamps, RecvMode mode) {
+    if (internal_ == nullptr || internal_->sockfd == -1 ||
+        sizes.size() < buffers.size() ||
+        (!sources.empty() && sources.size() < buffers.size()) ||
+        (!timestamps.empty() && timestamps.size() < buffers.size())) {
+        return NetBatchResult{NetStatus::Error, 0, 0};
+    }
+
+    NetBatchResult result{NetStatus::Success, 0, 0};
+    // flags for the first call; once something has arrived, later calls
+    // only take what is already queued unless every buffer must be filled
+    int flags = mode == RecvMode::NonBlocking ? MSG_DONTWAIT : 0;
+#if defined(__linux__)
+    if (mode == RecvMode::WaitForOne) {
+        flags = MSG_WAITFORONE;
+    }
+    constexpr std::size_t chunk = 64;
+    struct mmsghdr msgs[chunk];
+    struct iovec iovs[chunk];
+    struct sockaddr_in addrs[chunk];
+#if defined(SO_TIMESTAMPNS)
+    alignas(struct cmsghdr) char control[chunk][CMSG_SPACE(sizeof(timespec))];
+#endif
+    while (result.messages < buffers.size()) {
+        const std::size_t first = result.messages;
+        const std::size_t n = std::min(chunk, buffers.size() - first);
+        for (std::size_t i = 0; i < n; ++i) {
+            iovs[i].iov_base = buffers[first + i].data();
+            iovs[i].iov_len = buffers[first + i].size();
+            msgs[i] = {};
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            if (!sources.empty()) {
+                msgs[i].msg_hdr.msg_name = &addrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            }
+#if defined(SO_TIMESTAMPNS)
+            if (!timestamps.empty()) {
+                msgs[i].msg_hdr.msg_control = control[i];
+                msgs[i].msg_hdr.msg_controllen = sizeof(control[i]);
+            }
+#endif
+        }
+        int received = ::recvmmsg(internal_->sockfd, msgs,
+                                  static_cast<unsigned int>(n), flags, nullptr);
+        if (received < 0) {
+            if (would_block(errno)) {
+                break;
+            }
+            result.status = NetStatus::Error;
+            return result;
+        }
+        for (std::size_t i = 0; i < static_cast<std::size_t>(received); ++i) {
+            sizes[first + i] = msgs[i].msg_len;
+            result.bytes_transferred += msgs[i].msg_len;
+            if (!sources.empty()) {
+                sources[first + i] =
+                    SockAddr::from_native(&addrs[i], msgs[i].msg_hdr.msg_namelen)
+                        .value_or(SockAddr());
+            }
+            if (!timestamps.empty()) {
+#if defined(SO_TIMESTAMPNS)
+                timestamps[first + i] = kernel_timestamp(msgs[i].msg_hdr);
+#else
+                timestamps[first + i] = std::chrono::nanoseconds(0);
+#endif
+            }
+        }
+        result.messages += static_cast<std::size_t>(received);
+        if (static_cast<std::size_t>(received) < n) {
+            break;
+        }
+        if (mode != RecvMode::WaitForAll) {
+            flags = MSG_DONTWAIT;
+        }
+    }
+#else
+    for (; result.messages < buffers.size(); ++result.messages) {
+        const std::size_t i = result.messages;
+        struct sockaddr_in src_addr{};
+        socklen_t src_addr_len = sizeof(src_addr);
+        ssize_t received = ::recvfrom(
+            internal_->sockfd, buffers[i].data(), buffers[i].size(), flags,
+            reinterpret_cast<struct sockaddr*>(&src_addr), &src_addr_len);
+        if (received < 0) {
+            if (would_block(errno)) {
+                break;
+            }
+            result.status = NetStatus::Error;
+            return result;
+        }
+        sizes[i] = static_cast<std::size_t>(received);
+        result.bytes_transferred += static_cast<std::size_t>(received);
+        if (!sources.empty()) {
+            sources[i] = SockAddr::from_native(&src_addr, src_addr_len)
+                             .value_or(SockAddr());
+        }
+        if (!timestamps.empty()) {
+            timestamps[i] = std::chrono::nanoseconds(0);
+        }
+        if (mode != RecvMode::WaitForAll) {
+            flags = MSG_DONTWAIT;
+        }
+    }
+#endif
+    if (result.messages == 0 && !buffers.empty()) {
+        result.status = NetStatus::Empty;
+    }
+    return result;
+}
+
+NetStatus UDPEndpoint::enable_timestamps() {
+    if (internal_ == nullptr || internal_->sockfd == -1) {
+        return NetStatus::Error;
+    }
+#if defined(SO_TIMESTAMPNS)
+    int on = 1;
+    if (::setsockopt(internal_->sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &on,
+                     sizeof(on)) < 0) {
+        return NetStatus::Error;
+    }
+    return NetStatus::Success;
+#else
+    return NetStatus::Error;
+#endif
+}
+
+int UDPEndpoint::native_handle() const noexcept {
+    return internal_ == nullptr ? -1 : internal_->sockfd;
+}
+
 PollStatus UDPEndpoint::poll(int timeout_ms) {
 
     if (internal_ == nullptr || internal_->sockfd == -1) {
@@ -0,0 +1,333 @@
+#include <bit>
+#include <cmath>
+#include <csics/serialization/CBORDeserializer.hpp>
+#include <cstring>
+
+namespace csics::serialization {
+
+namespace {
+
+// Nesting beyond this is rejected rather than followed, so skipping a
+// hostile input cannot exhaust the stack.
+constexpr std::size_t max_depth = 256;
+
+std::uint64_t load_be(const char* p, std::size_t n) noexcept {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        v = v << 8 | static_cast<std::uint8_t>(p[i]);
+    }
+    return v;
+}
+
+double half_to_double(std::uint16_t half) noexcept {
+    const int exp = (half >> 10) & 0x1F;
+    const int mant = half & 0x3FF;
+    double v;
+    if (exp == 0) {
+        v = std::ldexp(mant, -24);
+    } else if (exp != 31) {
+        v = std::ldexp(mant + 1024, exp - 25);
+    } else {
+        v = mant == 0 ? INFINITY : NAN;
+    }
+    return half & 0x8000 ? -v : v;
+}
+
+}  // namespace
+
+expected<CBORDeserializer::Header, CBORDeserializer::error_type>
+CBORDeserializer::header(std::size_t& p) const {
+    if (p >= data_.size()) {
+        return empty();
+    }
+    const auto initial = static_cast<std::uint8_t>(data_.data()[p]);
+    Header h{static_cast<std::uint8_t>(initial >> 5),
+             static_cast<std::uint8_t>(initial & 0x1F), 0};
+    if (h.info < 24) {
+        h.arg = h.info;
+        ++p;
+        return h;
+    }
+    if (h.info == 31) {
+        ++p;
+        return h;
+    }
+    if (h.info > 27) {
+        return invalid(p);
+    }
+    const std::size_t n = std::size_t{1} << (h.info - 24);
+    if (n >= data_.size() - p) {
+        return empty();
+    }
+    h.arg = load_be(data_.data() + p + 1, n);
+    p += 1 + n;
+    return h;
+}
+
+expected<void, CBORDeserializer::error_type> CBORDeserializer::skip_item(
+    std::size_t& p, std::size_t depth) const {
+    if (depth > max_depth) {
+        return invalid(p);
+    }
+    const std::size_t at = p;
+    auto h = header(p);
+    if (!h) {
+        return error_type(h.error());
+    }
+    const bool open = h->info == 31;
+    switch (h->major) {
+        case cbor::unsigned_int:
+        case cbor::negative_int:
+            return open ? expected<void, error_type>(invalid(at))
+                        : expected<void, error_type>();
+        case cbor::bytes:
+        case cbor::text:
+            if (open) {
+                // definite-length chunks up to a break
+                while (!at_break(p)) {
+                    auto r = skip_item(p, depth + 1);
+                    if (!r) {
+                        return r;
+                    }
+                }
+                ++p;
+                return {};
+            }
+            if (h->arg > data_.size() - p) {
+                return empty();
+            }
+            p += h->arg;
+            return {};
+        case cbor::array:
+        case cbor::map: {
+            const std::uint64_t items =
+                h->major == cbor::map ? h->arg * 2 : h->arg;
+            for (std::uint64_t i = 0; open ? !at_break(p) : i < items; ++i) {
+                if (p >= data_.size()) {
+                    return empty();
+                }
+                auto r = skip_item(p, depth + 1);
+                if (!r) {
+                    return r;
+                }
+            }
+            p += open;
+            return {};
+        }
+        case 6:  // tag: the tagged item follows
+            return skip_item(p, depth + 1);
+        default:
+            // simple values and floats carry everything in the header
+            return open ? expected<void, error_type>(invalid(at))
+                        : expected<void, error_type>();
+    }
+}
+
+expected<void, CBORDeserializer::error_type> CBORDeserializer::skip() {
+    return skip_item(pos_, 0);
+}
+
+expected<std::size_t, CBORDeserializer::error_type>
+CBORDeserializer::read_container(std::uint8_t major) {
+    const std::size_t at = pos_;
+    auto h = header(pos_);
+    if (!h) {
+        return h.error();
+    }
+    if (h->major != major) {
+        pos_ = at;
+        return invalid(at);
+    }
+    if (h->info == 31) {
+        return indefinite;
+    }
+    // every element takes at least a byte
+    if (h->arg > data_.size() - pos_) {
+        return empty();
+    }
+    return static_cast<std::size_t>(h->arg);
+}
+
+expected<std::string_view, CBORDeserializer::error_type>
+CBORDeserializer::read_string(std::uint8_t major) {
+    const std::size_t at = pos_;
+    auto h = header(pos_);
+    if (!h) {
+        return h.error();
+    }
+    if (h->major != major || h->info == 31) {
+        pos_ = at;
+        return invalid(at);
+    }
+    if (h->arg > data_.size() - pos_) {
+        return empty();
+    }
+    const std::string_view s(data_.data() + pos_,
+                             static_cast<std::size_t>(h->arg));
+    pos_ += s.size();
+    return s;
+}
+
+expected<bool, CBORDeserializer::error_type> CBORDeserializer::read_bool() {
+    if (pos_ >= data_.size()) {
+        return empty();
+    }
+    const auto b = static_cast<std::uint8_t>(data_.data()[pos_]);
+    if (b != cbor::true_value && b != cbor::false_value) {
+        return invalid(pos_);
+    }
+    ++pos_;
+    return b == cbor::true_value;
+}
+
+expected<void, CBORDeserializer::error_type> CBORDeserializer::read_null() {
+    if (pos_ >= data_.size()) {
+        return empty();
+    }
+    if (static_cast<std::uint8_t>(data_.data()[pos_]) != cbor::null_value) {
+        return invalid(pos_);
+    }
+    ++pos_;
+    return {};
+}
+
+// Floats of any width; integers are accepted too, since a writer may
+// shorten a whole-valued double to one.
+expected<double, CBORDeserializer::error_type> CBORDeserializer::read_double() {
+    const std::size_t at = pos_;
+    auto h = header(pos_);
+    if (!h) {
+        return h.error();
+    }
+    switch (h->major) {
+        case cbor::unsigned_int:
+            if (h->info < 28) {
+                return static_cast<double>(h->arg);
+            }
+            break;
+        case cbor::negative_int:
+            if (h->info < 28) {
+                return -1.0 - static_cast<double>(h->arg);
+            }
+            break;
+        case cbor::simple:
+            if (h->info == 25) {
+                return half_to_double(static_cast<std::uint16_t>(h->arg));
+            }
+            if (h->info == 26) {
+                return static_cast<double>(std::bit_cast<float>(
+                    static_cast<std::uint32_t>(h->arg)));
+            }
+            if (h->info == 27) {
+                return std::bit_cast<double>(h->arg);
+            }
+            break;
+        default:
+            break;
+    }
+    pos_ = at;
+    return invalid(at);
+}
+
+expected<void, CBORDeserializer::error_type> CBORDeserializer::begin_obj() {
+    auto count = read_container(cbor::map);
+    if (!count) {
+        return error_type(count.error());
+    }
+    frames_.push_back(Frame{pos_, *count, 0});
+    return {};
+}
+
+expected<void, CBORDeserializer::error_type> CBORDeserializer::field(
+    std::string_view key) {
+    if (frames_.empty()) {
+        return invalid(pos_);
+    }
+    Frame& frame = frames_[frames_.size() - 1];
+
+    // Reads the key at p; true and p past the key if it is `key`.
+    auto matches = [&](std::size_t& p) -> expected<bool, error_type> {
+        std::size_t q = p;
+        auto h = header(q);
+        if (!h) {
+            return h.error();
+        }
+        if (h->major != cbor::text || h->info == 31 ||
+            h->arg > data_.size() - q) {
+            return invalid(p);
+        }
+        const std::string_view k(data_.data() + q,
+                                 static_cast<std::size_t>(h->arg));
+        p = q + k.size();
+        return k == key;
+    };
+
+    // Fields read in the order they were written are the next pair.
+    if (frame.count == indefinite ? !at_break(pos_)
+                                  : frame.index < frame.count) {
+        std::size_t p = pos_;
+        auto m = matches(p);
+        if (!m) {
+            return tag_field(error_type(m.error()), key.data());
+        }
+        if (*m) {
+            pos_ = p;
+            ++frame.index;
+            return {};
+        }
+    }
+
+    std::size_t p = frame.start;
+    for (std::size_t i = 0;
+         frame.count == indefinite ? !at_break(p) : i < frame.count; ++i) {
+        if (p >= data_.size()) {
+            return tag_field(error_type(DeserializationStatus::BufferEmpty,
+                                        data_.size()),
+                             key.data());
+        }
+        auto m = matches(p);
+        if (!m) {
+            return tag_field(error_type(m.error()), key.data());
+        }
+        if (*m) {
+            pos_ = p;
+            frame.index = i + 1;
+            return {};
+        }
+        if (auto r = skip_item(p, 0); !r) {
+            return tag_field(error_type(r.error()), key.data());
+        }
+    }
+    return tag_field(error_type(DeserializationStatus::InvalidData,
+                                frame.start),
+                     key.data());
+}
+
+expected<void, CBORDeserializer::error_type> CBORDeserializer::end_obj() {
+    if (frames_.empty()) {
+        return invalid(pos_);
+    }
+    const Frame frame = frames_.pop_back();
+    if (frame.count == indefinite) {
+        while (!at_break(pos_)) {
+            if (pos_ >= data_.size()) {
+                return empty();
+            }
+            if (auto r = skip_item(pos_, 0); !r) {
+                return r;
+            }
+        }
+        ++pos_;
+        return {};
+    }
+    for (std::size_t i = frame.index; i < frame.count; ++i) {
+        for (int item = 0; item < 2; ++item) {
+            if (auto r = skip_item(pos_, 0); !r) {
+                return r;
+            }
+        }
+    }
+    return {};
+}
+
+};  // namespace csics::serialization
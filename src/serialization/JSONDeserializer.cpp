@@ -0,0 +1,544 @@
+#include <bit>
+#include <limits>
+#include <csics/serialization/JSONDeserializer.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace csics::serialization {
+
+namespace {
+
+constexpr std::size_t block_size = 64;
+constexpr std::size_t npos = ~std::size_t{0};
+
+// 64 input bytes, compared against one character at a time. Each compare
+// gives a 64 bit mask with bit i set where byte i matches.
+struct Block {
+#if defined(__SSE2__)
+    explicit Block(const char* p) noexcept {
+        for (int i = 0; i < 4; ++i) {
+            v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p) + i);
+        }
+    }
+    std::uint64_t eq(char c) const noexcept {
+        const __m128i m = _mm_set1_epi8(c);
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(v[i], m))))
+                    << (16 * i);
+        }
+        return bits;
+    }
+
+   private:
+    __m128i v[4];
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    explicit Block(const char* p) noexcept {
+        for (int i = 0; i < 4; ++i) {
+            v[i] = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p) + 16 * i);
+        }
+    }
+    std::uint64_t eq(char c) const noexcept {
+        const uint8x16_t m = vdupq_n_u8(static_cast<std::uint8_t>(c));
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits |= static_cast<std::uint64_t>(movemask(vceqq_u8(v[i], m)))
+                    << (16 * i);
+        }
+        return bits;
+    }
+
+   private:
+    uint8x16_t v[4];
+    // one bit per 0x00/0xFF byte, by summing weighted lanes pairwise
+    static std::uint16_t movemask(uint8x16_t x) noexcept {
+        const uint8x16_t weights = {1, 2, 4, 8, 16, 32, 64, 128,
+                                    1, 2, 4, 8, 16, 32, 64, 128};
+        uint8x16_t m = vandq_u8(x, weights);
+        m = vpaddq_u8(m, m);
+        m = vpaddq_u8(m, m);
+        m = vpaddq_u8(m, m);
+        return vgetq_lane_u16(vreinterpretq_u16_u8(m), 0);
+    }
+#else
+    explicit Block(const char* p) noexcept { std::memcpy(v, p, block_size); }
+    std::uint64_t eq(char c) const noexcept {
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < block_size; ++i) {
+            bits |= std::uint64_t{v[i] == c} << i;
+        }
+        return bits;
+    }
+
+   private:
+    char v[block_size];
+#endif
+};
+
+// Characters preceded by an odd number of backslashes. `carry` is set when
+// the next block starts with an escaped character.
+std::uint64_t escaped_chars(std::uint64_t backslash,
+                            std::uint64_t& carry) noexcept {
+    constexpr std::uint64_t even_bits = 0x5555555555555555ull;
+    backslash &= ~carry;
+    const std::uint64_t follows_escape = backslash << 1 | carry;
+    const std::uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    std::uint64_t even_starts;
+    carry = __builtin_add_overflow(odd_starts, backslash, &even_starts);
+    return (even_bits ^ (even_starts << 1)) & follows_escape;
+}
+
+// Bit i set where an odd number of bits at or below i are set.
+std::uint64_t prefix_xor(std::uint64_t x) noexcept {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+bool is_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+int hex_digit(char c) noexcept {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Four hex digits at p, or -1.
+long hex4(const char* p) noexcept {
+    long v = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int d = hex_digit(p[i]);
+        if (d < 0) {
+            return -1;
+        }
+        v = v << 4 | d;
+    }
+    return v;
+}
+
+char* put_utf8(char* out, std::uint32_t cp) noexcept {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | cp >> 6);
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | cp >> 12);
+        *out++ = static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | cp >> 18);
+        *out++ = static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// Unescapes the contents of a JSON string into out, which must hold
+// raw.size() bytes. Returns the unescaped length, or npos if an escape is
+// invalid.
+std::size_t unescape(std::string_view raw, char* out) noexcept {
+    char* const start = out;
+    const char* p = raw.data();
+    const char* const end = p + raw.size();
+    while (p < end) {
+        const char* bs = static_cast<const char*>(
+            std::memchr(p, '\\', static_cast<std::size_t>(end - p)));
+        if (!bs) {
+            bs = end;
+        }
+        std::memcpy(out, p, static_cast<std::size_t>(bs - p));
+        out += bs - p;
+        p = bs;
+        if (p == end) {
+            break;
+        }
+        if (p + 1 == end) {
+            return npos;
+        }
+        switch (p[1]) {
+            case '"':
+            case '\\':
+            case '/':
+                *out++ = p[1];
+                break;
+            case 'b':
+                *out++ = '\b';
+                break;
+            case 'f':
+                *out++ = '\f';
+                break;
+            case 'n':
+                *out++ = '\n';
+                break;
+            case 'r':
+                *out++ = '\r';
+                break;
+            case 't':
+                *out++ = '\t';
+                break;
+            case 'u': {
+                const long hi = end - p >= 6 ? hex4(p + 2) : -1;
+                if (hi < 0) {
+                    return npos;
+                }
+                std::uint32_t cp = static_cast<std::uint32_t>(hi);
+                if (cp >= 0xD800 && cp < 0xDC00) {
+                    // a high surrogate must be followed by a low one
+                    const long lo = end - p >= 12 && p[6] == '\\' &&
+                                            p[7] == 'u'
+                                        ? hex4(p + 8)
+                                        : -1;
+                    if (lo < 0xDC00 || lo >= 0xE000) {
+                        return npos;
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) +
+                         (static_cast<std::uint32_t>(lo) - 0xDC00);
+                    p += 6;
+                } else if (cp >= 0xDC00 && cp < 0xE000) {
+                    return npos;
+                }
+                // never longer than the escape it replaces
+                out = put_utf8(out, cp);
+                p += 6;
+                continue;
+            }
+            default:
+                return npos;
+        }
+        p += 2;
+    }
+    return static_cast<std::size_t>(out - start);
+}
+
+}  // namespace
+
+JSONDeserializer::JSONDeserializer(BufferView json) : json_(json) {
+    build_index();
+}
+
+// Stage one: one pass over the input building the structural index, with
+// no branches on the input bytes except to pad the final block.
+void JSONDeserializer::build_index() {
+    const std::size_t n = json_.size();
+    // offsets are stored in 32 bits
+    if (n > std::numeric_limits<std::uint32_t>::max()) {
+        ok_ = false;
+        error_at_ = 0;
+        return;
+    }
+    index_ = Buffer<std::uint32_t>(n + 1);
+    std::uint32_t* out = index_.data();
+
+    std::uint64_t escape_carry = 0;
+    std::uint64_t in_string_carry = 0;  // all ones inside a string
+    std::uint64_t scalar_carry = 0;     // previous block ended in a scalar
+    char tail[block_size];
+
+    for (std::size_t base = 0; base < n; base += block_size) {
+        const char* p = json_.data() + base;
+        if (n - base < block_size) {
+            std::memset(tail, ' ', block_size);
+            std::memcpy(tail, p, n - base);
+            p = tail;
+        }
+        const Block block(p);
+
+        const std::uint64_t escaped =
+            escaped_chars(block.eq('\\'), escape_carry);
+        const std::uint64_t quote = block.eq('"') & ~escaped;
+        // set from each opening quote up to, not including, its close
+        const std::uint64_t in_string = prefix_xor(quote) ^ in_string_carry;
+        in_string_carry = static_cast<std::uint64_t>(
+            static_cast<std::int64_t>(in_string) >> 63);
+
+        const std::uint64_t op = block.eq('{') | block.eq('}') |
+                                 block.eq('[') | block.eq(']') |
+                                 block.eq(':') | block.eq(',');
+        const std::uint64_t space = block.eq(' ') | block.eq('\t') |
+                                    block.eq('\n') | block.eq('\r');
+        const std::uint64_t scalar = ~(op | space | quote | in_string);
+        const std::uint64_t scalar_start =
+            scalar & ~(scalar << 1 | scalar_carry);
+        scalar_carry = scalar >> 63;
+
+        std::uint64_t structural =
+            (op & ~in_string) | (quote & in_string) | scalar_start;
+        while (structural) {
+            *out++ = static_cast<std::uint32_t>(
+                base + static_cast<std::size_t>(std::countr_zero(structural)));
+            structural &= structural - 1;
+        }
+    }
+    count_ = static_cast<std::size_t>(out - index_.data());
+    if (in_string_carry) {
+        ok_ = false;
+        error_at_ = n;
+    }
+}
+
+std::string_view JSONDeserializer::token_text(std::size_t i) const noexcept {
+    if (i >= count_) {
+        return {};
+    }
+    const char* first = json_.data() + index_[i];
+    const char* last = json_.data() + position(i + 1);
+    while (last > first + 1 && is_space(last[-1])) {
+        --last;
+    }
+    return std::string_view(first, static_cast<std::size_t>(last - first));
+}
+
+std::size_t JSONDeserializer::skip_from(std::size_t i) const noexcept {
+    const char c = token(i);
+    if (c != '{' && c != '[') {
+        return i + 1;
+    }
+    std::size_t depth = 0;
+    do {
+        const char t = token(i);
+        if (t == '{' || t == '[') {
+            ++depth;
+        } else if (t == '}' || t == ']') {
+            --depth;
+        }
+        ++i;
+    } while (depth > 0 && i < count_);
+    return i;
+}
+
+expected<void, JSONDeserializer::error_type> JSONDeserializer::skip() {
+    if (!ok_) {
+        return error_type(DeserializationStatus::InvalidData, error_at_);
+    }
+    if (cur_ >= count_) {
+        return error_type(DeserializationStatus::BufferEmpty, offset());
+    }
+    cur_ = skip_from(cur_);
+    return {};
+}
+
+expected<void, JSONDeserializer::error_type> JSONDeserializer::begin_array() {
+    if (!ok_) {
+        return error_type(DeserializationStatus::InvalidData, error_at_);
+    }
+    if (!at('[')) {
+        return invalid();
+    }
+    ++cur_;
+    return {};
+}
+
+expected<bool, JSONDeserializer::error_type> JSONDeserializer::next_element(
+    char close) {
+    if (at(',')) {
+        ++cur_;
+        return true;
+    }
+    if (at(close)) {
+        ++cur_;
+        return false;
+    }
+    return invalid();
+}
+
+expected<void, JSONDeserializer::error_type> JSONDeserializer::begin_obj() {
+    if (!ok_) {
+        return error_type(DeserializationStatus::InvalidData, error_at_);
+    }
+    if (!at('{')) {
+        return invalid();
+    }
+    ++cur_;
+    objects_.push_back(static_cast<std::uint32_t>(cur_));
+    return {};
+}
+
+void JSONDeserializer::pop_object() noexcept {
+    if (!objects_.empty()) {
+        objects_.pop_back();
+    }
+}
+
+expected<std::string_view, JSONDeserializer::error_type>
+JSONDeserializer::read_key() {
+    auto key = read_string_view();
+    if (!key) {
+        return key.error();
+    }
+    if (!at(':')) {
+        return invalid();
+    }
+    ++cur_;
+    return key;
+}
+
+expected<void, JSONDeserializer::error_type> JSONDeserializer::field(
+    std::string_view key) {
+    if (objects_.empty()) {
+        return invalid();
+    }
+    const std::size_t first = objects_[objects_.size() - 1];
+    std::size_t from = cur_;
+    if (token(from) == ',') {
+        ++from;
+    }
+    if (token(from) == '}') {
+        from = first;
+    }
+
+    // Pairs are searched from the cursor on, then from the start of the
+    // object, so fields read in the order they were written are each
+    // found at the first key compared.
+    auto scan = [&](std::size_t i,
+                    std::size_t stop) -> expected<std::size_t, error_type> {
+        while (i != stop && token(i) != '}') {
+            if (token(i) != '"' || token(i + 1) != ':') {
+                return error_type(DeserializationStatus::InvalidData,
+                                  position(i));
+            }
+            const std::string_view text = token_text(i);
+            if (text.size() == key.size() + 2 &&
+                text.compare(1, key.size(), key) == 0) {
+                return i + 2;
+            }
+            i = skip_from(i + 2);
+            if (token(i) == ',') {
+                ++i;
+            } else if (token(i) != '}') {
+                return error_type(DeserializationStatus::InvalidData,
+                                  position(i));
+            }
+        }
+        return npos;
+    };
+
+    auto finish = [&](const expected<std::size_t, error_type>& found)
+        -> expected<void, error_type> {
+        if (!found) {
+            return tag_field(error_type(found.error()), key.data());
+        }
+        if (*found == npos) {
+            return tag_field(error_type(DeserializationStatus::InvalidData,
+                                        position(first - 1)),
+                             key.data());
+        }
+        cur_ = *found;
+        return {};
+    };
+
+    auto found = scan(from, npos);
+    if (found && *found == npos && from != first) {
+        return finish(scan(first, from));
+    }
+    return finish(found);
+}
+
+expected<void, JSONDeserializer::error_type> JSONDeserializer::end_obj() {
+    pop_object();
+    std::size_t i = cur_;
+    while (i < count_ && token(i) != '}') {
+        i = skip_from(i);
+    }
+    if (i >= count_) {
+        return error_type(DeserializationStatus::InvalidData, json_.size());
+    }
+    cur_ = i + 1;
+    return {};
+}
+
+expected<std::string_view, JSONDeserializer::error_type>
+JSONDeserializer::raw_string() {
+    if (!at('"')) {
+        return invalid();
+    }
+    const std::string_view text = token_text(cur_);
+    if (text.size() < 2 || text.back() != '"') {
+        return invalid();
+    }
+    return text.substr(1, text.size() - 2);
+}
+
+expected<std::string_view, JSONDeserializer::error_type>
+JSONDeserializer::read_string_view() {
+    auto raw = raw_string();
+    if (!raw) {
+        return raw.error();
+    }
+    if (raw->find('\\') == std::string_view::npos) {
+        ++cur_;
+        return raw;
+    }
+    // Unescaped strings never outgrow their input, so scratch space the
+    // size of the input is allocated once and earlier views stay valid.
+    if (scratch_.empty()) {
+        scratch_.resize(json_.size());
+    }
+    char* out = scratch_.data() + scratch_used_;
+    const std::size_t len = unescape(*raw, out);
+    if (len == npos) {
+        return invalid();
+    }
+    scratch_used_ += len;
+    ++cur_;
+    return std::string_view(out, len);
+}
+
+expected<std::string, JSONDeserializer::error_type>
+JSONDeserializer::read_string() {
+    auto raw = raw_string();
+    if (!raw) {
+        return raw.error();
+    }
+    std::string s(raw->size(), '\0');
+    const std::size_t len = unescape(*raw, s.data());
+    if (len == npos) {
+        return invalid();
+    }
+    s.resize(len);
+    ++cur_;
+    return s;
+}
+
+expected<bool, JSONDeserializer::error_type> JSONDeserializer::read_bool() {
+    const std::string_view text = token_text(cur_);
+    if (text == "true") {
+        ++cur_;
+        return true;
+    }
+    if (text == "false") {
+        ++cur_;
+        return false;
+    }
+    return invalid();
+}
+
+expected<void, JSONDeserializer::error_type> JSONDeserializer::read_literal(
+    std::string_view literal) {
+    if (token_text(cur_) != literal) {
+        return invalid();
+    }
+    ++cur_;
+    return {};
+}
+
+};  // namespace csics::serialization
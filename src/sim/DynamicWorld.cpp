@@ -0,0 +1,326 @@
+#include "csics/sim/ecs/DynamicWorld.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace csics::sim::ecs {
+
+namespace detail {
+std::uint32_t next_component_type_index() noexcept {
+    static std::atomic<std::uint32_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace detail
+
+namespace {
+constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+std::size_t align_up(std::size_t v, std::size_t align) {
+    return (v + align - 1) & ~(align - 1);
+}
+}  // namespace
+
+RawComponentPool::RawComponentPool(std::size_t size, std::size_t align)
+    : size_(size),
+      align_(align),
+      stride_(align_up(std::max<std::size_t>(size, 1), align)) {
+    CSICS_RUNTIME_ASSERT(align != 0 && (align & (align - 1)) == 0 &&
+                             align <= kMaxAlign,
+                         "Component alignment must be a power of two <= 64");
+}
+
+bool RawComponentPool::contains(const Entity& e) const noexcept {
+    return e.id < sparse_.size() && sparse_[e.id] != npos;
+}
+
+void* RawComponentPool::get(const Entity& e) noexcept {
+    if (!contains(e) || entities_[sparse_[e.id]].generation != e.generation) {
+        return nullptr;
+    }
+    return at_index(sparse_[e.id]);
+}
+
+const void* RawComponentPool::get(const Entity& e) const noexcept {
+    return const_cast<RawComponentPool*>(this)->get(e);
+}
+
+void RawComponentPool::insert_copy(const Entity& e, const void* src) {
+    if (e.id >= sparse_.size()) [[unlikely]] {
+        const std::size_t old_size = sparse_.size();
+        sparse_.resize(std::max<std::size_t>(e.id + 1, old_size * 2));
+        std::fill(sparse_.begin() + old_size, sparse_.end(), npos);
+    }
+    std::byte* dst;
+    if (sparse_[e.id] == npos) {
+        sparse_[e.id] = entities_.size();
+        entities_.push_back(e);
+        dst = dense_.append_uninitialized(stride_);
+    } else {
+        dst = at_index(sparse_[e.id]);
+    }
+    std::memcpy(dst, src, size_);
+}
+
+void RawComponentPool::remove(const Entity& e) {
+    if (!contains(e)) {
+        return;
+    }
+    const std::size_t index = sparse_[e.id];
+    const std::size_t last = entities_.size() - 1;
+    if (index != last) {
+        std::memcpy(at_index(index), at_index(last), stride_);
+        const Entity moved = entities_[last];
+        entities_[index] = moved;
+        sparse_[moved.id] = index;
+    }
+    sparse_[e.id] = npos;
+    entities_.pop_back();
+    dense_.resize(dense_.size() - stride_);
+}
+
+void* CommandBuffer::allocate(std::size_t size, std::size_t align) {
+    CSICS_RUNTIME_ASSERT(align <= kBlockAlign,
+                         "Component alignment exceeds command block alignment");
+    commands_.reserve(commands_.size() + 1);
+    if (size == 0) {
+        return nullptr;
+    }
+    while (true) {
+        if (current_ == blocks_.size()) {
+            Block block;
+            block.data.resize(std::max(kBlockSize, size));
+            blocks_.push_back(std::move(block));
+        }
+        Block& block = blocks_[current_];
+        const std::size_t offset = align_up(block.used, align);
+        if (offset + size <= block.data.size()) {
+            block.used = offset + size;
+            return block.data.data() + offset;
+        }
+        // oversized payloads get a block of their own
+        if (block.used == 0) {
+            block.data.resize(size);
+            continue;
+        }
+        ++current_;
+    }
+}
+
+void CommandBuffer::push(Op op, ComponentId component, const Entity& e,
+                         void* payload) {
+    commands_.push_back(Command{op, component, e, payload});
+}
+
+void CommandBuffer::clear() noexcept {
+    commands_.clear();
+    for (std::size_t i = 0; i <= current_ && i < blocks_.size(); ++i) {
+        blocks_[i].used = 0;
+    }
+    current_ = 0;
+}
+
+DynamicWorld::DynamicWorld() = default;
+DynamicWorld::~DynamicWorld() = default;
+DynamicWorld::DynamicWorld(DynamicWorld&&) noexcept = default;
+DynamicWorld& DynamicWorld::operator=(DynamicWorld&&) noexcept = default;
+
+ComponentId DynamicWorld::add_pool(std::string_view name,
+                                   std::unique_ptr<IComponentPool> pool) {
+    const auto id = static_cast<ComponentId>(pools_.size());
+    if (!name.empty()) {
+        const bool inserted =
+            ids_by_name_.emplace(std::string(name), id).second;
+        CSICS_RUNTIME_ASSERT(inserted, "Component name already registered");
+        (void)inserted;  // disable warning in release builds
+    }
+    pools_.push_back(std::move(pool));
+    names_.emplace_back(name);
+    return id;
+}
+
+ComponentId DynamicWorld::register_component(std::string_view name,
+                                             std::size_t size,
+                                             std::size_t align) {
+    CSICS_RUNTIME_ASSERT(!name.empty(),
+                         "Runtime components must have a name");
+    if (auto id = component_id(name); id != kInvalidComponent) {
+        CSICS_RUNTIME_ASSERT(pools_[id]->element_size() == size &&
+                                 pools_[id]->element_align() == align,
+                             "Component re-registered with a different layout");
+        return id;
+    }
+    return add_pool(name, std::make_unique<RawComponentPool>(size, align));
+}
+
+ComponentId DynamicWorld::component_id(std::string_view name) const {
+    auto it = ids_by_name_.find(std::string(name));
+    return it == ids_by_name_.end() ? kInvalidComponent : it->second;
+}
+
+IComponentPool& DynamicWorld::pool(ComponentId id) {
+    CSICS_RUNTIME_ASSERT(id < pools_.size(), "Unknown component id");
+    return *pools_[id];
+}
+
+const IComponentPool& DynamicWorld::pool(ComponentId id) const {
+    CSICS_RUNTIME_ASSERT(id < pools_.size(), "Unknown component id");
+    return *pools_[id];
+}
+
+Entity DynamicWorld::add_entity() {
+    Entity e;
+    if (!dead_entities_.empty()) {
+        e.id = dead_entities_.pop_back();
+        e.generation = ++generations_[e.id];
+    } else {
+        e.id = static_cast<std::uint32_t>(generations_.size());
+        e.generation = 0;
+        generations_.push_back(0);
+        slots_.push_back(kNoSlot);
+    }
+    slots_[e.id] = static_cast<std::uint32_t>(entities_.size());
+    entities_.push_back(e);
+    return e;
+}
+
+void DynamicWorld::remove_entity(const Entity& e) {
+    CSICS_RUNTIME_ASSERT(has_entity(e), "Entity not found in world entities.");
+    if (hierarchy_.contains(e)) {
+        hierarchy_.remove_subtree(
+            e, [&](const Entity& d) { remove_single_entity(d); });
+    } else {
+        remove_single_entity(e);
+    }
+}
+
+bool DynamicWorld::set_parent(const Entity& child, const Entity& parent) {
+    if (!Hierarchy::is_null(parent) && !hierarchy_.contains(parent)) {
+        hierarchy_.add(parent);
+    }
+    if (!hierarchy_.contains(child)) {
+        hierarchy_.add(child, parent);
+        return true;
+    }
+    return hierarchy_.reparent(child, parent);
+}
+
+void DynamicWorld::remove_single_entity(const Entity& e) {
+    const std::uint32_t slot = slots_[e.id];
+    const Entity last = entities_.back();
+    entities_[slot] = last;
+    slots_[last.id] = slot;
+    entities_.pop_back();
+    slots_[e.id] = kNoSlot;
+    dead_entities_.push_back(e.id);
+    for (auto& p : pools_) {
+        p->remove(e);
+    }
+}
+
+bool DynamicWorld::has_entity(const Entity& e) const noexcept {
+    return e.id < slots_.size() && slots_[e.id] != kNoSlot &&
+           generations_[e.id] == e.generation;
+}
+
+void DynamicWorld::add_component(const Entity& e, ComponentId id,
+                                 const void* data) {
+    pool(id).insert_copy(e, data);
+}
+
+void* DynamicWorld::get_component(const Entity& e, ComponentId id) {
+    return pool(id).get(e);
+}
+
+const void* DynamicWorld::get_component(const Entity& e,
+                                        ComponentId id) const {
+    return pool(id).get(e);
+}
+
+void DynamicWorld::remove_component(const Entity& e, ComponentId id) {
+    pool(id).remove(e);
+}
+
+std::size_t DynamicWorld::add_layer() {
+    layers_.emplace_back();
+    return layers_.size() - 1;
+}
+
+void DynamicWorld::add_erased_system(std::size_t layer, System system) {
+    CSICS_RUNTIME_ASSERT(layer < layers_.size(), "Layer does not exist");
+    layers_[layer].systems.push_back(std::move(system));
+    layers_[layer].contexts.push_back(Context(this));
+}
+
+void DynamicWorld::set_hook(std::size_t layer, Hook hook) {
+    CSICS_RUNTIME_ASSERT(layer < layers_.size(), "Layer does not exist");
+    layers_[layer].hook = std::move(hook);
+}
+
+void DynamicWorld::run(double dt) {
+    for (std::size_t l = 0; l < layers_.size(); ++l) {
+        auto& layer = layers_[l];
+        for (std::size_t i = 0; i < layer.systems.size(); ++i) {
+            layer.contexts[i].world_ = this;
+            layer.systems[i](*this, dt, layer.contexts[i]);
+        }
+        if (layer.hook) {
+            layer.hook(*this);
+        }
+        for (auto& ctx : layer.contexts) {
+            apply(ctx);
+        }
+    }
+}
+
+void DynamicWorld::apply(Context& ctx) {
+    for (const auto& cmd : ctx.commands_.commands()) {
+        switch (cmd.op) {
+            case CommandBuffer::Op::AddComponent: {
+                auto& p = *pools_[cmd.component];
+                if (has_entity(cmd.entity)) {
+                    p.insert_move(cmd.entity, cmd.payload);
+                }
+                p.destroy(cmd.payload);
+                break;
+            }
+            case CommandBuffer::Op::RemoveComponent:
+                pools_[cmd.component]->remove(cmd.entity);
+                break;
+            case CommandBuffer::Op::DestroyEntity:
+                // several systems may destroy the same entity in one layer
+                if (has_entity(cmd.entity)) {
+                    remove_entity(cmd.entity);
+                }
+                break;
+        }
+    }
+    ctx.commands_.clear();
+}
+
+void DynamicWorld::Context::add_component(const Entity& e, ComponentId id,
+                                          const void* data) {
+    auto& p = world_->pool(id);
+    CSICS_RUNTIME_ASSERT(world_->has_entity(e),
+                         "Entity not found in world entities.");
+    void* dst = commands_.allocate(p.element_size(), p.element_align());
+    p.copy_construct(dst, data);
+    commands_.push(CommandBuffer::Op::AddComponent, id, e, dst);
+}
+
+void DynamicWorld::Context::remove_component(const Entity& e,
+                                             ComponentId id) {
+    CSICS_RUNTIME_ASSERT(id < world_->component_count(),
+                         "Component not registered in the world");
+    CSICS_RUNTIME_ASSERT(world_->has_entity(e),
+                         "Entity not found in world entities.");
+    commands_.push(CommandBuffer::Op::RemoveComponent, id, e);
+}
+
+void DynamicWorld::Context::destroy_entity(const Entity& e) {
+    CSICS_RUNTIME_ASSERT(world_->has_entity(e),
+                         "Entity not found in world entities.");
+    commands_.push(CommandBuffer::Op::DestroyEntity, kInvalidComponent, e);
+}
+
+};  // namespace csics::sim::ecs
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+
+using namespace csics::em;
+using csics::geo::Geocentric;
+
+namespace {
+constexpr double kFrequency = 1.0e9;
+constexpr double kBandwidth = 1.0e6;
+
+IsometricTransmitter tx_at(double power, double x, double y, double z) {
+    return IsometricTransmitter(power, kFrequency, kBandwidth,
+                                Geocentric<double>(x, y, z));
+}
+
+IsometricReceiver rx_at(double x, double y, double z) {
+    return IsometricReceiver(
+        csics::geo::to_geodetic(Geocentric<double>(x, y, z)));
+}
+}  // namespace
+
+TEST(CSICSEMTests, CulledBudgetMatchesBruteForce) {
+    auto channel = StaticChannel(FreeSpaceEnvironmentalModel{},
+                                 AWGNoiseModel(-174.0));
+    csics::executor::SingleThreadedExecutor executor;
+
+    // receivers on the equator, in the middle of a 1 km cell along x
+    constexpr double cell = 1000.0;
+    constexpr double range = 2000.0;
+    constexpr double x0 = 6378500.0;
+    csics::Buffer<IsometricReceiver> rxs;
+    rxs.push_back(rx_at(x0, 0.0, 0.0));
+    rxs.push_back(rx_at(x0, 300.0, 0.0));
+
+    csics::Buffer<IsometricTransmitter> desired;
+    desired.push_back(tx_at(10.0, x0, 100.0, 0.0));
+
+    // interferers inside the range, one on the boundary between two cells
+    // and one inside the range but in a cell that does not hold either
+    // receiver, then two beyond the range
+    csics::Buffer<IsometricTransmitter> near;
+    near.push_back(tx_at(1.0, x0, -500.0, 0.0));
+    near.push_back(tx_at(2.0, x0 + 500.0, 0.0, 0.0));
+    near.push_back(tx_at(3.0, x0 + 1400.0, 0.0, 0.0));
+    csics::Buffer<IsometricTransmitter> all = near;
+    all.push_back(tx_at(500.0, x0, -5000.0, 0.0));
+    all.push_back(tx_at(500.0, x0 + 30000.0, 0.0, 0.0));
+
+    csics::geo::SpatialGrid index(cell);
+    Link::index_transmitters(all, index);
+    auto culled = Link::apply_and_budget(channel, desired, all, rxs, index,
+                                         range, executor);
+    auto brute = Link::apply_and_budget(channel, desired, near, rxs, executor);
+    auto unculled =
+        Link::apply_and_budget(channel, desired, all, rxs, executor);
+
+    ASSERT_EQ(culled.sinrs.size(), rxs.size());
+    for (std::size_t i = 0; i < rxs.size(); ++i) {
+        EXPECT_NEAR(culled.received_powers[i], brute.received_powers[i], 1e-9);
+        EXPECT_NEAR(culled.interference_powers[i],
+                    brute.interference_powers[i], 1e-9);
+        EXPECT_NEAR(culled.noise_floors[i], brute.noise_floors[i], 1e-9);
+        EXPECT_NEAR(culled.sinrs[i], brute.sinrs[i], 1e-9);
+        // the far interferers would have changed the answer
+        EXPECT_GT(unculled.interference_powers[i],
+                  culled.interference_powers[i] + 1.0);
+    }
+
+    // a range covering everything gives the brute force result over all
+    auto wide = Link::apply_and_budget(channel, desired, all, rxs, index,
+                                       1.0e6, executor);
+    for (std::size_t i = 0; i < rxs.size(); ++i) {
+        EXPECT_NEAR(wide.interference_powers[i],
+                    unculled.interference_powers[i], 1e-9);
+        EXPECT_NEAR(wide.sinrs[i], unculled.sinrs[i], 1e-9);
+    }
+}
@@ -21,3 +21,68 @@ TEST(CSICSGeoTests, GeocentricToGeodetic) {
 }
 
 
+
+TEST(CSICSGeoTests, SpatialGridQueries) {
+    using csics::geo::Geocentric;
+    csics::geo::SpatialGrid grid(1000.0);
+    // a line of points 500 m apart along x
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        grid.insert(i, Geocentric<double>(500.0 * i, 0.0, 0.0));
+    }
+    EXPECT_EQ(grid.size(), 100u);
+
+    csics::Buffer<std::uint32_t> hits;
+    grid.query_radius(Geocentric<double>(10000.0, 0.0, 0.0), 1200.0, hits);
+    std::sort(hits.begin(), hits.end());
+    ASSERT_EQ(hits.size(), 5u);
+    EXPECT_EQ(hits[0], 18u);
+    EXPECT_EQ(hits[4], 22u);
+
+    csics::Buffer<csics::geo::SpatialGrid::Neighbour> nearest;
+    grid.query_knn(Geocentric<double>(49600.0, 0.0, 0.0), 3, nearest);
+    ASSERT_EQ(nearest.size(), 3u);
+    EXPECT_EQ(nearest[0].id, 99u);
+    EXPECT_EQ(nearest[1].id, 98u);
+    EXPECT_EQ(nearest[2].id, 97u);
+
+    hits.clear();
+    grid.query_box(Geocentric<double>(-1.0, -1.0, -1.0),
+                   Geocentric<double>(1000.0, 1.0, 1.0), hits);
+    EXPECT_EQ(hits.size(), 3u);
+
+    // moving and removing keep the grid consistent
+    grid.insert(0, Geocentric<double>(10000.0, 0.0, 0.0));
+    grid.remove(20);
+    hits.clear();
+    grid.query_radius(Geocentric<double>(10000.0, 0.0, 0.0), 1.0, hits);
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], 0u);
+    EXPECT_FALSE(grid.contains(20));
+}
+
+TEST(CSICSGeoTests, SpatialGridSparseKnn) {
+    using csics::geo::Geocentric;
+    // a few items millions of cells apart; walking every shell out to the
+    // farthest one would probe ~1e19 cells
+    csics::geo::SpatialGrid grid(1.0);
+    const double points[][3] = {{0.0, 0.0, 0.0},
+                                {2.0e6, 0.0, 0.0},
+                                {0.0, -3.0e6, 1.0e5},
+                                {-1.0e6, 1.0e6, -1.0e6},
+                                {3.0, 4.0, 0.0}};
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        grid.insert(i, Geocentric<double>(points[i][0], points[i][1],
+                                          points[i][2]));
+    }
+
+    csics::Buffer<csics::geo::SpatialGrid::Neighbour> nearest;
+    grid.query_knn(Geocentric<double>(1.0e5, 0.0, 0.0), 4, nearest);
+    ASSERT_EQ(nearest.size(), 4u);
+    EXPECT_EQ(nearest[0].id, 4u);
+    EXPECT_EQ(nearest[1].id, 0u);
+    EXPECT_EQ(nearest[2].id, 3u);
+    EXPECT_EQ(nearest[3].id, 1u);
+    for (std::size_t i = 1; i < nearest.size(); ++i) {
+        EXPECT_LE(nearest[i - 1].distance_sq, nearest[i].distance_sq);
+    }
+}
@@ -0,0 +1,206 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <csics/csics.hpp>
+#include <string>
+#include <vector>
+
+using namespace csics::io::net;
+
+namespace {
+// Runs the reactor until `count` completions are queued or a second passes.
+std::vector<Completion> collect(Reactor& reactor, std::size_t count) {
+    std::vector<Completion> out;
+    for (int i = 0; i < 100 && out.size() < count; ++i) {
+        reactor.run_once(10);
+        Completion c;
+        while (reactor.completions().try_pop(c) ==
+               csics::queue::SPSCError::None) {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+std::string text(const Reactor& reactor, const Completion& c) {
+    auto bv = reactor.data(c);
+    return std::string(bv.data(), bv.size());
+}
+
+class ReactorTest : public ::testing::TestWithParam<bool> {
+   protected:
+    // Default is there to cover io_uring; where the kernel falls back to
+    // epoll it would only repeat the Epoll instance, so say so and skip.
+    void SetUp() override {
+        if (!GetParam() &&
+            Reactor(config()).backend() != ReactorBackend::IoUring) {
+            GTEST_SKIP() << "io_uring unavailable, Default would run on epoll";
+        }
+    }
+
+    ReactorConfig config() const {
+        ReactorConfig c;
+        c.buffer_count = 8;
+        c.buffer_size = 256;
+        c.force_epoll = GetParam();
+        return c;
+    }
+};
+}  // namespace
+
+TEST_P(ReactorTest, UDPDatagramsLandInPool) {
+    const Port a_port = GetParam() ? 47330 : 47335;
+    const Port b_port = a_port + 1;
+    const Port tx_port = a_port + 2;
+    Reactor reactor(config());
+    if (GetParam()) {
+        EXPECT_EQ(reactor.backend(), ReactorBackend::Epoll);
+    }
+    UDPEndpoint a;
+    ASSERT_EQ(a.bind(a_port), NetStatus::Success);
+    UDPEndpoint b;
+    ASSERT_EQ(b.bind(b_port), NetStatus::Success);
+    UDPEndpoint tx;
+    ASSERT_EQ(tx.bind(tx_port), NetStatus::Success);
+
+    auto a_id = reactor.add(a);
+    auto b_id = reactor.add(b);
+    ASSERT_TRUE(a_id.has_value());
+    ASSERT_TRUE(b_id.has_value());
+    EXPECT_NE(*a_id, *b_id);
+    reactor.run_once(0);
+
+    // more datagrams than buffers, released as they are consumed
+    std::size_t received = 0;
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            const std::string payload = "datagram " + std::to_string(i);
+            const csics::BufferView bv(payload.data(), payload.size());
+            ASSERT_EQ(tx.send(bv, SockAddr::localhost(a_port)).status,
+                      NetStatus::Success);
+            ASSERT_EQ(tx.send(bv, SockAddr::localhost(b_port)).status,
+                      NetStatus::Success);
+        }
+        auto got = collect(reactor, 8);
+        ASSERT_EQ(got.size(), 8u);
+        std::size_t on_a = 0;
+        for (const auto& c : got) {
+            EXPECT_EQ(c.status, NetStatus::Success);
+            EXPECT_EQ(text(reactor, c).substr(0, 9), "datagram ");
+            EXPECT_EQ(c.source.port(), tx_port);
+            on_a += c.endpoint == *a_id;
+            reactor.release(c);
+        }
+        EXPECT_EQ(on_a, 4u);
+        received += got.size();
+    }
+    EXPECT_EQ(received, 32u);
+    EXPECT_EQ(reactor.dropped(), 0u);
+
+    // removed endpoints stop reporting
+    ASSERT_EQ(reactor.remove(*a_id), NetStatus::Success);
+    reactor.run_once(0);
+    const std::string payload = "after remove";
+    const csics::BufferView bv(payload.data(), payload.size());
+    tx.send(bv, SockAddr::localhost(a_port));
+    tx.send(bv, SockAddr::localhost(b_port));
+    auto got = collect(reactor, 2);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].endpoint, *b_id);
+    EXPECT_EQ(text(reactor, got[0]), payload);
+}
+
+TEST_P(ReactorTest, WaitsWhileAllBuffersAreHeld) {
+    const Port port = GetParam() ? 47340 : 47342;
+    const Port tx_port = port + 1;
+    Reactor reactor(config());
+    UDPEndpoint rx;
+    ASSERT_EQ(rx.bind(port), NetStatus::Success);
+    UDPEndpoint tx;
+    ASSERT_EQ(tx.bind(tx_port), NetStatus::Success);
+    ASSERT_TRUE(reactor.add(rx).has_value());
+    reactor.run_once(0);
+
+    // fill every buffer and leave more waiting on the socket
+    const std::string payload = "held";
+    const csics::BufferView bv(payload.data(), payload.size());
+    for (int i = 0; i < 12; ++i) {
+        ASSERT_EQ(tx.send(bv, SockAddr::localhost(port)).status,
+                  NetStatus::Success);
+    }
+    auto held = collect(reactor, 8);
+    ASSERT_EQ(held.size(), 8u);
+
+    // with nowhere to put the rest, run_once sleeps out its timeout
+    // rather than returning at once on the readable socket. A signal may
+    // still cut a wait short, so count wakeups over a fixed window.
+    const auto stop =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    std::size_t queued = 0;
+    int wakeups = 0;
+    while (std::chrono::steady_clock::now() < stop) {
+        queued += reactor.run_once(20);
+        ++wakeups;
+    }
+    EXPECT_EQ(queued, 0u);
+    EXPECT_LE(wakeups, 10);
+
+    for (const auto& c : held) {
+        reactor.release(c);
+    }
+    auto rest = collect(reactor, 4);
+    ASSERT_EQ(rest.size(), 4u);
+    EXPECT_EQ(text(reactor, rest[0]), payload);
+}
+
+TEST_P(ReactorTest, TCPStreamAndDisconnect) {
+    const Port port = GetParam() ? 47333 : 47338;
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    int on = 1;
+    ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)),
+              0);
+    ASSERT_EQ(::listen(listener, 1), 0);
+
+    TCPEndpoint client;
+    ASSERT_EQ(client.connect(SockAddr::localhost(port)), NetStatus::Success);
+    int server = ::accept(listener, nullptr, nullptr);
+    ASSERT_GE(server, 0);
+
+    Reactor reactor(config());
+    auto id = reactor.add(client);
+    ASSERT_TRUE(id.has_value());
+    reactor.run_once(0);
+
+    const std::string payload = "stream bytes";
+    ASSERT_EQ(::send(server, payload.data(), payload.size(), 0),
+              static_cast<ssize_t>(payload.size()));
+    auto got = collect(reactor, 1);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].status, NetStatus::Success);
+    EXPECT_EQ(text(reactor, got[0]), payload);
+    reactor.release(got[0]);
+
+    ::close(server);
+    got = collect(reactor, 1);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].endpoint, *id);
+    EXPECT_EQ(got[0].status, NetStatus::Disconnected);
+    EXPECT_EQ(got[0].buffer, Completion::no_buffer);
+    ::close(listener);
+}
+
+INSTANTIATE_TEST_SUITE_P(CSICSNetTests, ReactorTest,
+                         ::testing::Values(false, true),
+                         [](const auto& info) {
+                             return info.param ? "Epoll" : "Default";
+                         });
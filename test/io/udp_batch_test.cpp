@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <csics/csics.hpp>
+#include <string>
+#include <vector>
+
+using namespace csics::io::net;
+
+namespace {
+// A datagram whose bytes identify it.
+std::string datagram(std::size_t i) {
+    return "datagram " + std::to_string(i) + std::string(i, 'x');
+}
+}  // namespace
+
+TEST(CSICSNetTests, UDPBatchRoundTrip) {
+    constexpr Port rx_port = 47320;
+    constexpr Port tx_port = 47321;
+    constexpr std::size_t count = 100;  // more than one recvmmsg chunk
+    UDPEndpoint rx;
+    ASSERT_EQ(rx.bind(rx_port), NetStatus::Success);
+    UDPEndpoint tx;
+    ASSERT_EQ(tx.bind(tx_port), NetStatus::Success);
+
+    std::vector<std::string> payloads;
+    std::vector<csics::BufferView> datagrams;
+    for (std::size_t i = 0; i < count; ++i) {
+        payloads.push_back(datagram(i));
+    }
+    for (const auto& p : payloads) {
+        datagrams.emplace_back(p.data(), p.size());
+    }
+    auto sent = tx.send_batch(datagrams, SockAddr::localhost(rx_port));
+    ASSERT_EQ(sent.status, NetStatus::Success);
+    ASSERT_EQ(sent.messages, count);
+
+    std::vector<std::array<char, 256>> storage(count + 10);
+    std::vector<csics::MutableBufferView> buffers;
+    for (auto& s : storage) {
+        buffers.emplace_back(s.data(), s.size());
+    }
+    std::vector<SockAddr> sources(buffers.size());
+    std::vector<std::size_t> sizes(buffers.size());
+
+    // blocks for the first datagram only, so asking for more than were sent
+    // returns what arrived
+    std::size_t received = 0;
+    while (received < count) {
+        ASSERT_EQ(rx.poll(1000), PollStatus::Ready);
+        auto got = rx.recv_batch(std::span(buffers).subspan(received),
+                                 std::span(sources).subspan(received),
+                                 std::span(sizes).subspan(received));
+        ASSERT_EQ(got.status, NetStatus::Success);
+        received += got.messages;
+    }
+    ASSERT_EQ(received, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(std::string(storage[i].data(), sizes[i]), payloads[i]);
+        EXPECT_EQ(sources[i].port(), tx_port);
+        EXPECT_EQ(sources[i].address().bytes()[0], 127);
+    }
+
+    // nothing left
+    auto empty = rx.recv_batch(buffers, {}, sizes, RecvMode::NonBlocking);
+    EXPECT_EQ(empty.status, NetStatus::Empty);
+    EXPECT_EQ(empty.messages, 0u);
+}
+
+TEST(CSICSNetTests, UDPBatchPerDestination) {
+    constexpr Port a_port = 47322;
+    constexpr Port b_port = 47323;
+    UDPEndpoint a;
+    ASSERT_EQ(a.bind(a_port), NetStatus::Success);
+    UDPEndpoint b;
+    ASSERT_EQ(b.bind(b_port), NetStatus::Success);
+    UDPEndpoint tx;
+    ASSERT_EQ(tx.bind(0), NetStatus::Success);
+
+    const std::string to_a = "to a";
+    const std::string to_b = "to b";
+    const std::array<csics::BufferView, 3> datagrams{
+        csics::BufferView(to_a.data(), to_a.size()),
+        csics::BufferView(to_b.data(), to_b.size()),
+        csics::BufferView(to_a.data(), to_a.size())};
+    const std::array<SockAddr, 3> dests{SockAddr::localhost(a_port),
+                                        SockAddr::localhost(b_port),
+                                        SockAddr::localhost(a_port)};
+    auto sent = tx.send_batch(datagrams, dests);
+    ASSERT_EQ(sent.status, NetStatus::Success);
+    EXPECT_EQ(sent.messages, 3u);
+    EXPECT_EQ(sent.bytes_transferred, 12u);
+
+    // mismatched spans are rejected
+    EXPECT_EQ(tx.send_batch(datagrams, std::span(dests).first(2)).status,
+              NetStatus::Error);
+
+    std::array<std::array<char, 16>, 2> storage{};
+    std::array<csics::MutableBufferView, 2> buffers{
+        csics::MutableBufferView(storage[0].data(), storage[0].size()),
+        csics::MutableBufferView(storage[1].data(), storage[1].size())};
+    std::array<std::size_t, 2> sizes{};
+
+    auto got = a.recv_batch(buffers, {}, sizes, RecvMode::WaitForAll);
+    ASSERT_EQ(got.status, NetStatus::Success);
+    ASSERT_EQ(got.messages, 2u);
+    EXPECT_EQ(std::string(storage[0].data(), sizes[0]), to_a);
+    EXPECT_EQ(std::string(storage[1].data(), sizes[1]), to_a);
+
+    got = b.recv_batch(std::span(buffers).first(1), {}, sizes);
+    ASSERT_EQ(got.status, NetStatus::Success);
+    ASSERT_EQ(got.messages, 1u);
+    EXPECT_EQ(std::string(storage[0].data(), sizes[0]), to_b);
+}
+
+TEST(CSICSNetTests, UDPBatchKernelTimestamps) {
+    constexpr Port port = 47324;
+    UDPEndpoint rx;
+    ASSERT_EQ(rx.bind(port), NetStatus::Success);
+    UDPEndpoint tx;
+    ASSERT_EQ(tx.bind(0), NetStatus::Success);
+#if defined(__linux__)
+    ASSERT_EQ(rx.enable_timestamps(), NetStatus::Success);
+#else
+    GTEST_SKIP() << "kernel receive timestamps need SO_TIMESTAMPNS";
+#endif
+
+    const std::string payload = "stamped";
+    const auto before = std::chrono::system_clock::now().time_since_epoch();
+    ASSERT_EQ(tx.send(csics::BufferView(payload.data(), payload.size()),
+                      SockAddr::localhost(port))
+                  .status,
+              NetStatus::Success);
+
+    std::array<char, 32> storage{};
+    std::array<csics::MutableBufferView, 1> buffers{
+        csics::MutableBufferView(storage.data(), storage.size())};
+    std::array<std::size_t, 1> sizes{};
+    std::array<std::chrono::nanoseconds, 1> timestamps{};
+    auto got = rx.recv_batch(buffers, {}, sizes, timestamps);
+    ASSERT_EQ(got.status, NetStatus::Success);
+    ASSERT_EQ(got.messages, 1u);
+    EXPECT_EQ(sizes[0], payload.size());
+
+    const auto after = std::chrono::system_clock::now().time_since_epoch();
+    EXPECT_GE(timestamps[0], before);
+    EXPECT_LE(timestamps[0], after);
+}
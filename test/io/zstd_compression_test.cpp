@@ -55,3 +55,43 @@ TEST(CSICSCompressionTests, ZSTDCompressorBasic) {
 
     std::filesystem::remove("temp_compressed.zst");
 }
+
+TEST(CSICSCompressionTests, ZSTDDecompressorRoundTrip) {
+    using namespace csics::io::compression;
+    using namespace csics::io::decompression;
+    using namespace csics;
+
+    auto compressor = ICompressor::create(CompressorType::ZSTD);
+    auto decompressor = IDecompressor::create(CompressorType::ZSTD);
+    constexpr std::size_t data_size = 256 * 1024;
+    auto input_data = generate_random_bytes(data_size);
+    std::vector<unsigned char> compressed_data(ZSTD_compressBound(data_size));
+
+    CompressionResult c = compressor->finish(BufferView(input_data),
+                                             MutableBufferView(compressed_data));
+    ASSERT_EQ(c.status, CompressionStatus::InputBufferFinished);
+    BufferView frame(compressed_data.data(), c.compressed);
+
+    std::vector<unsigned char> out(data_size);
+    DecompressionResult d =
+        decompressor->decompress_buffer(frame, MutableBufferView(out));
+    ASSERT_EQ(d.status, CompressionStatus::InputBufferFinished);
+    EXPECT_EQ(d.input_consumed, c.compressed);
+    ASSERT_EQ(d.decompressed, data_size);
+    EXPECT_EQ(out, input_data);
+
+    // a short output buffer is reported, and reset() starts over
+    std::vector<unsigned char> small(data_size / 2);
+    d = decompressor->decompress_buffer(frame, MutableBufferView(small));
+    EXPECT_EQ(d.status, CompressionStatus::OutputBufferFull);
+    decompressor->reset();
+    d = decompressor->decompress_buffer(frame, MutableBufferView(out));
+    EXPECT_EQ(d.status, CompressionStatus::InputBufferFinished);
+    EXPECT_EQ(out, input_data);
+
+    // a truncated frame asks for more input
+    decompressor->reset();
+    d = decompressor->decompress_buffer(frame(0, frame.size() / 2),
+                                        MutableBufferView(out));
+    EXPECT_EQ(d.status, CompressionStatus::NeedsInput);
+}
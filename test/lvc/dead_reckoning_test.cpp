@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <numbers>
+
+#include "csics/lvc/dis/DeadReckoning.hpp"
+
+namespace {
+using namespace csics::lvc;
+
+dis::DRState make_state(dis::DRAlgorithm algorithm) {
+    dis::DRState s;
+    s.location = dis::WorldCoordinates(1000.0, -2000.0, 3000.0);
+    s.orientation = dis::EulerAngles(0.3f, -0.2f, 0.1f);
+    s.linear_velocity = dis::Vector(10.0f, -5.0f, 2.0f);
+    s.linear_acceleration = dis::Vector(1.0f, 0.5f, -0.25f);
+    s.angular_velocity = dis::Vector(0.05f, -0.1f, 0.2f);
+    s.algorithm = algorithm;
+    return s;
+}
+}  // namespace
+
+TEST(DISDeadReckoningTest, WorldAxisAlgorithms) {
+    auto s = make_state(dis::DRAlgorithm::FPW);
+    auto [p, o] = dis::extrapolate(s, 2.0);
+    EXPECT_DOUBLE_EQ(p.x(), 1020.0);
+    EXPECT_DOUBLE_EQ(p.y(), -2010.0);
+    EXPECT_DOUBLE_EQ(p.z(), 3004.0);
+    EXPECT_EQ(o, s.orientation);
+
+    s.algorithm = dis::DRAlgorithm::FVW;
+    p = dis::extrapolate(s, 2.0).first;
+    EXPECT_DOUBLE_EQ(p.x(), 1022.0);
+    EXPECT_DOUBLE_EQ(p.y(), -2009.0);
+    EXPECT_DOUBLE_EQ(p.z(), 3003.5);
+
+    s.algorithm = dis::DRAlgorithm::Static;
+    EXPECT_EQ(dis::extrapolate(s, 2.0).first, s.location);
+
+    // pure yaw rate about the body z axis turns psi only
+    s = make_state(dis::DRAlgorithm::RPW);
+    s.orientation = dis::EulerAngles(0.5f, 0.0f, 0.0f);
+    s.angular_velocity = dis::Vector(0.0f, 0.0f, 0.1f);
+    o = dis::extrapolate(s, 3.0).second;
+    EXPECT_NEAR(o.psi(), 0.8f, 1e-5);
+    EXPECT_NEAR(o.theta(), 0.0f, 1e-5);
+    EXPECT_NEAR(o.phi(), 0.0f, 1e-5);
+}
+
+TEST(DISDeadReckoningTest, BodyAxisTurn) {
+    // 10 m/s north with a 0.1 rad/s yaw rate: a circle of radius 100 m,
+    // a quarter of the way round after pi / 0.2 seconds
+    dis::DRState s;
+    s.linear_velocity = dis::Vector(10.0f, 0.0f, 0.0f);
+    s.angular_velocity = dis::Vector(0.0f, 0.0f, 0.1f);
+    s.algorithm = dis::DRAlgorithm::RPB;
+    auto [p, o] = dis::extrapolate(s, std::numbers::pi / 0.2);
+    EXPECT_NEAR(p.x(), 100.0, 1e-3);
+    EXPECT_NEAR(p.y(), 100.0, 1e-3);
+    EXPECT_NEAR(p.z(), 0.0, 1e-3);
+    EXPECT_NEAR(o.psi(), std::numbers::pi_v<float> / 2, 1e-5);
+
+    // with no rotation the body-axis forms reduce to the world-axis ones
+    s = make_state(dis::DRAlgorithm::FVB);
+    s.orientation = dis::EulerAngles();
+    auto fvb = dis::extrapolate(s, 2.0).first;
+    s.algorithm = dis::DRAlgorithm::FVW;
+    auto fvw = dis::extrapolate(s, 2.0).first;
+    EXPECT_NEAR(fvb.x(), fvw.x(), 1e-9);
+    EXPECT_NEAR(fvb.y(), fvw.y(), 1e-9);
+    EXPECT_NEAR(fvb.z(), fvw.z(), 1e-9);
+}
+
+TEST(DISDeadReckoningTest, BatchMatchesScalar) {
+    // more slots than a vector width, with a tail, covering every algorithm
+    dis::DeadReckoningBatch batch;
+    csics::Buffer<dis::DRState> states;
+    for (std::uint8_t i = 0; i < 23; ++i) {
+        auto s = make_state(static_cast<dis::DRAlgorithm>(i % 10));
+        s.location = dis::WorldCoordinates(i * 100.0, 0.0, -i * 10.0);
+        states.push_back(s);
+        batch.add(s, 10.0 + i * 0.1);
+    }
+    EXPECT_EQ(batch.size(), 23u);
+
+    batch.extrapolate(15.0);
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        auto [p, o] = dis::extrapolate(states[i], 15.0 - batch.time(i));
+        auto bp = batch.location(i);
+        auto bo = batch.orientation(i);
+        EXPECT_NEAR(bp.x(), p.x(), 1e-3) << i;
+        EXPECT_NEAR(bp.y(), p.y(), 1e-3) << i;
+        EXPECT_NEAR(bp.z(), p.z(), 1e-3) << i;
+        EXPECT_NEAR(bo.psi(), o.psi(), 1e-5) << i;
+        EXPECT_NEAR(bo.theta(), o.theta(), 1e-5) << i;
+        EXPECT_NEAR(bo.phi(), o.phi(), 1e-5) << i;
+    }
+
+    batch.swap_and_pop(0);
+    EXPECT_EQ(batch.size(), 22u);
+    EXPECT_EQ(batch.time(0), 10.0 + 22 * 0.1);
+    EXPECT_EQ(batch.algorithm(0), dis::DRAlgorithm::FPW);
+}
+
+TEST(DISDeadReckoningTest, UpdateThresholds) {
+    dis::DeadReckoningBatch published;
+    for (int i = 0; i < 3; ++i) {
+        auto s = make_state(dis::DRAlgorithm::FPW);
+        s.orientation = dis::EulerAngles(3.1f, 0.0f, 0.0f);
+        published.add(s, 0.0);
+    }
+
+    // entity 0 is where remote sites expect it; 1 has drifted 2 m; 2 has
+    // turned across the +-pi wrap by less than the threshold
+    published.extrapolate(1.0);
+    dis::KinematicColumns truth = published.current();
+    truth.y[1] += 2.0;
+    truth.psi[2] = -3.14f;
+
+    dis::DRThresholds thresholds;
+    csics::Buffer<std::uint32_t> stale;
+    EXPECT_EQ(published.check(1.0, truth, thresholds, stale), 1u);
+    ASSERT_EQ(stale.size(), 1u);
+    EXPECT_EQ(stale[0], 1u);
+
+    truth.psi[2] = 2.9f;
+    stale.clear();
+    EXPECT_EQ(published.check(1.0, truth, thresholds, stale), 2u);
+    EXPECT_EQ(stale[1], 2u);
+
+    // past the heartbeat everything is due
+    stale.clear();
+    EXPECT_EQ(published.check(5.0, published.current(), thresholds, stale),
+              3u);
+}
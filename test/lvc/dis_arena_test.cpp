@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+
+#include <csics/Arena.hpp>
+#include <csics/csics.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "csics/lvc/dis/DISDispatch.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+
+namespace {
+using namespace csics::lvc;
+using csics::Arena;
+
+dis::ElectromagneticEmissionPDU emission() {
+    dis::ElectromagneticEmissionPDU pdu{};
+    pdu.emitter_id = dis::EntityID(1, 2, 3);
+    pdu.event_id = dis::EventID(1, 2, 6);
+    for (std::uint8_t s = 0; s < 3; ++s) {
+        dis::EmitterSystem system{};
+        system.emitter_name = 0x1234;
+        system.emitter_number = s;
+        for (std::uint8_t b = 0; b < 4; ++b) {
+            dis::Beam beam{};
+            beam.beam_number = b;
+            beam.fundamental_parameters.center_frequency = 1000.0f + b;
+            csics::Buffer<dis::TrackJam> jams;
+            for (std::uint16_t t = 0; t <= b; ++t) {
+                jams.push_back(dis::TrackJam{dis::EntityID(1, 2, t), s, b});
+            }
+            beam.number_of_targets = static_cast<std::uint8_t>(jams.size());
+            beam.track_jams = std::move(jams);
+            system.beams.push_back(std::move(beam));
+        }
+        pdu.emitter_systems.push_back(std::move(system));
+    }
+    return pdu;
+}
+
+std::vector<char> encode(const dis::ElectromagneticEmissionPDU& pdu) {
+    csics::serialization::DirectSerializer s;
+    std::vector<char> out(4096);
+    auto res = csics::serialization::serialize(
+        s, csics::MutableBufferView(out.data(), out.size()), pdu);
+    EXPECT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    out.resize(res.written_view.size());
+    return out;
+}
+
+// Checks every container in the PDU allocates from `resource`.
+void expect_resource(const dis::ElectromagneticEmissionPDU& pdu,
+                     std::pmr::memory_resource* resource) {
+    EXPECT_EQ(pdu.emitter_systems.resource(), resource);
+    for (const auto& system : pdu.emitter_systems) {
+        EXPECT_EQ(system.beams.resource(), resource);
+        for (const auto& beam : system.beams) {
+            ASSERT_TRUE(beam.track_jams.has_value());
+            EXPECT_EQ(beam.track_jams->resource(), resource);
+        }
+    }
+}
+}  // namespace
+
+TEST(ArenaTest, BumpAllocatesAndResets) {
+    Arena arena(1024);
+    void* first = arena.allocate(3, 1);
+    void* aligned = arena.allocate(64, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    EXPECT_GE(arena.used(), 67u);
+
+    // larger than a chunk
+    void* big = arena.allocate(10000, 8);
+    ASSERT_NE(big, nullptr);
+    const std::size_t capacity = arena.capacity();
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.allocate(3, 1), first);
+    std::ignore = arena.allocate(64, 64);
+    std::ignore = arena.allocate(10000, 8);
+    // the same workload again needs no new chunks
+    EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(ArenaTest, BufferUsesResource) {
+    Arena arena;
+    csics::Buffer<int> b(arena);
+    for (int i = 0; i < 1000; ++i) {
+        b.push_back(i);
+    }
+    EXPECT_EQ(b.resource(), &arena);
+    EXPECT_GE(arena.used(), 1000 * sizeof(int));
+    EXPECT_EQ(b[999], 999);
+
+    // moves take the storage and the resource along
+    const int* data = b.data();
+    csics::Buffer<int> moved(std::move(b));
+    EXPECT_EQ(moved.data(), data);
+    EXPECT_EQ(moved.resource(), &arena);
+    EXPECT_TRUE(b.empty());
+
+    // copies go to the heap
+    csics::Buffer<int> copy(moved);
+    EXPECT_EQ(copy.resource(), nullptr);
+    EXPECT_EQ(copy[999], 999);
+}
+
+TEST(ArenaTest, MoveStealsNonTrivialElements) {
+    csics::Buffer<std::string> b;
+    b.push_back(std::string(100, 'x'));
+    const std::string* data = b.data();
+    csics::Buffer<std::string> moved(std::move(b));
+    EXPECT_EQ(moved.data(), data);
+    EXPECT_EQ(moved[0], std::string(100, 'x'));
+    EXPECT_EQ(b.size(), 0u);
+
+    csics::Buffer<std::string> assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.data(), data);
+    EXPECT_EQ(moved.size(), 0u);
+}
+
+TEST(ArenaTest, MoveAcrossPoliciesOfTheSameKind) {
+    using Small = csics::Buffer<std::string, alignof(std::string),
+                                csics::CapacityPolicy::CacheAligned(4)>;
+    using Large = csics::Buffer<std::string, alignof(std::string),
+                                csics::CapacityPolicy::CacheAligned(16)>;
+    Arena arena;
+    Small b(arena);
+    for (int i = 0; i < 5; ++i) {
+        b.push_back(std::string(50, static_cast<char>('a' + i)));
+    }
+    const std::string* data = b.data();
+    const std::size_t capacity = b.capacity();
+
+    Large moved(std::move(b));
+    EXPECT_EQ(moved.data(), data);
+    EXPECT_EQ(moved.capacity(), capacity);
+    EXPECT_EQ(moved.resource(), &arena);
+    EXPECT_EQ(moved[4], std::string(50, 'e'));
+    EXPECT_EQ(b.data(), nullptr);
+    EXPECT_EQ(b.size(), 0u);
+    EXPECT_EQ(b.capacity(), 0u);
+
+    // the target's own heap storage is released and the arena's taken over
+    Small assigned;
+    assigned.push_back("heap");
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.data(), data);
+    EXPECT_EQ(assigned.capacity(), capacity);
+    EXPECT_EQ(assigned.resource(), &arena);
+    EXPECT_EQ(assigned.size(), 5u);
+    EXPECT_EQ(assigned[0], std::string(50, 'a'));
+    EXPECT_EQ(moved.data(), nullptr);
+    EXPECT_EQ(moved.size(), 0u);
+    EXPECT_EQ(moved.capacity(), 0u);
+
+    // a different kind of policy moves the elements into new storage
+    csics::Buffer<std::string, alignof(std::string),
+                  csics::CapacityPolicy::PowerOfTwo()>
+        pow2(std::move(assigned));
+    EXPECT_EQ(pow2.size(), 5u);
+    EXPECT_EQ(pow2.capacity(), 8u);
+    EXPECT_EQ(pow2[2], std::string(50, 'c'));
+}
+
+TEST(DISArenaTest, EmissionDecodesIntoArena) {
+    const auto pdu = emission();
+    const auto bytes = encode(pdu);
+    Arena arena;
+
+    std::size_t capacity = 0;
+    for (int batch = 0; batch < 3; ++batch) {
+        for (int i = 0; i < 50; ++i) {
+            csics::serialization::DirectDeserializer d(
+                csics::BufferView(bytes.data(), bytes.size()), &arena);
+            dis::ElectromagneticEmissionPDU out;
+            auto r = csics::serialization::deserialize(d, out);
+            ASSERT_TRUE(r.has_value());
+            expect_resource(*r, &arena);
+            ASSERT_EQ(r->emitter_systems.size(), 3u);
+            const auto& beam = r->emitter_systems[2].beams[3];
+            EXPECT_EQ(beam.fundamental_parameters.center_frequency, 1003.0f);
+            ASSERT_EQ(beam.track_jams->size(), 4u);
+            EXPECT_EQ((*beam.track_jams)[3].track_jam_target,
+                      dis::EntityID(1, 2, 3));
+        }
+        if (batch == 0) {
+            capacity = arena.capacity();
+        }
+        // later batches reuse the chunks of the first
+        EXPECT_EQ(arena.capacity(), capacity);
+        arena.reset();
+    }
+
+    // without an arena, containers use the heap as before
+    csics::serialization::DirectDeserializer d(
+        csics::BufferView(bytes.data(), bytes.size()));
+    dis::ElectromagneticEmissionPDU out;
+    auto r = csics::serialization::deserialize(d, out);
+    ASSERT_TRUE(r.has_value());
+    expect_resource(*r, nullptr);
+}
+
+TEST(DISArenaTest, TransmitterParametersDecodeIntoArena) {
+    dis::TransmitterPDU pdu{};
+    pdu.radio_reference_id = dis::ID(1, 2, 3);
+    for (std::uint8_t i = 0; i < 5; ++i) {
+        pdu.modulation_parameters.push_back(i);
+    }
+    dis::VariableTransmitterParameters params;
+    params.type = 7;
+    for (std::uint8_t i = 0; i < 10; ++i) {
+        params.data.push_back(i);
+    }
+    pdu.variable_parameters.push_back(std::move(params));
+
+    csics::serialization::DirectSerializer s;
+    char buffer[512];
+    auto res = csics::serialization::serialize(
+        s, csics::MutableBufferView(buffer, sizeof(buffer)), pdu);
+    ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+
+    Arena arena;
+    csics::serialization::DirectDeserializer d(res.written_view, &arena);
+    dis::TransmitterPDU out;
+    auto r = csics::serialization::deserialize(d, out);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->modulation_parameters.resource(), &arena);
+    EXPECT_EQ(r->variable_parameters.resource(), &arena);
+    ASSERT_EQ(r->variable_parameters.size(), 1u);
+    const auto& data = r->variable_parameters[0].data;
+    EXPECT_EQ(data.resource(), &arena);
+    // the data keeps the record padding
+    ASSERT_GE(data.size(), 10u);
+    for (std::uint8_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(data[i], i);
+    }
+}
+
+TEST(DISArenaTest, DispatchersDecodeIntoArena) {
+    const auto bytes = encode(emission());
+    const csics::BufferView bv(bytes.data(), bytes.size());
+    Arena arena;
+
+    std::size_t handled = 0;
+    dis::DISDispatcher dispatcher;
+    dispatcher.resource(&arena);
+    dispatcher.on<dis::ElectromagneticEmissionPDU>(
+        [&](const dis::ElectromagneticEmissionPDU& pdu) {
+            expect_resource(pdu, &arena);
+            ++handled;
+        });
+    EXPECT_EQ(dispatcher.dispatch(bv), dis::DispatchStatus::Handled);
+
+    auto static_dispatcher = dis::make_dis_dispatcher(
+        dis::on<dis::ElectromagneticEmissionPDU>(
+            [&](const dis::ElectromagneticEmissionPDU& pdu) {
+                expect_resource(pdu, &arena);
+                ++handled;
+            }));
+    static_dispatcher.resource(&arena);
+    EXPECT_EQ(static_dispatcher.dispatch(bv), dis::DispatchStatus::Handled);
+    EXPECT_EQ(handled, 2u);
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csics/csics.hpp>
+#include <vector>
+
+#include "csics/lvc/dis/Bundle.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+
+namespace {
+using namespace csics::lvc;
+
+// Collects every flushed datagram, accepting all of them.
+struct Sink {
+    std::vector<std::vector<char>> datagrams;
+    std::size_t calls = 0;
+
+    std::size_t operator()(std::span<const csics::BufferView> batch) {
+        ++calls;
+        for (auto d : batch) {
+            datagrams.emplace_back(d.begin(), d.end());
+        }
+        return batch.size();
+    }
+};
+
+struct ManualClock {
+    using duration = std::chrono::microseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+    static inline time_point current{};
+    static time_point now() noexcept { return current; }
+};
+
+dis::EntityStatePDU entity_state(std::uint16_t id) {
+    dis::EntityStatePDU pdu{};
+    pdu.entity_id = dis::EntityID(1, 1, id);
+    return pdu;
+}
+
+std::vector<std::uint16_t> entity_ids(const std::vector<char>& datagram) {
+    std::vector<std::uint16_t> ids;
+    dis::for_each_bundled_pdu(
+        csics::BufferView(datagram.data(), datagram.size()),
+        [&](csics::BufferView pdu) {
+            dis::EntityStatePDUView view(pdu);
+            ids.push_back(view.valid() ? view.entity_id().id() : 0xFFFF);
+        });
+    return ids;
+}
+}  // namespace
+
+TEST(DISBundleTest, PacksUpToDatagramSize) {
+    dis::PDUBundler<> bundler;
+    Sink sink;
+    // 144 byte entity states: ten to a 1472 byte datagram
+    for (std::uint16_t i = 0; i < 25; ++i) {
+        ASSERT_EQ(bundler.add(entity_state(i), sink),
+                  csics::serialization::SerializationStatus::Ok);
+    }
+    EXPECT_EQ(sink.calls, 0u);
+    EXPECT_EQ(bundler.pending_pdus(), 25u);
+    EXPECT_EQ(bundler.pending_datagrams(), 3u);
+
+    EXPECT_EQ(bundler.flush(sink), 3u);
+    EXPECT_EQ(sink.calls, 1u);
+    ASSERT_EQ(sink.datagrams.size(), 3u);
+    EXPECT_EQ(sink.datagrams[0].size(), 1440u);
+    EXPECT_EQ(sink.datagrams[2].size(), 720u);
+    auto ids = entity_ids(sink.datagrams[1]);
+    ASSERT_EQ(ids.size(), 10u);
+    EXPECT_EQ(ids.front(), 10u);
+    EXPECT_EQ(ids.back(), 19u);
+
+    EXPECT_EQ(bundler.pending_pdus(), 0u);
+    EXPECT_EQ(bundler.flush(sink), 0u);
+    EXPECT_EQ(sink.calls, 1u);
+    EXPECT_EQ(bundler.stats().pdus, 25u);
+    EXPECT_EQ(bundler.stats().datagrams, 3u);
+}
+
+TEST(DISBundleTest, AlignsBundledPDUs) {
+    dis::PDUBundler<> bundler;
+    Sink sink;
+    // a 28 byte emission PDU leaves 4 bytes of padding before the next
+    dis::ElectromagneticEmissionPDU ee{};
+    ee.emitter_id = dis::EntityID(1, 1, 99);
+    ASSERT_EQ(bundler.add(ee, sink),
+              csics::serialization::SerializationStatus::Ok);
+    ASSERT_EQ(bundler.add(entity_state(7), sink),
+              csics::serialization::SerializationStatus::Ok);
+    bundler.flush(sink);
+
+    ASSERT_EQ(sink.datagrams.size(), 1u);
+    const auto& d = sink.datagrams[0];
+    ASSERT_EQ(d.size(), 32u + 144u);
+    for (std::size_t i = 28; i < 32; ++i) {
+        EXPECT_EQ(d[i], 0);
+    }
+    std::vector<dis::PDUType> types;
+    dis::for_each_bundled_pdu(csics::BufferView(d.data(), d.size()),
+                              [&](csics::BufferView pdu) {
+                                  types.push_back(
+                                      dis::PDUHeaderView(pdu).pdu_type());
+                              });
+    EXPECT_EQ(types, (std::vector<dis::PDUType>{
+                         dis::PDUType::ElectromagneticEmission,
+                         dis::PDUType::EntityState}));
+
+    // a bundle cut short stops at the truncated PDU
+    EXPECT_EQ(dis::for_each_bundled_pdu(csics::BufferView(d.data(), 100),
+                                        [](csics::BufferView) {}),
+              1u);
+}
+
+TEST(DISBundleTest, UnbundledAndForcedFlush) {
+    dis::BundlerConfig config;
+    config.bundle = false;
+    config.max_datagrams = 4;
+    dis::PDUBundler<> bundler(config);
+    Sink sink;
+    for (std::uint16_t i = 0; i < 10; ++i) {
+        bundler.add(entity_state(i), sink);
+    }
+    // two full batches went out from add(), two datagrams still pending
+    EXPECT_EQ(sink.calls, 2u);
+    EXPECT_EQ(sink.datagrams.size(), 8u);
+    EXPECT_EQ(bundler.pending_datagrams(), 2u);
+    for (const auto& d : sink.datagrams) {
+        EXPECT_EQ(d.size(), 144u);
+    }
+    EXPECT_EQ(entity_ids(sink.datagrams[5]), std::vector<std::uint16_t>{5});
+
+    config.max_datagram = 100;
+    dis::PDUBundler<> small(config);
+    EXPECT_EQ(small.add(entity_state(0), sink),
+              csics::serialization::SerializationStatus::BufferFull);
+    EXPECT_EQ(small.pending_pdus(), 0u);
+}
+
+TEST(DISBundleTest, ZeroMaxDatagramsHoldsOne) {
+    dis::BundlerConfig config;
+    config.bundle = false;
+    config.max_datagrams = 0;
+    dis::PDUBundler<> bundler(config);
+    EXPECT_EQ(bundler.config().max_datagrams, 1u);
+    Sink sink;
+    for (std::uint16_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(bundler.add(entity_state(i), sink),
+                  csics::serialization::SerializationStatus::Ok);
+    }
+    // each add flushes the one before it
+    EXPECT_EQ(sink.datagrams.size(), 2u);
+    EXPECT_EQ(bundler.pending_datagrams(), 1u);
+}
+
+TEST(DISBundleTest, MaxLatency) {
+    dis::BundlerConfig config;
+    config.max_latency = std::chrono::microseconds(500);
+    dis::PDUBundler<dis::FixedLayoutSerializer, ManualClock> bundler(config);
+    Sink sink;
+
+    ManualClock::current = ManualClock::time_point(std::chrono::seconds(1));
+    bundler.add(entity_state(1), sink);
+    ManualClock::current += std::chrono::microseconds(400);
+    bundler.add(entity_state(2), sink);
+    EXPECT_EQ(bundler.poll(sink), 0u);
+
+    ManualClock::current += std::chrono::microseconds(100);
+    EXPECT_EQ(bundler.poll(sink), 1u);
+    ASSERT_EQ(sink.datagrams.size(), 1u);
+    EXPECT_EQ(entity_ids(sink.datagrams[0]),
+              (std::vector<std::uint16_t>{1, 2}));
+    EXPECT_EQ(bundler.poll(sink), 0u);
+
+    // a sink that drops everything is counted
+    bundler.add(entity_state(3), sink);
+    bundler.flush([](std::span<const csics::BufferView>) { return 0; });
+    EXPECT_EQ(bundler.stats().dropped, 1u);
+}
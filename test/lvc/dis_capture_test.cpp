@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csics/csics.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "csics/lvc/dis/Capture.hpp"
+#include "csics/lvc/dis/FixedLayout.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+
+namespace {
+using namespace csics::lvc;
+using namespace std::chrono_literals;
+
+constexpr std::size_t kPDUs = 1000;
+
+std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Entity states at 1 ms spacing, with an emission PDU every tenth.
+std::vector<std::vector<char>> make_traffic() {
+    std::vector<std::vector<char>> pdus;
+    csics::serialization::DirectSerializer s;
+    for (std::size_t i = 0; i < kPDUs; ++i) {
+        std::vector<char> out(256);
+        std::size_t size = 0;
+        if (i % 10 == 9) {
+            dis::ElectromagneticEmissionPDU ee{};
+            ee.header.timestamp = dis::DISTimestamp(std::uint32_t(i) << 1);
+            ee.emitter_id = dis::EntityID(1, 1, std::uint16_t(i));
+            size = csics::serialization::serialize(s, out, ee)
+                       .written_view.size();
+        } else {
+            dis::EntityStatePDU es{};
+            es.header.timestamp = dis::DISTimestamp(std::uint32_t(i) << 1);
+            es.entity_id = dis::EntityID(1, 1, std::uint16_t(i));
+            es.entity_location = dis::WorldCoordinates(double(i), 0.0, 0.0);
+            size = dis::encode_fixed(out, es).written_view.size();
+        }
+        out.resize(size);
+        pdus.push_back(std::move(out));
+    }
+    return pdus;
+}
+
+void record_traffic(dis::DISRecorder& recorder,
+                    const std::vector<std::vector<char>>& pdus) {
+    for (std::size_t i = 0; i < pdus.size(); ++i) {
+        ASSERT_EQ(recorder.record(csics::BufferView(pdus[i].data(),
+                                                    pdus[i].size()),
+                                  std::chrono::milliseconds(i)),
+                  dis::CaptureStatus::Ok);
+    }
+}
+
+void expect_round_trip(dis::DISLog& log,
+                       const std::vector<std::vector<char>>& pdus) {
+    std::size_t i = 0;
+    auto status = log.for_each([&](const dis::CaptureRecord& r) {
+        ASSERT_LT(i, pdus.size());
+        EXPECT_EQ(r.time, std::chrono::milliseconds(i));
+        EXPECT_EQ(r.timestamp, dis::DISTimestamp(std::uint32_t(i) << 1));
+        EXPECT_EQ(r.type, dis::PDUHeaderView(r.pdu).pdu_type());
+        ASSERT_EQ(r.pdu.size(), pdus[i].size());
+        EXPECT_TRUE(std::equal(r.pdu.begin(), r.pdu.end(), pdus[i].begin()));
+        ++i;
+    });
+    EXPECT_EQ(status, dis::CaptureStatus::Ok);
+    EXPECT_EQ(i, pdus.size());
+}
+}  // namespace
+
+TEST(DISCaptureTest, RecordAndRead) {
+    const auto path = temp_path("csics_capture_round_trip.dis");
+    const auto pdus = make_traffic();
+    dis::CaptureConfig config;
+    config.chunk_size = 4096;
+    {
+        dis::DISRecorder recorder(config);
+        ASSERT_EQ(recorder.open(path), dis::CaptureStatus::Ok);
+        record_traffic(recorder, pdus);
+        EXPECT_EQ(recorder.record(csics::BufferView("junk", 4), 0ms),
+                  dis::CaptureStatus::InvalidPDU);
+        ASSERT_EQ(recorder.close(), dis::CaptureStatus::Ok);
+        EXPECT_EQ(recorder.stats().records, kPDUs);
+    }
+
+    dis::DISLog log;
+    ASSERT_EQ(log.open(path), dis::CaptureStatus::Ok);
+    EXPECT_FALSE(log.recovered());
+    EXPECT_EQ(log.records(), kPDUs);
+    EXPECT_GT(log.chunks().size(), 10u);
+    EXPECT_EQ(log.duration(), std::chrono::milliseconds(kPDUs - 1));
+    expect_round_trip(log, pdus);
+
+    // seeking lands in the chunk holding the time, filtering by type
+    std::vector<std::chrono::nanoseconds> times;
+    log.for_each([&](const dis::CaptureRecord& r) { times.push_back(r.time); },
+                 500ms, 600ms,
+                 dis::PDUTypeSet{dis::PDUType::ElectromagneticEmission});
+    ASSERT_EQ(times.size(), 10u);
+    EXPECT_EQ(times.front(), 509ms);
+    EXPECT_EQ(times.back(), 599ms);
+    auto chunk = log.chunks()[log.seek(500ms)];
+    EXPECT_LE(chunk.first, 500ms);
+    EXPECT_GE(chunk.last, 500ms);
+
+    // and the callback can stop early
+    std::size_t seen = 0;
+    log.for_each([&](const dis::CaptureRecord&) { return ++seen < 5; });
+    EXPECT_EQ(seen, 5u);
+
+    std::filesystem::remove(path);
+}
+
+TEST(DISCaptureTest, RecoversUnclosedLog) {
+    const auto path = temp_path("csics_capture_unclosed.dis");
+    const auto pdus = make_traffic();
+    dis::CaptureConfig config;
+    config.chunk_size = 4096;
+    dis::DISRecorder recorder(config);
+    ASSERT_EQ(recorder.open(path), dis::CaptureStatus::Ok);
+    record_traffic(recorder, pdus);
+    ASSERT_EQ(recorder.flush(), dis::CaptureStatus::Ok);
+
+    // read while the recorder is still open: no index yet
+    dis::DISLog log;
+    ASSERT_EQ(log.open(path), dis::CaptureStatus::Ok);
+    EXPECT_TRUE(log.recovered());
+    EXPECT_EQ(log.records(), kPDUs);
+    expect_round_trip(log, pdus);
+    log.close();
+    recorder.close();
+
+    // a chunk cut short is dropped along with everything after it
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size / 2);
+    ASSERT_EQ(log.open(path), dis::CaptureStatus::Ok);
+    EXPECT_TRUE(log.recovered());
+    EXPECT_GT(log.records(), 0u);
+    EXPECT_LT(log.records(), kPDUs);
+    log.close();
+
+    {
+        std::ofstream bad(path, std::ios::binary | std::ios::trunc);
+        bad << "not a capture log at all";
+    }
+    EXPECT_EQ(log.open(path), dis::CaptureStatus::BadFile);
+    std::filesystem::remove(path);
+    EXPECT_EQ(log.open(path), dis::CaptureStatus::IOError);
+}
+
+#ifdef CSICS_USE_ZSTD
+TEST(DISCaptureTest, CompressedChunks) {
+    const auto path = temp_path("csics_capture_compressed.dis");
+    const auto pdus = make_traffic();
+    dis::CaptureConfig config;
+    config.chunk_size = 16384;
+    config.compress = true;
+    {
+        dis::DISRecorder recorder(config);
+        ASSERT_EQ(recorder.open(path), dis::CaptureStatus::Ok);
+        record_traffic(recorder, pdus);
+        ASSERT_EQ(recorder.close(), dis::CaptureStatus::Ok);
+        // mostly zero padded entity states compress well
+        EXPECT_LT(recorder.stats().written_bytes * 4,
+                  recorder.stats().raw_bytes);
+    }
+
+    dis::DISLog log;
+    ASSERT_EQ(log.open(path), dis::CaptureStatus::Ok);
+    EXPECT_TRUE(log.chunks()[0].compressed);
+    expect_round_trip(log, pdus);
+    std::filesystem::remove(path);
+}
+#endif
+
+TEST(DISCaptureTest, Replay) {
+    const auto path = temp_path("csics_capture_replay.dis");
+    const auto pdus = make_traffic();
+    {
+        dis::DISRecorder recorder;
+        ASSERT_EQ(recorder.open(path), dis::CaptureStatus::Ok);
+        record_traffic(recorder, pdus);
+    }
+    dis::DISLog log;
+    ASSERT_EQ(log.open(path), dis::CaptureStatus::Ok);
+
+    // as fast as possible, straight into a dispatcher
+    dis::DISDispatcher dispatcher;
+    std::size_t entity_states = 0;
+    dispatcher.on<dis::EntityStatePDU>(
+        [&](const dis::EntityStatePDUView&) { ++entity_states; });
+    dis::ReplayConfig config;
+    config.speed = 0;
+    dis::DISReplayer replayer(log, config);
+    auto status =
+        replayer.play([&](csics::BufferView pdu) { dispatcher.dispatch(pdu); });
+    ASSERT_EQ(status, dis::CaptureStatus::Ok);
+    EXPECT_EQ(entity_states, kPDUs - kPDUs / 10);
+    EXPECT_EQ(replayer.played(), kPDUs);
+
+    // paused and resumed without losing or repeating a PDU
+    std::vector<std::chrono::nanoseconds> times;
+    replayer.seek(100ms);
+    replayer.play(
+        [&](const dis::CaptureRecord& r) {
+            times.push_back(r.time);
+            return times.size() < 10;
+        },
+        200ms);
+    EXPECT_EQ(replayer.position(), 109ms);
+    replayer.play([&](const dis::CaptureRecord& r) { times.push_back(r.time); },
+                  200ms);
+    ASSERT_EQ(times.size(), 100u);
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        EXPECT_EQ(times[i], std::chrono::milliseconds(100 + i));
+    }
+
+    // paced: 200 ms of capture at 20x takes about 10 ms
+    replayer.speed(20);
+    replayer.seek(0ms);
+    const auto begin = std::chrono::steady_clock::now();
+    std::size_t sent = 0;
+    replayer.play([&](csics::BufferView) { ++sent; }, 200ms);
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    EXPECT_EQ(sent, 200u);
+    EXPECT_GE(elapsed, 9ms);
+    std::filesystem::remove(path);
+}
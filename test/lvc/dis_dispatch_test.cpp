@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <csics/csics.hpp>
+#include <vector>
+
+#include "csics/lvc/dis/DISDispatch.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/serde.hpp"
+#ifdef CSICS_BUILD_QUEUE
+#include "csics/lvc/dis/SignalQueue.hpp"
+#endif
+
+namespace {
+using namespace csics::lvc;
+
+csics::BufferView make_entity_state(csics::Buffer<char>& buffer,
+                                    std::uint8_t exercise,
+                                    const dis::EntityID& id) {
+    dis::EntityStatePDU pdu{};
+    pdu.header.exercise_id = exercise;
+    pdu.entity_id = id;
+    pdu.entity_appearance = 42;
+    csics::serialization::DirectSerializer s;
+    auto res = csics::serialization::serialize(s, buffer, pdu);
+    return csics::BufferView(buffer.data(), res.written_view.size());
+}
+
+csics::BufferView make_transmitter(csics::Buffer<char>& buffer) {
+    dis::TransmitterPDU pdu{};
+    pdu.radio_reference_id = dis::ID(1, 2, 3);
+    pdu.power = 10.0f;
+    csics::serialization::DirectSerializer s;
+    auto res = csics::serialization::serialize(s, buffer, pdu);
+    return csics::BufferView(buffer.data(), res.written_view.size());
+}
+}  // namespace
+
+TEST(DISDispatchTest, StaticDispatcher) {
+    csics::Buffer<char> es_buffer(512);
+    csics::Buffer<char> tx_buffer(512);
+    auto es = make_entity_state(es_buffer, 1, dis::EntityID(1, 2, 3));
+    auto tx = make_transmitter(tx_buffer);
+
+    int views = 0;
+    float power = 0;
+    auto dispatcher = dis::make_dis_dispatcher(
+        dis::on<dis::EntityStatePDU>([&](const dis::EntityStatePDUView& v) {
+            EXPECT_EQ(v.appearance(), 42u);
+            ++views;
+        }),
+        dis::on<dis::TransmitterPDU>(
+            [&](const dis::TransmitterPDU& pdu) { power = pdu.power; }));
+
+    EXPECT_EQ(dispatcher.dispatch(es), dis::DispatchStatus::Handled);
+    EXPECT_EQ(dispatcher.dispatch(tx), dis::DispatchStatus::Handled);
+    EXPECT_EQ(views, 1);
+    EXPECT_EQ(power, 10.0f);
+
+    // truncated: the view rejects it, the typed handler fails to decode
+    EXPECT_EQ(dispatcher.dispatch(es.head(100)),
+              dis::DispatchStatus::Malformed);
+    EXPECT_EQ(dispatcher.dispatch(tx.head(60)),
+              dis::DispatchStatus::Malformed);
+    EXPECT_EQ(dispatcher.dispatch(es.head(4)), dis::DispatchStatus::Malformed);
+    EXPECT_EQ(views, 1);
+
+    auto only_es = dis::make_dis_dispatcher(
+        dis::on<dis::EntityStatePDU>([](csics::BufferView) {}));
+    EXPECT_EQ(only_es.dispatch(tx), dis::DispatchStatus::Unhandled);
+}
+
+TEST(DISDispatchTest, Filters) {
+    csics::Buffer<char> a_buffer(512);
+    csics::Buffer<char> b_buffer(512);
+    auto a = make_entity_state(a_buffer, 1, dis::EntityID(1, 2, 3));
+    auto b = make_entity_state(b_buffer, 2, dis::EntityID(1, 5, 3));
+
+    int calls = 0;
+    auto dispatcher = dis::make_dis_dispatcher(dis::on<dis::EntityStatePDU>(
+        [&](const dis::EntityStatePDUView&) { ++calls; }));
+
+    dispatcher.filter().exercise(1);
+    EXPECT_EQ(dispatcher.dispatch(a), dis::DispatchStatus::Handled);
+    EXPECT_EQ(dispatcher.dispatch(b), dis::DispatchStatus::Filtered);
+
+    dispatcher.filter().any_exercise();
+    dispatcher.filter().entity(dis::EntityID(1, dis::ALL_APPLIC, 3));
+    EXPECT_EQ(dispatcher.dispatch(a), dis::DispatchStatus::Handled);
+    EXPECT_EQ(dispatcher.dispatch(b), dis::DispatchStatus::Handled);
+
+    dispatcher.filter().entity(dis::EntityID(1, 5, dis::ALL_ENTITIES));
+    EXPECT_EQ(dispatcher.dispatch(a), dis::DispatchStatus::Filtered);
+    EXPECT_EQ(dispatcher.dispatch(b), dis::DispatchStatus::Handled);
+    EXPECT_EQ(calls, 4);
+}
+
+TEST(DISDispatchTest, RuntimeDispatcher) {
+    csics::Buffer<char> es_buffer(512);
+    csics::Buffer<char> tx_buffer(512);
+    auto es = make_entity_state(es_buffer, 1, dis::EntityID(1, 2, 3));
+    auto tx = make_transmitter(tx_buffer);
+
+    dis::DISDispatcher dispatcher;
+    int raw = 0;
+    dis::EntityID id;
+    int errors = 0;
+    dispatcher.on<dis::EntityStatePDU>(
+        [&](const dis::EntityStatePDU& pdu) { id = pdu.entity_id; });
+    dispatcher.on<dis::TransmitterPDU>([&](csics::BufferView) { ++raw; });
+    dispatcher.on_error(
+        [&](dis::DispatchStatus, csics::BufferView) { ++errors; });
+
+    EXPECT_EQ(dispatcher.dispatch(es), dis::DispatchStatus::Handled);
+    EXPECT_EQ(dispatcher.dispatch(tx), dis::DispatchStatus::Handled);
+    EXPECT_EQ(id, dis::EntityID(1, 2, 3));
+    EXPECT_EQ(raw, 1);
+
+    EXPECT_EQ(dispatcher.dispatch(es.head(50)),
+              dis::DispatchStatus::Malformed);
+    EXPECT_EQ(errors, 1);
+
+    dispatcher.filter().exercise(9);
+    EXPECT_EQ(dispatcher.dispatch(es), dis::DispatchStatus::Filtered);
+    EXPECT_EQ(errors, 1);
+}
+
+#ifdef CSICS_BUILD_QUEUE
+TEST(DISDispatchTest, SignalToQueue) {
+    std::vector<char> audio(320, 0x55);
+    dis::SignalPDU pdu{};
+    pdu.radio_reference_id = dis::ID(1, 2, 3);
+    pdu.radio_number = 1;
+    pdu.sample_rate = 8000;
+    pdu.samples = 160;
+    pdu.data = csics::BufferView(audio.data(), audio.size());
+    csics::Buffer<char> buffer(512);
+    csics::serialization::DirectSerializer s;
+    auto res = csics::serialization::serialize(s, buffer, pdu);
+    csics::BufferView datagram(buffer.data(), res.written_view.size());
+
+    csics::queue::SPSCQueue queue(4096);
+    auto writer = queue.get_write_handle();
+    auto reader = queue.get_read_handle();
+    int dropped = 0;
+    auto dispatcher = dis::make_dis_dispatcher(
+        dis::on<dis::SignalPDU>([&](const dis::SignalPDUView& v) {
+            if (dis::enqueue_signal(writer, v) !=
+                csics::queue::SPSCError::None) {
+                ++dropped;
+            }
+        }));
+
+    // more than the queue holds: the overflow is dropped, not blocked on
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(dispatcher.dispatch(datagram), dis::DispatchStatus::Handled);
+    }
+    EXPECT_GT(dropped, 0);
+
+    int frames = 0;
+    csics::queue::SPSCQueue::ReadSlot slot;
+    while (reader.acquire(slot) == csics::queue::SPSCError::None) {
+        auto signal = dis::read_signal(slot);
+        EXPECT_EQ(signal.frame.radio, dis::ID(1, 2, 3).packed());
+        EXPECT_EQ(signal.frame.sample_rate, 8000u);
+        EXPECT_EQ(signal.frame.samples, 160);
+        EXPECT_EQ(signal.frame.data_length, 320 * 8);
+        ASSERT_EQ(signal.data.size(), audio.size());
+        EXPECT_TRUE(std::equal(audio.begin(), audio.end(), signal.data.data()));
+        reader.commit(std::move(slot));
+        ++frames;
+    }
+    EXPECT_EQ(frames + dropped, 16);
+}
+#endif
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csics/csics.hpp>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "csics/lvc/dis/EntityIDMap.hpp"
+#include "csics/lvc/dis/EntityTable.hpp"
+#include "csics/lvc/dis/FixedLayout.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+
+namespace {
+using namespace csics::lvc;
+using namespace std::chrono_literals;
+
+struct ManualClock {
+    using duration = std::chrono::microseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+    static inline time_point current{};
+    static time_point now() noexcept { return current; }
+};
+
+using Table = dis::RemoteEntityTable<ManualClock>;
+
+// An encoded entity state for entity `id` at DIS timestamp `ts`, with
+// x = `x`.
+std::vector<char> entity_state(std::uint16_t id, std::uint32_t ts,
+                               double x = 0.0) {
+    dis::EntityStatePDU pdu{};
+    pdu.header.timestamp = dis::DISTimestamp(ts);
+    pdu.entity_id = dis::EntityID(1, 2, id);
+    pdu.entity_type = dis::EntityType(1, 2, 225, 4, 5, 6, 7);
+    pdu.entity_location = dis::WorldCoordinates(x, 0.0, 0.0);
+    pdu.entity_appearance = id;
+    std::vector<char> out(dis::layout::entity_state::size);
+    dis::encode_fixed(out, pdu);
+    return out;
+}
+
+csics::BufferView view(const std::vector<char>& v) {
+    return csics::BufferView(v.data(), v.size());
+}
+
+ManualClock::time_point at(std::chrono::milliseconds t) {
+    return ManualClock::time_point(t);
+}
+}  // namespace
+
+TEST(DISEntityIDMapTest, MatchesUnorderedMap) {
+    dis::EntityIDMap<std::uint32_t> map;
+    std::unordered_map<std::uint64_t, std::uint32_t> expected;
+    std::mt19937_64 rng(7);
+    std::vector<std::uint64_t> keys;
+    for (std::uint32_t i = 0; i < 100000; ++i) {
+        // site and application from a small set, as on a real exercise
+        const std::uint64_t key =
+            dis::EntityID(rng() % 4, rng() % 8, rng() % 65536).packed();
+        keys.push_back(key);
+        auto [v, inserted] = map.try_emplace(key, i);
+        auto [it, e_inserted] = expected.try_emplace(key, i);
+        ASSERT_EQ(inserted, e_inserted);
+        ASSERT_EQ(*v, it->second);
+    }
+    EXPECT_EQ(map.size(), expected.size());
+
+    // erase half, leaving tombstones behind, then churn
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+        EXPECT_EQ(map.erase(keys[i]), expected.erase(keys[i]) != 0);
+    }
+    for (std::size_t i = 0; i < keys.size(); i += 3) {
+        map[keys[i]] = 7;
+        expected[keys[i]] = 7;
+    }
+    ASSERT_EQ(map.size(), expected.size());
+    for (auto key : keys) {
+        const std::uint32_t* v = map.find(key);
+        auto it = expected.find(key);
+        ASSERT_EQ(v != nullptr, it != expected.end());
+        if (v) {
+            EXPECT_EQ(*v, it->second);
+        }
+    }
+    std::size_t visited = 0;
+    map.for_each([&](std::uint64_t key, std::uint32_t v) {
+        EXPECT_EQ(expected.at(key), v);
+        ++visited;
+    });
+    EXPECT_EQ(visited, expected.size());
+
+    map.clear();
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_EQ(map.find(keys[1]), nullptr);
+}
+
+TEST(DISEntityTableTest, UpdatesAndSuppressesDuplicates) {
+    Table table;
+    auto t0 = at(1000ms);
+    EXPECT_EQ(table.update(view(entity_state(1, 100, 1.0)), t0),
+              dis::EntityUpdate::Created);
+    EXPECT_EQ(table.update(view(entity_state(2, 100)), t0),
+              dis::EntityUpdate::Created);
+    EXPECT_EQ(table.update(view(entity_state(1, 200, 2.0)), t0 + 1ms),
+              dis::EntityUpdate::Updated);
+    // a duplicate and a reordered PDU
+    EXPECT_EQ(table.update(view(entity_state(1, 200, 9.0)), t0 + 2ms),
+              dis::EntityUpdate::Stale);
+    EXPECT_EQ(table.update(view(entity_state(1, 150, 9.0)), t0 + 2ms),
+              dis::EntityUpdate::Stale);
+    // timestamps wrap at the hour
+    EXPECT_EQ(table.update(view(entity_state(2, 0xFFFFFFF0)), t0 + 3ms),
+              dis::EntityUpdate::Stale);
+    EXPECT_EQ(table.update(view(entity_state(2, 0x3FFFFFF0u << 1)), t0),
+              dis::EntityUpdate::Updated);
+    EXPECT_EQ(table.update(view(entity_state(2, 0x7FFFFFE0u << 1)), t0),
+              dis::EntityUpdate::Updated);
+    EXPECT_EQ(table.update(view(entity_state(2, 0x20)), t0 + 3ms),
+              dis::EntityUpdate::Updated);
+    EXPECT_EQ(table.update(view(entity_state(2, 0x20)).subview(0, 100), t0),
+              dis::EntityUpdate::Malformed);
+
+    ASSERT_EQ(table.size(), 2u);
+    auto row = table.find(dis::EntityID(1, 2, 1));
+    ASSERT_TRUE(row.has_value());
+    const auto& c = table.columns();
+    EXPECT_EQ(c.x[*row], 2.0);
+    EXPECT_EQ(c.timestamps[*row], 200u);
+    EXPECT_EQ(c.appearances[*row], 1u);
+    EXPECT_EQ(c.types[*row].country, 225u);
+    EXPECT_EQ(c.entity_id(*row), dis::EntityID(1, 2, 1));
+    EXPECT_EQ(table.last_update(*row), t0 + 1ms);
+    EXPECT_FALSE(table.find(dis::EntityID(1, 2, 3)).has_value());
+
+    EXPECT_EQ(table.updated().size(), 2u);
+    table.clear_events();
+    EXPECT_EQ(table.updated().size(), 0u);
+    EXPECT_EQ(table.stats().created, 2u);
+    EXPECT_EQ(table.stats().stale, 3u);
+    EXPECT_EQ(table.stats().malformed, 1u);
+}
+
+TEST(DISEntityTableTest, Throttles) {
+    dis::EntityTableConfig config;
+    config.min_interval = 100ms;
+    Table table(config);
+    auto t0 = at(0ms);
+    table.update(view(entity_state(1, 2)), t0);
+    EXPECT_EQ(table.update(view(entity_state(1, 4)), t0 + 50ms),
+              dis::EntityUpdate::Throttled);
+    EXPECT_EQ(table.update(view(entity_state(1, 6)), t0 + 100ms),
+              dis::EntityUpdate::Updated);
+    EXPECT_EQ(table.stats().throttled, 1u);
+}
+
+TEST(DISEntityTableTest, Expires) {
+    Table table;  // 12 s timeout, 100 ms ticks
+    auto t0 = at(5000ms);
+    std::vector<std::vector<char>> batch;
+    for (std::uint16_t id = 1; id <= 3; ++id) {
+        batch.push_back(entity_state(id, 2));
+    }
+    dis::ElectromagneticEmissionPDU ee{};
+    std::vector<char> other(64);
+    csics::serialization::DirectSerializer s;
+    other.resize(csics::serialization::serialize(s, other, ee)
+                     .written_view.size());
+    batch.push_back(other);
+    std::vector<csics::BufferView> views;
+    for (const auto& pdu : batch) {
+        views.push_back(view(pdu));
+    }
+    EXPECT_EQ(table.update_batch(views, t0), 3u);
+    table.clear_events();
+
+    EXPECT_EQ(table.expire(t0 + 5s), 0u);
+    table.update(view(entity_state(2, 4)), t0 + 5s);
+    EXPECT_EQ(table.expire(t0 + 11900ms), 0u);
+    EXPECT_EQ(table.expire(t0 + 12s), 2u);
+    EXPECT_EQ(table.size(), 1u);
+    auto expired = std::vector<std::uint64_t>(table.expired().begin(),
+                                              table.expired().end());
+    std::sort(expired.begin(), expired.end());
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{
+                           dis::EntityID(1, 2, 1).packed(),
+                           dis::EntityID(1, 2, 3).packed()}));
+    // the survivor was moved into a freed row and is still found
+    auto row = table.find(dis::EntityID(1, 2, 2));
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(table.columns().keys[*row], dis::EntityID(1, 2, 2).packed());
+
+    // a long gap between calls still expires everything due
+    EXPECT_EQ(table.expire(t0 + 1h), 1u);
+    EXPECT_EQ(table.size(), 0u);
+
+    // a removed and recreated entity is timed from its recreation
+    table.update(view(entity_state(5, 2)), t0 + 2h);
+    EXPECT_TRUE(table.remove(dis::EntityID(1, 2, 5)));
+    EXPECT_FALSE(table.remove(dis::EntityID(1, 2, 5)));
+    table.update(view(entity_state(5, 2)), t0 + 2h + 6s);
+    EXPECT_EQ(table.expire(t0 + 2h + 12s), 0u);
+    EXPECT_EQ(table.expire(t0 + 2h + 18s), 1u);
+    EXPECT_EQ(table.stats().expired, 4u);
+}
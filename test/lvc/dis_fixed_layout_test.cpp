@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <cstring>
+
+#include "csics/lvc/dis/FixedLayout.hpp"
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/serde.hpp"
+
+namespace {
+using namespace csics::lvc;
+
+dis::EntityStatePDU make_entity_state(std::uint8_t params_type) {
+    dis::EntityStatePDU pdu{};
+    pdu.header.exercise_id = 4;
+    pdu.header.timestamp = dis::DISTimestamp(123456789);
+    pdu.header.protocol_family = 1;
+    pdu.entity_id = dis::EntityID(1, 2, 3);
+    pdu.force_id = 2;
+    pdu.entity_type = dis::EntityType(1, 2, 225, 4, 5, 6, 7);
+    pdu.alternative_entity_type = dis::EntityType(7, 6, 5, 4, 3, 2, 1);
+    pdu.entity_linear_velocity = dis::Vector(1.0f, 2.0f, 3.0f);
+    pdu.entity_location = dis::WorldCoordinates(4.0, 5.0, 6.0);
+    pdu.entity_orientation = dis::EulerAngles(0.1f, 0.2f, 0.3f);
+    pdu.entity_appearance = 0x12345678;
+    pdu.dr_parameters.algorithm = 4;
+    pdu.dr_parameters.params_type = params_type;
+    if (params_type == 1) {
+        pdu.dr_parameters.fixed.local_angles =
+            dis::EulerAngles(0.01f, 0.02f, 0.03f);
+    } else if (params_type == 2) {
+        pdu.dr_parameters.rotating.quat = dis::DISQuat(1000, 0.1f, 0.2f, 0.3f);
+    }
+    pdu.dr_parameters.linear_acceleration = dis::Vector(0.1f, 0.2f, 0.3f);
+    pdu.dr_parameters.angular_velocity = dis::Vector(0.4f, 0.5f, 0.6f);
+    pdu.entity_marking.character_set = 1;
+    std::memcpy(pdu.entity_marking.marking, "TANK1", 5);
+    pdu.capabilities = 0xCAFEBABE;
+    return pdu;
+}
+
+csics::BufferView serialize_direct(csics::Buffer<char>& buffer,
+                                   const dis::EntityStatePDU& pdu) {
+    csics::serialization::DirectSerializer s;
+    auto res = csics::serialization::serialize(s, buffer, pdu);
+    return csics::BufferView(buffer.data(), res.written_view.size());
+}
+}  // namespace
+
+TEST(DISFixedLayoutTest, MatchesDirectSerializer) {
+    for (std::uint8_t params_type : {0, 1, 2}) {
+        auto pdu = make_entity_state(params_type);
+        if (params_type == 2) {
+            for (std::uint8_t i = 0; i < 2; ++i) {
+                dis::VariableParameters vp{};
+                vp.type = i + 1;
+                vp.data[0] = 0x10 + i;
+                vp.data[14] = 0x20 + i;
+                pdu.variable_parameters.push_back(vp);
+            }
+        }
+
+        csics::Buffer<char> direct_buffer(512);
+        auto expected = serialize_direct(direct_buffer, pdu);
+
+        // poison the output so any byte the fast path skips shows up
+        csics::Buffer<char> fixed_buffer(512, '\xAA');
+        auto res = dis::encode_fixed(fixed_buffer, pdu);
+        ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+        ASSERT_EQ(res.written_view.size(), expected.size());
+        EXPECT_EQ(std::memcmp(res.written_view.data(), expected.data(),
+                              expected.size()),
+                  0)
+            << "params_type " << int(params_type);
+
+        // and through the generic entry point
+        dis::FixedLayoutSerializer s;
+        csics::Buffer<char> generic_buffer(512);
+        res = csics::serialization::serialize(s, generic_buffer, pdu);
+        ASSERT_EQ(res.written_view.size(), expected.size());
+        EXPECT_EQ(std::memcmp(res.written_view.data(), expected.data(),
+                              expected.size()),
+                  0);
+    }
+}
+
+TEST(DISFixedLayoutTest, BufferFull) {
+    auto pdu = make_entity_state(1);
+    csics::Buffer<char> buffer(dis::pdu_size_calc(pdu) - 1, '\xAA');
+    auto res = dis::encode_fixed(buffer, pdu);
+    EXPECT_EQ(res.status,
+              csics::serialization::SerializationStatus::BufferFull);
+    EXPECT_EQ(res.written_view.size(), 0u);
+    EXPECT_EQ(buffer[0], '\xAA');
+
+    dis::EntityStateImage image(pdu);
+    EXPECT_EQ(image.write(buffer).status,
+              csics::serialization::SerializationStatus::BufferFull);
+}
+
+TEST(DISFixedLayoutTest, EntityStateImage) {
+    auto pdu = make_entity_state(1);
+    dis::EntityStateImage image(pdu);
+
+    pdu.header.timestamp = dis::DISTimestamp(987654321);
+    pdu.entity_location = dis::WorldCoordinates(-1.0, -2.0, -3.0);
+    pdu.entity_orientation = dis::EulerAngles(1.0f, 0.5f, -0.5f);
+    pdu.entity_linear_velocity = dis::Vector(9.0f, 8.0f, 7.0f);
+    pdu.entity_appearance = 7;
+    image.timestamp(pdu.header.timestamp);
+    image.location(pdu.entity_location);
+    image.orientation(pdu.entity_orientation);
+    image.linear_velocity(pdu.entity_linear_velocity);
+    image.appearance(pdu.entity_appearance);
+
+    csics::Buffer<char> direct_buffer(512);
+    auto expected = serialize_direct(direct_buffer, pdu);
+
+    csics::Buffer<char> out(512);
+    auto res = image.write(out);
+    EXPECT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    ASSERT_EQ(res.written_view.size(), expected.size());
+    EXPECT_EQ(
+        std::memcmp(res.written_view.data(), expected.data(), expected.size()),
+        0);
+
+    dis::EntityStatePDUView view(res.written_view);
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.location(), pdu.entity_location);
+    EXPECT_EQ(view.header().timestamp(), dis::DISTimestamp(987654321));
+}
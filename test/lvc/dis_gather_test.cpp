@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <vector>
+
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+
+namespace {
+using namespace csics::lvc;
+using csics::serialization::DirectSerializer;
+using csics::serialization::GatherSerializer;
+
+std::vector<char> concat(std::span<const csics::BufferView> chunks) {
+    std::vector<char> out;
+    for (auto c : chunks) {
+        out.insert(out.end(), c.begin(), c.end());
+    }
+    return out;
+}
+
+std::vector<char> direct(const auto& pdu) {
+    DirectSerializer s;
+    std::vector<char> out(4096);
+    auto res = csics::serialization::serialize(
+        s, csics::MutableBufferView(out.data(), out.size()), pdu);
+    EXPECT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    out.resize(res.written_view.size());
+    return out;
+}
+
+dis::TransmitterPDU transmitter() {
+    dis::TransmitterPDU pdu{};
+    pdu.radio_reference_id = dis::ID(1, 2, 3);
+    pdu.radio_type.dis7 = dis::RadioType7{1, 2, 225, 3, 4, 5, 6};
+    pdu.center_frequency = 243000000;
+    dis::VariableTransmitterParameters small;
+    small.type = 1;
+    for (std::uint8_t i = 0; i < 10; ++i) {
+        small.data.push_back(i);
+    }
+    dis::VariableTransmitterParameters large;
+    large.type = 2;
+    for (std::size_t i = 0; i < 1001; ++i) {
+        large.data.push_back(static_cast<std::uint8_t>(i * 7));
+    }
+    pdu.variable_parameters.push_back(std::move(small));
+    pdu.variable_parameters.push_back(std::move(large));
+    return pdu;
+}
+}  // namespace
+
+TEST(DISGatherTest, TransmitterReferencesLargeParameters) {
+    const auto pdu = transmitter();
+    const auto expected = direct(pdu);
+    const auto& large = pdu.variable_parameters[1].data;
+
+    GatherSerializer<DirectSerializer> s;
+    std::vector<char> staging(expected.size() - large.size());
+    auto res = csics::serialization::serialize(
+        s, csics::MutableBufferView(staging.data(), staging.size()), pdu);
+    ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    EXPECT_EQ(s.referenced(), large.size());
+
+    auto chunks = s.chunks(res.written_view);
+    ASSERT_EQ(chunks.size(), 3u);
+    // the large parameter is the source buffer itself, the small one copied
+    EXPECT_EQ(chunks[1].data(), reinterpret_cast<const char*>(large.data()));
+    EXPECT_EQ(concat(chunks), expected);
+}
+
+TEST(DISGatherTest, SignalDataNeedsNoStaging) {
+    std::vector<char> audio(1001);
+    for (std::size_t i = 0; i < audio.size(); ++i) {
+        audio[i] = static_cast<char>(i);
+    }
+    dis::SignalPDU pdu{};
+    pdu.radio_reference_id = dis::ID(1, 2, 3);
+    pdu.sample_rate = 8000;
+    pdu.samples = 500;
+    pdu.data = csics::BufferView(audio.data(), audio.size());
+    const auto expected = direct(pdu);
+
+    // only the header and the padding are staged
+    GatherSerializer<DirectSerializer> s;
+    std::vector<char> staging(32 + 3);
+    auto res = csics::serialization::serialize(
+        s, csics::MutableBufferView(staging.data(), staging.size()), pdu);
+    ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    auto chunks = s.chunks(res.written_view);
+    ASSERT_EQ(chunks.size(), 3u);
+    EXPECT_EQ(chunks[1].data(), audio.data());
+    EXPECT_EQ(concat(chunks), expected);
+
+    // below the threshold everything is copied
+    GatherSerializer<DirectSerializer> copying(audio.size() + 1);
+    std::vector<char> whole(expected.size());
+    res = csics::serialization::serialize(
+        copying, csics::MutableBufferView(whole.data(), whole.size()), pdu);
+    ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    EXPECT_EQ(copying.chunks(res.written_view).size(), 1u);
+    EXPECT_EQ(whole, expected);
+
+    s.clear();
+    EXPECT_EQ(s.referenced(), 0u);
+    EXPECT_EQ(csics::serialization::serialize(
+                  s, csics::MutableBufferView(staging.data(), 31), pdu)
+                  .status,
+              csics::serialization::SerializationStatus::BufferFull);
+}
+
+TEST(DISGatherTest, CBORByteStrings) {
+    struct Snippet {
+        int id = 9;
+        csics::BufferView iq;
+        static consteval auto fields() {
+            using csics::serialization::make_field;
+            return csics::serialization::make_fields(
+                make_field("id", &Snippet::id), make_field("iq", &Snippet::iq));
+        }
+    };
+    std::vector<char> samples(4096, 0x5A);
+    const Snippet snippet{9, csics::BufferView(samples.data(), samples.size())};
+
+    csics::serialization::CBORSerializer plain;
+    csics::Buffer<char> expected;
+    csics::serialization::serialize_to(plain, expected, snippet);
+
+    GatherSerializer<csics::serialization::CBORSerializer> s;
+    char staging[32];
+    auto res = csics::serialization::serialize(
+        s, csics::MutableBufferView(staging, sizeof(staging)), snippet);
+    ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    auto chunks = s.chunks(res.written_view);
+    ASSERT_EQ(chunks.size(), 2u);
+    EXPECT_EQ(chunks[1].data(), samples.data());
+    EXPECT_EQ(concat(chunks),
+              std::vector<char>(expected.data(),
+                                expected.data() + expected.size()));
+}
+
+TEST(DISGatherTest, UDPSendGather) {
+    using namespace csics::io::net;
+    constexpr Port port = 47311;
+    UDPEndpoint rx;
+    ASSERT_EQ(rx.bind(port), NetStatus::Success);
+    UDPEndpoint tx;
+    ASSERT_EQ(tx.bind(0), NetStatus::Success);
+
+    const auto pdu = transmitter();
+    GatherSerializer<DirectSerializer> s;
+    std::vector<char> staging(1024);
+    auto res = csics::serialization::serialize(
+        s, csics::MutableBufferView(staging.data(), staging.size()), pdu);
+    ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    auto chunks = s.chunks(res.written_view);
+    const auto expected = concat(chunks);
+
+    auto sent = tx.send_gather(chunks, SockAddr::localhost(port));
+    ASSERT_EQ(sent.status, NetStatus::Success);
+    EXPECT_EQ(sent.bytes_transferred, expected.size());
+
+    ASSERT_EQ(rx.poll(1000), PollStatus::Ready);
+    std::vector<char> received(2048);
+    SockAddr src;
+    auto got = rx.recv(
+        csics::MutableBufferView(received.data(), received.size()), src);
+    ASSERT_EQ(got.status, NetStatus::Success);
+    received.resize(got.bytes_transferred);
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(received, direct(pdu));
+}
@@ -0,0 +1,439 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <csics/csics.hpp>
+#include <vector>
+
+#include "csics/lvc/dis/PDUs.hpp"
+#include "csics/lvc/dis/Views.hpp"
+#include "csics/lvc/dis/serde.hpp"
+
+namespace {
+using namespace csics::lvc;
+
+dis::PDUHeader make_header(
+    dis::PDUType type,
+    dis::ProtocolVersion version = dis::ProtocolVersion::IEEE_1278_2012) {
+    dis::PDUHeader header;
+    header.protocol_version = version;
+    header.exercise_id = 4;
+    header.pdu_type = type;
+    header.timestamp = dis::DISTimestamp(123456789);
+    header.protocol_family = 1;
+    header.status = 0;
+    return header;
+}
+
+template <typename PDU>
+csics::BufferView serialize_pdu(csics::Buffer<char>& buffer, const PDU& pdu) {
+    csics::serialization::DirectSerializer s;
+    auto res = csics::serialization::serialize(s, buffer, pdu);
+    EXPECT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    EXPECT_EQ(res.written_view.size(), dis::pdu_size_calc(pdu));
+    return csics::BufferView(buffer.data(), res.written_view.size());
+}
+}  // namespace
+
+TEST(DISViewTest, EntityState) {
+    dis::EntityStatePDU pdu{};
+    pdu.header = make_header(dis::PDUType::EntityState);
+    pdu.entity_id = dis::EntityID(1, 2, 3);
+    pdu.force_id = 2;
+    pdu.entity_type = dis::EntityType(1, 2, 225, 4, 5, 6, 7);
+    pdu.alternative_entity_type = dis::EntityType(7, 6, 5, 4, 3, 2, 1);
+    pdu.entity_linear_velocity = dis::Vector(1.0f, 2.0f, 3.0f);
+    pdu.entity_location = dis::WorldCoordinates(4.0, 5.0, 6.0);
+    pdu.entity_orientation = dis::EulerAngles(0.1f, 0.2f, 0.3f);
+    pdu.entity_appearance = 0x12345678;
+    pdu.dr_parameters.algorithm = 4;
+    pdu.dr_parameters.params_type = 1;
+    pdu.dr_parameters.fixed.local_angles =
+        dis::EulerAngles(0.01f, 0.02f, 0.03f);
+    pdu.dr_parameters.linear_acceleration = dis::Vector(0.1f, 0.2f, 0.3f);
+    pdu.dr_parameters.angular_velocity = dis::Vector(0.4f, 0.5f, 0.6f);
+    pdu.entity_marking.character_set = 1;
+    std::memcpy(pdu.entity_marking.marking, "TANK1", 5);
+    pdu.capabilities = 0xCAFEBABE;
+    for (std::uint8_t i = 0; i < 2; ++i) {
+        dis::VariableParameters vp{};
+        vp.type = i + 1;
+        vp.data[0] = 0x10 + i;
+        vp.data[14] = 0x20 + i;
+        pdu.variable_parameters.push_back(vp);
+    }
+
+    csics::Buffer<char> buffer(1024);
+    auto bytes = serialize_pdu(buffer, pdu);
+
+    dis::EntityStatePDUView view(bytes);
+    ASSERT_TRUE(view.valid());
+    ASSERT_TRUE(view.header().valid());
+    EXPECT_EQ(view.header().exercise_id(), 4);
+    EXPECT_EQ(view.header().length(), bytes.size());
+    EXPECT_EQ(view.header().timestamp(), dis::DISTimestamp(123456789));
+    EXPECT_EQ(view.entity_id(), dis::EntityID(1, 2, 3));
+    EXPECT_EQ(view.force_id(), 2);
+    EXPECT_EQ(view.entity_type().country, 225);
+    EXPECT_EQ(view.alternative_entity_type().kind, 7);
+    EXPECT_EQ(view.linear_velocity(), dis::Vector(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(view.location(), dis::WorldCoordinates(4.0, 5.0, 6.0));
+    EXPECT_EQ(view.orientation(), dis::EulerAngles(0.1f, 0.2f, 0.3f));
+    EXPECT_EQ(view.appearance(), 0x12345678u);
+    EXPECT_EQ(view.capabilities(), 0xCAFEBABEu);
+    EXPECT_EQ(view.marking_text(), "TANK1");
+
+    auto dr = view.dr_parameters();
+    EXPECT_EQ(dr.algorithm, 4);
+    EXPECT_EQ(dr.fixed.local_angles, dis::EulerAngles(0.01f, 0.02f, 0.03f));
+    EXPECT_EQ(dr.angular_velocity, dis::Vector(0.4f, 0.5f, 0.6f));
+
+    std::uint8_t expected_type = 1;
+    for (auto vp : view.variable_parameters()) {
+        EXPECT_EQ(vp.type(), expected_type);
+        EXPECT_EQ(vp.value().data[14], 0x20 + expected_type - 1);
+        ++expected_type;
+    }
+    EXPECT_EQ(expected_type, 3);
+
+    // the views agree with the owning deserializer
+    csics::serialization::DirectDeserializer d(bytes);
+    dis::EntityStatePDU owned_pdu;
+    auto owned = csics::serialization::deserialize(d, owned_pdu);
+    ASSERT_TRUE(owned.has_value());
+    EXPECT_EQ(owned->entity_appearance, view.appearance());
+    EXPECT_EQ(owned->capabilities, view.capabilities());
+
+    // a truncated buffer is rejected, and records past the end are not read
+    EXPECT_FALSE(dis::EntityStatePDUView(bytes.head(100)).valid());
+    dis::EntityStatePDUView truncated(bytes.head(bytes.size() - 1));
+    EXPECT_FALSE(truncated.header().valid());
+    std::size_t n = 0;
+    for ([[maybe_unused]] auto vp : truncated.variable_parameters()) {
+        ++n;
+    }
+    EXPECT_EQ(n, 1u);
+}
+
+TEST(DISViewTest, ElectromagneticEmission) {
+    dis::ElectromagneticEmissionPDU pdu{};
+    pdu.header = make_header(dis::PDUType::ElectromagneticEmission);
+    pdu.emitter_id = dis::EntityID(1, 2, 3);
+    pdu.event_id = dis::EventID(1, 2, 6);
+    for (std::uint8_t s = 0; s < 2; ++s) {
+        dis::EmitterSystem system{};
+        system.emitter_name = 0x1234 + s;
+        system.emitter_number = s;
+        system.emitter_location = dis::EntityCoordinates(1.0f, 2.0f, 3.0f);
+        for (std::uint8_t b = 0; b < 2; ++b) {
+            dis::Beam beam{};
+            beam.beam_number = b;
+            beam.fundamental_parameters.center_frequency = 1000.0f * (b + 1);
+            beam.jamming_technique = {1, 2, 3, 4};
+            if (b == 1) {
+                csics::Buffer<dis::TrackJam> track_jams;
+                for (std::uint16_t t = 0; t < 3; ++t) {
+                    track_jams.push_back(
+                        dis::TrackJam{dis::EntityID(9, 9, t), s, b});
+                }
+                beam.number_of_targets = 3;
+                beam.track_jams = std::move(track_jams);
+            }
+            system.beams.push_back(std::move(beam));
+        }
+        pdu.emitter_systems.push_back(std::move(system));
+    }
+
+    csics::Buffer<char> buffer(2048);
+    auto bytes = serialize_pdu(buffer, pdu);
+
+    dis::ElectromagneticEmissionPDUView view(bytes);
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.emitter_id(), dis::EntityID(1, 2, 3));
+    EXPECT_EQ(view.event_id(), dis::EventID(1, 2, 6));
+    EXPECT_EQ(view.system_count(), 2);
+
+    std::size_t systems = 0;
+    std::size_t track_jams = 0;
+    std::size_t total = dis::layout::emission::size;
+    for (auto system : view.systems()) {
+        EXPECT_EQ(system.emitter_name(), 0x1234 + systems);
+        EXPECT_EQ(system.location(), dis::EntityCoordinates(1.0f, 2.0f, 3.0f));
+        std::uint8_t b = 0;
+        for (auto beam : system.beams()) {
+            EXPECT_EQ(beam.beam_number(), b);
+            EXPECT_EQ(beam.fundamental_parameters().center_frequency,
+                      1000.0f * (b + 1));
+            EXPECT_EQ(beam.jamming_technique().specific, 4);
+            std::uint16_t t = 0;
+            for (auto tj : beam.track_jams()) {
+                EXPECT_EQ(tj.target(), dis::EntityID(9, 9, t));
+                EXPECT_EQ(tj.beam_number(), b);
+                ++t;
+                ++track_jams;
+            }
+            EXPECT_EQ(t, beam.number_of_targets());
+            ++b;
+        }
+        EXPECT_EQ(b, 2);
+        total += system.size_bytes();
+        ++systems;
+    }
+    EXPECT_EQ(systems, 2u);
+    EXPECT_EQ(track_jams, 6u);
+    EXPECT_EQ(total, bytes.size());
+}
+
+TEST(DISViewTest, Transmitter) {
+    for (auto version : {dis::ProtocolVersion::IEEE_1278_1998,
+                         dis::ProtocolVersion::IEEE_1278_2012}) {
+        dis::TransmitterPDU pdu{};
+        pdu.header = make_header(dis::PDUType::Transmitter, version);
+        pdu.radio_reference_id = dis::ID(1, 2, 3);
+        pdu.radio_number = 7;
+        if (version == dis::ProtocolVersion::IEEE_1278_1998) {
+            pdu.radio_type.dis6 = dis::RadioType6{1, 2, 225, 3, 4, 0x4567};
+        } else {
+            pdu.radio_type.dis7 = dis::RadioType7{1, 2, 225, 3, 4, 5, 6};
+        }
+        pdu.transmit_state = 2;
+        pdu.input_source = 1;
+        pdu.antenna_location = dis::WorldCoordinates(1.0, 2.0, 3.0);
+        pdu.center_frequency = 243000000;
+        pdu.power = 40.0f;
+        pdu.modulation_type = {1, 2, 3, 4};
+        for (std::uint8_t i = 0; i < 5; ++i) {
+            pdu.modulation_parameters.push_back(i);
+        }
+        dis::BeamAntennaPattern pattern{};
+        pattern.azimuth_beamwidth = 0.5f;
+        pattern.phase = 0.25f;
+        pdu.antenna_patterns.push_back(pattern);
+        if (version == dis::ProtocolVersion::IEEE_1278_2012) {
+            dis::VariableTransmitterParameters vp;
+            vp.type = 3000;
+            vp.data.push_back(0xAB);
+            vp.data.push_back(0xCD);
+            pdu.variable_parameters.push_back(std::move(vp));
+        }
+
+        csics::Buffer<char> buffer(1024);
+        auto bytes = serialize_pdu(buffer, pdu);
+
+        dis::TransmitterPDUView view(bytes);
+        ASSERT_TRUE(view.valid());
+        EXPECT_EQ(view.radio_reference_id(), dis::ID(1, 2, 3));
+        EXPECT_EQ(view.radio_number(), 7);
+        EXPECT_EQ(view.radio_type().dis7.country_code, 225);
+        if (version == dis::ProtocolVersion::IEEE_1278_1998) {
+            EXPECT_EQ(view.radio_type().dis6.nomenclature, 0x4567);
+        } else {
+            EXPECT_EQ(view.radio_type().dis7.extra, 6);
+        }
+        EXPECT_EQ(view.transmit_state(), 2);
+        EXPECT_EQ(view.antenna_location(),
+                  dis::WorldCoordinates(1.0, 2.0, 3.0));
+        EXPECT_EQ(view.frequency(), 243000000u);
+        EXPECT_EQ(view.power(), 40.0f);
+        EXPECT_EQ(view.modulation_type().radio_system, 4);
+        ASSERT_EQ(view.modulation_parameters().size(), 5u);
+        EXPECT_EQ(view.modulation_parameters()[4], 4);
+
+        std::size_t patterns = 0;
+        for (auto p : view.antenna_patterns()) {
+            EXPECT_EQ(p.value().azimuth_beamwidth, 0.5f);
+            EXPECT_EQ(p.value().phase, 0.25f);
+            ++patterns;
+        }
+        EXPECT_EQ(patterns, 1u);
+
+        std::size_t params = 0;
+        for (auto p : view.variable_parameters()) {
+            EXPECT_EQ(p.type(), 3000u);
+            EXPECT_EQ(p.size_bytes(), 8u);
+            EXPECT_EQ(static_cast<std::uint8_t>(p.data()[1]), 0xCD);
+            ++params;
+        }
+        EXPECT_EQ(params, pdu.variable_parameters.size());
+
+        csics::serialization::DirectDeserializer d(bytes);
+        dis::TransmitterPDU owned_pdu;
+        auto owned = csics::serialization::deserialize(d, owned_pdu);
+        ASSERT_TRUE(owned.has_value());
+        EXPECT_EQ(owned->modulation_parameters.size(), 5u);
+        EXPECT_EQ(owned->antenna_patterns.size(), 1u);
+        EXPECT_EQ(owned->variable_parameters.size(),
+                  pdu.variable_parameters.size());
+        EXPECT_EQ(owned->power, 40.0f);
+    }
+}
+
+TEST(DISViewTest, DeserializationErrors) {
+    dis::EntityStatePDU pdu{};
+    pdu.header = make_header(dis::PDUType::EntityState);
+    pdu.variable_parameters.push_back(dis::VariableParameters{});
+
+    csics::Buffer<char> buffer(1024);
+    auto bytes = serialize_pdu(buffer, pdu);
+
+    // cut inside the country code of the entity type
+    {
+        csics::serialization::DirectDeserializer d(bytes.head(23));
+        dis::EntityStatePDU out;
+        auto res = csics::serialization::deserialize(d, out);
+        ASSERT_FALSE(res.has_value());
+        EXPECT_EQ(res.error(),
+                  csics::serialization::DeserializationStatus::BufferEmpty);
+        EXPECT_EQ(res.error().offset, 22u);
+        EXPECT_STREQ(res.error().field, "entity_type");
+    }
+    // cut inside the variable parameter records
+    {
+        csics::serialization::DirectDeserializer d(bytes.head(150));
+        dis::EntityStatePDU out;
+        auto res = csics::serialization::deserialize(d, out);
+        ASSERT_FALSE(res.has_value());
+        EXPECT_EQ(res.error().offset, 150u);
+        EXPECT_STREQ(res.error().field, "variable_parameters");
+    }
+}
+
+TEST(DISViewTest, FireAndDetonation) {
+    const dis::BurstDescriptor burst{dis::EntityType{2, 9, 225, 1, 2, 3, 0},
+                                     1000, 2000, 4, 600};
+
+    dis::FirePDU fire{};
+    fire.header = make_header(dis::PDUType::Fire);
+    fire.firing_entity_id = dis::EntityID(1, 2, 3);
+    fire.target_entity_id = dis::EntityID(1, 2, 4);
+    fire.munition_id = dis::EntityID(1, 2, 5);
+    fire.event_id = dis::EventID(1, 2, 6);
+    fire.fire_mission_index = 17;
+    fire.location = dis::WorldCoordinates(1.0, 2.0, 3.0);
+    fire.burst_descriptor = burst;
+    fire.velocity = dis::Vector(300.0f, 0.0f, 10.0f);
+    fire.range = 2500.0f;
+
+    csics::Buffer<char> buffer(1024);
+    auto bytes = serialize_pdu(buffer, fire);
+    ASSERT_EQ(bytes.size(), 96u);
+
+    dis::FirePDUView fv(bytes);
+    ASSERT_TRUE(fv.valid());
+    EXPECT_FALSE(dis::FirePDUView(bytes.head(95)).valid());
+    EXPECT_EQ(fv.firing_entity_id(), dis::EntityID(1, 2, 3));
+    EXPECT_EQ(fv.target_entity_id(), dis::EntityID(1, 2, 4));
+    EXPECT_EQ(fv.munition_id(), dis::EntityID(1, 2, 5));
+    EXPECT_EQ(fv.event_id(), dis::EventID(1, 2, 6));
+    EXPECT_EQ(fv.fire_mission_index(), 17u);
+    EXPECT_EQ(fv.location(), dis::WorldCoordinates(1.0, 2.0, 3.0));
+    EXPECT_EQ(fv.burst_descriptor().munition.country, 225);
+    EXPECT_EQ(fv.burst_descriptor().fuse, 2000);
+    EXPECT_EQ(fv.burst_descriptor().rate, 600);
+    EXPECT_EQ(fv.velocity(), dis::Vector(300.0f, 0.0f, 10.0f));
+    EXPECT_EQ(fv.range(), 2500.0f);
+
+    csics::serialization::DirectDeserializer fd(bytes);
+    dis::FirePDU owned_fire;
+    auto fire_out = csics::serialization::deserialize(fd, owned_fire);
+    ASSERT_TRUE(fire_out.has_value());
+    EXPECT_EQ(fire_out->event_id, dis::EventID(1, 2, 6));
+    EXPECT_EQ(fire_out->burst_descriptor.quantity, 4);
+    EXPECT_EQ(fire_out->range, 2500.0f);
+
+    dis::DetonationPDU det{};
+    det.header = make_header(dis::PDUType::Detonation);
+    det.firing_entity_id = dis::EntityID(1, 2, 3);
+    det.target_entity_id = dis::EntityID(1, 2, 4);
+    det.munition_id = dis::EntityID(1, 2, 5);
+    det.event_id = dis::EventID(1, 2, 6);
+    det.velocity = dis::Vector(250.0f, 0.0f, -5.0f);
+    det.location = dis::WorldCoordinates(4.0, 5.0, 6.0);
+    det.burst_descriptor = burst;
+    det.entity_location = dis::EntityCoordinates(1.0f, 0.5f, 0.0f);
+    det.detonation_result = 1;
+    for (std::uint8_t i = 0; i < 2; ++i) {
+        dis::VariableParameters vp{};
+        vp.type = i;
+        vp.data[14] = 0x40 + i;
+        det.variable_parameters.push_back(vp);
+    }
+
+    bytes = serialize_pdu(buffer, det);
+    ASSERT_EQ(bytes.size(), 136u);
+
+    dis::DetonationPDUView dv(bytes);
+    ASSERT_TRUE(dv.valid());
+    EXPECT_FALSE(dis::FirePDUView(bytes).valid());
+    EXPECT_EQ(dv.munition_id(), dis::EntityID(1, 2, 5));
+    EXPECT_EQ(dv.velocity(), dis::Vector(250.0f, 0.0f, -5.0f));
+    EXPECT_EQ(dv.location(), dis::WorldCoordinates(4.0, 5.0, 6.0));
+    EXPECT_EQ(dv.burst_descriptor().warhead, 1000);
+    EXPECT_EQ(dv.entity_location(), dis::EntityCoordinates(1.0f, 0.5f, 0.0f));
+    EXPECT_EQ(dv.detonation_result(), 1);
+    std::uint8_t type = 0;
+    for (auto vp : dv.variable_parameters()) {
+        EXPECT_EQ(vp.type(), type);
+        EXPECT_EQ(vp.value().data[14], 0x40 + type);
+        ++type;
+    }
+    EXPECT_EQ(type, 2);
+
+    csics::serialization::DirectDeserializer dd(bytes);
+    dis::DetonationPDU owned_det;
+    auto det_out = csics::serialization::deserialize(dd, owned_det);
+    ASSERT_TRUE(det_out.has_value());
+    EXPECT_EQ(det_out->target_entity_id, dis::EntityID(1, 2, 4));
+    EXPECT_EQ(det_out->detonation_result, 1);
+    ASSERT_EQ(det_out->variable_parameters.size(), 2u);
+    EXPECT_EQ(det_out->variable_parameters[1].data[14], 0x41);
+}
+
+TEST(DISViewTest, Signal) {
+    std::vector<char> audio(161);  // odd length to exercise the padding
+    for (std::size_t i = 0; i < audio.size(); ++i) {
+        audio[i] = static_cast<char>(i);
+    }
+    dis::SignalPDU pdu{};
+    pdu.header = make_header(dis::PDUType::Signal);
+    pdu.radio_reference_id = dis::ID(1, 2, 3);
+    pdu.radio_number = 2;
+    pdu.encoding_scheme = 4;  // 16 bit linear PCM
+    pdu.sample_rate = 8000;
+    pdu.samples = 80;
+    pdu.data = csics::BufferView(audio.data(), audio.size());
+
+    csics::Buffer<char> buffer(1024);
+    auto bytes = serialize_pdu(buffer, pdu);
+    ASSERT_EQ(bytes.size(), 32u + 164u);
+
+    dis::SignalPDUView view(bytes);
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(view.radio_reference_id(), dis::ID(1, 2, 3));
+    EXPECT_EQ(view.radio_number(), 2);
+    EXPECT_EQ(view.encoding_class(), 0);
+    EXPECT_EQ(view.encoding_type(), 4);
+    EXPECT_EQ(view.sample_rate(), 8000u);
+    EXPECT_EQ(view.samples(), 80);
+    EXPECT_EQ(view.data_length(), 161 * 8);
+    // the data is a view into the datagram
+    ASSERT_EQ(view.data().size(), audio.size());
+    EXPECT_EQ(view.data().data(), bytes.data() + 32);
+    EXPECT_TRUE(
+        std::equal(audio.begin(), audio.end(), view.data().data()));
+    // a datagram cut inside the data is rejected
+    EXPECT_FALSE(dis::SignalPDUView(bytes.head(100)).valid());
+
+    csics::serialization::DirectDeserializer d(bytes);
+    dis::SignalPDU owned_pdu;
+    auto owned = csics::serialization::deserialize(d, owned_pdu);
+    ASSERT_TRUE(owned.has_value());
+    EXPECT_EQ(d.remaining(), 0u);
+    EXPECT_EQ(owned->sample_rate, 8000u);
+    EXPECT_EQ(owned->data.data(), bytes.data() + 32);
+    EXPECT_EQ(owned->data.size(), audio.size());
+
+    csics::serialization::DirectDeserializer cut(bytes.head(100));
+    auto truncated = csics::serialization::deserialize(cut, owned_pdu);
+    ASSERT_FALSE(truncated.has_value());
+    EXPECT_STREQ(truncated.error().field, "data");
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <csics/csics.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace csics::serialization;
+
+struct Telemetry {
+    std::uint32_t id = 0;
+    std::int64_t time = 0;
+    double lat = 0.0;
+    double lon = 0.0;
+    float alt = 0.0f;
+    bool valid = false;
+    std::string callsign;
+    std::vector<std::int16_t> samples;
+    std::map<std::string, int> counters;
+
+    static consteval auto fields() {
+        return make_fields(make_field("id", &Telemetry::id),
+                           make_field("time", &Telemetry::time),
+                           make_field("lat", &Telemetry::lat),
+                           make_field("lon", &Telemetry::lon),
+                           make_field("alt", &Telemetry::alt),
+                           make_field("valid", &Telemetry::valid),
+                           make_field("callsign", &Telemetry::callsign),
+                           make_field("samples", &Telemetry::samples),
+                           make_field("counters", &Telemetry::counters));
+    }
+};
+
+struct Blob {
+    std::string_view name;
+    csics::BufferView payload;
+
+    static consteval auto fields() {
+        return make_fields(make_field("name", &Blob::name),
+                           make_field("payload", &Blob::payload));
+    }
+};
+
+Telemetry make_telemetry() {
+    Telemetry t;
+    t.id = 70000;
+    t.time = -1700000000123;
+    t.lat = 35.123456789;
+    t.lon = -117.5;
+    t.alt = 1234.5f;
+    t.valid = true;
+    t.callsign = "VIPER 1";
+    t.samples = {0, 23, 24, -1, -25, 300, -32768};
+    t.counters = {{"rx", 10}, {"tx", 500}};
+    return t;
+}
+
+std::vector<std::uint8_t> bytes(csics::BufferView v) {
+    return std::vector<std::uint8_t>(
+        reinterpret_cast<const std::uint8_t*>(v.data()),
+        reinterpret_cast<const std::uint8_t*>(v.data()) + v.size());
+}
+
+csics::BufferView view(const std::vector<std::uint8_t>& v) {
+    return csics::BufferView(reinterpret_cast<const char*>(v.data()),
+                             v.size());
+}
+}  // namespace
+
+TEST(CSICSCBORTests, Encoding) {
+    CBORSerializer s;
+    char buffer[64];
+    // RFC 8949 appendix A examples
+    auto encode = [&](auto value) {
+        return bytes(serialize(s, csics::MutableBufferView(buffer, 64), value)
+                         .written_view);
+    };
+    using B = std::vector<std::uint8_t>;
+    EXPECT_EQ(encode(0), B({0x00}));
+    EXPECT_EQ(encode(23), B({0x17}));
+    EXPECT_EQ(encode(24), B({0x18, 0x18}));
+    EXPECT_EQ(encode(1000), B({0x19, 0x03, 0xE8}));
+    EXPECT_EQ(encode(std::uint64_t{1000000000000}),
+              B({0x1B, 0x00, 0x00, 0x00, 0xE8, 0xD4, 0xA5, 0x10, 0x00}));
+    EXPECT_EQ(encode(-1), B({0x20}));
+    EXPECT_EQ(encode(-1000), B({0x39, 0x03, 0xE7}));
+    EXPECT_EQ(encode(INT64_MIN), B({0x3B, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                    0xFF, 0xFF}));
+    EXPECT_EQ(encode(100000.0), B({0xFA, 0x47, 0xC3, 0x50, 0x00}));
+    EXPECT_EQ(encode(1.1),
+              B({0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A}));
+    EXPECT_EQ(encode(false), B({0xF4}));
+    EXPECT_EQ(encode(nullptr), B({0xF6}));
+    EXPECT_EQ(encode(std::string_view("IETF")),
+              B({0x64, 0x49, 0x45, 0x54, 0x46}));
+    EXPECT_EQ(encode(std::vector<int>{1, 2, 3}),
+              B({0x83, 0x01, 0x02, 0x03}));
+    EXPECT_EQ(encode(std::map<std::string, int>{{"a", 1}}),
+              B({0xA1, 0x61, 0x61, 0x01}));
+}
+
+TEST(CSICSCBORTests, RoundTrip) {
+    CBORSerializer s;
+    const Telemetry t = make_telemetry();
+    csics::Buffer<char> out;
+    auto res = serialize_to(s, out, t);
+    ASSERT_EQ(res.status, SerializationStatus::Ok);
+    EXPECT_EQ(out.size(), serialized_size(s, t));
+
+    CBORDeserializer d(out);
+    Telemetry back;
+    auto r = deserialize(d, back);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->id, t.id);
+    EXPECT_EQ(r->time, t.time);
+    EXPECT_EQ(r->lat, t.lat);
+    EXPECT_EQ(r->lon, t.lon);
+    EXPECT_EQ(r->alt, t.alt);
+    EXPECT_EQ(r->valid, t.valid);
+    EXPECT_EQ(r->callsign, t.callsign);
+    EXPECT_EQ(r->samples, t.samples);
+    EXPECT_EQ(r->counters, t.counters);
+    EXPECT_EQ(d.offset(), out.size());
+}
+
+TEST(CSICSCBORTests, SmallerThanJSON) {
+    struct Track {
+        int id = 4021;
+        double lat = 35.123456789;
+        double lon = -117.5;
+        bool valid = true;
+        std::vector<int> samples = std::vector<int>(64, 12);
+        static consteval auto fields() {
+            return make_fields(make_field("id", &Track::id),
+                               make_field("lat", &Track::lat),
+                               make_field("lon", &Track::lon),
+                               make_field("valid", &Track::valid),
+                               make_field("samples", &Track::samples));
+        }
+    };
+    const Track t;
+    CBORSerializer cbor;
+    JSONSerializer json;
+    EXPECT_LT(serialized_size(cbor, t) * 2, serialized_size(json, t));
+}
+
+TEST(CSICSCBORTests, ZeroCopyViews) {
+    const std::string payload = "\x01\x02\x00\x03";
+    Blob b{"blob", csics::BufferView(payload.data(), 4)};
+    CBORSerializer s;
+    char buffer[64];
+    auto out = serialize(s, csics::MutableBufferView(buffer, 64), b);
+    ASSERT_EQ(out.status, SerializationStatus::Ok);
+
+    CBORDeserializer d(out.written_view);
+    Blob back;
+    auto r = deserialize(d, back);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->name, "blob");
+    ASSERT_EQ(r->payload.size(), 4u);
+    EXPECT_EQ(std::memcmp(r->payload.data(), payload.data(), 4), 0);
+    // both point into the encoded buffer
+    EXPECT_GE(r->name.data(), buffer);
+    EXPECT_LT(r->payload.data(), buffer + out.written_view.size());
+}
+
+TEST(CSICSCBORTests, KeyedLookup) {
+    // {"extra": [_ {"x": 1}, h'00'], "valid": true, "id": 5} with an
+    // indefinite-length array and keys out of order; the other fields are
+    // missing, so only a struct with those fields reads it.
+    struct Small {
+        std::uint32_t id = 0;
+        bool valid = false;
+        static consteval auto fields() {
+            return make_fields(make_field("id", &Small::id),
+                               make_field("valid", &Small::valid));
+        }
+    };
+    const std::vector<std::uint8_t> in = {
+        0xA3, 0x65, 'e',  'x', 't',  'r',  'a',  0x9F, 0xA1, 0x61, 'x',
+        0x01, 0x41, 0x00, 0xFF, 0x65, 'v', 'a',  'l',  'i',  'd',  0xF5,
+        0x62, 'i',  'd',  0x05};
+    CBORDeserializer d(view(in));
+    Small s;
+    auto r = deserialize(d, s);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->id, 5u);
+    EXPECT_TRUE(r->valid);
+    EXPECT_EQ(d.offset(), in.size());
+
+    // the same as an indefinite-length map
+    std::vector<std::uint8_t> open = in;
+    open[0] = 0xBF;
+    open.push_back(0xFF);
+    CBORDeserializer o(view(open));
+    auto ro = deserialize(o, s);
+    ASSERT_TRUE(ro.has_value());
+    EXPECT_EQ(ro->id, 5u);
+    EXPECT_EQ(o.offset(), open.size());
+}
+
+TEST(CSICSCBORTests, Errors) {
+    CBORSerializer s;
+    const Telemetry t = make_telemetry();
+    csics::Buffer<char> out;
+    serialize_to(s, out, t);
+
+    // every truncation fails cleanly
+    for (std::size_t n = 0; n < out.size(); ++n) {
+        CBORDeserializer d(csics::BufferView(out.data(), n));
+        Telemetry back;
+        EXPECT_FALSE(deserialize(d, back).has_value()) << n;
+    }
+
+    // a value out of range for its field
+    const std::vector<std::uint8_t> big = {0xA1, 0x62, 'i', 'd', 0x1B, 1, 0,
+                                           0,    0,    0,   0,   0,    0};
+    struct Id {
+        std::uint32_t id = 0;
+        static consteval auto fields() {
+            return make_fields(make_field("id", &Id::id));
+        }
+    };
+    CBORDeserializer d(view(big));
+    Id id;
+    auto r = deserialize(d, id);
+    ASSERT_FALSE(r.has_value());
+    EXPECT_EQ(r.error().reason, DeserializationStatus::InvalidData);
+    EXPECT_STREQ(r.error().field, "id");
+    EXPECT_EQ(r.error().offset, 4u);
+
+    // a buffer too small to serialize into
+    char small[8];
+    EXPECT_EQ(serialize(s, csics::MutableBufferView(small, 8), t).status,
+              SerializationStatus::BufferFull);
+}
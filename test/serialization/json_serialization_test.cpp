@@ -163,3 +163,313 @@ TEST(CSICSSerializationTests, JSONMapSerialization) {
     std::string_view result(res.written_view.data(), res.written_view.size());
     EXPECT_EQ(result, expected);
 }
+
+TEST(CSICSSerializationTests, JSONValueFormatting) {
+    using namespace csics::serialization;
+
+    JSONSerializer serializer;
+    char buffer[256];
+    std::vector<int> ints = {0, 9, 10, 99, 100, -1, INT32_MIN, INT32_MAX};
+    auto res = serialize(serializer, csics::MutableBufferView(buffer, 256),
+                         ints);
+    ASSERT_EQ(res.status, SerializationStatus::Ok);
+    EXPECT_EQ(std::string_view(res.written_view.data(),
+                               res.written_view.size()),
+              "[0,9,10,99,100,-1,-2147483648,2147483647]");
+
+    std::vector<double> doubles = {0.1, -2.5e-300, 1e21,
+                                   std::numeric_limits<double>::infinity()};
+    res = serialize(serializer, csics::MutableBufferView(buffer, 256),
+                    doubles);
+    ASSERT_EQ(res.status, SerializationStatus::Ok);
+    EXPECT_EQ(std::string_view(res.written_view.data(),
+                               res.written_view.size()),
+              "[0.1,-2.5e-300,1e+21,null]");
+
+    std::map<std::string, std::string> m = {{"k\"ey", "a\tb\x01"}};
+    res = serialize(serializer, csics::MutableBufferView(buffer, 256), m);
+    ASSERT_EQ(res.status, SerializationStatus::Ok);
+    EXPECT_EQ(std::string_view(res.written_view.data(),
+                               res.written_view.size()),
+              R"({"k\"ey":"a\tb\u0001"})");
+}
+
+TEST(CSICSSerializationTests, JSONBufferFull) {
+    using namespace csics::serialization;
+
+    JSONSerializer serializer;
+    TestClass c(42, 3.14, "Hello, world!", {1, 2, 3}, {4, 5, 6});
+    constexpr std::size_t full = 61;  // the JSONStructSerialization output
+    char buffer[full];
+    for (std::size_t n = 0; n < full; ++n) {
+        auto out =
+            serialize(serializer, csics::MutableBufferView(buffer, n), c);
+        EXPECT_EQ(out.status, SerializationStatus::BufferFull) << n;
+        EXPECT_LE(out.written_view.size(), n);
+    }
+    auto out = serialize(serializer, csics::MutableBufferView(buffer, full), c);
+    EXPECT_EQ(out.status, SerializationStatus::Ok);
+    EXPECT_EQ(out.written_view.size(), full);
+}
+
+namespace {
+struct Point {
+    int x = 0;
+    double y = 0.0;
+    std::string name;
+
+    static consteval auto fields() {
+        using namespace csics::serialization;
+        return make_fields(make_field("x", &Point::x),
+                           make_field("y", &Point::y),
+                           make_field("name", &Point::name));
+    }
+};
+
+struct Track {
+    Point origin;
+    std::vector<Point> points;
+    std::vector<int> ids;
+    std::map<std::string, double> scores;
+    bool active = false;
+
+    static consteval auto fields() {
+        using namespace csics::serialization;
+        return make_fields(make_field("origin", &Track::origin),
+                           make_field("points", &Track::points),
+                           make_field("ids", &Track::ids),
+                           make_field("scores", &Track::scores),
+                           make_field("active", &Track::active));
+    }
+};
+
+csics::BufferView view(std::string_view s) {
+    return csics::BufferView(s.data(), s.size());
+}
+}  // namespace
+
+TEST(CSICSSerializationTests, JSONStructDeserialization) {
+    using namespace csics::serialization;
+
+    constexpr std::string_view json = R"({"x":42,"y":3.25,"name":"alpha"})";
+    JSONDeserializer d(view(json));
+    Point p;
+    auto res = deserialize(d, p);
+    ASSERT_TRUE(res.has_value());
+    EXPECT_EQ(res->x, 42);
+    EXPECT_EQ(res->y, 3.25);
+    EXPECT_EQ(res->name, "alpha");
+}
+
+TEST(CSICSSerializationTests, JSONRoundTrip) {
+    using namespace csics::serialization;
+
+    Track t;
+    t.origin = Point{1, -2.5, "origin"};
+    t.points = {Point{2, 0.5, "a"}, Point{3, 1e-3, "b \"quoted\""}};
+    t.ids = {7, -8, 9};
+    t.scores = {{"one", 1.5}, {"two", -2.0}};
+    t.active = true;
+
+    JSONSerializer s;
+    char buffer[512];
+    csics::MutableBufferView bv(buffer, sizeof(buffer));
+    auto out = serialize(s, bv, t);
+    ASSERT_EQ(out.status, SerializationStatus::Ok);
+
+    JSONDeserializer d(out.written_view);
+    Track back;
+    auto res = deserialize(d, back);
+    ASSERT_TRUE(res.has_value());
+    EXPECT_EQ(res->origin.name, "origin");
+    EXPECT_EQ(res->origin.y, -2.5);
+    ASSERT_EQ(res->points.size(), 2u);
+    EXPECT_EQ(res->points[1].x, 3);
+    EXPECT_EQ(res->points[1].y, 1e-3);
+    EXPECT_EQ(res->points[1].name, "b \"quoted\"");
+    EXPECT_EQ(res->ids, (std::vector<int>{7, -8, 9}));
+    EXPECT_EQ(res->scores, t.scores);
+    EXPECT_TRUE(res->active);
+}
+
+TEST(CSICSSerializationTests, JSONOutOfOrderAndUnknownKeys) {
+    using namespace csics::serialization;
+
+    constexpr std::string_view json = R"(
+        {
+            "extra": {"deep": [1, {"x": 5}, "}"]},
+            "name" : "beta",
+            "y" : -1.5e2 ,
+            "x" : 7
+        })";
+    JSONDeserializer d(view(json));
+    Point p;
+    auto res = deserialize(d, p);
+    ASSERT_TRUE(res.has_value());
+    EXPECT_EQ(res->x, 7);
+    EXPECT_EQ(res->y, -150.0);
+    EXPECT_EQ(res->name, "beta");
+}
+
+TEST(CSICSSerializationTests, JSONStringViewsAndEscapes) {
+    using namespace csics::serialization;
+
+    // the escaped quote and backslash straddle the first 64 byte block
+    std::string json = "[\"plain\",\"";
+    json += std::string(50, 'x');
+    json += R"(\\\"]\n\u00e9\ud83d\ude00\/","")";
+    json += "]";
+    JSONDeserializer d(view(json));
+    std::vector<std::string_view> strings;
+    auto res = deserialize(d, strings);
+    ASSERT_TRUE(res.has_value());
+    ASSERT_EQ(res->size(), 3u);
+    // unescaped strings are views into the input
+    EXPECT_EQ((*res)[0], "plain");
+    EXPECT_EQ((*res)[0].data(), json.data() + 2);
+    EXPECT_EQ((*res)[1], std::string(50, 'x') +
+                             "\\\"]\n\xC3\xA9\xF0\x9F\x98\x80/");
+    EXPECT_EQ((*res)[2], "");
+}
+
+TEST(CSICSSerializationTests, JSONPrimitives) {
+    using namespace csics::serialization;
+
+    constexpr std::string_view json = R"([true, false, null, 12, "s"])";
+    JSONDeserializer d(view(json));
+    EXPECT_EQ(d.structural_count(), 11u);
+    ASSERT_TRUE(d.skip().has_value());
+    EXPECT_EQ(d.offset(), json.size());
+    JSONDeserializer e(view(R"(true)"));
+    EXPECT_EQ(*e.read<bool>(), true);
+    JSONDeserializer n(view(R"(null)"));
+    EXPECT_TRUE(n.read<std::nullptr_t>().has_value());
+    JSONDeserializer u(view(R"(255)"));
+    EXPECT_EQ(*u.read<std::uint8_t>(), 255);
+    JSONDeserializer big(view(R"(256)"));
+    EXPECT_FALSE(big.read<std::uint8_t>().has_value());
+}
+
+TEST(CSICSSerializationTests, JSONDeserializationErrors) {
+    using namespace csics::serialization;
+
+    {
+        constexpr std::string_view json = R"({"x":1,"y":2.0})";
+        JSONDeserializer d(view(json));
+        Point p;
+        auto res = deserialize(d, p);
+        ASSERT_FALSE(res.has_value());
+        EXPECT_EQ(res.error().reason, DeserializationStatus::InvalidData);
+        EXPECT_STREQ(res.error().field, "name");
+    }
+    {
+        constexpr std::string_view json = R"({"x":"1","y":2.0,"name":""})";
+        JSONDeserializer d(view(json));
+        Point p;
+        auto res = deserialize(d, p);
+        ASSERT_FALSE(res.has_value());
+        EXPECT_STREQ(res.error().field, "x");
+        EXPECT_EQ(res.error().offset, json.find("\"1\""));
+    }
+    {
+        constexpr std::string_view json = R"({"x":1,"y":2.0,"name":"abc)";
+        JSONDeserializer d(view(json));
+        Point p;
+        auto res = deserialize(d, p);
+        ASSERT_FALSE(res.has_value());
+        EXPECT_EQ(res.error().offset, json.size());
+    }
+    {
+        constexpr std::string_view json = R"([1,2,])";
+        JSONDeserializer d(view(json));
+        std::vector<int> v;
+        EXPECT_FALSE(deserialize(d, v).has_value());
+    }
+    {
+        constexpr std::string_view json = R"(["\q"])";
+        JSONDeserializer d(view(json));
+        std::vector<std::string> v;
+        EXPECT_FALSE(deserialize(d, v).has_value());
+    }
+    {
+        // too large for the 32 bit index; rejected before any byte is read
+        constexpr std::string_view json = R"([1])";
+        JSONDeserializer d(
+            csics::BufferView(json.data(), std::size_t{1} << 32));
+        std::vector<int> v;
+        auto res = deserialize(d, v);
+        ASSERT_FALSE(res.has_value());
+        EXPECT_EQ(res.error().reason, DeserializationStatus::InvalidData);
+        EXPECT_EQ(d.structural_count(), 0u);
+    }
+}
+
+namespace {
+struct Fixed {
+    int a = 0;
+    double b = 0.0;
+    bool c = false;
+    std::array<int, 3> d{};
+
+    static consteval auto fields() {
+        using namespace csics::serialization;
+        return make_fields(
+            make_field("a", &Fixed::a), make_field("b", &Fixed::b),
+            make_field("c", &Fixed::c), make_field("d", &Fixed::d));
+    }
+};
+
+template <typename T>
+concept HasMaxSize = requires {
+    csics::serialization::max_size<csics::serialization::JSONSerializer, T>();
+};
+}  // namespace
+
+TEST(CSICSSerializationTests, JSONSerializedSize) {
+    using namespace csics::serialization;
+
+    JSONSerializer serializer;
+    char buffer[512];
+    TestClass c(42, 3.14, "Hello, \"world\"!\n", {1, 2, 3}, {});
+    Track t;
+    t.origin = Point{-1, 1e300, "o"};
+    t.points = {Point{2, 0.5, "a"}, Point{3, 1e-3, ""}};
+    t.scores = {{"k\\", 1.0}};
+
+    auto check = [&](const auto& obj) {
+        auto out = serialize(serializer, csics::MutableBufferView(buffer, 512),
+                             obj);
+        ASSERT_EQ(out.status, SerializationStatus::Ok);
+        EXPECT_EQ(serialized_size(serializer, obj), out.written_view.size());
+    };
+    check(c);
+    check(t);
+    check(std::vector<int>{});
+    check(std::map<std::string, int>{{"x", -10}, {"y", 0}});
+
+    static_assert(HasMaxSize<Fixed>);
+    static_assert(!HasMaxSize<Point>);
+    static_assert(!HasMaxSize<std::vector<int>>);
+    // {"a":-2147483648,"b":<24 chars>,"c":false,"d":[<3 ints>]}
+    static_assert(max_size<JSONSerializer, Fixed>() == 98);
+    Fixed f{INT32_MIN,
+            -2.2250738585072014e-308,
+            false,
+            {INT32_MIN, INT32_MIN, INT32_MIN}};
+    constexpr std::size_t bound = max_size<JSONSerializer, Fixed>();
+    EXPECT_EQ(serialized_size(serializer, f), bound);
+}
+
+TEST(CSICSSerializationTests, JSONSerializeToBuffer) {
+    using namespace csics::serialization;
+
+    JSONSerializer serializer;
+    csics::Buffer<char> out;
+    TestClass c(42, 3.14, "Hello, world!", {1, 2, 3}, {4, 5, 6});
+    auto res = serialize_to(serializer, out, c);
+    ASSERT_EQ(res.status, SerializationStatus::Ok);
+    res = serialize_to(serializer, out, std::vector<int>{7});
+    ASSERT_EQ(res.status, SerializationStatus::Ok);
+    EXPECT_EQ(std::string_view(out.data(), out.size()),
+              R"({"a":42,"b":3.14,"c":"Hello, world!","d":[1,2,3],"e":[4,5,6]}[7])");
+}
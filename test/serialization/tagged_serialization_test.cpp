@@ -0,0 +1,341 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <csics/csics.hpp>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace csics::serialization;
+
+enum class Affiliation : std::uint8_t { Unknown, Friendly, Hostile };
+
+struct Waypoint {
+    double lat = 0.0;
+    double lon = 0.0;
+    std::string name;
+
+    static consteval auto fields() {
+        return make_fields(make_field("lat", &Waypoint::lat, 1),
+                           make_field("lon", &Waypoint::lon, 2),
+                           make_field("name", &Waypoint::name, 3));
+    }
+};
+
+struct Scenario {
+    std::uint32_t id = 0;
+    std::int64_t start = 0;
+    bool live = false;
+    Affiliation side = Affiliation::Unknown;
+    std::string title;
+    std::vector<float> samples;
+    std::array<std::int16_t, 3> offsets{};
+    std::vector<Waypoint> route;
+    std::map<std::string, int> counters;
+    std::optional<double> altitude;
+
+    static consteval auto fields() {
+        return make_fields(make_field("id", &Scenario::id),
+                           make_field("start", &Scenario::start),
+                           make_field("live", &Scenario::live),
+                           make_field("side", &Scenario::side),
+                           make_field("title", &Scenario::title),
+                           make_field("samples", &Scenario::samples),
+                           make_field("offsets", &Scenario::offsets),
+                           make_field("route", &Scenario::route),
+                           make_field("counters", &Scenario::counters),
+                           make_field("altitude", &Scenario::altitude));
+    }
+};
+
+// Two versions of one record: V2 drops `speed` (id 2) and adds `heading`
+// (id 4) and an optional `note`, declared in a different order.
+struct TrackV1 {
+    std::uint16_t id = 0;
+    float speed = 0.0f;
+    std::string callsign;
+
+    static consteval auto fields() {
+        return make_fields(make_field("id", &TrackV1::id, 1),
+                           make_field("speed", &TrackV1::speed, 2),
+                           make_field("callsign", &TrackV1::callsign, 3));
+    }
+};
+
+struct TrackV2 {
+    std::string callsign = "none";
+    double heading = -1.0;
+    std::uint16_t id = 0;
+    std::optional<std::string> note;
+
+    static consteval auto fields() {
+        return make_fields(make_field("callsign", &TrackV2::callsign, 3),
+                           make_field("heading", &TrackV2::heading, 4),
+                           make_field("id", &TrackV2::id, 1),
+                           make_field("note", &TrackV2::note, 5));
+    }
+};
+
+// consecutive fixed fields, written as one run
+struct Sample {
+    std::uint8_t quality = 0;
+    std::uint16_t site = 0;
+    std::uint32_t time = 0;
+
+    static consteval auto fields() {
+        return make_fields(make_field("quality", &Sample::quality, 1),
+                           make_field("site", &Sample::site, 2),
+                           make_field("time", &Sample::time, 3));
+    }
+};
+
+// reads one field from the middle of the run and one it does not hold
+struct SampleSite {
+    std::uint16_t site = 0;
+    double range = -1.0;
+
+    static consteval auto fields() {
+        return make_fields(make_field("site", &SampleSite::site, 2),
+                           make_field("range", &SampleSite::range, 4));
+    }
+};
+
+// a longer run of its own than the one it reads
+struct SampleV2 {
+    std::uint8_t quality = 0;
+    std::uint16_t site = 0;
+    std::uint32_t time = 0;
+    double range = -1.0;
+
+    static consteval auto fields() {
+        return make_fields(make_field("quality", &SampleV2::quality, 1),
+                           make_field("site", &SampleV2::site, 2),
+                           make_field("time", &SampleV2::time, 3),
+                           make_field("range", &SampleV2::range, 4));
+    }
+};
+
+struct Label {
+    std::string text;
+    std::uint32_t color = 0;
+
+    static consteval auto fields() {
+        return make_fields(make_field("text", &Label::text),
+                           make_field("color", &Label::color));
+    }
+};
+
+template <typename T>
+std::vector<char> encode(const T& value) {
+    TaggedSerializer s;
+    std::vector<char> out(4096);
+    auto res = serialize(s, csics::MutableBufferView(out.data(), out.size()),
+                         value);
+    EXPECT_EQ(res.status, SerializationStatus::Ok);
+    out.resize(res.written_view.size());
+    return out;
+}
+
+csics::BufferView view(const std::vector<char>& v) {
+    return csics::BufferView(v.data(), v.size());
+}
+
+Scenario make_scenario() {
+    Scenario s;
+    s.id = 4021;
+    s.start = -1700000000123;
+    s.live = true;
+    s.side = Affiliation::Hostile;
+    s.title = "Red Flag";
+    s.samples = {1.5f, -2.25f, 3.0f};
+    s.offsets = {-1, 0, 300};
+    s.route = {{35.1, -117.5, "IP"}, {35.2, -117.4, "TGT"}};
+    s.counters = {{"rx", 10}, {"tx", 500}};
+    s.altitude = 9144.0;
+    return s;
+}
+}  // namespace
+
+TEST(CSICSTaggedTests, RoundTrip) {
+    const Scenario in = make_scenario();
+    const auto bytes = encode(in);
+
+    TaggedDeserializer d(view(bytes));
+    Scenario out;
+    auto r = deserialize(d, out);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->id, in.id);
+    EXPECT_EQ(r->start, in.start);
+    EXPECT_EQ(r->live, in.live);
+    EXPECT_EQ(r->side, in.side);
+    EXPECT_EQ(r->title, in.title);
+    EXPECT_EQ(r->samples, in.samples);
+    EXPECT_EQ(r->offsets, in.offsets);
+    ASSERT_EQ(r->route.size(), 2u);
+    EXPECT_EQ(r->route[1].lat, 35.2);
+    EXPECT_EQ(r->route[1].name, "TGT");
+    EXPECT_EQ(r->counters, in.counters);
+    EXPECT_EQ(r->altitude, in.altitude);
+    EXPECT_EQ(d.offset(), bytes.size());
+}
+
+TEST(CSICSTaggedTests, Layout) {
+    // u32 length, then key (id << 3 | type) and value per field
+    const auto bytes = encode(TrackV1{0x0102, 0.0f, "ab"});
+    const std::vector<char> expected = {
+        15,   0,    0,    0,                       // message length
+        0x09, 0x02, 0x01,                          // id 1, fixed16
+        0x12, 0x00, 0x00, 0x00, 0x00,              // id 2, fixed32
+        0x1C, 0x02, 0x00, 0x00, 0x00, 'a', 'b'};   // id 3, bytes
+    EXPECT_EQ(bytes, expected);
+}
+
+TEST(CSICSTaggedTests, RunLayout) {
+    const auto bytes = encode(Sample{0x7F, 0x0102, 0x03040506});
+    const std::vector<char> expected = {
+        10,   0,    0,    0,                       // message length
+        0x0D, 3,    0x24,                          // id 1, run of 3 types
+        0x7F, 0x02, 0x01, 0x06, 0x05, 0x04, 0x03}; // values
+    EXPECT_EQ(bytes, expected);
+
+    TaggedDeserializer d(view(bytes));
+    Sample out;
+    auto r = deserialize(d, out);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->quality, 0x7F);
+    EXPECT_EQ(r->site, 0x0102);
+    EXPECT_EQ(r->time, 0x03040506u);
+
+    TaggedDeserializer ds(view(bytes));
+    SampleSite site;
+    auto rs = deserialize(ds, site);
+    ASSERT_TRUE(rs.has_value());
+    EXPECT_EQ(rs->site, 0x0102);
+    EXPECT_EQ(rs->range, -1.0);
+    EXPECT_EQ(ds.offset(), bytes.size());
+
+    TaggedDeserializer d2(view(bytes));
+    SampleV2 v2;
+    auto r2 = deserialize(d2, v2);
+    ASSERT_TRUE(r2.has_value());
+    EXPECT_EQ(r2->time, 0x03040506u);
+    EXPECT_EQ(r2->range, -1.0);
+
+    // and back: the old reader takes its run out of the longer one
+    const auto longer = encode(SampleV2{1, 2, 3, 4.0});
+    TaggedDeserializer d1(view(longer));
+    Sample v1;
+    auto r1 = deserialize(d1, v1);
+    ASSERT_TRUE(r1.has_value());
+    EXPECT_EQ(r1->quality, 1);
+    EXPECT_EQ(r1->site, 2);
+    EXPECT_EQ(r1->time, 3u);
+    EXPECT_EQ(d1.offset(), longer.size());
+}
+
+TEST(CSICSTaggedTests, OptionalFieldsCostNothingWhenAbsent) {
+    Scenario with = make_scenario();
+    Scenario without = with;
+    without.altitude.reset();
+    // key and a fixed64
+    EXPECT_EQ(encode(with).size(), encode(without).size() + 1 + 8);
+
+    const auto bytes = encode(without);
+    TaggedDeserializer d(view(bytes));
+    Scenario out;
+    out.altitude = 1.0;
+    auto r = deserialize(d, out);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_FALSE(r->altitude.has_value());
+}
+
+TEST(CSICSTaggedTests, SchemaEvolution) {
+    // old data, new reader: speed is skipped, heading keeps its default
+    const auto v1 = encode(TrackV1{7, 250.0f, "VIPER 1"});
+    TaggedDeserializer d2(view(v1));
+    TrackV2 t2;
+    auto r2 = deserialize(d2, t2);
+    ASSERT_TRUE(r2.has_value());
+    EXPECT_EQ(r2->id, 7);
+    EXPECT_EQ(r2->callsign, "VIPER 1");
+    EXPECT_EQ(r2->heading, -1.0);
+    EXPECT_FALSE(r2->note.has_value());
+
+    // new data, old reader: heading and note are skipped
+    TrackV2 newer;
+    newer.id = 9;
+    newer.callsign = "COBRA 2";
+    newer.heading = 90.0;
+    newer.note = std::string(1000, 'x');
+    const auto v2 = encode(newer);
+    TaggedDeserializer d1(view(v2));
+    TrackV1 t1;
+    auto r1 = deserialize(d1, t1);
+    ASSERT_TRUE(r1.has_value());
+    EXPECT_EQ(r1->id, 9);
+    EXPECT_EQ(r1->callsign, "COBRA 2");
+    EXPECT_EQ(r1->speed, 0.0f);
+    EXPECT_EQ(d1.offset(), v2.size());
+}
+
+TEST(CSICSTaggedTests, Errors) {
+    const auto bytes = encode(make_scenario());
+    for (std::size_t n = 0; n < bytes.size(); ++n) {
+        TaggedDeserializer d(csics::BufferView(bytes.data(), n));
+        Scenario out;
+        auto r = deserialize(d, out);
+        ASSERT_FALSE(r.has_value()) << n;
+        EXPECT_EQ(r.error().reason, DeserializationStatus::BufferEmpty) << n;
+    }
+
+    // a known id with the wrong wire type
+    auto v1 = encode(TrackV1{7, 250.0f, "A"});
+    v1[4] = 0x0A;  // id 1 as fixed32
+    TaggedDeserializer d(view(v1));
+    TrackV1 t;
+    auto r = deserialize(d, t);
+    ASSERT_FALSE(r.has_value());
+    EXPECT_EQ(r.error().reason, DeserializationStatus::InvalidData);
+    EXPECT_STREQ(r.error().field, "id");
+
+    char small[16];
+    TaggedSerializer s;
+    EXPECT_EQ(serialize(s, csics::MutableBufferView(small, sizeof(small)),
+                        make_scenario())
+                  .status,
+              SerializationStatus::BufferFull);
+}
+
+TEST(CSICSTaggedTests, NestedLengthPastParent) {
+    // the message claims 5 bytes, but its string runs to the end of the
+    // input, past the message and over where `color` would be
+    const std::vector<char> bytes = {
+        5,    0,  0, 0,                                  // message length
+        0x0C, 14, 0, 0, 0,                               // id 1, bytes
+        'a',  'b', 'c', 'd', 'e', 0x12, 0, 0, 0, 0,      // ...
+        0,    0,  0, 0};
+    TaggedDeserializer d(view(bytes));
+    Label out;
+    auto r = deserialize(d, out);
+    ASSERT_FALSE(r.has_value());
+    EXPECT_EQ(r.error().reason, DeserializationStatus::InvalidData);
+    EXPECT_STREQ(r.error().field, "text");
+
+    // mutated encodings fail or succeed, but stay inside the input
+    const auto good = encode(make_scenario());
+    std::mt19937 rng(46);
+    for (int i = 0; i < 4000; ++i) {
+        std::vector<char> bad = good;
+        for (int j = 0; j < 3; ++j) {
+            bad[rng() % bad.size()] = static_cast<char>(rng());
+        }
+        TaggedDeserializer md(view(bad));
+        Scenario s;
+        auto mr = deserialize(md, s);
+        EXPECT_LE(md.offset(), bad.size());
+        (void)mr;
+    }
+}
@@ -2,7 +2,10 @@
 
 #include <concepts>
 #include <csics/csics.hpp>
+#include <stdexcept>
+#include <string>
 
+#include "csics/sim/ecs/DynamicWorld.hpp"
 #include "csics/sim/ecs/World.hpp"
 
 using namespace csics::sim::ecs;
@@ -123,3 +126,477 @@ TEST(CSICSSimTests, ECSBasicTest) {
     EXPECT_FLOAT_EQ(pos2.x, 9);
     EXPECT_FLOAT_EQ(pos2.y, 9);
 }
+
+struct Tag {
+    int value;
+};
+
+struct Tagger {
+    using view_type = View<const Velocity>;
+    template <typename Ctx>
+    void operator()(view_type v, double, Ctx& ctx) const {
+        for (auto [entity, vel] : v) {
+            if (vel.dx < 0) {
+                ctx.template add_component<Tag>(entity, 7);
+            }
+        }
+    }
+};
+
+TEST(CSICSSimTests, ECSDynamicWorldTest) {
+    DynamicWorld world;
+    const auto tag_id = world.register_component<Tag>("tag");
+    // a component only known at runtime, e.g. read from a scenario file
+    const auto fuel_id = world.register_component("fuel", sizeof(float),
+                                                  alignof(float));
+    EXPECT_EQ(world.component_id("fuel"), fuel_id);
+    EXPECT_EQ(world.component_id<Tag>(), tag_id);
+    EXPECT_EQ(world.register_component<Tag>(), tag_id);
+
+    const auto move = world.add_layer();
+    world.add_system(move, sys2);
+    world.add_system(move, Tagger{});
+    const auto burn = world.add_layer();
+    std::size_t hooks = 0;
+    world.set_hook(burn, [&](DynamicWorld&) { ++hooks; });
+    world.add_system(burn, [fuel_id](DynamicWorld& w, double dt,
+                                     DynamicWorld::Context& ctx) {
+        const ComponentId ids[] = {fuel_id};
+        w.each(ids, [&](const Entity& e, std::span<void* const> c) {
+            auto& fuel = *static_cast<float*>(c[0]);
+            fuel -= static_cast<float>(dt);
+            if (fuel <= 0) {
+                ctx.destroy_entity(e);
+            }
+        });
+    });
+
+    auto e1 = world.add_entity();
+    auto e2 = world.add_entity();
+    world.add_component<Position>(e1, {0, 0});
+    world.add_component<Velocity>(e1, {1, 1});
+    world.add_component<Position>(e2, {10, 10});
+    world.add_component<Velocity>(e2, {-1, -1});
+    const float fuel1 = 5.0f;
+    const float fuel2 = 1.5f;
+    world.add_component(e1, fuel_id, &fuel1);
+    world.add_component(e2, fuel_id, &fuel2);
+
+    world.run(1.0);
+
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e1).x, 1);
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e2).x, 9);
+    EXPECT_EQ(world.get_component_set<Tag>().size(), 1u);
+    EXPECT_EQ(world.get_component<Tag>(e2).value, 7);
+    EXPECT_FLOAT_EQ(
+        *static_cast<const float*>(world.get_component(e2, fuel_id)), 0.5f);
+    EXPECT_EQ(hooks, 1u);
+
+    world.run(1.0);
+
+    EXPECT_TRUE(world.has_entity(e1));
+    EXPECT_FALSE(world.has_entity(e2));
+    EXPECT_EQ(world.entities().size(), 1u);
+    EXPECT_EQ(world.get_component_set<Tag>().size(), 0u);
+    EXPECT_EQ(world.pool(fuel_id).size(), 1u);
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e1).x, 2);
+
+    // recycled ids come back with a new generation
+    auto e3 = world.add_entity();
+    EXPECT_EQ(e3.id, e2.id);
+    EXPECT_NE(e3.generation, e2.generation);
+    EXPECT_EQ(world.get_component(e2, fuel_id), nullptr);
+}
+
+struct Callsign {
+    std::string name;
+};
+
+TEST(CSICSSimTests, ECSDynamicWorldDeferredCopyTest) {
+    DynamicWorld world;
+    const auto id = world.register_component<Callsign>("callsign");
+    auto e = world.add_entity();
+    // long enough to live on the heap, so a bitwise copy would be freed twice
+    const Callsign src{std::string(64, 'V')};
+    const auto layer = world.add_layer();
+    world.add_system(layer, [&](DynamicWorld& w, double,
+                                 DynamicWorld::Context& ctx) {
+        if (w.get_component(e, id) == nullptr) {
+            ctx.add_component(e, id, &src);
+        }
+    });
+
+    world.run(1.0);
+    world.run(1.0);
+
+    EXPECT_EQ(world.get_component<Callsign>(e).name, src.name);
+    EXPECT_EQ(src.name, std::string(64, 'V'));
+}
+
+struct Checked {
+    explicit Checked(int v) : value(v) {
+        if (v < 0) {
+            throw std::invalid_argument("negative");
+        }
+    }
+    int value;
+};
+
+TEST(CSICSSimTests, ECSDynamicWorldDeferredThrowTest) {
+    DynamicWorld world;
+    world.register_component<Checked>("checked");
+    auto bad = world.add_entity();
+    auto good = world.add_entity();
+    const auto layer = world.add_layer();
+    world.add_system(layer, [&](DynamicWorld&, double,
+                                 DynamicWorld::Context& ctx) {
+        EXPECT_THROW(ctx.add_component<Checked>(bad, -1),
+                     std::invalid_argument);
+        ctx.add_component<Checked>(good, 7);
+    });
+
+    world.run(1.0);
+
+    // the failed add leaves nothing behind to apply
+    EXPECT_EQ(world.get_component(bad, world.component_id<Checked>()),
+              nullptr);
+    EXPECT_EQ(world.get_component<Checked>(good).value, 7);
+}
+
+struct LocalOffset {
+    float x;
+};
+
+struct WorldOffset {
+    float x;
+};
+
+TEST(CSICSSimTests, ECSHierarchyTest) {
+    auto world = StaticWorldBuilder()
+                     .add_layer(sys3)
+                     .add_components<Position, LocalOffset, WorldOffset>()
+                     .build();
+
+    // platform -> emitter -> {beam_a, beam_b}, plus a second platform
+    auto platform = world.add_entity();
+    auto emitter = world.add_entity();
+    auto beam_a = world.add_entity();
+    auto beam_b = world.add_entity();
+    auto other = world.add_entity();
+    EXPECT_TRUE(world.set_parent(emitter, platform));
+    EXPECT_TRUE(world.set_parent(beam_a, emitter));
+    EXPECT_TRUE(world.set_parent(beam_b, emitter));
+    world.hierarchy().add(other);
+
+    world.add_component<LocalOffset>(platform, {100});
+    world.add_component<LocalOffset>(emitter, {10});
+    world.add_component<LocalOffset>(beam_a, {1});
+    world.add_component<LocalOffset>(beam_b, {2});
+    world.add_component<LocalOffset>(other, {500});
+
+    const auto& h = world.hierarchy();
+    EXPECT_EQ(h.depth(beam_b), 2u);
+    EXPECT_EQ(h.subtree(platform).size(), 4u);
+    std::size_t children = 0;
+    h.for_each_child(emitter, [&](const Entity&) { ++children; });
+    EXPECT_EQ(children, 2u);
+    // parents always precede children
+    for (std::size_t i = 0; i < h.size(); ++i) {
+        const auto p = h.parent_indices()[i];
+        EXPECT_TRUE(p == Hierarchy::npos || p < i);
+    }
+
+    auto compose = [](const WorldOffset* parent, const LocalOffset& local) {
+        return WorldOffset{(parent ? parent->x : 0.0f) + local.x};
+    };
+    h.propagate(world.get_component_set<LocalOffset>(),
+                world.get_component_set<WorldOffset>(), compose);
+    EXPECT_FLOAT_EQ(world.get_component<WorldOffset>(beam_b).x, 112);
+    EXPECT_FLOAT_EQ(world.get_component<WorldOffset>(other).x, 500);
+
+    // cycles are rejected, moving the emitter carries its beams along
+    EXPECT_FALSE(world.set_parent(platform, beam_a));
+    EXPECT_TRUE(world.set_parent(emitter, other));
+    EXPECT_EQ(h.subtree(platform).size(), 1u);
+    EXPECT_EQ(h.subtree(other).size(), 4u);
+    EXPECT_EQ(h.depth(beam_a), 2u);
+    h.propagate(world.get_component_set<LocalOffset>(),
+                world.get_component_set<WorldOffset>(), compose);
+    EXPECT_FLOAT_EQ(world.get_component<WorldOffset>(beam_a).x, 511);
+
+    // removing an entity removes its whole subtree
+    world.remove_entity(emitter);
+    EXPECT_FALSE(world.has_entity(beam_a));
+    EXPECT_FALSE(world.has_entity(beam_b));
+    EXPECT_TRUE(world.has_entity(other));
+    EXPECT_EQ(h.size(), 2u);
+    EXPECT_EQ(h.subtree(other).size(), 1u);
+    EXPECT_EQ(world.get_component_set<LocalOffset>().size(), 2u);
+}
+
+TEST(CSICSSimTests, ECSHierarchyPassThroughTest) {
+    // root -> group (no local name) -> leaf, world names built as paths
+    Hierarchy h;
+    const Entity root(0, 0), group(0, 1), leaf(0, 2);
+    h.add(root);
+    h.add(group, root);
+    h.add(leaf, group);
+    SparseSet<Callsign> local;
+    SparseSet<std::string> path;
+    local.insert(root, Callsign{std::string(40, 'r')});
+    local.insert(leaf, Callsign{"leaf"});
+
+    auto compose = [](const std::string* parent, const Callsign& c) {
+        return parent ? *parent + "/" + c.name : c.name;
+    };
+    for (int pass = 0; pass < 2; ++pass) {
+        h.propagate(local, path, compose);
+        EXPECT_EQ(path.size(), 2u);
+        EXPECT_EQ(path.at(group), nullptr);
+        ASSERT_NE(path.at(leaf), nullptr);
+        EXPECT_EQ(*path.at(leaf), std::string(40, 'r') + "/leaf");
+    }
+}
+
+TEST(CSICSSimTests, ECSSnapshotRestoreTest) {
+    using namespace csics::sim::ecs;
+    auto world = StaticWorldBuilder()
+                     .add_layer(sys2)
+                     .add_component<Position>()
+                     .add_component<Velocity>()
+                     .build();
+
+    auto e1 = world.add_entity();
+    auto e2 = world.add_entity();
+    world.add_component<Position>(e1, {0, 0});
+    world.add_component<Velocity>(e1, {1, 2});
+    world.add_component<Position>(e2, {5, 5});
+
+    WorldSnapshot base;
+    world.snapshot(base);
+
+    world.run(1.0);
+    world.remove_component<Position>(e2);
+    auto e3 = world.add_entity();
+    world.add_component<Position>(e3, {7, 7});
+
+    DeltaSnapshot delta;
+    world.snapshot_delta(base, delta);
+    EXPECT_GT(delta.page_count(), 0u);
+
+    auto rolled_forward = base;
+    delta.apply_to(rolled_forward);
+    EXPECT_TRUE(rolled_forward == world.snapshot());
+
+    ASSERT_TRUE(world.restore(base));
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e1).x, 0);
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e2).x, 5);
+    EXPECT_FALSE(world.has_entity(e3));
+
+    ASSERT_TRUE(world.restore(rolled_forward));
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e1).x, 1);
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e1).y, 2);
+    EXPECT_EQ(world.get_component_set<Position>().at(e2), nullptr);
+    EXPECT_FLOAT_EQ(world.get_component<Position>(e3).x, 7);
+
+    // an unchanged world produces an empty delta
+    world.snapshot_delta(rolled_forward, delta);
+    EXPECT_EQ(delta.page_count(), 0u);
+}
+
+#ifdef CSICS_BUILD_SERIALIZATION
+TEST(CSICSSimTests, ECSSnapshotWireTest) {
+    using namespace csics::sim::ecs;
+    auto world = StaticWorldBuilder()
+                     .add_layer(sys3)
+                     .add_component<Position>()
+                     .build();
+    for (int i = 0; i < 100; ++i) {
+        auto e = world.add_entity();
+        world.add_component<Position>(e, {float(i), float(-i)});
+    }
+    auto snap = world.snapshot();
+
+    csics::Buffer<char> out(snapshot_wire_size(snap));
+    csics::serialization::DirectSerializer s;
+    auto res = csics::serialization::serialize(s, out, snap);
+    ASSERT_EQ(res.status, csics::serialization::SerializationStatus::Ok);
+    ASSERT_EQ(res.written_view.size(), out.size());
+
+    csics::serialization::DirectDeserializer d(out);
+    auto loaded = csics::serialization::deserialize(d, snap);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_TRUE(*loaded == snap);
+
+    out[0] = 'X';
+    csics::serialization::DirectDeserializer bad(out);
+    EXPECT_FALSE(csics::serialization::deserialize(bad, snap).has_value());
+
+    // truncated: the header promises more blob than the input holds
+    out[0] = 'C';
+    csics::serialization::DirectDeserializer cut(
+        csics::BufferView(out.data(), out.size() - 1));
+    auto r = csics::serialization::deserialize(cut, snap);
+    ASSERT_FALSE(r.has_value());
+    EXPECT_STREQ(r.error().field, "blob_size");
+
+    // oversized: a bare header claiming a huge section is rejected before
+    // anything is allocated for it
+    csics::Buffer<char> header(48);
+    csics::serialization::DirectSerializer hs;
+    auto hv = csics::MutableBufferView(header.data(), header.size());
+    hs.write(hv, csics::le<std::uint32_t>(kSnapshotMagic));
+    hs.write(hv, csics::le<std::uint16_t>(kSnapshotVersion));
+    hs.write(hv, csics::le<std::uint16_t>(0));
+    hs.write(hv, csics::le<std::uint32_t>(1));
+    hs.pad(hv, 4);
+    hs.write(hv, csics::le<std::uint64_t>(std::uint64_t{1} << 62));
+    hs.write(hv, csics::le<std::uint64_t>(0));
+    hs.write(hv, csics::le<std::uint64_t>(std::uint64_t{1} << 60));
+    hs.write(hv, csics::le<std::uint32_t>(4));
+    hs.pad(hv, 4);
+    csics::serialization::DirectDeserializer huge(header);
+    auto rh = csics::serialization::deserialize(huge, snap);
+    ASSERT_FALSE(rh.has_value());
+    EXPECT_STREQ(rh.error().field, "blob_size");
+}
+#endif
+
+#ifdef CSICS_BUILD_GEO
+struct EcefPosition {
+    double x, y, z;
+};
+
+TEST(CSICSSimTests, ECSSpatialIndexTest) {
+    using namespace csics::sim::ecs;
+    using csics::geo::Geocentric;
+    auto world = StaticWorldBuilder()
+                     .add_layer(sys3)
+                     .add_component<EcefPosition>()
+                     .build();
+
+    Entity entities[10];
+    for (int i = 0; i < 10; ++i) {
+        entities[i] = world.add_entity();
+        world.add_component<EcefPosition>(entities[i],
+                                          {1000.0 * i, 0.0, 0.0});
+    }
+
+    SpatialIndex<EcefPosition> index(2000.0);
+    index.update(world.get_component_set<EcefPosition>());
+    EXPECT_EQ(index.size(), 10u);
+
+    csics::Buffer<Entity> found;
+    index.query_radius(Geocentric<double>(0.0, 0.0, 0.0), 1500.0, found);
+    EXPECT_EQ(found.size(), 2u);
+
+    world.get_component<EcefPosition>(entities[9]).x = 0.0;
+    world.remove_component<EcefPosition>(entities[1]);
+    index.update(world.get_component_set<EcefPosition>());
+    EXPECT_EQ(index.size(), 9u);
+
+    found.clear();
+    index.query_knn(Geocentric<double>(0.0, 0.0, 0.0), 2, found);
+    ASSERT_EQ(found.size(), 2u);
+    EXPECT_TRUE(found[0].id == entities[0].id || found[0].id == entities[9].id);
+    EXPECT_TRUE(found[1].id == entities[0].id || found[1].id == entities[9].id);
+}
+#endif
+
+#ifdef CSICS_BUILD_LVC
+namespace {
+csics::BufferView encode_entity_state(csics::Buffer<char>& buffer,
+                                      const csics::lvc::dis::EntityID& id,
+                                      double x) {
+    csics::lvc::dis::EntityStatePDU pdu{};
+    pdu.entity_id = id;
+    pdu.entity_location = csics::lvc::dis::WorldCoordinates(x, 2.0, 3.0);
+    pdu.entity_orientation = csics::lvc::dis::EulerAngles(0.5f, 0.25f, 0.0f);
+    pdu.entity_linear_velocity = csics::lvc::dis::Vector(10.0f, 0.0f, -1.0f);
+    csics::serialization::DirectSerializer s;
+    auto res = csics::serialization::serialize(s, buffer, pdu);
+    return csics::BufferView(buffer.data(), res.written_view.size());
+}
+}  // namespace
+
+TEST(CSICSSimTests, ECSDISIngestTest) {
+    using namespace csics::lvc::dis;
+    auto world = StaticWorldBuilder()
+                     .add_layer(sys3)
+                     .add_component<WorldCoordinates>()
+                     .add_component<EulerAngles>()
+                     .add_component<Vector>()
+                     .build();
+
+    csics::Buffer<char> buffers[5] = {
+        csics::Buffer<char>(512), csics::Buffer<char>(512),
+        csics::Buffer<char>(512), csics::Buffer<char>(512),
+        csics::Buffer<char>(512)};
+    TransmitterPDU tx{};
+    csics::serialization::DirectSerializer s;
+    auto tx_size =
+        csics::serialization::serialize(s, buffers[4], tx).written_view.size();
+
+    csics::BufferView batch[] = {
+        encode_entity_state(buffers[0], EntityID(1, 2, 3), 1.0),
+        encode_entity_state(buffers[1], EntityID(1, 2, 4), 2.0),
+        csics::BufferView(buffers[4].data(), tx_size),
+        encode_entity_state(buffers[2], EntityID(1, 2, 3), 5.0),
+        encode_entity_state(buffers[3], EntityID(1, 2, 5), 6.0).head(100),
+    };
+
+    EntityStateIngest<> ingest;
+    auto stats = ingest.ingest(world, batch);
+    EXPECT_EQ(stats.accepted, 3u);
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.malformed, 1u);
+    EXPECT_EQ(stats.created, 2u);
+    EXPECT_EQ(ingest.size(), 2u);
+    EXPECT_EQ(ingest.columns().keys[0], EntityID(1, 2, 3).packed());
+
+    // the later update for 1:2:3 in the same batch wins
+    auto e = ingest.find(EntityID(1, 2, 3));
+    ASSERT_TRUE(e.valid());
+    EXPECT_EQ(world.get_component<WorldCoordinates>(e).x(), 5.0);
+    EXPECT_EQ(world.get_component<EulerAngles>(e).pitch(), 0.25f);
+    EXPECT_EQ(world.get_component<Vector>(e), Vector(10.0f, 0.0f, -1.0f));
+    EXPECT_FALSE(ingest.find(EntityID(1, 2, 5)).valid());
+
+    // a second batch updates in place; the filter drops other entities
+    ingest.filter().entity(EntityID(1, 2, 4));
+    stats = ingest.ingest(world, std::span(batch, 2));
+    EXPECT_EQ(stats.accepted, 1u);
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.created, 0u);
+    EXPECT_EQ(world.get_component_set<WorldCoordinates>().size(), 2u);
+    EXPECT_EQ(world.get_component<WorldCoordinates>(e).x(), 5.0);
+
+    EXPECT_TRUE(ingest.forget(EntityID(1, 2, 4)));
+    EXPECT_FALSE(ingest.find(EntityID(1, 2, 4)).valid());
+    EXPECT_FALSE(ingest.forget(EntityID(1, 2, 4)));
+    EXPECT_FALSE(ingest.forget(EntityID(9, 9, 9)));
+    EXPECT_EQ(ingest.size(), 1u);
+
+    // a forgotten id is created again; ids on other pages, and the same
+    // entity number under another application, are distinct entities
+    ingest.filter() = DISFilter();
+    csics::BufferView spread[] = {
+        encode_entity_state(buffers[0], EntityID(1, 2, 4), 1.0),
+        encode_entity_state(buffers[1], EntityID(1, 2, 3 + 64), 2.0),
+        encode_entity_state(buffers[2], EntityID(1, 3, 3), 3.0),
+    };
+    stats = ingest.ingest(world, spread);
+    EXPECT_EQ(stats.created, 3u);
+    EXPECT_EQ(ingest.size(), 4u);
+    const Entity found[] = {ingest.find(EntityID(1, 2, 3)),
+                            ingest.find(EntityID(1, 2, 4)),
+                            ingest.find(EntityID(1, 2, 3 + 64)),
+                            ingest.find(EntityID(1, 3, 3))};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = i + 1; j < 4; ++j) {
+            EXPECT_NE(found[i].id, found[j].id);
+        }
+    }
+    EXPECT_EQ(world.get_component<WorldCoordinates>(found[3]).x(), 3.0);
+}
+#endif